@@ -0,0 +1,218 @@
+/*
+ * Benchmarks.cpp is part of Brewtarget, and is Copyright the following
+ * authors 2021
+ * - Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "Benchmarks.h"
+
+#include <iostream> // For std::cerr
+
+#include <xercesc/util/PlatformUtils.hpp>
+
+#include <QDebug>
+#include <QSettings>
+#include <QString>
+#include <QTableView>
+#include <QTextStream>
+
+#include "brewtarget.h"
+#include "BtTreeModel.h"
+#include "database/ObjectStoreTyped.h"
+#include "database/ObjectStoreWrapper.h"
+#include "HopTableModel.h"
+#include "Logging.h"
+#include "model/Fermentable.h"
+#include "model/Hop.h"
+#include "model/Recipe.h"
+#include "PersistentSettings.h"
+#include "xml/BeerXml.h"
+
+namespace {
+   // How many extra hops and fermentables we put in the database before we start
+   int const numSeededIngredients = 1000;
+
+   std::shared_ptr<Hop> makeHop(int ii) {
+      auto hop = std::make_shared<Hop>();
+      hop->setName(QString{"Benchmark Hop %1"}.arg(ii));
+      // Spread things over a few folders so the trees have some structure to build
+      hop->setFolder(QString{"/Benchmark/%1"}.arg(ii % 10));
+      hop->setAlpha_pct(3.0 + (ii % 15));
+      hop->setAmount_kg(0.01 + (ii % 5) * 0.005);
+      hop->setTime_min(ii % 90);
+      hop->setUse(Hop::Boil);
+      hop->setType(Hop::Both);
+      hop->setForm(Hop::Pellet);
+      return hop;
+   }
+
+   std::shared_ptr<Fermentable> makeFermentable(int ii) {
+      auto fermentable = std::make_shared<Fermentable>();
+      fermentable->setName(QString{"Benchmark Fermentable %1"}.arg(ii));
+      fermentable->setFolder(QString{"/Benchmark/%1"}.arg(ii % 10));
+      fermentable->setType(Fermentable::Grain);
+      fermentable->setYield_pct(60.0 + (ii % 20));
+      fermentable->setColor_srm(2.0 + (ii % 40));
+      fermentable->setAmount_kg(0.1 + (ii % 10) * 0.1);
+      fermentable->setIsMashed(true);
+      return fermentable;
+   }
+
+   /**
+    * \brief Make a recipe, stored in the database, with the given number of hops and of fermentables
+    */
+   std::shared_ptr<Recipe> makeRecipe(int numIngredients) {
+      auto recipe = std::make_shared<Recipe>(QString{"Benchmark Recipe (%1 ingredients)"}.arg(numIngredients));
+      recipe->setBatchSize_l(20.0);
+      recipe->setBoilSize_l(24.0);
+      recipe->setEfficiency_pct(70.0);
+      ObjectStoreWrapper::insert(recipe);
+      for (int ii = 0; ii < numIngredients; ++ii) {
+         recipe->add(makeHop(ii));
+         recipe->add(makeFermentable(ii));
+      }
+      return recipe;
+   }
+}
+
+QTEST_MAIN(Benchmarks)
+
+void Benchmarks::initTestCase() {
+   // Initialize Xerces XML tools
+   try {
+      xercesc::XMLPlatformUtils::Initialize();
+   } catch (xercesc::XMLException const & xercesInitException) {
+      qCritical() << Q_FUNC_INFO << "Xerces XML Parser Initialisation Failed: " << xercesInitException.getMessage();
+      return;
+   }
+
+   try {
+      // Separate settings and a brand new database, so we neither disturb nor depend on anyone's real data
+      QCoreApplication::setOrganizationDomain("brewtarget.com/bench");
+      QCoreApplication::setApplicationName("brewtarget-bench");
+      this->userDataDir = std::make_unique<QTemporaryDir>();
+      QVERIFY(this->userDataDir->isValid());
+      PersistentSettings::initialise(this->userDataDir->path());
+
+      Logging::initializeLogging();
+      // Debug logging would swamp what we're trying to measure
+      Logging::setLogLevel(Logging::LogLevel_WARNING);
+      Logging::setDirectory(QDir{this->userDataDir->path()}, Logging::NewDirectoryIsTemporary);
+      Logging::setLoggingToStderr(false);
+
+      Brewtarget::setInteractive(false);
+      QVERIFY(Brewtarget::initialize());
+
+      for (int ii = 0; ii < numSeededIngredients; ++ii) {
+         ObjectStoreWrapper::insert(makeHop(ii));
+         ObjectStoreWrapper::insert(makeFermentable(ii));
+      }
+   } catch (std::exception const & e) {
+      std::cerr << "Caught exception: " << e.what() << std::endl;
+      throw;
+   }
+   return;
+}
+
+void Benchmarks::cleanupTestCase() {
+   Brewtarget::cleanup();
+   Logging::terminateLogging();
+   QSettings().clear();
+   this->userDataDir.reset();
+   xercesc::XMLPlatformUtils::Terminate();
+   return;
+}
+
+void Benchmarks::benchmarkRecalcAll_data() {
+   QTest::addColumn<int>("numIngredients");
+   QTest::newRow("small") << 4;
+   QTest::newRow("large") << 250;
+   return;
+}
+
+void Benchmarks::benchmarkRecalcAll() {
+   QFETCH(int, numIngredients);
+   auto recipe = makeRecipe(numIngredients);
+   QBENCHMARK {
+      recipe->recalcAll();
+   }
+   return;
+}
+
+void Benchmarks::benchmarkLoadAll() {
+   // Each iteration reads everything into a new, separate store, so the objects the rest of the program is using are
+   // left alone
+   QBENCHMARK {
+      auto hopStore = ObjectStoreTyped<Hop>::createUnshared();
+      hopStore->loadAll();
+      auto fermentableStore = ObjectStoreTyped<Fermentable>::createUnshared();
+      fermentableStore->loadAll();
+      QVERIFY(hopStore->getAll().size() >= numSeededIngredients);
+   }
+   return;
+}
+
+void Benchmarks::benchmarkBeerXmlImport() {
+   QString const defaultDataFileName = Brewtarget::getResourceDir().filePath("DefaultData.xml");
+   QVERIFY2(QFile::exists(defaultDataFileName), qPrintable(defaultDataFileName + " not found"));
+   // Each import changes the database that the next one would run against, so repeating it in a loop would measure a
+   // different (and unrepresentative) workload on every iteration.  Instead we time a single import into the database
+   // as set up by initTestCase(), which is the same every time the benchmarks are run.
+   QBENCHMARK_ONCE {
+      QString userMessage;
+      QTextStream userMessageAsStream{&userMessage};
+      QVERIFY2(BeerXML::getInstance().importFromXML(defaultDataFileName, userMessageAsStream),
+               qPrintable(userMessage));
+   }
+   return;
+}
+
+void Benchmarks::benchmarkHopTableModelData() {
+   QTableView tableView;
+   HopTableModel model{&tableView, false};
+   model.observeDatabase(true);
+   while (model.canFetchMore(QModelIndex{})) {
+      model.fetchMore(QModelIndex{});
+   }
+   QVERIFY(model.rowCount() >= numSeededIngredients);
+
+   QBENCHMARK {
+      for (int row = 0; row < model.rowCount(); ++row) {
+         for (int column = 0; column < model.columnCount(); ++column) {
+            QModelIndex const index = model.index(row, column);
+            model.data(index, Qt::DisplayRole);
+            model.data(index, Qt::ToolTipRole);
+         }
+      }
+   }
+   return;
+}
+
+void Benchmarks::benchmarkLoadTreeModel_data() {
+   QTest::addColumn<int>("typeMask");
+   QTest::newRow("recipes")      << static_cast<int>(BtTreeModel::RECIPEMASK);
+   QTest::newRow("hops")         << static_cast<int>(BtTreeModel::HOPMASK);
+   QTest::newRow("fermentables") << static_cast<int>(BtTreeModel::FERMENTMASK);
+   return;
+}
+
+void Benchmarks::benchmarkLoadTreeModel() {
+   QFETCH(int, typeMask);
+   // The constructor is what calls loadTreeModel()
+   QBENCHMARK {
+      BtTreeModel treeModel{nullptr, static_cast<BtTreeModel::TypeMasks>(typeMask)};
+   }
+   return;
+}
@@ -0,0 +1,74 @@
+/*
+ * Benchmarks.h is part of Brewtarget, and is Copyright the following
+ * authors 2021
+ * - Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+#pragma once
+
+#include <memory>
+
+#include <QObject>
+#include <QTemporaryDir>
+#include <QtTest/QtTest>
+
+/**
+ * \brief Micro and macro benchmarks, built as the brewtarget_bench executable.
+ *
+ *        These are separate from the unit tests in \c Testing because they are slow, and because what matters is the
+ *        numbers they produce rather than whether they pass.  Run them with the run_benchmarks build target, which
+ *        writes the results in QtTest XML format to benchmark_results.xml in the build directory, so they can be kept
+ *        and compared between releases.  (Or run brewtarget_bench directly with any of the usual QtTest options, eg
+ *        -o results.csv,csv.)
+ *
+ *        Everything runs against a new database in a temporary directory, seeded with a known number of ingredients,
+ *        so results don't depend on what's in the user's own database.
+ */
+class Benchmarks : public QObject {
+   Q_OBJECT
+
+private:
+   // Where we put the settings and database for the benchmark run
+   std::unique_ptr<QTemporaryDir> userDataDir;
+
+private slots:
+   // Run once before all benchmarks
+   void initTestCase();
+
+   // Run once after all benchmarks
+   void cleanupTestCase();
+
+   //! \brief Recipe::recalcAll on a small and a very large recipe
+   void benchmarkRecalcAll_data();
+   void benchmarkRecalcAll();
+
+   //! \brief ObjectStore::loadAll on hops and fermentables in the seeded database
+   void benchmarkLoadAll();
+
+   //! \brief A single BeerXML import of DefaultData.xml into the seeded database (which is mostly spotting that
+   //!        everything is already there)
+   void benchmarkBeerXmlImport();
+
+   //! \brief HopTableModel::data for every cell, as when the hop table is repainted
+   void benchmarkHopTableModelData();
+
+   //! \brief Building the trees shown on the left-hand side of the main window
+   void benchmarkLoadTreeModel_data();
+   void benchmarkLoadTreeModel();
+};
+
+#endif
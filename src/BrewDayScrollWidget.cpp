@@ -59,10 +59,13 @@ namespace {
 
 
 BrewDayScrollWidget::BrewDayScrollWidget(QWidget* parent) : QWidget{parent},
-                                                            recObs{nullptr} {
+                                                            recObs{nullptr},
+                                                            instructionChanges{"BrewDayScrollWidget"} {
    this->setupUi(this);
    this->setObjectName("BrewDayScrollWidget");
 
+   connect(&this->instructionChanges, &ChangeDispatcher::refresh, this, &BrewDayScrollWidget::refreshInstructions);
+
    connect(listWidget,                      &QListWidget::currentRowChanged, this, &BrewDayScrollWidget::showInstruction          );
    connect(btTextEdit,                      SIGNAL(textModified()),          this, SLOT(saveInstruction())                        );
 //   connect(btTextEdit,                      &BtLineEdit::textModified,       this, &BrewDayScrollWidget::saveInstruction          );
@@ -225,6 +228,8 @@ void BrewDayScrollWidget::setRecipe(Recipe* rec) {
       btTextEdit->setEnabled(true);
    }
 
+   // Anything still pending was for the old recipe
+   this->instructionChanges.discardPending();
    showChanges();
    return;
 }
@@ -260,13 +265,9 @@ void BrewDayScrollWidget::acceptChanges(QMetaProperty prop, QVariant /*value*/)
 {
    if( recObs && QString(prop.name()) == "instructions" )
    {
-      // An instruction has been added or deleted, so update internal list.
-      foreach( Instruction* ins, recIns )
-         disconnect( ins, nullptr, this, nullptr );
-      recIns = recObs->instructions(); // Already sorted by instruction numbers.
-      foreach( Instruction* ins, recIns )
-         connect( ins, &Instruction::changed, this, &BrewDayScrollWidget::acceptInsChanges );
-      showChanges();
+      // An instruction has been added or deleted, so update internal list, but not until the recipe has finished
+      // changing
+      this->instructionChanges.markDirty(prop.name());
    }
 }
 
@@ -276,9 +277,9 @@ void BrewDayScrollWidget::acceptInsChanges(QMetaProperty prop, QVariant /*value*
 
    if( propName == "instructionNumber" )
    {
-      // The order changed, so resort our internal list.
-      std::sort( recIns.begin(), recIns.end(), insPtrLtByNumber );
-      showChanges();
+      // The order changed, so resort our internal list.  (Moving one instruction renumbers two, so wait until both
+      // have been done.)
+      this->instructionChanges.markDirty(propName);
    }
    else if( propName == PropertyNames::Instruction::directions )
    {
@@ -287,6 +288,25 @@ void BrewDayScrollWidget::acceptInsChanges(QMetaProperty prop, QVariant /*value*
    }
 }
 
+void BrewDayScrollWidget::refreshInstructions(QSet<QString> const & changedProperties) {
+   if (this->recObs == nullptr) {
+      return;
+   }
+
+   if (changedProperties.contains("instructions")) {
+      foreach( Instruction* ins, recIns )
+         disconnect( ins, nullptr, this, nullptr );
+      recIns = recObs->instructions(); // Already sorted by instruction numbers.
+      foreach( Instruction* ins, recIns )
+         connect( ins, &Instruction::changed, this, &BrewDayScrollWidget::acceptInsChanges );
+   } else {
+      std::sort( recIns.begin(), recIns.end(), insPtrLtByNumber );
+   }
+
+   showChanges();
+   return;
+}
+
 void BrewDayScrollWidget::clear() {
    listWidget->clear();
    return;
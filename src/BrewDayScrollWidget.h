@@ -43,6 +43,7 @@ class BrewDayScrollWidget;
 #include <QPrintDialog>
 #include <QFile>
 #include "model/Recipe.h"
+#include "utils/ChangeDispatcher.h"
 
 
 /*!
@@ -87,6 +88,8 @@ private slots:
    void acceptInsChanges( QMetaProperty prop, QVariant value );
 
 private:
+   //! \brief Does, once per turn of the event loop, the work asked for by \c acceptChanges() and \c acceptInsChanges()
+   void refreshInstructions(QSet<QString> const & changedProperties);
    //! Update the view.
    void showChanges();
    //! Repopulate the list widget with all the instructions.
@@ -102,6 +105,8 @@ private:
    QTextBrowser* doc;
    //! Internal list of recipe instructions, always sorted by instruction number.
    QList<Instruction*> recIns;
+   //! Generating instructions adds them one at a time, so we don't want to rebuild the list for each one
+   ChangeDispatcher instructionChanges;
 
    QString cssName;
 
@@ -24,6 +24,7 @@
 #include <QDebug>
 
 #include "brewtarget.h"
+#include "Logging.h"
 #include "model/Style.h"
 #include "model/Recipe.h"
 #include "PersistentSettings.h"
@@ -71,7 +72,7 @@ void BtLabel::initializeSection()
       _section = btParent->property("configSection").toString();
    else
    {
-      qDebug() << "this failed" << this;
+      qCDebug(lcUi) << "this failed" << this;
       _section = btParent->objectName();
    }
 }
@@ -89,7 +90,7 @@ void BtLabel::initializeProperty()
    else if ( mybuddy && mybuddy->property("editField").isValid() )
       propertyName = mybuddy->property("editField").toString();
    else
-      qDebug() << "That failed miserably";
+      qCDebug(lcUi) << "That failed miserably";
 }
 
 void BtLabel::initializeMenu()
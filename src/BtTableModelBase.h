@@ -0,0 +1,407 @@
+/*
+ * BtTableModelBase.h is part of Brewtarget, and is Copyright the following
+ * authors 2021
+ * - Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef BTTABLEMODELBASE_H
+#define BTTABLEMODELBASE_H
+#pragma once
+
+#include <algorithm>
+#include <memory>
+
+#include <QDebug>
+#include <QList>
+#include <QModelIndex>
+#include <QObject>
+#include <QSet>
+#include <QTimer>
+#include <QVector>
+
+#include "database/ObjectStoreTyped.h"
+#include "database/ObjectStoreWrapper.h"
+#include "model/Recipe.h"
+#include "utils/FormattedValueCache.h"
+
+/**
+ * \class BtTableModelBase
+ *
+ * \brief Common code for the table models that show a list of \c NE objects, either those used in a \c Recipe or all
+ *        those in the database.
+ *
+ *        Qt's meta-object compiler can't cope with class templates that have signals or slots, so this is not itself a
+ *        \c QObject.  Instead we use the Curiously Recurring Template Pattern and the derived class (which must inherit
+ *        from \c QAbstractTableModel \b before it inherits from this class) must:
+ *           • declare this class a friend, so that we can call its protected \c beginInsertRows() etc;
+ *           • have a public slot \c changed(QMetaProperty, QVariant), which we connect to the recipe and to each row
+ *             object, and which should call \c rowChanged() for the latter;
+ *           • provide \c QList<NE *> recipeItems(Recipe const & recipe) const returning the objects to show for a
+ *             recipe;
+ *           • forward \c rowCount(), \c canFetchMore() and \c fetchMore() to \c rowCountImpl() etc.
+ *
+ *        Things we do here, rather than in each derived class:
+ *           • Rows are inserted and removed in batches, with one \c beginInsertRows() / \c beginRemoveRows() per
+ *             contiguous range, rather than one per object.
+ *           • When showing everything in the database (eg in \c HopDialog), we don't create all the rows up-front but
+ *             hand them out a page at a time via \c canFetchMore() / \c fetchMore() as the view scrolls.
+ *           • Changes to row objects are coalesced and \c dataChanged() is emitted, once per contiguous range of
+ *             changed rows, the next time the event loop runs.  (Setting one property on an object often triggers
+ *             several other property changes, and it's wasteful to have the view repaint the row for each one.)
+ */
+template<class Derived, class NE>
+class BtTableModelBase {
+public:
+   /**
+    * \brief How many rows to add per call to \c fetchMore() when we are showing everything in the database
+    */
+   static constexpr int fetchBatchSize = 256;
+
+   /**
+    * \param numColumns Number of columns in the derived model
+    * \param emitHeaderChanges Whether the vertical header depends on row contents (eg IBUs in \c HopTableModel), in
+    *                          which case we also emit \c headerDataChanged() for changed rows
+    */
+   BtTableModelBase(int numColumns, bool emitHeaderChanges = false) :
+      recObs{nullptr},
+      rows{},
+      formattedValueCache{numColumns},
+      numColumns{numColumns},
+      emitHeaderChanges{emitHeaderChanges},
+      observingDatabase{false},
+      rowSet{},
+      unfetched{},
+      pendingChanges{},
+      flushScheduled{false} {
+      return;
+   }
+
+   ~BtTableModelBase() = default;
+
+   //! \brief Observe a recipe's list of \c NE objects
+   void observeRecipe(Recipe * rec) {
+      if (this->recObs) {
+         QObject::disconnect(this->recObs, nullptr, &this->derived(), nullptr);
+         this->removeAll();
+      }
+
+      this->recObs = rec;
+      if (this->recObs) {
+         QObject::connect(this->recObs, &NamedEntity::changed, &this->derived(), &Derived::changed);
+         this->add(this->derived().recipeItems(*this->recObs));
+      }
+      return;
+   }
+
+   //! \brief If true, we model the database's list of \c NE objects
+   void observeDatabase(bool val) {
+      ObjectStoreTyped<NE> & objectStore = ObjectStoreTyped<NE>::getInstance();
+      if (val) {
+         this->observeRecipe(nullptr);
+         this->removeAll();
+         //
+         // Qt::UniqueConnection doesn't work for lambdas, so we have to make sure ourselves that being asked to observe
+         // the database again doesn't connect a second time (which would eg add each new object twice over).
+         //
+         if (!this->observingDatabase) {
+            this->observingDatabase = true;
+            QObject::connect(&objectStore,
+                             &ObjectStoreTyped<NE>::signalObjectInserted,
+                             &this->derived(),
+                             [this](int id) { this->addById(id); });
+            QObject::connect(&objectStore,
+                             &ObjectStoreTyped<NE>::signalObjectDeleted,
+                             &this->derived(),
+                             [this](int /*id*/, std::shared_ptr<QObject> object) {
+                                this->remove(std::static_pointer_cast<NE>(object).get());
+                             });
+         }
+
+         //
+         // Rather than create rows for everything now, we just note what there is and let the view pull in rows via
+         // fetchMore() as it needs them.  Sorting by name means the pages come in roughly the order the user will see
+         // them with the default sort.
+         //
+         for (auto ne : objectStore.getAllRaw()) {
+            if (!ne->deleted() && ne->display()) {
+               this->unfetched.append(ne);
+            }
+         }
+         std::sort(this->unfetched.begin(),
+                   this->unfetched.end(),
+                   [](NE const * lhs, NE const * rhs) { return lhs->name() < rhs->name(); });
+         this->fetchMoreImpl();
+      } else {
+         this->removeAll();
+         QObject::disconnect(&objectStore, nullptr, &this->derived(), nullptr);
+         this->observingDatabase = false;
+      }
+      return;
+   }
+
+   /**
+    * \brief Append rows for any of \c items we're not already showing, in one batch
+    */
+   void add(QList<NE *> const & items) {
+      QList<NE *> toAdd;
+      for (auto ne : items) {
+         if (!ne || this->rowSet.contains(ne)) {
+            continue;
+         }
+         // If we are observing the database, ensure that the item is undeleted and fit to display.
+         if (this->observingDatabase && (ne->deleted() || !ne->display())) {
+            continue;
+         }
+         this->rowSet.insert(ne);
+         toAdd.append(ne);
+      }
+
+      if (toAdd.isEmpty()) {
+         return;
+      }
+
+      int const first = this->rows.size();
+      this->derived().beginInsertRows(QModelIndex(), first, first + toAdd.size() - 1);
+      this->rows.append(toAdd);
+      for (auto ne : toAdd) {
+         QObject::connect(ne, &NamedEntity::changed, &this->derived(), &Derived::changed);
+      }
+      this->derived().endInsertRows();
+      return;
+   }
+
+   /**
+    * \brief Remove the row for \c ne, if we have one
+    *
+    * \return \c true if \c ne was found and removed
+    */
+   bool remove(NE * ne) {
+      return this->remove(QList<NE *>{ne}) > 0;
+   }
+
+   /**
+    * \brief Remove the rows for any of \c items that we are showing, with one \c beginRemoveRows() per contiguous
+    *        range of rows
+    *
+    * \return number of rows removed
+    */
+   int remove(QList<NE *> const & items) {
+      QSet<NE const *> toForget;
+      QSet<NE const *> toRemove;
+      for (auto ne : items) {
+         toForget.insert(ne);
+         if (this->rowSet.contains(ne)) {
+            toRemove.insert(ne);
+         }
+      }
+
+      // Anything not yet handed out by fetchMore() just needs to come off that list, which we can do in one pass
+      if (!this->unfetched.isEmpty()) {
+         this->unfetched.erase(std::remove_if(this->unfetched.begin(),
+                                              this->unfetched.end(),
+                                              [&toForget](NE const * ne) { return toForget.contains(ne); }),
+                               this->unfetched.end());
+      }
+
+      if (toRemove.isEmpty()) {
+         return 0;
+      }
+
+      QVector<int> indexes;
+      for (int ii = 0; ii < this->rows.size(); ++ii) {
+         if (toRemove.contains(this->rows.at(ii))) {
+            indexes.append(ii);
+         }
+      }
+
+      // Work backwards so that removing one range does not shift the ones we have yet to do
+      int last = indexes.size() - 1;
+      while (last >= 0) {
+         int first = last;
+         while (first > 0 && indexes.at(first - 1) == indexes.at(first) - 1) {
+            --first;
+         }
+         this->derived().beginRemoveRows(QModelIndex(), indexes.at(first), indexes.at(last));
+         for (int ii = indexes.at(first); ii <= indexes.at(last); ++ii) {
+            this->forget(this->rows.at(ii));
+         }
+         this->rows.erase(this->rows.begin() + indexes.at(first), this->rows.begin() + indexes.at(last) + 1);
+         this->derived().endRemoveRows();
+         last = first - 1;
+      }
+      return indexes.size();
+   }
+
+   //! \brief Clear the model
+   void removeAll() {
+      this->unfetched.clear();
+      if (!this->rows.isEmpty()) {
+         this->derived().beginRemoveRows(QModelIndex(), 0, this->rows.size() - 1);
+         while (!this->rows.isEmpty()) {
+            QObject::disconnect(this->rows.takeLast(), nullptr, &this->derived(), nullptr);
+         }
+         this->derived().endRemoveRows();
+      }
+      this->rowSet.clear();
+      this->pendingChanges.clear();
+      this->formattedValueCache.clear();
+      return;
+   }
+
+   /**
+    * \brief Pull in all the rows not yet handed out by \c fetchMore(), eg because the user is about to filter on them
+    */
+   void fetchAll() {
+      QList<NE *> batch;
+      batch.swap(this->unfetched);
+      this->add(batch);
+      return;
+   }
+
+   //! \return the object shown in row \c ii, or \c nullptr if there isn't one
+   NE * getRow(int ii) const {
+      if (ii < 0 || ii >= this->rows.size()) {
+         qWarning() << Q_FUNC_INFO << "Row" << ii << "out of range (" << this->rows.size() << "rows)";
+         return nullptr;
+      }
+      return this->rows.at(ii);
+   }
+
+protected:
+   //! \brief Implementation of \c QAbstractItemModel::rowCount() for derived class to call
+   int rowCountImpl() const {
+      return this->rows.size();
+   }
+
+   //! \brief Implementation of \c QAbstractItemModel::canFetchMore() for derived class to call
+   bool canFetchMoreImpl(QModelIndex const & parent = QModelIndex()) const {
+      return !parent.isValid() && !this->unfetched.isEmpty();
+   }
+
+   //! \brief Implementation of \c QAbstractItemModel::fetchMore() for derived class to call
+   void fetchMoreImpl(QModelIndex const & parent = QModelIndex()) {
+      if (parent.isValid() || this->unfetched.isEmpty()) {
+         return;
+      }
+      int const numToFetch = std::min(BtTableModelBase::fetchBatchSize, this->unfetched.size());
+      QList<NE *> batch = this->unfetched.mid(0, numToFetch);
+      this->unfetched.erase(this->unfetched.begin(), this->unfetched.begin() + numToFetch);
+      this->add(batch);
+      return;
+   }
+
+   /**
+    * \brief Derived class calls this when one of its row objects has changed.  We forget any formatted values we
+    *        cached for the row straight away, but only tell the view on the next pass of the event loop.
+    */
+   void rowChanged(NE const * ne) {
+      if (!this->rowSet.contains(ne)) {
+         return;
+      }
+      this->formattedValueCache.invalidateRow(ne);
+      this->pendingChanges.insert(ne);
+      if (!this->flushScheduled) {
+         this->flushScheduled = true;
+         QTimer::singleShot(0, &this->derived(), [this]() { this->flushChanges(); });
+      }
+      return;
+   }
+
+   /**
+    * \brief Emit \c dataChanged() (and \c headerDataChanged() if required) for all rows changed since the last call
+    */
+   void flushChanges() {
+      this->flushScheduled = false;
+      if (this->pendingChanges.isEmpty()) {
+         return;
+      }
+
+      QVector<int> indexes;
+      for (int ii = 0; ii < this->rows.size(); ++ii) {
+         if (this->pendingChanges.contains(this->rows.at(ii))) {
+            indexes.append(ii);
+         }
+      }
+      this->pendingChanges.clear();
+
+      int first = 0;
+      while (first < indexes.size()) {
+         int last = first;
+         while (last + 1 < indexes.size() && indexes.at(last + 1) == indexes.at(last) + 1) {
+            ++last;
+         }
+         emit this->derived().dataChanged(this->derived().index(indexes.at(first), 0),
+                                          this->derived().index(indexes.at(last), this->numColumns - 1));
+         if (this->emitHeaderChanges) {
+            emit this->derived().headerDataChanged(Qt::Vertical, indexes.at(first), indexes.at(last));
+         }
+         first = last + 1;
+      }
+      return;
+   }
+
+   Recipe * recObs;
+   QList<NE *> rows;
+   //! \brief Display strings for amounts etc, so we don't have to reformat them on every repaint
+   mutable FormattedValueCache formattedValueCache;
+
+private:
+   Derived & derived() {
+      return static_cast<Derived &>(*this);
+   }
+
+   //! \brief Handle an \c NE object being added to the database
+   void addById(int id) {
+      NE * ne = ObjectStoreWrapper::getByIdRaw<NE>(id);
+      if (!ne) {
+         // Not sure this should ever happen in practice, but, if there ever is no object with the specified ID,
+         // there's not a lot we can do.
+         qWarning() << Q_FUNC_INFO << "Received signal that ID" << id << "added, but unable to retrieve the object";
+         return;
+      }
+
+      if (!this->unfetched.isEmpty()) {
+         // The view hasn't yet pulled in everything that was there before, so just join the back of the queue
+         if (!ne->deleted() && ne->display()) {
+            this->unfetched.append(ne);
+         }
+         return;
+      }
+
+      this->add(QList<NE *>{ne});
+      return;
+   }
+
+   //! \brief Tidy up after a row object has been taken out of \c rows
+   void forget(NE * ne) {
+      QObject::disconnect(ne, nullptr, &this->derived(), nullptr);
+      this->rowSet.remove(ne);
+      this->pendingChanges.remove(ne);
+      this->formattedValueCache.invalidateRow(ne);
+      return;
+   }
+
+   int const numColumns;
+   bool const emitHeaderChanges;
+   bool observingDatabase;
+   //! \brief Same contents as \c rows, for quick "do we already have this one" checks on large lists
+   QSet<NE const *> rowSet;
+   //! \brief Objects we will show when the view calls \c fetchMore()
+   QList<NE *> unfetched;
+   QSet<NE const *> pendingChanges;
+   bool flushScheduled;
+};
+
+#endif
@@ -45,15 +45,6 @@ protected:
 
 private:
    BtTreeModel::TypeMasks treeMask;
-
-   bool lessThanRecipe(BtTreeModel* model,const QModelIndex &left, const QModelIndex &right) const;
-   bool lessThanEquip(BtTreeModel* model,const QModelIndex &left, const QModelIndex &right) const;
-   bool lessThanFerment(BtTreeModel* model,const QModelIndex &left, const QModelIndex &right) const;
-   bool lessThanMisc(BtTreeModel* model,const QModelIndex &left, const QModelIndex &right) const;
-   bool lessThanHop(BtTreeModel* model,const QModelIndex &left, const QModelIndex &right) const;
-   bool lessThanYeast(BtTreeModel* model,const QModelIndex &left, const QModelIndex &right) const;
-   bool lessThanStyle(BtTreeModel* model,const QModelIndex &left, const QModelIndex &right) const;
-   bool lessThanWater(BtTreeModel* model,const QModelIndex &left, const QModelIndex &right) const;
 };
 
 #endif
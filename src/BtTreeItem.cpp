@@ -32,6 +32,7 @@
 #include "brewtarget.h"
 #include "BtFolder.h"
 #include "FermentableTableModel.h"
+#include "Logging.h"
 #include "model/BrewNote.h"
 #include "model/Equipment.h"
 #include "model/Fermentable.h"
@@ -171,7 +172,7 @@ QVariant BtTreeItem::data(int column) {
 }
 
 bool BtTreeItem::insertChildren(int position, int count, int _type) {
-//   qDebug() <<
+//   qCDebug(lcUi) <<
 //      Q_FUNC_INFO << "Inserting" << count << "children of type" << _type << "(" <<
 //      this->itemTypeToString(static_cast<BtTreeItem::ITEMTYPE>(_type)) << ") at position" << position;
    if (position < 0  || position > this->childItems.size()) {
@@ -36,6 +36,7 @@
 #include "BtFolder.h"
 #include "BtTreeItem.h"
 #include "BtTreeView.h"
+#include "Logging.h"
 #include "RecipeFormatter.h"
 #include "database/ObjectStoreWrapper.h"
 #include "model/Equipment.h"
@@ -48,8 +49,24 @@
 #include "model/Style.h"
 #include "model/Water.h"
 #include "utils/BtStringConst.h"
+#include "utils/Tracing.h"
 #include "PersistentSettings.h"
 
+namespace {
+   /**
+    * \brief Turns whatever is stored as a thing's folder into the form we use for \c BtFolder::fullPath(), ie "/a/b",
+    *        or "/" for the top of the tree
+    */
+   QString normalisedFolderPath(QString const & folder) {
+#if QT_VERSION < QT_VERSION_CHECK(5,15,0)
+      QStringList dirs = folder.simplified().split("/", QString::SkipEmptyParts);
+#else
+      QStringList dirs = folder.simplified().split("/", Qt::SkipEmptyParts);
+#endif
+      return "/" % dirs.join("/");
+   }
+}
+
 // =========================================================================
 // ============================ CLASS STUFF ================================
 // =========================================================================
@@ -163,14 +180,59 @@ BtTreeItem * BtTreeModel::item(const QModelIndex & index) const {
 
 int BtTreeModel::rowCount(const QModelIndex & parent) const {
    if (! parent.isValid()) {
-//      qDebug() << Q_FUNC_INFO << "No parent. Root item has" << this->rootItem->childCount() << "children";
+//      qCDebug(lcUi) << Q_FUNC_INFO << "No parent. Root item has" << this->rootItem->childCount() << "children";
       return this->rootItem->childCount();
    }
 
-//   qDebug() << Q_FUNC_INFO << "Parent has" << this->item(parent)->childCount() << "children";
+//   qCDebug(lcUi) << Q_FUNC_INFO << "Parent has" << this->item(parent)->childCount() << "children";
    return this->item(parent)->childCount();
 }
 
+bool BtTreeModel::hasChildren(QModelIndex const & parent) const {
+   BtTreeItem * pItem = this->item(parent);
+   if (! this->unfetched.contains(pItem)) {
+      return pItem->childCount() > 0;
+   }
+
+   // We only create folders when there's something to put in them
+   if (pItem->type() != BtTreeItem::RECIPE) {
+      return true;
+   }
+
+   if (! this->unfetchedHasChildren.contains(pItem)) {
+      Recipe * rec = pItem->recipe();
+      this->unfetchedHasChildren.insert(pItem, rec && (rec->hasAncestors() || ! rec->brewNotes().isEmpty()));
+   }
+   return this->unfetchedHasChildren.value(pItem);
+}
+
+bool BtTreeModel::canFetchMore(QModelIndex const & parent) const {
+   return this->unfetched.contains(this->item(parent));
+}
+
+void BtTreeModel::fetchMore(QModelIndex const & parent) {
+   BtTreeItem * pItem = this->item(parent);
+   if (! this->unfetched.remove(pItem)) {
+      return;
+   }
+   this->unfetchedHasChildren.remove(pItem);
+
+   if (pItem->type() == BtTreeItem::FOLDER) {
+      QString const path = pItem->folder()->fullPath();
+      QList<NamedEntity *> contents;
+      for (NamedEntity * elem : this->elements()) {
+         if (normalisedFolderPath(elem->folder()) == path) {
+            contents.append(elem);
+         }
+      }
+      qCDebug(lcUi) << Q_FUNC_INFO << "Adding" << contents.size() << "items to folder" << path;
+      this->insertElements(pItem, contents);
+   } else if (pItem->type() == BtTreeItem::RECIPE) {
+      this->addRecipeSubTree(pItem);
+   }
+   return;
+}
+
 int BtTreeModel::columnCount(const QModelIndex & parent) const {
    Q_UNUSED(parent)
    return m_maxColumns;
@@ -478,16 +540,43 @@ bool BtTreeModel::insertRow(int row, const QModelIndex & parent, QObject * victi
       type = victimType == -1 ? type : victimType;
       BtTreeItem * added = pItem->child(row);
       added->setData(type, victim);
+      this->indexItem(added);
    }
    endInsertRows();
 
    return success;
 }
 
+void BtTreeModel::insertElements(BtTreeItem * pItem, QList<NamedEntity *> const & elems) {
+   if (elems.isEmpty()) {
+      return;
+   }
+
+   int const first = pItem->childCount();
+   this->beginInsertRows(createIndex(pItem->childNumber(), 0, pItem), first, first + elems.size() - 1);
+   pItem->insertChildren(first, elems.size(), this->_type);
+   for (int ii = 0; ii < elems.size(); ++ii) {
+      BtTreeItem * added = pItem->child(first + ii);
+      added->setData(this->_type, elems.at(ii));
+      this->indexItem(added);
+      // A recipe's brew notes and previous versions wait until it is expanded
+      if (this->treeMask & RECIPEMASK) {
+         this->unfetched.insert(added);
+      }
+   }
+   this->endInsertRows();
+   return;
+}
+
 bool BtTreeModel::removeRows(int row, int count, const QModelIndex & parent) {
    BtTreeItem * pItem = item(parent);
 
    this->beginRemoveRows(parent, row, row + count - 1);
+   if (row >= 0 && row + count <= pItem->childCount()) {
+      for (int ii = row; ii < row + count; ++ii) {
+         this->unindexSubtree(pItem->child(ii));
+      }
+   }
    bool success = pItem->removeChildren(row, count);
    this->endRemoveRows();
 
@@ -498,43 +587,223 @@ bool BtTreeModel::removeRows(int row, int count, const QModelIndex & parent) {
 // ====================== BREWTARGET STUFF =================================
 // =========================================================================
 
-// One find method for all things. This .. is nice
-QModelIndex BtTreeModel::findElement(NamedEntity * thing, BtTreeItem * parent) {
-   BtTreeItem * pItem;
-   QList<BtTreeItem *> folders;
+void BtTreeModel::indexItem(BtTreeItem * item) {
+   if (item->type() == BtTreeItem::FOLDER) {
+      if (item->folder()) {
+         this->folderIndex.insert(item->folder()->fullPath(), item);
+      }
+   } else if (item->thing()) {
+      // We only listen to things that are actually in the tree
+      if (! this->elementIndex.contains(item->thing())) {
+         this->observeElement(item->thing());
+      }
+      this->elementIndex.insert(item->thing(), item);
+   }
+   return;
+}
 
-   int i;
+void BtTreeModel::unindexSubtree(BtTreeItem * item) {
+   for (int ii = 0; ii < item->childCount(); ++ii) {
+      this->unindexSubtree(item->child(ii));
+   }
 
-   if (parent == nullptr) {
-      pItem = rootItem->child(0);
-   } else {
-      pItem = parent;
+   if (item->type() == BtTreeItem::FOLDER) {
+      if (item->folder()) {
+         QString const path = item->folder()->fullPath();
+         if (this->folderIndex.value(path) == item) {
+            this->folderIndex.remove(path);
+         }
+      }
+   } else if (item->thing()) {
+      this->elementIndex.remove(item->thing(), item);
+      if (! this->elementIndex.contains(item->thing())) {
+         disconnect(item->thing(), nullptr, this, nullptr);
+      }
    }
+   this->unfetched.remove(item);
+   this->unfetchedHasChildren.remove(item);
+   this->forgetSortKeys(item);
+   return;
+}
 
-   if (! thing) {
-      return createIndex(0, 0, pItem);
+BtTreeModel::SortKey BtTreeModel::sortKey(QModelIndex const & index) const {
+   BtTreeItem * item = this->item(index);
+   QPair<BtTreeItem const *, int> const cacheKey{item, index.column()};
+
+   auto cached = this->sortKeys.constFind(cacheKey);
+   if (cached != this->sortKeys.constEnd()) {
+      return *cached;
    }
 
-   folders.append(pItem);
+   SortKey key = this->makeSortKey(item, index.column());
+   this->sortKeys.insert(cacheKey, key);
+   return key;
+}
 
-   // Recursion. Wonderful.
-   while (! folders.isEmpty()) {
-      BtTreeItem * target = folders.takeFirst();
-      for (i = 0; i < target->childCount(); ++i) {
-         // If we've found what we are looking for, return
-         if (target->child(i)->thing() == thing) {
-            return createIndex(i, 0, target->child(i));
+void BtTreeModel::forgetSortKeys(BtTreeItem const * item) {
+   for (int column = 0; column < this->m_maxColumns; ++column) {
+      this->sortKeys.remove(qMakePair(item, column));
+   }
+   return;
+}
+
+BtTreeModel::SortKey BtTreeModel::makeSortKey(BtTreeItem * item, int column) const {
+   SortKey key;
+   key.type = item->type();
+
+   auto setNumber = [&key](double value) {
+      key.isNumber = true;
+      key.number = value;
+   };
+
+   if (key.type == BtTreeItem::FOLDER) {
+      // Folders only ever sort on their full path
+      if (item->folder()) {
+         key.name = item->folder()->fullPath();
+      }
+      key.text = key.name;
+      return key;
+   }
+
+   NamedEntity * thing = item->thing();
+   if (! thing) {
+      return key;
+   }
+   key.name = thing->name();
+   key.key = thing->key();
+   // Unless the column says otherwise, we sort on the name
+   key.text = key.name;
+
+   switch (key.type) {
+      case BtTreeItem::BREWNOTE:
+         // Brew notes are only ever sorted by date
+         setNumber(item->brewNote()->brewDate().toJulianDay());
+         break;
+      case BtTreeItem::RECIPE:
+         if (column == BtTreeItem::RECIPEBREWDATECOL) {
+            setNumber(item->recipe()->date().toJulianDay());
+         } else if (column == BtTreeItem::RECIPESTYLECOL) {
+            // No style sorts before any style
+            Style * style = item->recipe()->style();
+            key.text = style ? style->name() : QString();
+         }
+         break;
+      case BtTreeItem::EQUIPMENT:
+         if (column == BtTreeItem::EQUIPMENTBOILTIMECOL) {
+            setNumber(item->equipment()->boilTime_min());
+         }
+         break;
+      case BtTreeItem::FERMENTABLE:
+         if (column == BtTreeItem::FERMENTABLETYPECOL) {
+            setNumber(static_cast<int>(item->fermentable()->type()));
+         } else if (column == BtTreeItem::FERMENTABLECOLORCOL) {
+            setNumber(item->fermentable()->color_srm());
          }
+         break;
+      case BtTreeItem::HOP:
+         if (column == BtTreeItem::HOPFORMCOL) {
+            setNumber(static_cast<int>(item->hop()->form()));
+         } else if (column == BtTreeItem::HOPUSECOL) {
+            setNumber(static_cast<int>(item->hop()->use()));
+         }
+         break;
+      case BtTreeItem::MISC:
+         if (column == BtTreeItem::MISCTYPECOL) {
+            setNumber(static_cast<int>(item->misc()->type()));
+         } else if (column == BtTreeItem::MISCUSECOL) {
+            setNumber(static_cast<int>(item->misc()->use()));
+         }
+         break;
+      case BtTreeItem::YEAST:
+         if (column == BtTreeItem::YEASTTYPECOL) {
+            setNumber(static_cast<int>(item->yeast()->type()));
+         } else if (column == BtTreeItem::YEASTFORMCOL) {
+            setNumber(static_cast<int>(item->yeast()->form()));
+         }
+         break;
+      case BtTreeItem::STYLE:
+         switch (column) {
+            case BtTreeItem::STYLECATEGORYCOL:
+               key.text = item->style()->category();
+               break;
+            case BtTreeItem::STYLENUMBERCOL:
+               key.text = item->style()->categoryNumber();
+               break;
+            case BtTreeItem::STYLELETTERCOL:
+               key.text = item->style()->styleLetter();
+               break;
+            case BtTreeItem::STYLEGUIDECOL:
+               key.text = item->style()->styleGuide();
+               break;
+         }
+         break;
+      case BtTreeItem::WATER:
+         switch (column) {
+            case BtTreeItem::WATERpHCOL:
+               setNumber(item->water()->ph());
+               break;
+            case BtTreeItem::WATERHCO3COL:
+               setNumber(item->water()->bicarbonate_ppm());
+               break;
+            case BtTreeItem::WATERSO4COL:
+               setNumber(item->water()->sulfate_ppm());
+               break;
+            case BtTreeItem::WATERCLCOL:
+               setNumber(item->water()->chloride_ppm());
+               break;
+            case BtTreeItem::WATERNACOL:
+               setNumber(item->water()->sodium_ppm());
+               break;
+            case BtTreeItem::WATERMGCOL:
+               setNumber(item->water()->magnesium_ppm());
+               break;
+            case BtTreeItem::WATERCACOL:
+               setNumber(item->water()->calcium_ppm());
+               break;
+         }
+         break;
+   }
+   return key;
+}
 
-         // If we have a folder, or we are looking for a brewnote and have a
-         // recipe in hand, push the child onto the stack
-         if (target->child(i)->type() == BtTreeItem::FOLDER ||
-             (qobject_cast<BrewNote *>(thing) && target->child(i)->type() == BtTreeItem::RECIPE)) {
-            folders.append(target->child(i));
+// One find method for all things. This .. is nice
+QModelIndex BtTreeModel::findElement(NamedEntity * thing, BtTreeItem * parent) {
+   BtTreeItem * pItem = parent ? parent : this->rootItem->child(0);
+
+   if (! thing) {
+      return createIndex(0, 0, pItem);
+   }
+
+   //
+   // We used to do a breadth-first search from pItem, descending into folders (and into recipes if we were looking for
+   // a brew note).  Now we look the thing up in the index and just check that each item we get back is somewhere that
+   // search would have reached.  If there's more than one, the shallowest wins, as it would have with the search.
+   //
+   bool const lookingForBrewNote = qobject_cast<BrewNote *>(thing) != nullptr;
+   BtTreeItem * found = nullptr;
+   int foundDepth = 0;
+   for (BtTreeItem * candidate : this->elementIndex.values(thing)) {
+      int depth = 1;
+      BtTreeItem * ancestor = candidate->parent();
+      while (ancestor && ancestor != pItem) {
+         if (ancestor->type() != BtTreeItem::FOLDER &&
+             ! (lookingForBrewNote && ancestor->type() == BtTreeItem::RECIPE)) {
+            ancestor = nullptr;
+            break;
          }
+         ancestor = ancestor->parent();
+         ++depth;
+      }
+      if (ancestor && (! found || depth < foundDepth)) {
+         found = candidate;
+         foundDepth = depth;
       }
    }
-   return QModelIndex();
+
+   if (! found) {
+      return QModelIndex();
+   }
+   return createIndex(found->childNumber(), 0, found);
 }
 
 QList<NamedEntity *> BtTreeModel::elements() {
@@ -591,49 +860,49 @@ QList<NamedEntity *> BtTreeModel::elements() {
 }
 
 void BtTreeModel::loadTreeModel() {
-   int i;
-
-   QModelIndex ndxLocal;
-   BtTreeItem * local = nullptr;
+   Tracing::Span const span{"BtTreeModel::loadTreeModel"};
+   BtTreeItem * local = this->rootItem->child(0);
+   QList<NamedEntity *> topLevel;
    QList<NamedEntity *> elems = this->elements();
 
-   qDebug() << Q_FUNC_INFO << "Got " << elems.length() << "elements matching type mask" << this->treeMask;
+   qCDebug(lcUi) << Q_FUNC_INFO << "Got " << elems.length() << "elements matching type mask" << this->treeMask;
 
    for (NamedEntity * elem : elems) {
+      if (normalisedFolderPath(elem->folder()) == "/") {
+         topLevel.append(elem);
+         continue;
+      }
 
-      if (! elem->folder().isEmpty()) {
-         ndxLocal = findFolder(elem->folder(), rootItem->child(0), true);
+      // We only make the folder here.  Its contents get added by fetchMore() when it's expanded.
+      if (! findFolder(elem->folder(), local, true).isValid()) {
          // I cannot imagine this failing, but what the hell
-         if (! ndxLocal.isValid()) {
-            qWarning() << "Invalid return from findFolder in loadTreeModel()";
-            continue;
-         }
-         local = item(ndxLocal);
-         i = local->childCount();
-      } else {
-         local = rootItem->child(0);
-         i = local->childCount();
-         ndxLocal = createIndex(i, 0, local);
+         qWarning() << "Invalid return from findFolder in loadTreeModel()";
       }
+   }
 
-      if (!this->insertRow(i, ndxLocal, elem, _type)) {
-         qWarning() << "Insert failed in loadTreeModel()";
-         continue;
-      }
+   for (BtTreeItem * folderItem : this->folderIndex) {
+      this->unfetched.insert(folderItem);
+   }
 
-      // If we have brewnotes, set them up here.
-      if (treeMask & RECIPEMASK) {
-         Recipe * holdmebeer = qobject_cast<Recipe *>(elem);
-         if (PersistentSettings::value(PersistentSettings::Names::showsnapshots, false).toBool() && holdmebeer->hasAncestors()) {
-            setShowChild(ndxLocal, true);
-            addAncestoralTree(holdmebeer, i, local);
-            addBrewNoteSubTree(holdmebeer, i, local, false);
-         } else {
-            addBrewNoteSubTree(holdmebeer, i, local);
-         }
-      }
-      observeElement(elem);
+   this->insertElements(local, topLevel);
+   return;
+}
+
+void BtTreeModel::addRecipeSubTree(BtTreeItem * recipeItem) {
+   Recipe * rec = recipeItem->recipe();
+   if (! rec) {
+      return;
+   }
+
+   int i = recipeItem->childNumber();
+   if (PersistentSettings::value(PersistentSettings::Names::showsnapshots, false).toBool() && rec->hasAncestors()) {
+      setShowChild(createIndex(i, 0, recipeItem), true);
+      addAncestoralTree(rec, i, recipeItem->parent());
+      addBrewNoteSubTree(rec, i, recipeItem->parent(), false);
+   } else {
+      addBrewNoteSubTree(rec, i, recipeItem->parent());
    }
+   return;
 }
 
 void BtTreeModel::addAncestoralTree(Recipe * rec, int i, BtTreeItem * parent) {
@@ -654,7 +923,6 @@ void BtTreeModel::addAncestoralTree(Recipe * rec, int i, BtTreeItem * parent) {
 
       // finally, add this ancestors brewnotes but do not recurse
       addBrewNoteSubTree(stor, j, temp, false);
-      observeElement(stor);
       ++j;
    }
 }
@@ -663,6 +931,10 @@ void BtTreeModel::addBrewNoteSubTree(Recipe * rec, int i, BtTreeItem * parent, b
    QList<BrewNote *> notes = recurse ? RecipeHelper::brewNotesForRecipeAndAncestors(*rec) : rec->brewNotes();
    BtTreeItem * temp = parent->child(i);
 
+   // Whoever called us is (re)building this recipe's children, so there's nothing left for fetchMore() to do
+   this->unfetched.remove(temp);
+   this->unfetchedHasChildren.remove(temp);
+
    int j = 0;
 
    for (BrewNote * note : notes) {
@@ -672,7 +944,6 @@ void BtTreeModel::addBrewNoteSubTree(Recipe * rec, int i, BtTreeItem * parent, b
          qWarning() << "Brewnote insert failed in loadTreeModel()";
          continue;
       }
-      observeElement(note);
       ++j;
    }
 }
@@ -816,7 +1087,7 @@ void BtTreeModel::copySelected(QList< QPair<QModelIndex, QString>> toBeCopied) {
          break;
          case BtTreeItem::RECIPE: {
             auto copy = ObjectStoreWrapper::copy(*this->recipe(ndx)); // Create a deep copy.
-            qDebug() <<
+            qCDebug(lcUi) <<
                Q_FUNC_INFO << "display:" <<  copy->display() << "isLocked:" << copy->locked() <<
                "hasDescendants:" << copy->hasDescendants();
             copy->setName(name);
@@ -975,13 +1246,16 @@ void BtTreeModel::folderChanged(NamedEntity * test) {
    BtTreeItem * local = item(newNdx);
    int j = local->childCount();
 
-   if (!  insertRow(j, newNdx, test, _type)) {
-      qWarning() << Q_FUNC_INFO << "Could not insert row";
-      return;
-   }
-   // If we have brewnotes, set them up here.
-   if (treeMask & RECIPEMASK) {
-      addBrewNoteSubTree(qobject_cast<Recipe *>(test), j, local);
+   // If the new folder hasn't been expanded yet, we'll pick the thing up when it is
+   if (! this->unfetched.contains(local)) {
+      if (!  insertRow(j, newNdx, test, _type)) {
+         qWarning() << Q_FUNC_INFO << "Could not insert row";
+         return;
+      }
+      // If we have brewnotes, set them up here.
+      if (treeMask & RECIPEMASK) {
+         addBrewNoteSubTree(qobject_cast<Recipe *>(test), j, local);
+      }
    }
 
    if (expand) {
@@ -1013,6 +1287,24 @@ bool BtTreeModel::removeFolder(QModelIndex ndx) {
    return removeRows(i, 1, pInd);
 }
 
+void BtTreeModel::fetchFolderTree(BtTreeItem * folderItem) {
+   QList<BtTreeItem *> folders;
+   folders.append(folderItem);
+
+   while (! folders.isEmpty()) {
+      BtTreeItem * target = folders.takeFirst();
+      if (this->unfetched.contains(target)) {
+         this->fetchMore(createIndex(target->childNumber(), 0, target));
+      }
+      for (int i = 0; i < target->childCount(); ++i) {
+         if (target->child(i)->type() == BtTreeItem::FOLDER) {
+            folders.append(target->child(i));
+         }
+      }
+   }
+   return;
+}
+
 QModelIndexList BtTreeModel::allChildren(QModelIndex ndx) {
    QModelIndexList leafNodes;
    QList<BtTreeItem *> folders;
@@ -1024,6 +1316,8 @@ QModelIndexList BtTreeModel::allChildren(QModelIndex ndx) {
    }
 
    BtTreeItem * start = item(ndx);
+   // We can't return what isn't in the tree yet
+   this->fetchFolderTree(start);
    folders.append(start);
 
    while (! folders.isEmpty()) {
@@ -1061,6 +1355,7 @@ bool BtTreeModel::renameFolder(BtFolder * victim, QString newName) {
    }
 
    BtTreeItem * start = item(ndx);
+   this->fetchFolderTree(start);
    f.first  = targetPath;
    f.second = start;
 
@@ -1130,6 +1425,7 @@ QModelIndex BtTreeModel::createFolderTree(QStringList dirs, BtTreeItem * parent,
 
       pItem->insertChildren(i, 1, BtTreeItem::FOLDER);
       pItem->child(i)->setData(BtTreeItem::FOLDER, temp);
+      this->indexItem(pItem->child(i));
 
       // Set the parent item to point to the newly created tree
       pItem = pItem->child(i);
@@ -1172,6 +1468,35 @@ QModelIndex BtTreeModel::findFolder(QString name, BtTreeItem * parent, bool crea
       return QModelIndex();
    }
 
+   //
+   // Folder paths are absolute, so, if we're searching from the top of the tree, we can just look the path up in the
+   // index.  If it's not there, the nearest ancestor that is tells us where to start creating.
+   //
+   if (pItem == this->rootItem->child(0)) {
+      targetPath = "/" % dirs.join("/");
+      BtTreeItem * kid = this->folderIndex.value(targetPath, nullptr);
+      if (kid) {
+         return createIndex(kid->childNumber(), 0, kid);
+      }
+      if (! create) {
+         return QModelIndex();
+      }
+
+      QStringList missing;
+      while (! dirs.isEmpty()) {
+         missing.prepend(dirs.takeLast());
+         if (dirs.isEmpty()) {
+            break;
+         }
+         fullPath = "/" % dirs.join("/");
+         kid = this->folderIndex.value(fullPath, nullptr);
+         if (kid) {
+            return createFolderTree(missing, kid, fullPath);
+         }
+      }
+      return createFolderTree(missing, pItem, "/");
+   }
+
    current = dirs.takeFirst();
    fullPath = "/";
    targetPath = fullPath % current;
@@ -1234,6 +1559,10 @@ void BtTreeModel::elementChanged() {
       return;
    }
 
+   for (BtTreeItem * changedItem : this->elementIndex.values(d)) {
+      this->forgetSortKeys(changedItem);
+   }
+
    QModelIndex ndxLeft = findElement(d);
    if (! ndxLeft.isValid()) {
       return;
@@ -1298,6 +1627,12 @@ void BtTreeModel::elementAdded(NamedEntity * victim) {
       return;
    }
 
+   // If the recipe hasn't been expanded yet, the brew note will get added when it is
+   if (this->unfetched.contains(item(pIdx))) {
+      this->unfetchedHasChildren.remove(item(pIdx));
+      return;
+   }
+
    int breadth = rowCount(pIdx);
 
    if (! insertRow(breadth, pIdx, victim, lType)) {
@@ -1318,7 +1653,7 @@ void BtTreeModel::elementAdded(NamedEntity * victim) {
          }
       }
    }
-   observeElement(victim);
+   return;
 }
 
 void BtTreeModel::elementRemovedRecipe(int victimId, std::shared_ptr<QObject> victim) {
@@ -1378,7 +1713,7 @@ void BtTreeModel::recipePropertyChanged(int recipeId, BtStringConst const & prop
    // .:TBD:. We could probably get away with propertyName == PropertyNames::Recipe::ancestorId here because
    // we always use the same constants for property names.
    if (propertyName != PropertyNames::Recipe::ancestorId) {
-      qDebug() << Q_FUNC_INFO << "Ignoring change to" << propertyName << "on Recipe" << recipeId;
+      qCDebug(lcUi) << Q_FUNC_INFO << "Ignoring change to" << propertyName << "on Recipe" << recipeId;
       return;
    }
 
@@ -1391,7 +1726,7 @@ void BtTreeModel::recipePropertyChanged(int recipeId, BtStringConst const & prop
    int ancestorId = descendant->getAncestorId();
 
    if (ancestorId <= 0 || ancestorId == descendant->key()) {
-      qDebug() << Q_FUNC_INFO << "No ancestor (" << ancestorId << ") on Recipe" << recipeId;
+      qCDebug(lcUi) << Q_FUNC_INFO << "No ancestor (" << ancestorId << ") on Recipe" << recipeId;
       return;
    }
 
@@ -1412,6 +1747,9 @@ void BtTreeModel::observeElement(NamedEntity * d) {
       return;
    }
 
+   // Any change might affect how the thing sorts
+   connect(d, &NamedEntity::changed, this, &BtTreeModel::elementChanged);
+
    if (qobject_cast<BrewNote *>(d)) {
       connect(d, SIGNAL(brewDateChanged(QDateTime)), this, SLOT(elementChanged()));
    } else {
@@ -1638,12 +1976,12 @@ void BtTreeModel::spawnRecipe(QModelIndex ndx) {
    Q_ASSERT(ndx.isValid());
    Recipe * ancestor = this->recipe(ndx);
    Q_ASSERT(ancestor);
-   std::shared_ptr<Recipe> descendant = std::make_shared<Recipe>(*ancestor);
+   std::shared_ptr<Recipe> descendant = std::make_shared<Recipe>(*ancestor, Recipe::CopyMode::SharedVersion);
    // We want to store the new Recipe first so that it gets an ID...
    ObjectStoreWrapper::insert<Recipe>(descendant);
    // ...then we can connect it to the one it was copied from
    descendant->setAncestor(*ancestor);
-   qDebug() <<
+   qCDebug(lcUi) <<
       Q_FUNC_INFO << "Created descendant Recipe" << descendant->key() << "of Recipe" << ancestor->key() <<
       "(at position" << ndx.row() << ")";
 
@@ -1654,7 +1992,7 @@ void BtTreeModel::spawnRecipe(QModelIndex ndx) {
    // BtTreeModel::elementAddedRecipe(), so we can't assume that ndx is still valid, hence the reassignement here.
    //
    ndx = this->findElement(ancestor);
-   if (!removeRows(ndx.row(), 1, this->parent(ndx))) {
+   if (! ndx.isValid() || ! removeRows(ndx.row(), 1, this->parent(ndx))) {
       qCritical() << Q_FUNC_INFO << "Could not find Recipe" << ancestor->key() << "in display tree";
    }
 
@@ -1670,11 +2008,11 @@ void BtTreeModel::spawnRecipe(QModelIndex ndx) {
 }
 
 void BtTreeModel::versionedRecipe(Recipe * ancestor, Recipe * descendant) {
-   qDebug() << Q_FUNC_INFO << "Updating tree now that Recipe" << descendant->key() << "has ancestor Recipe" << ancestor->key();
+   qCDebug(lcUi) << Q_FUNC_INFO << "Updating tree now that Recipe" << descendant->key() << "has ancestor Recipe" << ancestor->key();
 
    // like before, remove the ancestor
    QModelIndex ndx = findElement(ancestor);
-   if (!removeRows(ndx.row(), 1, this->parent(ndx))) {
+   if (! ndx.isValid() || ! removeRows(ndx.row(), 1, this->parent(ndx))) {
       qCritical() << Q_FUNC_INFO << "Could not find Recipe" << ancestor->key() << "in display tree";
    }
 
@@ -1794,6 +2132,11 @@ void BtTreeModel::catchAncestors(bool showem) {
       local = rootItem->child(0);
       ndxLocal = findElement(elem, local);
 
+      // Recipes that haven't been expanded will pick up the setting when they are
+      if (! ndxLocal.isValid() || this->unfetched.contains(item(ndxLocal))) {
+         continue;
+      }
+
       if (rec->hasAncestors()) {
          showem ? showAncestors(ndxLocal) : hideAncestors(ndxLocal);
       }
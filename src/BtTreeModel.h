@@ -23,11 +23,15 @@
 #include <memory>
 
 #include <QAbstractItemModel>
+#include <QHash>
 #include <QList>
 #include <QMetaProperty>
 #include <QModelIndex>
 #include <QObject>
+#include <QPair>
+#include <QSet>
 #include <QSqlRelationalTableModel>
+#include <QString>
 #include <QVariant>
 
 // Forward declarations
@@ -55,6 +59,10 @@ class Yeast;
  * Provides the necessary model so we can build the trees. It extends the
  * QAbstractItemModel, so it has to implement some of the virtual methods
  * required.
+ *
+ * The tree is populated lazily: at start-up we only create the folders and the things at the top of the tree.  What's
+ * inside a folder, and a recipe's brew notes and previous versions, are only added (and only get their signals
+ * connected) when the view asks for them via \c canFetchMore() / \c fetchMore(), ie when the node is expanded.
  */
 class BtTreeModel : public QAbstractItemModel {
    Q_OBJECT
@@ -84,6 +92,26 @@ public:
       WATERMASK         = 512,
    };
 
+   /**
+    * \brief What \c BtTreeFilterProxyModel sorts a cell on.  These are worked out once per item and column, and then
+    *        cached until the thing changes, so that sorting does not have to go back to the underlying objects (and,
+    *        eg, look up a recipe's style) on every comparison.
+    */
+   struct SortKey {
+      //! \brief The \c BtTreeItem::ITEMTYPE of the item
+      int type = 0;
+      //! \brief Name of the thing, or full path of a folder
+      QString name;
+      //! \brief Database key of the thing, used for ordering recipe versions
+      int key = 0;
+      //! \brief Whether the column's value is in \c number or \c text
+      bool isNumber = false;
+      //! \brief Value of the column if it is numeric.  Enums are stored as their integer value and dates as Julian days.
+      double number = 0.0;
+      //! \brief Value of the column if it is not numeric
+      QString text;
+   };
+
    BtTreeModel(BtTreeView * parent = nullptr, TypeMasks type = RECIPEMASK);
    virtual ~BtTreeModel();
 
@@ -97,6 +125,12 @@ public:
    virtual int rowCount(const QModelIndex & parent = QModelIndex()) const;
    //! \brief Reimplemented from QAbstractItemModel
    virtual int columnCount(const QModelIndex & index = QModelIndex()) const;
+   //! \brief Reimplemented from QAbstractItemModel so that nodes we haven't populated yet can still be expanded
+   virtual bool hasChildren(const QModelIndex & parent = QModelIndex()) const;
+   //! \brief Reimplemented from QAbstractItemModel
+   virtual bool canFetchMore(const QModelIndex & parent) const;
+   //! \brief Reimplemented from QAbstractItemModel.  Populates a folder or recipe the first time it is expanded.
+   virtual void fetchMore(const QModelIndex & parent);
 
    //! \brief Reimplemented from QAbstractItemModel
    virtual QModelIndex index(int row, int col, const QModelIndex & parent = QModelIndex()) const;
@@ -169,6 +203,9 @@ public:
    //! \brief Get NamedEntity at \c index.
    NamedEntity * thing(const QModelIndex & index) const;
 
+   //! \brief Get the (cached) sort key for the cell at \c index
+   SortKey sortKey(const QModelIndex & index) const;
+
    //! \brief one find method to find them all, and in darkness bind them
    QModelIndex findElement(NamedEntity * thing, BtTreeItem * parent = nullptr);
 
@@ -294,8 +331,37 @@ private:
    void makeAncestors(NamedEntity * ancestor, NamedEntity * descendant);
    */
    void addAncestoralTree(Recipe * rec, int i, BtTreeItem * parent);
+   //! \brief appends \c elems (which must all be of this tree's type) to \c parent in one go
+   void insertElements(BtTreeItem * parent, QList<NamedEntity *> const & elems);
+   //! \brief adds the brew notes and, if we are showing snapshots, the previous versions under \c recipeItem
+   void addRecipeSubTree(BtTreeItem * recipeItem);
+   //! \brief makes sure everything in \c folderItem and its sub-folders is in the tree
+   void fetchFolderTree(BtTreeItem * folderItem);
+
+   //! \brief adds \c item to \c elementIndex or \c folderIndex as appropriate
+   void indexItem(BtTreeItem * item);
+   //! \brief removes \c item and everything under it from \c elementIndex and \c folderIndex
+   void unindexSubtree(BtTreeItem * item);
+   //! \brief works out the sort key for \c column of \c item
+   SortKey makeSortKey(BtTreeItem * item, int column) const;
+   //! \brief drops any cached sort keys for \c item
+   void forgetSortKeys(BtTreeItem const * item);
 
    BtTreeItem * rootItem;
+   /**
+    * \brief Every item in the tree that holds a \c NamedEntity, keyed by that entity, so that \c findElement() does not
+    *        have to walk the tree.  It's a multi-hash because the same thing can legitimately show up more than once
+    *        (eg a brew note under both a recipe and one of its descendants).
+    */
+   QMultiHash<NamedEntity const *, BtTreeItem *> elementIndex;
+   //! \brief Every folder item in the tree, keyed by its full path (eg "/a/b"), for \c findFolder()
+   QHash<QString, BtTreeItem *> folderIndex;
+   //! \brief Folders and recipes whose contents have not been added to the tree yet.  \sa fetchMore()
+   QSet<BtTreeItem const *> unfetched;
+   //! \brief Cached answers from \c hasChildren() for the recipes in \c unfetched, as working them out is not free
+   mutable QHash<BtTreeItem const *, bool> unfetchedHasChildren;
+   //! \brief Cache for \c sortKey(), keyed by item and column
+   mutable QHash<QPair<BtTreeItem const *, int>, SortKey> sortKeys;
    BtTreeView * parentTree;
    TypeMasks treeMask;
    int _type, m_maxColumns;
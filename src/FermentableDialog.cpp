@@ -229,6 +229,9 @@ void FermentableDialog::newFermentable() {
 
 void FermentableDialog::filterFermentables(QString searchExpression)
 {
-    fermTableProxy->setFilterCaseSensitivity(Qt::CaseInsensitive);
-    fermTableProxy->setFilterFixedString(searchExpression);
+    // The filter can only see rows the model has already handed out, so make sure that's all of them
+    if (!searchExpression.isEmpty()) {
+       fermTableModel->fetchAll();
+    }
+    fermTableProxy->setSearchText(searchExpression);
 }
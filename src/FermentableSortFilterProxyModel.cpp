@@ -99,12 +99,15 @@ QString FermentableSortFilterProxyModel::getName( const QModelIndex &index ) con
 
 bool FermentableSortFilterProxyModel::filterAcceptsRow( int source_row, const QModelIndex &source_parent) const
 {
+   Q_UNUSED(source_parent)
    FermentableTableModel* model = qobject_cast<FermentableTableModel*>(sourceModel());
-   QModelIndex index = sourceModel()->index(source_row, 0, source_parent);
+   Fermentable * fermentable = model->getFermentable(source_row);
 
-   return !filter
-          ||
-          (  sourceModel()->data(index).toString().contains(filterRegExp())
-             && model->getFermentable(source_row)->display()
-          );
+   return !filter || (fermentable->display() && this->search.matches(*fermentable));
+}
+
+void FermentableSortFilterProxyModel::setSearchText(QString const & searchText) {
+   this->search.setText(searchText);
+   this->invalidateFilter();
+   return;
 }
@@ -42,6 +42,7 @@
 
 #include "brewtarget.h"
 #include "database/ObjectStoreWrapper.h"
+#include "Logging.h"
 #include "MainWindow.h"
 #include "model/Fermentable.h"
 #include "model/Inventory.h"
@@ -53,14 +54,13 @@
 //=====================CLASS FermentableTableModel==============================
 FermentableTableModel::FermentableTableModel(QTableView* parent, bool editable) :
    QAbstractTableModel(parent),
+   BtTableModelBase<FermentableTableModel, Fermentable>(FERMNUMCOLS),
    parentTableWidget(parent),
    editable(editable),
    _inventoryEditable(false),
-   recObs(nullptr),
    displayPercentages(false),
    totalFermMass_kg(0) {
 
-   fermObs.clear();
    // for units and scales
    setObjectName("fermentableTable");
 
@@ -72,147 +72,14 @@ FermentableTableModel::FermentableTableModel(QTableView* parent, bool editable)
    parentTableWidget->setWordWrap(false);
    connect(headerView, &QWidget::customContextMenuRequested, this, &FermentableTableModel::contextMenu);
    connect(&ObjectStoreTyped<InventoryFermentable>::getInstance(), &ObjectStoreTyped<InventoryFermentable>::signalPropertyChanged, this, &FermentableTableModel::changedInventory);
+   // Rows are added and removed in BtTableModelBase, so this is the easiest way to keep the total up-to-date
+   connect(this, &QAbstractItemModel::rowsInserted, this, &FermentableTableModel::updateTotalGrains);
+   connect(this, &QAbstractItemModel::rowsRemoved,  this, &FermentableTableModel::updateTotalGrains);
    return;
 }
 
-void FermentableTableModel::observeRecipe(Recipe* rec) {
-   if (this->recObs) {
-      qDebug() << Q_FUNC_INFO << "Unobserve Recipe #" << this->recObs->key() << "(" << this->recObs->name() << ")";
-      disconnect(this->recObs, nullptr, this, nullptr);
-      this->removeAll();
-   }
-
-   this->recObs = rec;
-   if (this->recObs) {
-      qDebug() << Q_FUNC_INFO << "Observe Recipe #" << this->recObs->key() << "(" << this->recObs->name() << ")";
-
-      connect(this->recObs, &NamedEntity::changed, this, &FermentableTableModel::changed);
-      this->addFermentables( recObs->fermentables() );
-   }
-   return;
-}
-
-void FermentableTableModel::observeDatabase(bool val) {
-   if ( val ) {
-      // Observing a database and a recipe are mutually exclusive.
-      this->observeRecipe(nullptr);
-
-      this->removeAll();
-      connect(&ObjectStoreTyped<Fermentable>::getInstance(), &ObjectStoreTyped<Fermentable>::signalObjectInserted, this, &FermentableTableModel::addFermentable);
-      connect(&ObjectStoreTyped<Fermentable>::getInstance(), &ObjectStoreTyped<Fermentable>::signalObjectDeleted,  this, &FermentableTableModel::removeFermentable);
-      addFermentables( ObjectStoreTyped<Fermentable>::getInstance().getAllRaw() );
-   } else {
-      disconnect(&ObjectStoreTyped<Fermentable>::getInstance(), nullptr, this, nullptr);
-      this->removeAll();
-   }
-}
-
-void FermentableTableModel::addFermentable(int fermId) {
-   Fermentable * ferm = ObjectStoreWrapper::getByIdRaw<Fermentable>(fermId);
-   qDebug() << Q_FUNC_INFO << ferm->name();
-
-   // Check to see if it's already in the list
-   if (this->fermObs.contains(ferm)) {
-      return;
-   }
-
-   // If we are observing the database, ensure that the ferm is undeleted and
-   // fit to display.
-   if (this->recObs == nullptr && (ferm->deleted() || !ferm->display())) {
-      return;
-   }
-
-   // If we are watching a Recipe and the new Fermentable does not belong to it then there is nothing for us to do
-   if (this->recObs) {
-      Recipe * recipeOfNewFermentable = ferm->getOwningRecipe();
-      if (recipeOfNewFermentable && this->recObs->key() != recipeOfNewFermentable->key()) {
-         qDebug() <<
-            Q_FUNC_INFO << "Ignoring signal about new Ferementable #" << ferm->key() << "as it belongs to Recipe #" <<
-            recipeOfNewFermentable->key() << "and we are watching Recipe #" << this->recObs->key();
-         return;
-      }
-   }
-
-   int size = fermObs.size();
-   beginInsertRows( QModelIndex(), size, size );
-   fermObs.append(ferm);
-   connect( ferm, &NamedEntity::changed, this, &FermentableTableModel::changed );
-   totalFermMass_kg += ferm->amount_kg();
-   //reset(); // Tell everybody that the table has changed.
-   endInsertRows();
-   return;
-}
-
-void FermentableTableModel::addFermentables(QList<Fermentable*> ferms) {
-   qDebug() << Q_FUNC_INFO << QString("Add up to %1 fermentables to existing list of %2").arg(ferms.size()).arg(this->fermObs.size());
-
-   QList<Fermentable*> tmp;
-
-   for (auto ii : ferms) {
-//      qDebug() <<
-//         Q_FUNC_INFO << "Fermentable #" << ii->key() << (ii->deleted() ? "" : "not") << "deleted, display=" << (ii->display() ? "on" : "off");
-      if ( recObs == nullptr  && ( ii->deleted() || !ii->display() ) ) {
-
-            continue;
-      }
-      if( !fermObs.contains(ii) ) {
-         tmp.append(ii);
-      }
-   }
-
-   qDebug() << Q_FUNC_INFO << QString("After de-duping, adding %1 fermentables").arg(tmp.size());
-
-   int size = fermObs.size();
-   if (size+tmp.size()) {
-      beginInsertRows( QModelIndex(), size, size+tmp.size()-1 );
-      fermObs.append(tmp);
-
-      for(QList<Fermentable*>::iterator i = tmp.begin(); i != tmp.end(); i++ )
-      {
-         connect( *i, &NamedEntity::changed, this, &FermentableTableModel::changed );
-         totalFermMass_kg += (*i)->amount_kg();
-      }
-
-      endInsertRows();
-   }
-}
-
-void FermentableTableModel::removeFermentable(int fermId, std::shared_ptr<QObject> object) {
-   this->remove(std::static_pointer_cast<Fermentable>(object).get());
-   return;
-}
-
-bool FermentableTableModel::remove(Fermentable * ferm) {
-   int i = fermObs.indexOf(ferm);
-   if( i >= 0 )
-   {
-      beginRemoveRows( QModelIndex(), i, i );
-      disconnect(ferm, nullptr, this, nullptr);
-      fermObs.removeAt(i);
-
-      totalFermMass_kg -= ferm->amount_kg();
-      //reset(); // Tell everybody the table has changed.
-      endRemoveRows();
-
-      return true;
-   }
-
-   return false;
-}
-
-void FermentableTableModel::removeAll()
-{
-   if (fermObs.size())
-   {
-      beginRemoveRows( QModelIndex(), 0, fermObs.size()-1 );
-      while( !fermObs.isEmpty() )
-      {
-         disconnect( fermObs.takeLast(), nullptr, this, nullptr );
-      }
-      endRemoveRows();
-   }
-   // I think we need to zero this out
-   totalFermMass_kg = 0;
+QList<Fermentable *> FermentableTableModel::recipeItems(Recipe const & recipe) const {
+   return recipe.fermentables();
 }
 
 void FermentableTableModel::updateTotalGrains()
@@ -221,9 +88,9 @@ void FermentableTableModel::updateTotalGrains()
 
    totalFermMass_kg = 0;
 
-   size = fermObs.size();
+   size = this->rows.size();
    for( i = 0; i < size; ++i )
-      totalFermMass_kg += fermObs[i]->amount_kg();
+      totalFermMass_kg += this->rows[i]->amount_kg();
 }
 
 void FermentableTableModel::setDisplayPercentages(bool var)
@@ -234,9 +101,10 @@ void FermentableTableModel::setDisplayPercentages(bool var)
 void FermentableTableModel::changedInventory(int invKey, BtStringConst const & propertyName) {
 
    if (propertyName == PropertyNames::Inventory::amount) {
-      for( int i = 0; i < fermObs.size(); ++i ) {
-         Fermentable* holdmybeer = fermObs.at(i);
+      for( int i = 0; i < this->rows.size(); ++i ) {
+         Fermentable* holdmybeer = this->rows.at(i);
          if ( invKey == holdmybeer->inventoryId() ) {
+            this->formattedValueCache.invalidateCell(holdmybeer, FERMINVENTORYCOL);
             emit dataChanged( QAbstractItemModel::createIndex(i,FERMINVENTORYCOL),
                               QAbstractItemModel::createIndex(i,FERMINVENTORYCOL) );
          }
@@ -247,21 +115,14 @@ void FermentableTableModel::changedInventory(int invKey, BtStringConst const & p
 
 void FermentableTableModel::changed(QMetaProperty prop, QVariant /*val*/)
 {
-   qDebug() << QString("FermentableTableModel::changed() %1").arg(prop.name());
-
-   int i;
+   qCDebug(lcUi) << QString("FermentableTableModel::changed() %1").arg(prop.name());
 
    // Is sender one of our fermentables?
    Fermentable* fermSender = qobject_cast<Fermentable*>(sender());
    if( fermSender )
    {
-      i = fermObs.indexOf(fermSender);
-      if( i < 0 )
-         return;
-
+      this->rowChanged(fermSender);
       updateTotalGrains();
-      emit dataChanged( QAbstractItemModel::createIndex(i, 0),
-                        QAbstractItemModel::createIndex(i, FERMNUMCOLS-1));
       if( displayPercentages && rowCount() > 0 )
          emit headerDataChanged( Qt::Vertical, 0, rowCount()-1 );
       return;
@@ -269,17 +130,28 @@ void FermentableTableModel::changed(QMetaProperty prop, QVariant /*val*/)
 
    // See if our recipe gained or lost fermentables.
    Recipe* recSender = qobject_cast<Recipe*>(sender());
-   if( recSender && recSender == recObs && prop.name() == PropertyNames::Recipe::fermentableIds )
+   if( recSender && recSender == this->recObs && prop.name() == PropertyNames::Recipe::fermentableIds )
    {
-      removeAll();
-      addFermentables( recObs->fermentables() );
+      this->removeAll();
+      this->add( this->recObs->fermentables() );
       return;
    }
 }
 
 int FermentableTableModel::rowCount(const QModelIndex& /*parent*/) const
 {
-   return fermObs.size();
+   return this->rowCountImpl();
+}
+
+bool FermentableTableModel::canFetchMore(const QModelIndex& parent) const
+{
+   return this->canFetchMoreImpl(parent);
+}
+
+void FermentableTableModel::fetchMore(const QModelIndex& parent)
+{
+   this->fetchMoreImpl(parent);
+   return;
 }
 
 int FermentableTableModel::columnCount(const QModelIndex& /*parent*/) const
@@ -288,16 +160,13 @@ int FermentableTableModel::columnCount(const QModelIndex& /*parent*/) const
 }
 
 QVariant FermentableTableModel::data( const QModelIndex& index, int role ) const {
-   Unit::unitScale scale;
-   Unit::unitDisplay unit;
-
    // Ensure the row is OK
-   if (index.row() >= static_cast<int>(fermObs.size() )) {
+   if (index.row() >= static_cast<int>(this->rows.size() )) {
       qCritical() << Q_FUNC_INFO << tr("Bad model index. row = %1").arg(index.row());
       return QVariant();
    }
 
-   Fermentable* row = this->fermObs[index.row()];
+   Fermentable* row = this->rows[index.row()];
    if (row == nullptr) {
       // This is probably a coding error
       qCritical() << Q_FUNC_INFO << "Null pointer at row" << index.row();
@@ -324,19 +193,17 @@ QVariant FermentableTableModel::data( const QModelIndex& index, int role ) const
             return QVariant();
 
          // So just query the columns
-         unit  = displayUnit(col);
-         scale = displayScale(col);
-
-         return QVariant( Brewtarget::displayAmount(row->inventory(), &Units::kilograms, 3, unit, scale) );
+         return QVariant(this->formattedValueCache.get(row, col, [this, row, col]() {
+            return Brewtarget::displayAmount(row->inventory(), &Units::kilograms, 3, displayUnit(col), displayScale(col));
+         }));
       case FERMAMOUNTCOL:
          if( role != Qt::DisplayRole )
             return QVariant();
 
          // So just query the columns
-         unit  = displayUnit(col);
-         scale = displayScale(col);
-
-         return QVariant( Brewtarget::displayAmount(row->amount_kg(), &Units::kilograms, 3, unit, scale) );
+         return QVariant(this->formattedValueCache.get(row, col, [this, row, col]() {
+            return Brewtarget::displayAmount(row->amount_kg(), &Units::kilograms, 3, displayUnit(col), displayScale(col));
+         }));
       case FERMISMASHEDCOL:
          if( role == Qt::DisplayRole )
             return QVariant(row->additionMethodStringTr());
@@ -353,16 +220,18 @@ QVariant FermentableTableModel::data( const QModelIndex& index, int role ) const
             return QVariant();
       case FERMYIELDCOL:
          if( role == Qt::DisplayRole )
-            return QVariant( Brewtarget::displayAmount(row->yield_pct(), nullptr) );
+            return QVariant(this->formattedValueCache.get(row, col, [row]() {
+               return Brewtarget::displayAmount(row->yield_pct(), nullptr);
+            }));
          else
             return QVariant();
       case FERMCOLORCOL:
          if( role != Qt::DisplayRole )
             return QVariant();
 
-         unit  = displayUnit(col);
-
-         return QVariant( Brewtarget::displayAmount(row->color_srm(), &Units::srm, 0, unit) );
+         return QVariant(this->formattedValueCache.get(row, col, [this, row, col]() {
+            return Brewtarget::displayAmount(row->color_srm(), &Units::srm, 0, displayUnit(col));
+         }));
       default :
          qCritical() << tr("Bad column: %1").arg(col);
          return QVariant();
@@ -401,7 +270,7 @@ QVariant FermentableTableModel::headerData( int section, Qt::Orientation orienta
    {
       double perMass = 0.0;
       if ( totalFermMass_kg > 0.0 )
-         perMass = fermObs[section]->amount_kg()/totalFermMass_kg;
+         perMass = this->rows[section]->amount_kg()/totalFermMass_kg;
       return QVariant( QString("%1%").arg( static_cast<double>(100.0) * perMass, 0, 'f', 0 ) );
    }
 
@@ -412,7 +281,7 @@ Qt::ItemFlags FermentableTableModel::flags(const QModelIndex& index ) const
 {
    Qt::ItemFlags defaults = Qt::ItemIsEnabled;
    int col = index.column();
-   Fermentable* row = fermObs[index.row()];
+   Fermentable* row = this->rows[index.row()];
 
    switch(col)
    {
@@ -444,10 +313,10 @@ Unit::unitDisplay FermentableTableModel::displayUnit(const QModelIndex& index)
 {
    Fermentable* row;
 
-   if ( index.row() >= fermObs.size() )
+   if ( index.row() >= this->rows.size() )
       return Unit::noUnit;
 
-   row = fermObs[index.row()];
+   row = this->rows[index.row()];
 
    return row->displayUnit();
 }
@@ -456,10 +325,10 @@ void FermentableTableModel::setDisplayUnit(const QModelIndex& index, Unit::unitD
 {
    Fermentable* row;
 
-   if ( index.row() >= fermObs.size() )
+   if ( index.row() >= this->rows.size() )
       return;
 
-   row = fermObs[index.row()];
+   row = this->rows[index.row()];
    row->setDisplayUnit(displayUnit);
 }
 
@@ -467,10 +336,10 @@ Unit::unitScale FermentableTableModel::displayScale(const QModelIndex& index)
 {
    Fermentable* row;
 
-   if ( index.row() >= fermObs.size() )
+   if ( index.row() >= this->rows.size() )
       return Unit::noScale;
 
-   row = fermObs[index.row()];
+   row = this->rows[index.row()];
 
    return row->displayScale();
 }
@@ -479,10 +348,10 @@ void FermentableTableModel::setDisplayScale(const QModelIndex& index, Unit::unit
 {
    Fermentable* row;
 
-   if ( index.row() >= fermObs.size() )
+   if ( index.row() >= this->rows.size() )
       return;
 
-   row = fermObs[index.row()];
+   row = this->rows[index.row()];
    row->setDisplayScale(displayScale);
 }
 */
@@ -522,6 +391,11 @@ void FermentableTableModel::setDisplayUnit(int column, Unit::unitDisplay display
    PersistentSettings::insert(attribute, displayUnit, this->objectName(), PersistentSettings::UNIT);
    PersistentSettings::insert(attribute, Unit::noScale, this->objectName(), PersistentSettings::SCALE);
 
+   this->formattedValueCache.invalidateColumn(column);
+   if (this->rowCount() > 0) {
+      emit dataChanged(this->index(0, column), this->index(this->rowCount() - 1, column));
+   }
+
    /* Disabled cell-specific code
    for (int i = 0; i < rowCount(); ++i )
    {
@@ -543,6 +417,11 @@ void FermentableTableModel::setDisplayScale(int column, Unit::unitScale displayS
 
    PersistentSettings::insert(attribute, displayScale, this->objectName(), PersistentSettings::SCALE);
 
+   this->formattedValueCache.invalidateColumn(column);
+   if (this->rowCount() > 0) {
+      emit dataChanged(this->index(0, column), this->index(this->rowCount() - 1, column));
+   }
+
    /* disabled cell-specific code
    for (int i = 0; i < rowCount(); ++i )
    {
@@ -621,12 +500,12 @@ bool FermentableTableModel::setData( const QModelIndex& index, const QVariant& v
    Fermentable* row;
    bool retVal = false;
 
-   if( index.row() >= static_cast<int>(fermObs.size() ))
+   if( index.row() >= static_cast<int>(this->rows.size() ))
    {
       return false;
    }
    else
-      row = fermObs[index.row()];
+      row = this->rows[index.row()];
 
    Unit::unitDisplay dspUnit = displayUnit(index.column());
    Unit::unitScale   dspScl  = displayScale(index.column());
@@ -721,7 +600,7 @@ bool FermentableTableModel::setData( const QModelIndex& index, const QVariant& v
 
 Fermentable* FermentableTableModel::getFermentable(unsigned int i)
 {
-   return fermObs.at(static_cast<int>(i));
+   return this->rows.at(static_cast<int>(i));
 }
 
 //======================CLASS FermentableItemDelegate===========================
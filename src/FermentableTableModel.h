@@ -36,11 +36,12 @@
 #include <QWidget>
 
 #include "brewtarget.h"
+#include "BtTableModelBase.h"
+#include "model/Fermentable.h"
 #include "Unit.h"
 
 // Forward declarations.
 class BtStringConst;
-class Fermentable;
 class Recipe;
 class FermentableItemDelegate;
 
@@ -52,21 +53,15 @@ enum{FERMNAMECOL, FERMTYPECOL, FERMAMOUNTCOL, FERMINVENTORYCOL, FERMISMASHEDCOL,
  *
  * \brief A table model for a list of fermentables.
  */
-class FermentableTableModel : public QAbstractTableModel
+class FermentableTableModel : public QAbstractTableModel, public BtTableModelBase<FermentableTableModel, Fermentable>
 {
    Q_OBJECT
 
+   friend class BtTableModelBase<FermentableTableModel, Fermentable>;
+
 public:
    FermentableTableModel(QTableView* parent=nullptr, bool editable=true);
    virtual ~FermentableTableModel() {}
-   //! \brief Observe a recipe's list of fermentables.
-   void observeRecipe(Recipe* rec);
-   //! \brief If true, we model the database's list of fermentables.
-   void observeDatabase(bool val);
-   //! \brief Watch all the \b ferms for changes.
-   void addFermentables(QList<Fermentable*> ferms);
-   //! \brief Clear the model.
-   void removeAll();
    //! \brief Return the \c i-th fermentable in the model.
    Fermentable* getFermentable(unsigned int i);
    //! \brief True if you want to display percent of each grain in the row header.
@@ -88,6 +83,10 @@ public:
    //! \brief Reimplemented from QAbstractTableModel.
    virtual int columnCount(const QModelIndex& parent = QModelIndex()) const;
    //! \brief Reimplemented from QAbstractTableModel.
+   virtual bool canFetchMore(const QModelIndex& parent) const;
+   //! \brief Reimplemented from QAbstractTableModel.
+   virtual void fetchMore(const QModelIndex& parent);
+   //! \brief Reimplemented from QAbstractTableModel.
    virtual QVariant data( const QModelIndex& index, int role = Qt::DisplayRole ) const;
    //! \brief Reimplemented from QAbstractTableModel.
    virtual QVariant headerData( int section, Qt::Orientation orientation, int role = Qt::DisplayRole ) const;
@@ -98,14 +97,7 @@ public:
 
    QTableView* parentTableWidget;
 
-   //! \returns true if "ferm" is successfully found and removed.
-   bool remove(Fermentable * ferm);
-
 public slots:
-   //! \brief Watch \b ferm for changes.
-   void addFermentable(int fermId);
-
-   void removeFermentable(int fermId, std::shared_ptr<QObject> object);
    //! \brief pops the context menu for changing units and scales
    void contextMenu(const QPoint &point);
 
@@ -116,14 +108,14 @@ private slots:
    void changedInventory(int invKey, BtStringConst const & propertyName);
 
 private:
+   //! \brief Used by \c BtTableModelBase::observeRecipe()
+   QList<Fermentable *> recipeItems(Recipe const & recipe) const;
    //! \brief Recalculate the total amount of grains in the model.
    void updateTotalGrains();
    QString generateName(int column) const;
 
    bool editable;
    bool _inventoryEditable;
-   QList<Fermentable*> fermObs;
-   Recipe* recObs;
    bool displayPercentages;
    double totalFermMass_kg;
 
@@ -229,6 +229,9 @@ void HopDialog::newHop(QString folder)
 
 void HopDialog::filterHops(QString searchExpression)
 {
-    hopTableProxy->setFilterCaseSensitivity(Qt::CaseInsensitive);
-    hopTableProxy->setFilterFixedString(searchExpression);
+    // The filter can only see rows the model has already handed out, so make sure that's all of them
+    if (!searchExpression.isEmpty()) {
+       hopTableModel->fetchAll();
+    }
+    hopTableProxy->setSearchText(searchExpression);
 }
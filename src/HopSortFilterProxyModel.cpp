@@ -85,12 +85,15 @@ bool HopSortFilterProxyModel::lessThan(const QModelIndex &left,
 
 bool HopSortFilterProxyModel::filterAcceptsRow( int source_row, const QModelIndex &source_parent) const
 {
+   Q_UNUSED(source_parent)
    HopTableModel* model = qobject_cast<HopTableModel*>(sourceModel());
-   QModelIndex index = sourceModel()->index(source_row, 0, source_parent);
+   Hop * hop = model->getHop(source_row);
 
-   return !filter
-          ||
-           ( sourceModel()->data(index).toString().contains(filterRegExp())
-             && model->getHop(source_row)->display()
-           );
+   return !filter || (hop->display() && this->search.matches(*hop));
+}
+
+void HopSortFilterProxyModel::setSearchText(QString const & searchText) {
+   this->search.setText(searchText);
+   this->invalidateFilter();
+   return;
 }
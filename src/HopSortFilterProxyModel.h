@@ -22,6 +22,11 @@
 #define HOPSORTFILTERPROXYMODEL_H
 
 #include <QSortFilterProxyModel>
+#include <QString>
+
+#include "database/SearchIndex.h"
+
+class Hop;
 
 /*!
  * \class HopSortFilterProxyModel
@@ -35,12 +40,19 @@ class HopSortFilterProxyModel : public QSortFilterProxyModel
 public:
    HopSortFilterProxyModel(QObject *parent = 0, bool filt = true);
 
+   /**
+    * \brief Only show rows whose searchable text (see \c SearchIndex) contains \c searchText.  An empty string
+    *        shows everything.
+    */
+   void setSearchText(QString const & searchText);
+
 protected:
    bool lessThan(const QModelIndex &left, const QModelIndex &right) const;
    bool filterAcceptsRow( int source_row, const QModelIndex &source_parent) const;
 
 private:
    bool filter;
+   SearchFilter<Hop> search;
 };
 
 #endif
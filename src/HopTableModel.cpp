@@ -47,12 +47,11 @@
 
 HopTableModel::HopTableModel(QTableView * parent, bool editable) :
    QAbstractTableModel(parent),
+   BtTableModelBase<HopTableModel, Hop>(HOPNUMCOLS, true),
    colFlags(HOPNUMCOLS),
    _inventoryEditable(false),
-   recObs(nullptr),
    parentTableWidget(parent),
    showIBUs(false) {
-   this->hopObs.clear();
    this->setObjectName("hopTable");
 
    for (int i = 0; i < HOPNUMCOLS; ++i) {
@@ -78,170 +77,29 @@ HopTableModel::HopTableModel(QTableView * parent, bool editable) :
 }
 
 HopTableModel::~HopTableModel() {
-   this->hopObs.clear();
+   this->rows.clear();
 }
 
-void HopTableModel::observeRecipe(Recipe * rec) {
-   if (this->recObs) {
-      disconnect(this->recObs, nullptr, this, nullptr);
-      removeAll();
-   }
-
-   this->recObs = rec;
-   if (this->recObs) {
-      connect(this->recObs, &NamedEntity::changed, this, &HopTableModel::changed);
-      this->addHops(this->recObs->hops());
-   }
-}
-
-void HopTableModel::observeDatabase(bool val) {
-   if (val) {
-      observeRecipe(nullptr);
-      removeAll();
-      connect(&ObjectStoreTyped<Hop>::getInstance(), &ObjectStoreTyped<Hop>::signalObjectInserted, this,
-              &HopTableModel::addHop);
-      connect(&ObjectStoreTyped<Hop>::getInstance(),
-              &ObjectStoreTyped<Hop>::signalObjectDeleted,
-              this,
-              &HopTableModel::removeHop);
-      this->addHops(ObjectStoreTyped<Hop>::getInstance().getAllRaw());
-   } else {
-      removeAll();
-      disconnect(&ObjectStoreTyped<Hop>::getInstance(), nullptr, this, nullptr);
-
-   }
-}
-
-/*void HopTableModel::addHop(Hop * hop) {
-   if (hop == nullptr || hopObs.contains(hop)) {
-      return;
-   }
-
-   // If we are observing the database, ensure that the item is undeleted and
-   // fit to display.
-   if (recObs == nullptr && (hop->deleted() || !hop->display())) {
-      return;
-   }
-
-   int size = hopObs.size();
-   beginInsertRows(QModelIndex(), size, size);
-   hopObs.append(hop);
-   connect(hop, SIGNAL(changed(QMetaProperty, QVariant)), this, SLOT(changed(QMetaProperty, QVariant)));
-   //reset(); // Tell everybody that the table has changed.
-   endInsertRows();
-}*/
-void HopTableModel::addHop(int hopId) {
-   auto hopAdded = ObjectStoreTyped<Hop>::getInstance().getById(hopId);
-   if (!hopAdded) {
-      // Not sure this should ever happen in practice, but, if there ever is no hop with the specified ID, there's not
-      // a lot we can do.
-      qWarning() << Q_FUNC_INFO << "Received signal that Hop ID" << hopId << "added, but unable to retrieve the Hop";
-      return;
-   }
-
-   // .:TODO:. For the moment at least, the rest of this class uses raw pointers, but would be good to refactor to use
-   // shared pointers.
-   Hop * hop = hopAdded.get();
-   if (this->hopObs.contains(hop)) {
-      return;
-   }
-
-   // If we are observing the database, ensure that the item is undeleted and
-   // fit to display.
-   if (this->recObs == nullptr && (hop->deleted() || !hop->display())) {
-      return;
-   }
-
-   // If we are watching a Recipe and the new Hop does not belong to it then there is nothing for us to do
-   if (this->recObs) {
-      Recipe * recipeOfNewHop = hop->getOwningRecipe();
-      if (recipeOfNewHop && this->recObs->key() != recipeOfNewHop->key()) {
-         qDebug() <<
-            Q_FUNC_INFO << "Ignoring signal about new Hop #" << hop->key() << "as it belongs to Recipe #" <<
-            recipeOfNewHop->key() << "and we are watching Recipe #" << this->recObs->key();
-         return;
-      }
-   }
-
-   int size = hopObs.size();
-   beginInsertRows(QModelIndex(), size, size);
-   hopObs.append(hop);
-   connect(hop, &NamedEntity::changed, this, &HopTableModel::changed);
-   endInsertRows();
-   return;
-}
-
-void HopTableModel::addHops(QList<Hop *> hops) {
-   QList<Hop *> tmp;
-
-   for (auto hop : hops) {
-      if (recObs == nullptr && (hop->deleted() || !hop->display())) {
-         continue;
-      }
-      if (!hopObs.contains(hop)) {
-         tmp.append(hop);
-      }
-   }
-
-   int size = hopObs.size();
-   if (size + tmp.size()) {
-      beginInsertRows(QModelIndex(), size, size + tmp.size() - 1);
-      hopObs.append(tmp);
-
-      for (auto hop : tmp) {
-         connect(hop, &NamedEntity::changed, this, &HopTableModel::changed);
-      }
-
-      endInsertRows();
-   }
-   return;
-}
-
-bool HopTableModel::remove(Hop * hop) {
-   int i = hopObs.indexOf(hop);
-   if (i >= 0) {
-      beginRemoveRows(QModelIndex(), i, i);
-      disconnect(hop, nullptr, this, nullptr);
-      hopObs.removeAt(i);
-      //reset(); // Tell everybody the table has changed.
-      endRemoveRows();
-
-      return true;
-   }
-
-   return false;
-}
-
-void HopTableModel::removeHop(int hopId, std::shared_ptr<QObject> object) {
-   this->remove(std::static_pointer_cast<Hop>(object).get());
-   return;
+QList<Hop *> HopTableModel::recipeItems(Recipe const & recipe) const {
+   return recipe.hops();
 }
 
 void HopTableModel::setShowIBUs(bool var) {
    showIBUs = var;
 }
 
-void HopTableModel::removeAll() {
-   if (hopObs.size()) {
-      beginRemoveRows(QModelIndex(), 0, hopObs.size() - 1);
-      while (!hopObs.isEmpty()) {
-         disconnect(hopObs.takeLast(), nullptr, this, nullptr);
-      }
-      endRemoveRows();
-   }
-}
-
 void HopTableModel::changedInventory(int invKey, BtStringConst const & propertyName) {
    if (propertyName == PropertyNames::Inventory::amount) {
 ///      double newAmount = ObjectStoreWrapper::getById<InventoryHop>()->getAmount();
-      for (int i = 0; i < hopObs.size(); ++i) {
-         Hop * holdmybeer = hopObs.at(i);
+      for (int i = 0; i < this->rows.size(); ++i) {
+         Hop * holdmybeer = this->rows.at(i);
 
          if (invKey == holdmybeer->inventoryId()) {
 /// No need to update amount as it's only stored in one place (the inventory object) now
 ///            holdmybeer->setCacheOnly(true);
 ///            holdmybeer->setInventoryAmount(newAmount);
 ///            holdmybeer->setCacheOnly(false);
+            this->formattedValueCache.invalidateCell(holdmybeer, HOPINVENTORYCOL);
             emit dataChanged(QAbstractItemModel::createIndex(i, HOPINVENTORYCOL),
                              QAbstractItemModel::createIndex(i, HOPINVENTORYCOL));
          }
@@ -251,28 +109,19 @@ void HopTableModel::changedInventory(int invKey, BtStringConst const & propertyN
 }
 
 void HopTableModel::changed(QMetaProperty prop, QVariant /*val*/) {
-   int i;
-
    // Find the notifier in the list
    Hop * hopSender = qobject_cast<Hop *>(sender());
    if (hopSender) {
-      i = hopObs.indexOf(hopSender);
-      if (i < 0) {
-         return;
-      }
-
-      emit dataChanged(QAbstractItemModel::createIndex(i, 0),
-                       QAbstractItemModel::createIndex(i, HOPNUMCOLS - 1));
-      emit headerDataChanged(Qt::Vertical, i, i);
+      this->rowChanged(hopSender);
       return;
    }
 
    // See if sender is our recipe.
    Recipe * recSender = qobject_cast<Recipe *>(sender());
-   if (recSender && recSender == recObs) {
+   if (recSender && recSender == this->recObs) {
       if (QString(prop.name()) == PropertyNames::Recipe::hopIds) {
-         removeAll();
-         addHops(recObs->hops());
+         this->removeAll();
+         this->add(this->recObs->hops());
       }
       if (rowCount() > 0) {
          emit headerDataChanged(Qt::Vertical, 0, rowCount() - 1);
@@ -282,7 +131,16 @@ void HopTableModel::changed(QMetaProperty prop, QVariant /*val*/) {
 }
 
 int HopTableModel::rowCount(const QModelIndex & /*parent*/) const {
-   return hopObs.size();
+   return this->rowCountImpl();
+}
+
+bool HopTableModel::canFetchMore(const QModelIndex & parent) const {
+   return this->canFetchMoreImpl(parent);
+}
+
+void HopTableModel::fetchMore(const QModelIndex & parent) {
+   this->fetchMoreImpl(parent);
+   return;
 }
 
 int HopTableModel::columnCount(const QModelIndex & /*parent*/) const {
@@ -292,15 +150,13 @@ int HopTableModel::columnCount(const QModelIndex & /*parent*/) const {
 QVariant HopTableModel::data(const QModelIndex & index, int role) const {
    Hop * row;
    int col = index.column();
-   Unit::unitScale scale;
-   Unit::unitDisplay unit;
 
    // Ensure the row is ok.
-   if (index.row() >= static_cast<int>(hopObs.size())) {
+   if (index.row() >= static_cast<int>(this->rows.size())) {
       qWarning() << QString("Bad model index. row = %1").arg(index.row());
       return QVariant();
    } else {
-      row = hopObs[index.row()];
+      row = this->rows[index.row()];
    }
 
    switch (index.column()) {
@@ -312,7 +168,9 @@ QVariant HopTableModel::data(const QModelIndex & index, int role) const {
          }
       case HOPALPHACOL:
          if (role == Qt::DisplayRole) {
-            return QVariant(Brewtarget::displayAmount(row->alpha_pct(), nullptr));
+            return QVariant(this->formattedValueCache.get(row, col, [row]() {
+               return Brewtarget::displayAmount(row->alpha_pct(), nullptr);
+            }));
          } else {
             return QVariant();
          }
@@ -320,19 +178,17 @@ QVariant HopTableModel::data(const QModelIndex & index, int role) const {
          if (role != Qt::DisplayRole) {
             return QVariant();
          }
-         unit = displayUnit(col);
-         scale = displayScale(col);
-
-         return QVariant(Brewtarget::displayAmount(row->inventory(), &Units::kilograms, 3, unit, scale));
+         return QVariant(this->formattedValueCache.get(row, col, [this, row, col]() {
+            return Brewtarget::displayAmount(row->inventory(), &Units::kilograms, 3, displayUnit(col), displayScale(col));
+         }));
 
       case HOPAMOUNTCOL:
          if (role != Qt::DisplayRole) {
             return QVariant();
          }
-         unit = displayUnit(col);
-         scale = displayScale(col);
-
-         return QVariant(Brewtarget::displayAmount(row->amount_kg(), &Units::kilograms, 3, unit, scale));
+         return QVariant(this->formattedValueCache.get(row, col, [this, row, col]() {
+            return Brewtarget::displayAmount(row->amount_kg(), &Units::kilograms, 3, displayUnit(col), displayScale(col));
+         }));
 
       case HOPUSECOL:
          if (role == Qt::DisplayRole) {
@@ -347,9 +203,9 @@ QVariant HopTableModel::data(const QModelIndex & index, int role) const {
             return QVariant();
          }
 
-         scale = displayScale(col);
-
-         return QVariant(Brewtarget::displayAmount(row->time_min(), &Units::minutes, 3, Unit::noUnit, scale));
+         return QVariant(this->formattedValueCache.get(row, col, [this, row, col]() {
+            return Brewtarget::displayAmount(row->time_min(), &Units::minutes, 3, Unit::noUnit, displayScale(col));
+         }));
       case HOPFORMCOL:
          if (role == Qt::DisplayRole) {
             return QVariant(row->formStringTr());
@@ -385,8 +241,8 @@ QVariant HopTableModel::headerData(int section, Qt::Orientation orientation, int
             qWarning() << QString("HopTableModel::headerdata Bad column: %1").arg(section);
             return QVariant();
       }
-   } else if (showIBUs && recObs && orientation == Qt::Vertical && role == Qt::DisplayRole) {
-      QList<double> ibus = recObs->IBUs();
+   } else if (showIBUs && this->recObs && orientation == Qt::Vertical && role == Qt::DisplayRole) {
+      QList<double> ibus = this->recObs->IBUs();
 
       if (ibus.size() > section) {
          return QVariant(QString("%L1 IBU").arg(ibus.at(section), 0, 'f', 1));
@@ -406,11 +262,11 @@ bool HopTableModel::setData(const QModelIndex & index, const QVariant & value, i
    bool retVal = false;
    double amt;
 
-   if (index.row() >= static_cast<int>(hopObs.size()) || role != Qt::EditRole) {
+   if (index.row() >= static_cast<int>(this->rows.size()) || role != Qt::EditRole) {
       return false;
    }
 
-   row = hopObs[index.row()];
+   row = this->rows[index.row()];
 
    Unit::unitDisplay dspUnit = displayUnit(index.column());
    Unit::unitScale   dspScl  = displayScale(index.column());
@@ -531,6 +387,10 @@ void HopTableModel::setDisplayUnit(int column, Unit::unitDisplay displayUnit) {
    PersistentSettings::insert(attribute, displayUnit, this->objectName(), PersistentSettings::UNIT);
    PersistentSettings::insert(attribute, Unit::noScale, this->objectName(), PersistentSettings::SCALE);
 
+   this->formattedValueCache.invalidateColumn(column);
+   if (this->rowCount() > 0) {
+      emit dataChanged(this->index(0, column), this->index(this->rowCount() - 1, column));
+   }
 }
 
 // Setting the scale should clear any cell-level scaling options
@@ -545,6 +405,10 @@ void HopTableModel::setDisplayScale(int column, Unit::unitScale displayScale) {
 
    PersistentSettings::insert(attribute, displayScale, this->objectName(), PersistentSettings::SCALE);
 
+   this->formattedValueCache.invalidateColumn(column);
+   if (this->rowCount() > 0) {
+      emit dataChanged(this->index(0, column), this->index(this->rowCount() - 1, column));
+   }
 }
 
 QString HopTableModel::generateName(int column) const {
@@ -610,12 +474,12 @@ void HopTableModel::contextMenu(const QPoint & point) {
 
 // Returns null on failure.
 Hop * HopTableModel::getHop(int i) {
-   if (!(hopObs.isEmpty())) {
-      if (i >= 0 && i < hopObs.size()) {
-         return hopObs[i];
+   if (!(this->rows.isEmpty())) {
+      if (i >= 0 && i < this->rows.size()) {
+         return this->rows[i];
       }
    } else {
-      qWarning() << QString("HopTableModel::getHop( %1/%2 )").arg(i).arg(hopObs.size());
+      qWarning() << QString("HopTableModel::getHop( %1/%2 )").arg(i).arg(this->rows.size());
    }
    return nullptr;
 }
@@ -31,6 +31,7 @@
 #include <QVector>
 #include <QWidget>
 
+#include "BtTableModelBase.h"
 #include "model/Hop.h"
 #include "model/Recipe.h"
 
@@ -46,26 +47,20 @@ enum{HOPNAMECOL, HOPALPHACOL, HOPAMOUNTCOL, HOPINVENTORYCOL, HOPFORMCOL, HOPUSEC
  *
  * \brief Model class for a list of hops.
  */
-class HopTableModel : public QAbstractTableModel
+class HopTableModel : public QAbstractTableModel, public BtTableModelBase<HopTableModel, Hop>
 {
    Q_OBJECT
 
+   friend class BtTableModelBase<HopTableModel, Hop>;
+
 public:
 
    HopTableModel(QTableView* parent=nullptr, bool editable=true);
    virtual ~HopTableModel();
-   //! \brief Observe a recipe's list of fermentables.
-   void observeRecipe(Recipe* rec);
-   //! \brief If true, we model the database's list of hops.
-   void observeDatabase(bool val);
    //! \brief Show ibus in the vertical header.
    void setShowIBUs( bool var );
-   //! \brief Watch all the \c hops for changes.
-   void addHops(QList<Hop*> hops);
    //! \brief Return the \c i-th hop in the model.
    Hop* getHop(int i);
-   //! \brief Clear the model.
-   void removeAll();
 
    /*!
     * \brief True if the inventory column should be editable, false otherwise.
@@ -79,6 +74,10 @@ public:
    //! \brief Reimplemented from QAbstractTableModel.
    virtual int columnCount(const QModelIndex& parent = QModelIndex()) const;
    //! \brief Reimplemented from QAbstractTableModel.
+   virtual bool canFetchMore(const QModelIndex& parent) const;
+   //! \brief Reimplemented from QAbstractTableModel.
+   virtual void fetchMore(const QModelIndex& parent);
+   //! \brief Reimplemented from QAbstractTableModel.
    virtual QVariant data( const QModelIndex& index, int role = Qt::DisplayRole ) const;
    //! \brief Reimplemented from QAbstractTableModel.
    virtual QVariant headerData( int section, Qt::Orientation orientation, int role = Qt::DisplayRole ) const;
@@ -98,24 +97,18 @@ public:
 
    QString generateName(int column) const;
 
-   //! \returns true if "hop" is successfully found and removed.
-   bool remove(Hop* hop);
-
 public slots:
    void changed(QMetaProperty, QVariant);
    void changedInventory(int invKey, BtStringConst const & propertyName);
-   //! \brief Add a hop to the model.
-//   void addHop(Hop* hop);
-   void addHop(int hopId);
-   void removeHop(int hopId, std::shared_ptr<QObject> object);
 
    void contextMenu(const QPoint &point);
 
 private:
+   //! \brief Used by \c BtTableModelBase::observeRecipe()
+   QList<Hop *> recipeItems(Recipe const & recipe) const;
+
    QVector<Qt::ItemFlags> colFlags;
    bool _inventoryEditable;
-   QList<Hop*> hopObs;
-   Recipe* recObs;
    QTableView* parentTableWidget;
    bool showIBUs; // True if you want to show the IBU contributions in the table rows.
 };
@@ -20,7 +20,18 @@
  */
 #include "Logging.h"
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>      // For std::signal, std::raise
+#include <cstdio>       // For std::fputs, std::fflush
+#include <cstdlib>      // For std::abort
+#include <cstring>      // For std::strstr
+#include <exception>    // For std::set_terminate
+#include <memory>
+#include <mutex>
 #include <sstream>      // For std::ostringstream
+#include <thread>
 
 #include <boost/stacktrace.hpp>
 
@@ -43,6 +54,11 @@
 #define END_OF_LINE Qt::endl
 #endif
 
+Q_LOGGING_CATEGORY(lcDatabase, "brewtarget.database")
+Q_LOGGING_CATEGORY(lcModel,    "brewtarget.model")
+Q_LOGGING_CATEGORY(lcXml,      "brewtarget.xml")
+Q_LOGGING_CATEGORY(lcUi,       "brewtarget.ui")
+
 //
 // Anonymous namespace for constants, global variables and functions used only in this file
 //
@@ -50,6 +66,10 @@ namespace {
 
    Logging::Level currentLoggingLevel = Logging::LogLevel_INFO;
 
+   // Names of the logging categories for which we log debug messages (if currentLoggingLevel is LogLevel_DEBUG).  NB:
+   // Debug messages logged with plain qDebug() are in the "default" category and are not affected by this.
+   QStringList debugCategories;
+
    // We decompose the log filename into its body and suffix for log rotation
    // The _current_ log file is always "brewtarget.log"
    QString const logFilename{"brewtarget"};
@@ -64,9 +84,14 @@ namespace {
    QFile logFile;
    QMutex mutex;
 
+   // How big the current log file is, including anything we've written to the stream that hasn't yet been flushed to
+   // the file.  (We only count characters rather than bytes, but that's near enough for deciding when to rotate.)
+   qint64 currentLogFileSize = 0;
+
    // This global flag controls whether, in general, we are logging to stderr or not.  Usually it's turned off for at
-   // least the part of automated testing where we're generating lots of test logging.
-   bool isLoggingToStderr{true};
+   // least the part of automated testing where we're generating lots of test logging.  It's read on whichever thread is
+   // logging, so it needs to be atomic.
+   std::atomic<bool> isLoggingToStderr{true};
 
    QTextStream errStream{stderr};
    QTextStream * stream;
@@ -83,26 +108,23 @@ namespace {
 
    //
    // Although we can turn off logging to stderr (eg for running test cases), we want to force it to be enabled for
-   // logging errors about logging.  The combination of this thread-local variable and little RAII class enable you to
-   // create an object that will force stderr logging to be enabled for the current thread for the duration of the
-   // object's life (typically the duration of a function).
+   // logging errors about logging.  The combination of this counter and little RAII class enable you to create an
+   // object that will force stderr logging to be enabled for the duration of the object's life (typically the duration
+   // of a function).  We count, rather than just setting a flag, because one function that has created one of these
+   // objects might call another that does the same, and because the objects can exist on more than one thread at once
+   // (so the counter also needs to be atomic).
    //
-   thread_local bool forceStderrLogging{false};
+   std::atomic<int> forceStderrLoggingCount{0};
    class TemporarilyForceStderrLogging {
    public:
       TemporarilyForceStderrLogging()  {
-         this->savedState = forceStderrLogging;
-         forceStderrLogging = true;
+         ++forceStderrLoggingCount;
          return;
       }
       ~TemporarilyForceStderrLogging() {
-         forceStderrLogging = this->savedState;
+         --forceStderrLoggingCount;
          return;
       }
-   private:
-      // We need to save state because one function that has created one of these objects might call another that does
-      // the same
-      bool savedState;
    };
 
    //
@@ -123,17 +145,41 @@ namespace {
    }
 
    //
-   // This is what actually outputs a message to the log file and/or std::cerr
+   // Qt checks whether a logging category is enabled for a given message type _before_ any of the message is
+   // formatted, so, by turning off the categories (or message types) we're not logging, we avoid all the work of
+   // building messages that are only going to be thrown away.  Qt calls the category filter once for each category
+   // when it's created and again for all of them whenever the filter is (re)installed, so it's not on the logging path.
    //
-   void doLog(const Logging::Level level, const QString message) {
-      QString logEntry = QString{"[%1] (%2) %3 : %4"}.arg(QTime::currentTime().toString(timeFormat))
-                                                     .arg(threadId)
-                                                     .arg(Logging::getStringFromLogLevel(level))
-                                                     .arg(message);
-      QMutexLocker locker(&mutex);
-      if (isLoggingToStderr ||
-          forceStderrLogging) { errStream << logEntry << END_OF_LINE; }
-      if (stream)             {   *stream << logEntry << END_OF_LINE; }
+   QLoggingCategory::CategoryFilter previousCategoryFilter = nullptr;
+
+   void categoryFilter(QLoggingCategory * category) {
+      QString const categoryName = QString::fromLatin1(category->categoryName());
+      bool const isDefault = (categoryName == QLatin1String{"default"});
+      if (!isDefault && !categoryName.startsWith(QLatin1String{"brewtarget."})) {
+         // Not one of ours (eg it's one of Qt's own categories), so leave it to whatever filter was there before
+         if (previousCategoryFilter) {
+            previousCategoryFilter(category);
+         }
+         return;
+      }
+      category->setEnabled(QtDebugMsg,
+                           currentLoggingLevel <= Logging::LogLevel_DEBUG &&
+                           (isDefault || debugCategories.contains(categoryName)));
+      category->setEnabled(QtInfoMsg,    currentLoggingLevel <= Logging::LogLevel_INFO);
+      category->setEnabled(QtWarningMsg, currentLoggingLevel <= Logging::LogLevel_WARNING);
+      // We always log errors, so QtCriticalMsg stays enabled
+      return;
+   }
+
+   /**
+    * \brief (Re)install our category filter, which makes Qt re-run it for all existing categories
+    */
+   void applyCategoryFilter() {
+      QLoggingCategory::CategoryFilter oldFilter = QLoggingCategory::installFilter(categoryFilter);
+      // If we're re-installing, don't make ourselves our own previous filter!
+      if (oldFilter != categoryFilter) {
+         previousCategoryFilter = oldFilter;
+      }
       return;
    }
 
@@ -184,21 +230,46 @@ namespace {
    }
 
    /**
-    * \brief initializes the log file and opens the stream for writing.
-    *        This was moved to its own function as this has to be called every time logs are being pruned.
+    * \brief Something to log about what happened when we (re)opened the log file.  Because that's done with \c mutex
+    *        held, we can't log it there and then (as, until the writer thread is running, logging also needs the
+    *        mutex), so the caller logs it, with \c logReport(), once the mutex is released.
     */
-   bool openLogFile() {
+   struct LogFileReport {
+      Logging::Level level = Logging::LogLevel_INFO;
+      QString message;
+   };
+
+   void logReport(LogFileReport const & report) {
+      if (report.message.isEmpty()) {
+         return;
+      }
       // We _really_ need to see problems with opening the log file on stderr!
+      if (report.level == Logging::LogLevel_INFO) {
+         qInfo().noquote() << report.message;
+         return;
+      }
       TemporarilyForceStderrLogging temporarilyForceStderrLogging;
+      if (report.level == Logging::LogLevel_WARNING) {
+         qWarning().noquote() << report.message;
+      } else {
+         qCritical().noquote() << report.message;
+      }
+      return;
+   }
+
+   /**
+    * \brief initializes the log file and opens the stream for writing.
+    *        This was moved to its own function as this has to be called every time logs are being pruned.
+    *
+    *        NB: Caller must hold \c mutex (so any errors between here and the closing brace need to go to stderr or
+    *        \c report).
+    */
+   bool openLogFile(LogFileReport & report) {
+      // Close any stream we already have before we replace it
+      closeLogFile();
 
       // First check if it's time to rotate the log file
       if (logFile.size() > Logging::logFileSize) {
-         // Acquire lock due to the file mangling below.  NB: This means we do not want to use Qt logging in this
-         // block, as we'd end up attempting to acquire the same mutex in the doLog() function above!  So, any errors
-         // between here and the closing brace need to go to stderr
-         QMutexLocker locker(&mutex);
-         // Double check that the stream is not initiated, if so, kill it.
-         closeLogFile();
          if (!renameLogFileWithTimestamp(logDirectory)) {
             errStream <<
                "Could not rename the log file " << logFileFullName() << " in directory " <<
@@ -211,45 +282,58 @@ namespace {
       logFile.setFileName(logDirectory.filePath(logFileFullName()));
       if (logFile.open(QIODevice::WriteOnly | QIODevice::Append)) {
          stream = new QTextStream(&logFile);
-         qInfo() << Q_FUNC_INFO << "Logging to file" << QFileInfo(logFile).canonicalFilePath();
+         currentLogFileSize = logFile.size();
+         report = {Logging::LogLevel_INFO,
+                   QString{"%1 Logging to file %2"}.arg(Q_FUNC_INFO).arg(QFileInfo(logFile).canonicalFilePath())};
          return true;
       }
 
-      qInfo() <<
-         Q_FUNC_INFO << "Could not open log file" << QFileInfo(logFile).canonicalFilePath() <<
-         "for writing.  Will try using temporary directory";
+      QString const failedFilePath = QFileInfo(logFile).canonicalFilePath();
 
       // Defaults to temporary
       logFile.setFileName(QDir::temp().filePath(logFileFullName()));
       if (logFile.open(QFile::WriteOnly | QFile::Truncate)) {
          logFile.setPermissions(QFileDevice::WriteUser | QFileDevice::ReadUser | QFileDevice::ExeUser);
          stream = new QTextStream(&logFile);
-         qWarning() <<
-            Q_FUNC_INFO << "Log file is in a temporary directory: " << QFileInfo(logFile).canonicalFilePath();
+         currentLogFileSize = 0;
+         report = {Logging::LogLevel_WARNING,
+                   QString{"%1 Could not open log file %2 for writing.  Log file is in a temporary directory: %3"}
+                      .arg(Q_FUNC_INFO).arg(failedFilePath).arg(QFileInfo(logFile).canonicalFilePath())};
          return true;
       }
 
-      qCritical() << Q_FUNC_INFO << "Unable to open" << QFileInfo(logFile).canonicalFilePath();
-
+      report = {Logging::LogLevel_ERROR,
+                QString{"%1 Unable to open %2"}.arg(Q_FUNC_INFO).arg(QFileInfo(logFile).canonicalFilePath())};
       return false;
    }
 
+   /**
+    * \brief Get the list of log files in the current logging directory, oldest first.  Caller must hold \c mutex.
+    */
+   QFileInfoList logFileList() {
+      QStringList filters;
+      filters << QString("%1*.%2").arg(logFilename).arg(logFilenameExtension);
+
+      //configuring the file filters to only remove the log files as the directory also contains the database.
+      QDir dir;
+      dir.setSorting(QDir::Reversed | QDir::Time);
+      dir.setFilter(QDir::Files | QDir::Hidden | QDir::NoSymLinks);
+      dir.setPath(logDirectory.canonicalPath());
+      dir.setNameFilters(filters);
+      return dir.entryInfoList();
+   }
+
    /**
     * \brief Prunes old log files from the directory, keeping only the specified number of files in logFileCount,
     *        Purpose is to keep log files to a mininum while keeping the logs up-to-date and also not require manual
-    *        pruning of files.
+    *        pruning of files.  Caller must hold \c mutex.
     */
    void pruneLogFiles() {
-      QMutexLocker locker(&mutex);
       // Need to close and reset the stream before deleting any files.
       closeLogFile();
 
-      // If the logfile is closed and we're in testing mode where stderr is disabled, we need to enable it temporarily.
-      // saving old value to reset to after pruning.
-      TemporarilyForceStderrLogging temporarilyForceStderrLogging;
-
       //Get the list of log files.
-      QFileInfoList fileList = Logging::getLogFileList();
+      QFileInfoList fileList = logFileList();
       if (fileList.size() > Logging::logFileCount)
       {
          for (int i = 0; i < (fileList.size() - Logging::logFileCount); i++)
@@ -261,6 +345,382 @@ namespace {
       return;
    }
 
+   /**
+    * \brief Called from the log writer thread, with \c mutex held, before each write.  If the log file is too big,
+    *        prunes the old log files and starts a new one.  Because \c Logging::setDirectory() also holds \c mutex
+    *        whilst it's changing the log directory and moving the log file, the two can't trip over each other.
+    */
+   void rotateLogFileIfNeeded(LogFileReport & report) {
+      // Check if there is a file actually set yet.  In a rare case if the logfile was not created at initialization,
+      // then we won't be logging to a file, the location may not yet have been loaded from the settings, thus only
+      // logging to the stderr.  In this case we cannot do any of the pruning or filename generation.
+      if (stream && currentLogFileSize >= Logging::logFileSize) {
+         pruneLogFiles();
+         openLogFile(report);
+      }
+      return;
+   }
+
+   /**
+    * \brief A formatted log message waiting to be written
+    */
+   struct LogEntry {
+      QString text;
+      bool toStderr;
+   };
+
+   /**
+    * \brief Write a log entry to stderr and/or the log file.  Caller must hold \c mutex.
+    */
+   void writeEntry(LogEntry const & entry) {
+      if (entry.toStderr) { errStream << entry.text << '\n'; }
+      if (stream)         {   *stream << entry.text << '\n'; currentLogFileSize += entry.text.size() + 1; }
+      return;
+   }
+
+   /**
+    * \brief Bounded queue of log entries that any number of threads can add to without taking a lock, and which the
+    *        log writer thread empties.
+    *
+    *        This is the well-known algorithm from Dmitry Vyukov, where each cell has a sequence number that tells
+    *        producers and consumers whether it is free to write or ready to read.  Adding to a full queue fails
+    *        rather than waiting, leaving the caller to decide what to do.
+    */
+   class LogRingBuffer {
+   public:
+      //! Must be a power of two
+      static constexpr std::size_t capacity = 4096;
+
+      LogRingBuffer() : cells{new Cell[capacity]},
+                        enqueuePosition{0},
+                        dequeuePosition{0} {
+         for (std::size_t ii = 0; ii < capacity; ++ii) {
+            this->cells[ii].sequence.store(ii, std::memory_order_relaxed);
+         }
+         return;
+      }
+
+      bool tryPush(LogEntry && entry) {
+         Cell * cell;
+         std::size_t position = this->enqueuePosition.load(std::memory_order_relaxed);
+         for (;;) {
+            cell = &this->cells[position & mask];
+            std::size_t const sequence = cell->sequence.load(std::memory_order_acquire);
+            std::intptr_t const difference = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+            if (difference == 0) {
+               if (this->enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                  break;
+               }
+            } else if (difference < 0) {
+               // Queue is full
+               return false;
+            } else {
+               position = this->enqueuePosition.load(std::memory_order_relaxed);
+            }
+         }
+         cell->entry = std::move(entry);
+         cell->sequence.store(position + 1, std::memory_order_release);
+         return true;
+      }
+
+      bool tryPop(LogEntry & entry) {
+         Cell * cell;
+         std::size_t position = this->dequeuePosition.load(std::memory_order_relaxed);
+         for (;;) {
+            cell = &this->cells[position & mask];
+            std::size_t const sequence = cell->sequence.load(std::memory_order_acquire);
+            std::intptr_t const difference =
+               static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position + 1);
+            if (difference == 0) {
+               if (this->dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                  break;
+               }
+            } else if (difference < 0) {
+               // Queue is empty
+               return false;
+            } else {
+               position = this->dequeuePosition.load(std::memory_order_relaxed);
+            }
+         }
+         entry = std::move(cell->entry);
+         cell->sequence.store(position + mask + 1, std::memory_order_release);
+         return true;
+      }
+
+   private:
+      static constexpr std::size_t mask = capacity - 1;
+      static_assert((capacity & mask) == 0, "Capacity must be a power of two");
+
+      struct Cell {
+         std::atomic<std::size_t> sequence;
+         LogEntry entry;
+      };
+      std::unique_ptr<Cell[]> cells;
+      std::atomic<std::size_t> enqueuePosition;
+      std::atomic<std::size_t> dequeuePosition;
+   };
+
+   /**
+    * \brief Owns the thread that takes log entries off a \c LogRingBuffer and writes them out, so that threads doing
+    *        the logging (including the GUI thread) don't have to wait for file or console I/O.
+    *
+    *        If the buffer is full, debug messages are dropped (and we log how many) but anything more important waits
+    *        for there to be space.
+    *
+    *        Until the writer thread is started, and after it is stopped, messages are written straight out on the
+    *        calling thread as before.
+    */
+   class LogWriter {
+   public:
+      LogWriter() : buffer{},
+                    thread{},
+                    writerThreadId{},
+                    running{false},
+                    queuedCount{0},
+                    writtenCount{0},
+                    droppedCount{0},
+                    wakeMutex{},
+                    wakeCondition{},
+                    writtenCondition{} {
+         return;
+      }
+
+      //! If we get as far as static destruction without stopping the writer thread, we must stop it now
+      ~LogWriter() {
+         this->stop();
+         return;
+      }
+
+      void start() {
+         if (!this->running) {
+            this->running = true;
+            this->thread = std::thread{&LogWriter::run, this};
+         }
+         return;
+      }
+
+      //! Write everything that's queued and stop the writer thread
+      void stop() {
+         if (this->running) {
+            this->running = false;
+            this->wakeCondition.notify_one();
+            this->thread.join();
+
+            // Pick up anything that got added whilst the writer thread was finishing up
+            LogEntry entry;
+            QMutexLocker locker(&mutex);
+            while (this->buffer.tryPop(entry)) {
+               writeEntry(entry);
+            }
+            errStream.flush();
+            if (stream) { stream->flush(); }
+         }
+         return;
+      }
+
+      void log(Logging::Level const level, LogEntry && entry) {
+         if (!this->running) {
+            QMutexLocker locker(&mutex);
+            writeEntry(entry);
+            errStream.flush();
+            if (stream) { stream->flush(); }
+            return;
+         }
+
+         bool const onWriterThread = std::this_thread::get_id() == this->writerThreadId.load();
+         while (!this->buffer.tryPush(std::move(entry))) {
+            // The writer thread can't wait for itself to make space, and we don't hold up anyone else for debug
+            // messages
+            if (onWriterThread || level == Logging::LogLevel_DEBUG) {
+               ++this->droppedCount;
+               return;
+            }
+            this->wakeCondition.notify_one();
+            std::this_thread::yield();
+         }
+         ++this->queuedCount;
+         this->wakeCondition.notify_one();
+         return;
+      }
+
+      //! Wait until everything queued before this call has been written out and flushed
+      void flush() {
+         if (!this->running || std::this_thread::get_id() == this->writerThreadId.load()) {
+            return;
+         }
+         quint64 const target = this->queuedCount;
+         this->wakeCondition.notify_one();
+         std::unique_lock<std::mutex> lock{this->wakeMutex};
+         while (this->running && this->writtenCount < target) {
+            this->writtenCondition.wait_for(lock, std::chrono::milliseconds{10});
+         }
+         return;
+      }
+
+      /**
+       * \brief Called when the program is about to crash, to write out, on the calling thread, whatever is still
+       *        queued.  We can't wait for the writer thread, as it might be the one that's crashing.
+       *
+       *        This is best effort.  None of it is async-signal-safe, but we're going down anyway, and losing the
+       *        messages that might explain why is worse than the small risk of making a mess of the crash.  If we
+       *        can't get the mutex (eg because the crashing thread holds it) we just write to stderr.
+       */
+      void emergencyDrain() {
+         bool const haveLock = mutex.tryLock(emergencyLockTimeoutMs);
+         LogEntry entry;
+         while (this->buffer.tryPop(entry)) {
+            if (haveLock) {
+               writeEntry(entry);
+            } else {
+               std::fputs(entry.text.toLocal8Bit().constData(), stderr);
+               std::fputs("\n", stderr);
+            }
+         }
+         if (haveLock) {
+            errStream.flush();
+            if (stream) { stream->flush(); }
+            mutex.unlock();
+         }
+         std::fflush(stderr);
+         return;
+      }
+
+   private:
+      //! How long \c emergencyDrain() will wait for the mutex
+      static constexpr int emergencyLockTimeoutMs = 500;
+
+      void run() {
+         this->writerThreadId = std::this_thread::get_id();
+         LogEntry entry;
+         for (;;) {
+            bool wroteSomething = false;
+            while (this->buffer.tryPop(entry)) {
+               LogFileReport rotationReport;
+               {
+                  QMutexLocker locker(&mutex);
+                  rotateLogFileIfNeeded(rotationReport);
+                  writeEntry(entry);
+               }
+               // This just adds to the queue, which we'll get to on the next time round the loop
+               logReport(rotationReport);
+               ++this->writtenCount;
+               wroteSomething = true;
+            }
+
+            unsigned int const dropped = this->droppedCount.exchange(0);
+            if (dropped > 0) {
+               QMutexLocker locker(&mutex);
+               writeEntry({
+                  QString{"[%1] (%2) %3 : %4 log messages were dropped because the log buffer was full"}
+                     .arg(QTime::currentTime().toString(timeFormat))
+                     .arg(threadId)
+                     .arg(Logging::getStringFromLogLevel(Logging::LogLevel_WARNING))
+                     .arg(dropped),
+                  true
+               });
+            }
+
+            if (wroteSomething) {
+               {
+                  QMutexLocker locker(&mutex);
+                  errStream.flush();
+                  if (stream) { stream->flush(); }
+               }
+               std::lock_guard<std::mutex> lock{this->wakeMutex};
+               this->writtenCondition.notify_all();
+               continue;
+            }
+
+            if (!this->running) {
+               return;
+            }
+
+            // Producers don't take wakeMutex when they notify us, so we might miss a wake-up, in which case we'll just
+            // find the new entries a few milliseconds later.
+            std::unique_lock<std::mutex> lock{this->wakeMutex};
+            this->wakeCondition.wait_for(lock, std::chrono::milliseconds{50});
+         }
+      }
+
+      LogRingBuffer buffer;
+      std::thread thread;
+      std::atomic<std::thread::id> writerThreadId;
+      std::atomic<bool> running;
+      std::atomic<quint64> queuedCount;
+      std::atomic<quint64> writtenCount;
+      std::atomic<unsigned int> droppedCount;
+      std::mutex wakeMutex;
+      std::condition_variable wakeCondition;
+      std::condition_variable writtenCondition;
+   };
+
+   LogWriter logWriter;
+
+   //
+   // This is what actually outputs a message to the log file and/or std::cerr (via the writer thread if it's running)
+   //
+   void doLog(const Logging::Level level, const QString message) {
+      QString logEntry = QString{"[%1] (%2) %3 : %4"}.arg(QTime::currentTime().toString(timeFormat))
+                                                     .arg(threadId)
+                                                     .arg(Logging::getStringFromLogLevel(level))
+                                                     .arg(message);
+      logWriter.log(level, LogEntry{logEntry, isLoggingToStderr || forceStderrLoggingCount > 0});
+      return;
+   }
+
+   //
+   // When we crash, we want the log to include everything queued up to that point.  For signals, once we've written
+   // out the log, we put back whatever handler was there before and re-raise the signal, so that the OS (or any crash
+   // reporter) still sees the crash as it would have done without us.  (SIGBUS isn't in the C standard and doesn't
+   // exist on Windows.)
+   //
+   int const crashSignals[] = {
+      SIGSEGV, SIGABRT, SIGFPE, SIGILL,
+#ifdef SIGBUS
+      SIGBUS,
+#endif
+   };
+   std::size_t const numCrashSignals = sizeof(crashSignals) / sizeof(crashSignals[0]);
+   using SignalHandler = void (*)(int);
+   SignalHandler previousSignalHandlers[numCrashSignals] = {};
+   std::terminate_handler previousTerminateHandler = nullptr;
+
+   void crashSignalHandler(int const signalNumber) {
+      logWriter.emergencyDrain();
+      for (std::size_t ii = 0; ii < numCrashSignals; ++ii) {
+         if (crashSignals[ii] == signalNumber) {
+            std::signal(signalNumber, previousSignalHandlers[ii] == SIG_ERR ? SIG_DFL : previousSignalHandlers[ii]);
+            break;
+         }
+      }
+      std::raise(signalNumber);
+      return;
+   }
+
+   [[noreturn]] void terminateHandler() {
+      logWriter.emergencyDrain();
+      if (previousTerminateHandler) {
+         previousTerminateHandler();
+      }
+      std::abort();
+   }
+
+   void installCrashHandlers() {
+      for (std::size_t ii = 0; ii < numCrashSignals; ++ii) {
+         previousSignalHandlers[ii] = std::signal(crashSignals[ii], crashSignalHandler);
+      }
+      previousTerminateHandler = std::set_terminate(terminateHandler);
+      return;
+   }
+
+   void removeCrashHandlers() {
+      for (std::size_t ii = 0; ii < numCrashSignals; ++ii) {
+         std::signal(crashSignals[ii], previousSignalHandlers[ii] == SIG_ERR ? SIG_DFL : previousSignalHandlers[ii]);
+      }
+      std::set_terminate(previousTerminateHandler);
+      return;
+   }
+
    /**
     * \brief Handles all log messages, which should be logged using the standard Qt functions, eg:
     *        qDebug() << "message" << some_variable; //for a debug message!
@@ -268,9 +728,8 @@ namespace {
    void logMessageHandler(QtMsgType qtMsgType, QMessageLogContext const & context, QString const & message) {
       Logging::Level logLevelOfMessage = levelFromQtMsgType(qtMsgType);
       //
-      // First things first!  What logging level has the user chosen.
-      // then, if the file-stream is open and the log file size is to big, we need to prune the old logs and initiate a new logfile.
-      // after that we're all set, Log away!
+      // First things first!  What logging level has the user chosen.  After that we're all set, Log away!  (If the log
+      // file gets too big, the log writer thread takes care of pruning the old logs and starting a new one.)
       //
 
       // Check that we're set to log this level, this is set by the user options.
@@ -278,16 +737,6 @@ namespace {
          return;
       }
 
-      // Check if there is a file actually set yet.  In a rare case if the logfile was not created at initialization,
-      // then we won't be logging to a file, the location may not yet have been loaded from the settings, thus only logging to the stderr.
-      // In this case we cannot do any of the pruning or filename generation.
-      if (stream) {
-         if (logFile.size() >= Logging::logFileSize) {
-            pruneLogFiles();
-            openLogFile();
-         }
-      }
-
       // Writing the actual log
       //
       // QMessageLogContext members are a bit hard to find in Qt documentation so noted here:
@@ -302,9 +751,20 @@ namespace {
       //    QString sourceFile = QFileInfo(context.file).fileName();
       // But we'd like to show the relative path under the src directory (eg database/Database.cpp rather than just
       // Database.cpp).  (The code here assumes there will not be any subdirectory of src that is also called src,
-      // which seems pretty reasonable.)
-      QString sourceFile = QString{context.file}.split("/src/").last();
-      doLog(logLevelOfMessage, QString("%1  [%2:%3]").arg(message).arg(sourceFile).arg(context.line));
+      // which seems pretty reasonable.)  We find the last "/src/" in place rather than splitting the path into a list
+      // of new strings, as this gets done for every message we log.
+      char const * sourceFile = context.file ? context.file : "";
+      for (char const * match = std::strstr(sourceFile, "/src/"); match; match = std::strstr(sourceFile, "/src/")) {
+         sourceFile = match + std::strlen("/src/");
+      }
+      doLog(logLevelOfMessage,
+            QString("%1  [%2:%3]").arg(message).arg(QLatin1String{sourceFile}).arg(context.line));
+
+      // Qt is going to abort the program as soon as we return, so make sure this message, and everything before it,
+      // actually gets written out
+      if (qtMsgType == QtFatalMsg) {
+         logWriter.flush();
+      }
       return;
    }
 
@@ -318,6 +778,13 @@ QVector<Logging::LevelDetail> const Logging::levelDetails{
    { Logging::LogLevel_ERROR,   "ERROR",   QObject::tr("Errors only")}
 };
 
+QVector<Logging::CategoryDetail> const Logging::categoryDetails{
+   { lcDatabase, QObject::tr("Database") },
+   { lcModel,    QObject::tr("Recipes and ingredients") },
+   { lcXml,      QObject::tr("BeerXML import and export") },
+   { lcUi,       QObject::tr("User interface") }
+};
+
 QString Logging::getStringFromLogLevel(const Logging::Level level) {
    auto match = std::find_if(Logging::levelDetails.begin(),
                               Logging::levelDetails.end(),
@@ -345,11 +812,23 @@ Logging::Level Logging::getLogLevel() {
 void Logging::setLogLevel(Level newLevel) {
    currentLoggingLevel = newLevel;
    PersistentSettings::insert(PersistentSettings::Names::LoggingLevel, Logging::getStringFromLogLevel(currentLoggingLevel));
+   applyCategoryFilter();
+   return;
+}
+
+QStringList Logging::getDebugCategories() {
+   return debugCategories;
+}
+
+void Logging::setDebugCategories(QStringList const & categoryNames) {
+   debugCategories = categoryNames;
+   PersistentSettings::insert(PersistentSettings::Names::LoggingDebugCategories, debugCategories);
+   applyCategoryFilter();
    return;
 }
 
 bool Logging::getLogInConfigDir() {
-   return PersistentSettings::getConfigDir().canonicalPath() == logDirectory.canonicalPath();
+   return PersistentSettings::getConfigDir().canonicalPath() == Logging::getDirectory().canonicalPath();
 }
 
 namespace Logging {
@@ -367,13 +846,27 @@ bool Logging::initializeLogging() {
    TemporarilyForceStderrLogging temporarilyForceStderrLogging;
 
    currentLoggingLevel = Logging::getLogLevelFromString(PersistentSettings::value(PersistentSettings::Names::LoggingLevel, "INFO").toString());
+   // By default, we log debug messages for all categories
+   QStringList allCategories;
+   for (auto const & categoryDetail : Logging::categoryDetails) {
+      allCategories.append(QString::fromLatin1(categoryDetail.category().categoryName()));
+   }
+   debugCategories = PersistentSettings::value(PersistentSettings::Names::LoggingDebugCategories,
+                                               allCategories).toStringList();
+   applyCategoryFilter();
    Logging::setDirectory(
       PersistentSettings::contains(PersistentSettings::Names::LogDirectory) ?
          std::optional<QDir>(PersistentSettings::value(PersistentSettings::Names::LogDirectory).toString()) : std::optional<QDir>(std::nullopt)
    );
 
+   // From here on, log messages are written out on a separate thread, so we need to make sure that, if we crash,
+   // whatever is still queued gets written out first
+   logWriter.start();
+   installCrashHandlers();
+
    qInstallMessageHandler(logMessageHandler);
-   qDebug() << Q_FUNC_INFO << "Logging initialized.  Logs will be written to" << logDirectory.canonicalPath();
+   qDebug() <<
+      Q_FUNC_INFO << "Logging initialized.  Logs will be written to" << Logging::getDirectory().canonicalPath();
 
    // It's quite useful on debug builds to check that stack trace logging is working, rather than to find out it's not
    // when you need the info to fix another bug.
@@ -393,100 +886,109 @@ void Logging::setLoggingToStderr(bool const enabled) {
 bool Logging::setDirectory(std::optional<QDir> newDirectory, Logging::PersistNewDirectory const persistNewDirectory) {
    qDebug() << Q_FUNC_INFO;
 
-   QDir oldDirectory = logDirectory;
-
    // Supplying no directory in the parameter means use the default location, ie the config directory
+   QDir const requestedDirectory = newDirectory.has_value() ? *newDirectory : PersistentSettings::getConfigDir();
    if (newDirectory.has_value()) {
-      logDirectory = *newDirectory;
-      qDebug() << Q_FUNC_INFO << "Logging to specified directory: " << logDirectory.canonicalPath();
+      qDebug() << Q_FUNC_INFO << "Logging to specified directory: " << requestedDirectory.canonicalPath();
    } else {
-      logDirectory = PersistentSettings::getConfigDir();
-      qDebug() << Q_FUNC_INFO << "Logging to configuration directory: " << logDirectory.canonicalPath();
+      qDebug() << Q_FUNC_INFO << "Logging to configuration directory: " << requestedDirectory.canonicalPath();
    }
 
    // Check if the new directory exists, if not create it.
    QString errorReason;
-   if (!logDirectory.exists()) {
-      qDebug() << Q_FUNC_INFO << logDirectory.canonicalPath() << "does not exist, creating";
-      if (!logDirectory.mkpath(logDirectory.canonicalPath())) {
+   if (!requestedDirectory.exists()) {
+      qDebug() << Q_FUNC_INFO << requestedDirectory.canonicalPath() << "does not exist, creating";
+      if (!requestedDirectory.mkpath(requestedDirectory.canonicalPath())) {
          errorReason = QObject::tr("Could not create new log file directory");
       }
    }
 
    // Check the new directory is usable
    if (errorReason.isEmpty()) {
-      if (!logDirectory.isReadable()) {
+      if (!requestedDirectory.isReadable()) {
          errorReason = QObject::tr("Could not read new log file directory");
-      } else if (!logDirectory.isReadable()) {
+      } else if (!requestedDirectory.isReadable()) {
          errorReason = QObject::tr("Could not write to new log file directory");
       }
    }
 
    if (!errorReason.isEmpty()) {
       qCritical() <<
-         errorReason << logDirectory.canonicalPath() << QObject::tr(" reverting to ") <<
-         oldDirectory.canonicalPath();
-      logDirectory = oldDirectory;
+         errorReason << requestedDirectory.canonicalPath() << QObject::tr(" reverting to ") <<
+         Logging::getDirectory().canonicalPath();
       return false;
    }
 
    // At this point, enough has succeeded that we're OK to commit to using the new directory
    if (persistNewDirectory == Logging::NewDirectoryIsPermanent) {
-      PersistentSettings::insert(PersistentSettings::Names::LogDirectory, logDirectory.absolutePath());
+      PersistentSettings::insert(PersistentSettings::Names::LogDirectory, requestedDirectory.absolutePath());
    }
 
-   //
-   // If we are already writing to a log file in the old directory, it needs to be closed and moved to the new one
-   //
-   // NB: This only moves the current Logfile, the older ones will be left behind.
-   //
-   if (stream && logDirectory.canonicalPath() != oldDirectory.canonicalPath()) {
-
-      // NB Don't try to log inside this if statement.  We are moving the log file!  Errors need to go to stderr.
+   LogFileReport openReport;
+   bool succeeded = false;
+   {
+      //
+      // The log writer thread might be about to rotate the log file, so everything from here on that touches the log
+      // file, directory or stream is done with the mutex held.  NB: This means we must not use Qt logging until it's
+      // released.  Errors need to go to stderr (or openReport).
+      //
       QMutexLocker locker(&mutex);
 
-      // Close the file if open and reset the stream.
-      closeLogFile();
+      QDir const oldDirectory = logDirectory;
+      logDirectory = requestedDirectory;
 
       //
-      // Attempt to move existing log file to the new directory, making some attempt to avoid overwriting any existing
-      // file of the same name (by moving/renaming it to have a .bak extension).
-      //
-      // Note however that some of this file moving/renaming could still fail for a couple of reasons:
-      //    - If we try to move/rename a file to overwrite a file that already exists (eg if the .bak file also already
-      //      exists) then, on some operating systems (eg Windows), the move will fail and, on others (eg Linux), it
-      //      will succeed (with the clashing file getting overwritten).
-      //    - On some operating systems, you can't move from one file system to another (eg on Windows from C: drive to
-      //      D: drive)
+      // If we are already writing to a log file in the old directory, it needs to be closed and moved to the new one
       //
-      // If things go wrong we can't really write a message to the log file(!) but we can emit something to stderr
+      // NB: This only moves the current Logfile, the older ones will be left behind.
       //
-      // The first check is whether there's anything to move!
-      //
-      QString fileName = logFileFullName();
-      if (oldDirectory.exists(fileName)) {
+      if (stream && logDirectory.canonicalPath() != oldDirectory.canonicalPath()) {
+         // Close the file if open and reset the stream.
+         closeLogFile();
+
          //
-         // Make a reasonable effort to move out the way anything we might otherwise be about to stomp on
+         // Attempt to move existing log file to the new directory, making some attempt to avoid overwriting any
+         // existing file of the same name (by moving/renaming it to have a .bak extension).
          //
-         if (logDirectory.exists(fileName)) {
-            if (!renameLogFileWithTimestamp(logDirectory)) {
+         // Note however that some of this file moving/renaming could still fail for a couple of reasons:
+         //    - If we try to move/rename a file to overwrite a file that already exists (eg if the .bak file also
+         //      already exists) then, on some operating systems (eg Windows), the move will fail and, on others (eg
+         //      Linux), it will succeed (with the clashing file getting overwritten).
+         //    - On some operating systems, you can't move from one file system to another (eg on Windows from C: drive
+         //      to D: drive)
+         //
+         // If things go wrong we can't really write a message to the log file(!) but we can emit something to stderr
+         //
+         // The first check is whether there's anything to move!
+         //
+         QString fileName = logFileFullName();
+         if (oldDirectory.exists(fileName)) {
+            //
+            // Make a reasonable effort to move out the way anything we might otherwise be about to stomp on
+            //
+            if (logDirectory.exists(fileName)) {
+               if (!renameLogFileWithTimestamp(logDirectory)) {
+                  errStream <<
+                     Q_FUNC_INFO << "Unable to rename " << fileName << " in directory " <<
+                     logDirectory.canonicalPath() << END_OF_LINE;
+                  return false;
+               }
+            }
+            if (!logFile.rename(logDirectory.filePath(fileName))) {
                errStream <<
-                  Q_FUNC_INFO << "Unable to rename " << fileName << " in directory " << logDirectory.canonicalPath() <<
-                  END_OF_LINE;
+                  Q_FUNC_INFO << "Unable to move " << fileName << " from " << oldDirectory.canonicalPath() << " to " <<
+                  logDirectory.canonicalPath() << END_OF_LINE;
                return false;
             }
          }
-         if (!logFile.rename(logDirectory.filePath(fileName))) {
-            errStream <<
-               Q_FUNC_INFO << "Unable to move " << fileName << " from " << oldDirectory.canonicalPath() << " to " <<
-               logDirectory.canonicalPath() << END_OF_LINE;
-            return false;
-         }
       }
+
+      // Now make sure the log file in the new directory is open for writing
+      succeeded = openLogFile(openReport);
    }
 
-   // Now make sure the log file in the new directory is open for writing
-   if (!openLogFile()) {
+   logReport(openReport);
+   if (!succeeded) {
       qWarning() << Q_FUNC_INFO << QString("Could not open/create a log file");
       return false;
    }
@@ -495,25 +997,25 @@ bool Logging::setDirectory(std::optional<QDir> newDirectory, Logging::PersistNew
 }
 
 QDir Logging::getDirectory() {
+   QMutexLocker locker(&mutex);
    return logDirectory;
 }
 
 
 QFileInfoList Logging::getLogFileList() {
-   QStringList filters;
-   filters << QString("%1*.%2").arg(logFilename).arg(logFilenameExtension);
-
-   //configuring the file filters to only remove the log files as the directory also contains the database.
-   QDir dir;
-   dir.setSorting(QDir::Reversed | QDir::Time);
-   dir.setFilter(QDir::Files | QDir::Hidden | QDir::NoSymLinks);
-   dir.setPath(logDirectory.canonicalPath());
-   dir.setNameFilters(filters);
-   return dir.entryInfoList();
+   QMutexLocker locker(&mutex);
+   return logFileList();
 }
 
 
+void Logging::flush() {
+   logWriter.flush();
+   return;
+}
+
 void Logging::terminateLogging() {
+   logWriter.stop();
+   removeCrashHandlers();
    QMutexLocker locker(&mutex);
    closeLogFile();
    return;
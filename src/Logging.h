@@ -26,9 +26,24 @@
 
 #include <QDir>
 #include <QFileInfoList>
+#include <QLoggingCategory>
 #include <QString>
+#include <QStringList>
 #include <QVector>
 
+//
+// Logging categories for the main parts of the code.  Use these with qCDebug() etc, eg:
+//    qCDebug(lcDatabase) << Q_FUNC_INFO << "Inserting" << object->metaObject()->className();
+// Unlike with qDebug(), if debug logging is turned off (for the category or altogether), nothing after qCDebug(...) is
+// evaluated, so there is (almost) no cost to leaving detailed debug logging in the code.
+//
+// If the code is built with the NO_DEBUG_LOGGING CMake option, debug logging is compiled out entirely.
+//
+Q_DECLARE_LOGGING_CATEGORY(lcDatabase)
+Q_DECLARE_LOGGING_CATEGORY(lcModel)
+Q_DECLARE_LOGGING_CATEGORY(lcXml)
+Q_DECLARE_LOGGING_CATEGORY(lcUi)
+
 /*!
  * \brief Provides a proxy to an OS agnostic log file.
  */
@@ -69,6 +84,16 @@ namespace Logging {
    };
    extern QVector<LevelDetail> const levelDetails;
 
+   /**
+    * \brief Info about the logging categories (declared above) so the user can choose, on the Options dialog, which
+    *        parts of the code to see debug logging from
+    */
+   struct CategoryDetail {
+      QLoggingCategory const & (*category)();
+      QString description;
+   };
+   extern QVector<CategoryDetail> const categoryDetails;
+
    /**
     * \brief Convert logging level to a string representation
     */
@@ -89,6 +114,17 @@ namespace Logging {
     */
    extern void setLogLevel(Level newLevel);
 
+   /**
+    * \brief Names of the logging categories for which debug messages are logged when the logging level is
+    *        \c LogLevel_DEBUG.  (At other logging levels, no debug messages are logged.)
+    */
+   extern QStringList getDebugCategories();
+
+   /**
+    * \brief Set which logging categories debug messages are logged for (when the logging level is \c LogLevel_DEBUG)
+    */
+   extern void setDebugCategories(QStringList const & categoryNames);
+
    /**
     * \return \b true if we are logging in the config dir (the default), \b false if we are logging in a directory
     *         configured via \c Logging::setDirectory()
@@ -140,6 +176,8 @@ namespace Logging {
    /**
     * \brief  Initialize logging to utilize the built in logging functionality in QT5
     *         This has to be called before any logging is done, but after PersistentSettings::initialise() is called.
+    *         Because log messages are written out on a separate thread, this also installs handlers for crash signals
+    *         (SIGSEGV, SIGABRT, etc) and std::terminate that write out anything still queued before the program dies.
     * \return
     */
    extern bool initializeLogging();
@@ -160,6 +198,12 @@ namespace Logging {
     */
    extern QFileInfoList getLogFileList();
 
+   /**
+    * \brief Log messages are written out on a separate thread.  This waits until everything logged so far has been
+    *        written and flushed.
+    */
+   extern void flush();
+
    /**
     * \brief Terminate logging
     */
@@ -93,6 +93,7 @@
 #include "Html.h"
 #include "HydrometerTool.h"
 #include "InventoryFormatter.h"
+#include "Logging.h"
 #include "MashDesigner.h"
 #include "MashEditor.h"
 #include "MashListModel.h"
@@ -122,6 +123,7 @@
 #include "RefractoDialog.h"
 #include "RelationalUndoableUpdate.h"
 #include "ScaleRecipeTool.h"
+#include "SqlStatisticsDialog.h"
 #include "StrikeWaterDialog.h"
 #include "StyleEditor.h"
 #include "StyleListModel.h"
@@ -131,6 +133,8 @@
 #include "UndoableAddOrRemoveList.h"
 #include "Unit.h"
 #include "utils/BtStringConst.h"
+#include "utils/ChangeDispatcher.h"
+#include "utils/StartupProfile.h"
 #include "WaterDialog.h"
 #include "WaterEditor.h"
 #include "WaterListModel.h"
@@ -174,7 +178,8 @@ public:
    impl(MainWindow & self) :
       self{self},
       fileOpener{},
-      fileOpenDirectory{QDir::homePath()} {
+      fileOpenDirectory{QDir::homePath()},
+      recipeChanges{"MainWindow"} {
       return;
    }
 
@@ -209,8 +214,8 @@ public:
          return;
       }
 
-      qDebug() << Q_FUNC_INFO << "Importing " << fileOpener.selectedFiles().length() << " files";
-      qDebug() << Q_FUNC_INFO << "Directory " << fileOpener.directory();
+      qCDebug(lcUi) << Q_FUNC_INFO << "Importing " << fileOpener.selectedFiles().length() << " files";
+      qCDebug(lcUi) << Q_FUNC_INFO << "Directory " << fileOpener.directory();
       this->fileOpenDirectory = fileOpener.directory().canonicalPath();
 
       foreach( QString filename, fileOpener.selectedFiles() ) {
@@ -218,11 +223,11 @@ public:
          // I guess if the user were importing a lot of files in one go, it might be annoying to have a separate result
          // message for each one, but TBD whether that's much of a use case.  For now, we keep things simple.
          //
-         qDebug() << Q_FUNC_INFO << "Importing " << filename;
+         qCDebug(lcUi) << Q_FUNC_INFO << "Importing " << filename;
          QString userMessage;
          QTextStream userMessageAsStream{&userMessage};
          bool succeeded = BeerXML::getInstance().importFromXML(filename, userMessageAsStream);
-         qDebug() << Q_FUNC_INFO << "Import " << (succeeded ? "succeeded" : "failed");
+         qCDebug(lcUi) << Q_FUNC_INFO << "Import " << (succeeded ? "succeeded" : "failed");
          this->importExportMsg(IMPORT, filename, succeeded, userMessage);
       }
 
@@ -282,7 +287,7 @@ public:
             }
          }
       }
-      qDebug() << Q_FUNC_INFO << "Message box text : " << messageBoxText;
+      qCDebug(lcUi) << Q_FUNC_INFO << "Message box text : " << messageBoxText;
       QMessageBox msgBox{succeeded ? QMessageBox::Information : QMessageBox::Critical,
                          messageBoxTitle,
                          messageBoxText};
@@ -294,11 +299,15 @@ private:
    MainWindow & self;
    QFileDialog* fileOpener;
    QString fileOpenDirectory;
+
+public:
+   //! \brief Collects changes to the current recipe so we only update the display once for each batch of them
+   ChangeDispatcher recipeChanges;
 };
 
 
 MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent), pimpl{std::make_unique<impl>(*this)} {
-   qDebug() << Q_FUNC_INFO;
+   qCDebug(lcUi) << Q_FUNC_INFO;
 
    undoStack = new QUndoStack(this);
 
@@ -341,16 +350,23 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent), pimpl{std::make_u
 }
 
 void MainWindow::init() {
-   qDebug() << Q_FUNC_INFO;
+   StartupProfile::Phase const phase{"MainWindow::init"};
+   qCDebug(lcUi) << Q_FUNC_INFO;
    this->setupCSS();
    // initialize all of the dialog windows
-   this->setupDialogs();
+   {
+      StartupProfile::Phase const setupDialogsPhase{"MainWindow::setupDialogs"};
+      this->setupDialogs();
+   }
    // initialize the ranged sliders
    this->setupRanges();
    // the dialogs have to be setup before this is called
    this->setupComboBoxes();
    // do all the work to configure the tables models and their proxies
-   this->setupTables();
+   {
+      StartupProfile::Phase const setupTablesPhase{"MainWindow::setupTables"};
+      this->setupTables();
+   }
    // Create the keyboard shortcuts
    this->setupShortCuts();
    // Once more with the context menus too
@@ -361,7 +377,10 @@ void MainWindow::init() {
    // This sets up things that might have been 'remembered' (ie stored in the config file) from a previous run of the
    // program - eg window size, which is stored in MainWindow::closeEvent().
    // Breaks the naming convention, doesn't it?
-   this->restoreSavedState();
+   {
+      StartupProfile::Phase const restoreSavedStatePhase{"MainWindow::restoreSavedState"};
+      this->restoreSavedState();
+   }
 
    // Connect menu item slots to triggered() signals
    this->setupTriggers();
@@ -378,9 +397,9 @@ void MainWindow::init() {
 
    // Moved from Database class
    Recipe::connectSignals();
-   qDebug() << Q_FUNC_INFO << "Recipe signals connected";
+   qCDebug(lcUi) << Q_FUNC_INFO << "Recipe signals connected";
    Mash::connectSignals();
-   qDebug() << Q_FUNC_INFO << "Mash signals connected";
+   qCDebug(lcUi) << Q_FUNC_INFO << "Mash signals connected";
 
    // I do not like this connection here.
    connect(ancestorDialog, &AncestorDialog::ancestoryChanged, treeView_recipe->model(), &BtTreeModel::versionedRecipe);
@@ -392,12 +411,14 @@ void MainWindow::init() {
    // .:TODO:. Change this so we use the newer deleted signal!
    connect(&ObjectStoreTyped<BrewNote>::getInstance(), &ObjectStoreTyped<BrewNote>::signalObjectDeleted, this, &MainWindow::closeBrewNote);
 
+   connect(&this->pimpl->recipeChanges, &ChangeDispatcher::refresh, this, &MainWindow::refreshRecipeDisplay);
+
    // Set up the pretty tool tip. It doesn't really belong anywhere, so here it is
    // .:TODO:. When we allow users to change databases without restarting, we'll need to make sure to call this whenever
    // the databae is changed (as setToolTip() just takes static text as its parameter).
    label_Brewtarget->setToolTip(getLabelToolTip());
 
-   qDebug() << Q_FUNC_INFO << "MainWindow initialisation complete";
+   qCDebug(lcUi) << Q_FUNC_INFO << "MainWindow initialisation complete";
    return;
 }
 
@@ -425,13 +446,13 @@ void MainWindow::setSizesInPixelsBasedOnDpi()
    //
    auto dpiX = this->logicalDpiX();
    auto dpiY = this->logicalDpiY();
-   qDebug() << QString("Logical DPI: %1,%2.  Physical DPI: %3,%4")
+   qCDebug(lcUi) << QString("Logical DPI: %1,%2.  Physical DPI: %3,%4")
       .arg(dpiX)
       .arg(dpiY)
       .arg(this->physicalDpiX())
       .arg(this->physicalDpiY());
    auto defaultToolBarIconSize = this->toolBar->iconSize();
-   qDebug() << QString("Default toolbar icon size: %1,%2")
+   qCDebug(lcUi) << QString("Default toolbar icon size: %1,%2")
       .arg(defaultToolBarIconSize.width())
       .arg(defaultToolBarIconSize.height());
    this->toolBar->setIconSize(QSize(dpiX/4,dpiY/4));
@@ -441,7 +462,7 @@ void MainWindow::setSizesInPixelsBasedOnDpi()
    // size as the toolbar ones.
    //
    auto defaultTabIconSize = this->tabWidget_Trees->iconSize();
-   qDebug() << QString("Default tab icon size: %1,%2")
+   qCDebug(lcUi) << QString("Default tab icon size: %1,%2")
       .arg(defaultTabIconSize.width())
       .arg(defaultTabIconSize.height());
    this->tabWidget_Trees->setIconSize(QSize(dpiX/4,dpiY/4));
@@ -456,11 +477,11 @@ void MainWindow::setSizesInPixelsBasedOnDpi()
    //
    // This is a bit more work to implement because its a PNG image in a QLabel object
    //
-   qDebug() << QString("Logo default size: %1,%2").arg(this->label_Brewtarget->width()).arg(this->label_Brewtarget->height());
+   qCDebug(lcUi) << QString("Logo default size: %1,%2").arg(this->label_Brewtarget->width()).arg(this->label_Brewtarget->height());
    this->label_Brewtarget->setScaledContents(true);
    this->label_Brewtarget->setFixedSize((265.0/66.0) * dpiX/2,  // width = 265/66 × height = 265/66 × half an inch = (265/66) × (dpiX/2)
                                         dpiY/2);                // height = half an inch = dpiY/2
-   qDebug() << QString("Logo new size: %1,%2").arg(this->label_Brewtarget->width()).arg(this->label_Brewtarget->height());
+   qCDebug(lcUi) << QString("Logo new size: %1,%2").arg(this->label_Brewtarget->width()).arg(this->label_Brewtarget->height());
 
    return;
 }
@@ -538,6 +559,7 @@ void MainWindow::setupDialogs()
    hydrometerTool = new HydrometerTool(this);
    alcoholTool = new AlcoholTool(this);
    timerMainDialog = new TimerMainDialog(this);
+   sqlStatisticsDialog = new SqlStatisticsDialog(this);
    primingDialog = new PrimingDialog(this);
    strikeWaterDialog = new StrikeWaterDialog(this);
    refractoDialog = new RefractoDialog(this);
@@ -866,6 +888,7 @@ void MainWindow::setupTriggers() {
    connect( actionRefractometer_Tools, &QAction::triggered, refractoDialog, &QWidget::show );                           // > Tools > Refractometer Tools
    connect( actionPitch_Rate_Calculator, &QAction::triggered, this, &MainWindow::showPitchDialog);                      // > Tools > Pitch Rate Calculator
    connect( actionTimers, &QAction::triggered, timerMainDialog, &QWidget::show );                                       // > Tools > Timers
+   connect( actionDatabase_Statistics, &QAction::triggered, sqlStatisticsDialog, &QWidget::show );                      // > Tools > Database Statistics
    connect( actionDeleteSelected, &QAction::triggered, this, &MainWindow::deleteSelected );
    connect( actionWater_Chemistry, &QAction::triggered, this, &MainWindow::popChemistry);                               // > Tools > Water Chemistry
    connect( actionAncestors, &QAction::triggered, this, &MainWindow::setAncestor);                                      // > Tools > Ancestors
@@ -1343,7 +1366,9 @@ void MainWindow::changed(QMetaProperty prop, QVariant val) {
       this->singleStyleEditor->setStyle(this->recStyle);
    }
 
-   this->showChanges(&prop);
+   // A single recalculation of the recipe can change a dozen properties, one after the other, so we wait until it's
+   // finished before updating the display
+   this->pimpl->recipeChanges.markDirty(propName);
    return;
 }
 
@@ -1399,17 +1424,24 @@ void MainWindow::updateColorSlider(BtStringConst const & propertyNameMin,
 }
 
 void MainWindow::showChanges(QMetaProperty* prop)
+{
+   QSet<QString> changedProperties;
+   if (prop) {
+      changedProperties.insert(prop->name());
+   } else {
+      // We're about to update everything, so there's no point doing it again for anything that's pending
+      this->pimpl->recipeChanges.discardPending();
+   }
+   this->refreshRecipeDisplay(changedProperties);
+   return;
+}
+
+void MainWindow::refreshRecipeDisplay(QSet<QString> const & changedProperties)
 {
    if( recipeObs == nullptr )
       return;
 
-   bool updateAll = (prop == nullptr);
-   QString propName;
-
-   if( prop )
-   {
-      propName = prop->name();
-   }
+   bool updateAll = changedProperties.isEmpty();
 
    // May St. Stevens preserve me
    lineEdit_name->setText(recipeObs->name());
@@ -1482,7 +1514,7 @@ void MainWindow::showChanges(QMetaProperty* prop)
 
    // See if we need to change the mash in the table.
    if( (updateAll && recipeObs->mash()) ||
-       (propName == "mash" && recipeObs->mash()) )
+       (changedProperties.contains("mash") && recipeObs->mash()) )
    {
       mashStepTableModel->setMash(recipeObs->mash());
    }
@@ -1625,12 +1657,12 @@ void MainWindow::droppedRecipeEquipment(Equipment *kit)
 // This isn't called when we think it is...!
 void MainWindow::droppedRecipeStyle(Style* style)
 {
-   qDebug() << "MainWindow::droppedRecipeStyle";
+   qCDebug(lcUi) << "MainWindow::droppedRecipeStyle";
 
    if ( ! recipeObs )
       return;
    // When the style is changed, we also need to update what is shown on the Style button
-   qDebug() << "MainWindow::droppedRecipeStyle - do or redo";
+   qCDebug(lcUi) << "MainWindow::droppedRecipeStyle - do or redo";
    this->doOrRedoUpdate(
       newRelationalUndoableUpdate(*this->recipeObs,
                                   &Recipe::setStyle,
@@ -1821,7 +1853,7 @@ void MainWindow::addYeastToRecipe(Yeast* yeast) {
 }
 
 void MainWindow::addMashStepToMash(std::shared_ptr<MashStep> mashStep) {
-   qDebug() << Q_FUNC_INFO;
+   qCDebug(lcUi) << Q_FUNC_INFO;
    //
    // Mash Steps are a bit different from most other NamedEntity objects in that they don't really have an independent
    // existence.  If you ask a Mash to remove a MashStep then it will also tell the ObjectStore to delete it, but, when
@@ -1897,8 +1929,8 @@ void MainWindow::doOrRedoUpdate(QObject & updatee,
                                 QVariant newValue,
                                 QString const & description,
                                 QUndoCommand * parent) {
-///   qDebug() << Q_FUNC_INFO << "Updating" << propertyName << "on" << updatee.metaObject()->className();
-///   qDebug() << Q_FUNC_INFO << "this=" << static_cast<void *>(this);
+///   qCDebug(lcUi) << Q_FUNC_INFO << "Updating" << propertyName << "on" << updatee.metaObject()->className();
+///   qCDebug(lcUi) << Q_FUNC_INFO << "this=" << static_cast<void *>(this);
    this->doOrRedoUpdate(new SimpleUndoableUpdate(updatee, propertyName, newValue, description));
    return;
 }
@@ -1908,7 +1940,7 @@ void MainWindow::editUndo()
 {
    Q_ASSERT(this->undoStack != 0);
    if ( !this->undoStack->canUndo() ) {
-      qDebug() << "Undo called but nothing to undo";
+      qCDebug(lcUi) << "Undo called but nothing to undo";
    } else {
       this->undoStack->undo();
    }
@@ -1921,7 +1953,7 @@ void MainWindow::editRedo()
 {
    Q_ASSERT(this->undoStack != 0);
    if ( !this->undoStack->canRedo() ) {
-      qDebug() << "Redo called but nothing to redo";
+      qCDebug(lcUi) << "Redo called but nothing to redo";
    } else {
       this->undoStack->redo();
    }
@@ -2065,7 +2097,7 @@ void MainWindow::removeSelectedFermentable()
 
    size = selected.size();
 
-   qDebug() << QString("MainWindow::removeSelectedFermentable() %1 items selected to remove").arg(size);
+   qCDebug(lcUi) << QString("MainWindow::removeSelectedFermentable() %1 items selected to remove").arg(size);
 
    if( size == 0 )
       return;
@@ -2412,10 +2444,10 @@ void MainWindow::renameFolder()
 }
 
 void MainWindow::setTreeSelection(QModelIndex item) {
-   qDebug() << Q_FUNC_INFO;
+   qCDebug(lcUi) << Q_FUNC_INFO;
 
    if (! item.isValid()) {
-      qDebug() << Q_FUNC_INFO << "Item not valid";
+      qCDebug(lcUi) << Q_FUNC_INFO << "Item not valid";
       return;
    }
 
@@ -2426,7 +2458,7 @@ void MainWindow::setTreeSelection(QModelIndex item) {
 
    // Couldn't cast the active item to a BtTreeView
    if ( active == nullptr ) {
-      qDebug() << Q_FUNC_INFO << "Couldn't cast the active item to a BtTreeView";
+      qCDebug(lcUi) << Q_FUNC_INFO << "Couldn't cast the active item to a BtTreeView";
       return;
    }
 
@@ -2573,7 +2605,7 @@ void MainWindow::backup()
    // NB: QDir does all the necessary magic of translating '/' to whatever current platform's directory separator is
    QString defaultBackupFileName = QDir::currentPath() + "/" + Database::getDefaultBackupFileName();
    QString backupFileName = QFileDialog::getSaveFileName(this, tr("Backup Database"), defaultBackupFileName);
-   qDebug() << QString("Database backup filename \"%1\"").arg(backupFileName);
+   qCDebug(lcUi) << QString("Database backup filename \"%1\"").arg(backupFileName);
 
    // If the filename returned from the dialog is empty, it means the user clicked cancel, so we should stop trying to do the backup
    if (!backupFileName.isEmpty())
@@ -2761,8 +2793,16 @@ void MainWindow::removeMash() {
    //from the database.
    //remove from db
 
+   // Removing the steps gives any previous versions of the Recipe that shared the Mash their own copy of it.  We
+   // still check nothing else uses the Mash before deleting it though.
    m->removeAllMashSteps();
-   ObjectStoreWrapper::softDelete(*m);
+   Recipe const * currentRecipe = this->recipeObs;
+   Recipe * otherUser = ObjectStoreWrapper::findFirstMatching<Recipe>(
+      [currentRecipe, m](Recipe * recipe) { return recipe != currentRecipe && recipe->uses(*m); }
+   );
+   if (otherUser == nullptr) {
+      ObjectStoreWrapper::softDelete(*m);
+   }
 
    auto defaultMash = std::make_shared<Mash>();
    ObjectStoreWrapper::insert(defaultMash);
@@ -2957,7 +2997,7 @@ void MainWindow::exportSelected() {
    bool succeeded = false;
    QModelIndexList selected = active->selectionModel()->selectedRows();
    if (selected.count() == 0) {
-      qDebug() << Q_FUNC_INFO << "Nothing selected, so nothing to export";
+      qCDebug(lcUi) << Q_FUNC_INFO << "Nothing selected, so nothing to export";
       userMessage = "Nothing selected";
       this->pimpl->importExportMsg(impl::EXPORT, filename, succeeded, userMessage);
       return;
@@ -3018,10 +3058,10 @@ void MainWindow::exportSelected() {
             ++count;
             break;
          case BtTreeItem::FOLDER:
-            qDebug() << Q_FUNC_INFO << "Can't export selected Folder to XML as BeerXML does not support it";
+            qCDebug(lcUi) << Q_FUNC_INFO << "Can't export selected Folder to XML as BeerXML does not support it";
             break;
          case BtTreeItem::BREWNOTE:
-            qDebug() << Q_FUNC_INFO << "Can't export selected BrewNote to XML as BeerXML does not support it";
+            qCDebug(lcUi) << Q_FUNC_INFO << "Can't export selected BrewNote to XML as BeerXML does not support it";
             break;
          default:
             // This shouldn't happen, because we should explicitly cover all the types above
@@ -3031,7 +3071,7 @@ void MainWindow::exportSelected() {
    }
 
    if (0 == count) {
-      qDebug() << Q_FUNC_INFO << "Nothing selected was exportable to XML";
+      qCDebug(lcUi) << Q_FUNC_INFO << "Nothing selected was exportable to XML";
       userMessage = "Nothing exportable selected";
       this->pimpl->importExportMsg(impl::EXPORT, filename, succeeded, userMessage);
       return;
@@ -35,6 +35,7 @@
 #include <QPalette>
 #include <QPrintDialog>
 #include <QPrinter>
+#include <QSet>
 #include <QString>
 #include <QTimer>
 #include <QUndoStack>
@@ -88,6 +89,7 @@ class RecipeExtrasWidget;
 class RecipeFormatter;
 class RefractoDialog;
 class ScaleRecipeTool;
+class SqlStatisticsDialog;
 class StrikeWaterDialog;
 class StyleEditor;
 class StyleListModel;
@@ -315,6 +317,14 @@ private slots:
     */
    void showChanges(QMetaProperty* prop = nullptr);
 
+   /*!
+    * \brief Does the work for \c showChanges(), and for batches of changes to the current Recipe collected in
+    *        \c MainWindow::changed()
+    *
+    * \param changedProperties Names of the Recipe properties that changed.  If empty, everything is updated.
+    */
+   void refreshRecipeDisplay(QSet<QString> const & changedProperties);
+
    //! \brief Set whether undo / redo commands are enabled
    void setUndoRedoEnable();
 
@@ -367,6 +377,7 @@ private:
    HydrometerTool* hydrometerTool;
    AlcoholTool* alcoholTool;
    TimerMainDialog* timerMainDialog;
+   SqlStatisticsDialog* sqlStatisticsDialog;
    PrimingDialog* primingDialog;
    StrikeWaterDialog* strikeWaterDialog;
    RefractoDialog* refractoDialog;
@@ -26,6 +26,7 @@
 
 #include "brewtarget.h"
 #include "database/ObjectStoreWrapper.h"
+#include "Logging.h"
 #include "model/Equipment.h"
 #include "model/Mash.h"
 #include "model/Recipe.h"
@@ -58,7 +59,7 @@ void MashEditor::saveAndClose() {
       this->mashObs = new Mash(lineEdit_name->text(), true);
       isNew = true;
    }
-   qDebug() << Q_FUNC_INFO << "Saving" << (isNew ? "new" : "existing") << "mash (#" << this->mashObs->key() << ")";
+   qCDebug(lcUi) << Q_FUNC_INFO << "Saving" << (isNew ? "new" : "existing") << "mash (#" << this->mashObs->key() << ")";
 
    mashObs->setEquipAdjust(true); // BeerXML won't like me, but it's just stupid not to adjust for the equipment when you're able.
 
@@ -118,13 +119,13 @@ void MashEditor::setRecipe(Recipe* r) {
    if (this->mashObs && this->m_equip) {
       // Only do this if we have to. Otherwise, it causes some unnecessary updates to the database.
       if (this->mashObs->tunWeight_kg() != this->m_equip->tunWeight_kg()) {
-         qDebug() <<
+         qCDebug(lcUi) <<
             Q_FUNC_INFO << "Overwriting mash tunWeight_kg (" << this->mashObs->tunWeight_kg() << ") with equipment "
             "tunWeight_kg (" << this->m_equip->tunWeight_kg() << ")";
          this->mashObs->setTunWeight_kg(this->m_equip->tunWeight_kg());
       }
       if (this->mashObs->tunSpecificHeat_calGC() != this->m_equip->tunSpecificHeat_calGC() ) {
-         qDebug() <<
+         qCDebug(lcUi) <<
             Q_FUNC_INFO << "Overwriting mash tunSpecificHeat_calGC (" << this->mashObs->tunSpecificHeat_calGC() << ") "
             "with equipment tunSpecificHeat_calGC (" << this->m_equip->tunSpecificHeat_calGC() << ")";
          this->mashObs->setTunSpecificHeat_calGC(this->m_equip->tunSpecificHeat_calGC());
@@ -159,7 +160,7 @@ void MashEditor::showChanges(QMetaProperty* prop) {
    } else {
       propName = prop->name();
    }
-   qDebug() << Q_FUNC_INFO << "Updating" << (updateAll ? "all" : "property") << propName;
+   qCDebug(lcUi) << Q_FUNC_INFO << "Updating" << (updateAll ? "all" : "property") << propName;
 
    if( propName == PropertyNames::NamedEntity::name || updateAll ) {
       lineEdit_name->setText(mashObs->name());
@@ -22,6 +22,7 @@
 #include "MashListModel.h"
 
 #include "database/ObjectStoreWrapper.h"
+#include "Logging.h"
 #include "model/Mash.h"
 #include "model/Recipe.h"
 #include "model/Style.h"
@@ -36,7 +37,7 @@ MashListModel::MashListModel(QWidget* parent) :
 }
 
 void MashListModel::addMash(int mashId) {
-   qDebug() << Q_FUNC_INFO << "New mash #" << mashId;
+   qCDebug(lcUi) << Q_FUNC_INFO << "New mash #" << mashId;
    Mash* m = ObjectStoreWrapper::getByIdRaw<Mash>(mashId);
    if (!m || !m->display() || m->deleted()) {
       return;
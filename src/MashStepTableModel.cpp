@@ -35,6 +35,7 @@
 
 #include "brewtarget.h"
 #include "database/ObjectStoreWrapper.h"
+#include "Logging.h"
 #include "MainWindow.h"
 #include "model/MashStep.h"
 #include "PersistentSettings.h"
@@ -43,6 +44,7 @@
 
 MashStepTableModel::MashStepTableModel(QTableView* parent)
    : QAbstractTableModel(parent),
+     BtTableModelBase<MashStepTableModel, MashStep>(MASHSTEPNUMCOLS),
      mashObs(nullptr),
      parentTableWidget(parent) {
    setObjectName("mashStepTableModel");
@@ -62,78 +64,47 @@ void MashStepTableModel::addMashStep(int mashStepId) {
    MashStep * mashStep = ObjectStoreWrapper::getByIdRaw<MashStep>(mashStepId);
    if (mashStep == nullptr ||
        this->mashObs == nullptr ||
-       this->steps.contains(mashStep) ||
+       this->rows.contains(mashStep) ||
        this->mashObs->key() != mashStep->getMashId()) {
       return;
    }
 
-   int size {this->steps.size()};
-   qDebug() <<
+   qCDebug(lcUi) <<
       Q_FUNC_INFO << "Instance @" << static_cast<void *>(this) << "Adding MashStep" << mashStep->name() << "(#" <<
-      mashStepId << ") to existing list of " << size << "steps for Mash #" << this->mashObs->key();
+      mashStepId << ") to existing list of " << this->rows.size() << "steps for Mash #" << this->mashObs->key();
 
-   beginInsertRows( QModelIndex(), size, size );
-   this->steps.append(mashStep);
-   connect(mashStep, &NamedEntity::changed, this, &MashStepTableModel::mashStepChanged);
-   //reset(); // Tell everybody that the table has changed.
-   endInsertRows();
+   this->add(QList<MashStep *>{mashStep});
    return;
 }
 
 void MashStepTableModel::removeMashStep(int mashStepId, std::shared_ptr<QObject> object) {
-   this->remove(std::static_pointer_cast<MashStep>(object).get());
-   return;
-}
-
-bool MashStepTableModel::remove(MashStep * mashStep) {
-
-   int i {this->steps.indexOf(mashStep)};
-   if (i >= 0) {
-      qDebug() << Q_FUNC_INFO << "Removing MashStep" << mashStep->name() << "(#" << mashStep->key() << ")";
-      beginRemoveRows( QModelIndex(), i, i );
-      disconnect( mashStep, nullptr, this, nullptr );
-      this->steps.removeAt(i);
-      //reset(); // Tell everybody the table has changed.
-      endRemoveRows();
-
-      return true;
+   MashStep * mashStep = std::static_pointer_cast<MashStep>(object).get();
+   if (this->remove(mashStep)) {
+      qCDebug(lcUi) << Q_FUNC_INFO << "Removed MashStep" << mashStep->name() << "(#" << mashStepId << ")";
    }
-
-   return false;
+   return;
 }
 
 void MashStepTableModel::setMash(Mash * m) {
-   if (this->mashObs && this->steps.size() > 0) {
-      qDebug() <<
-         Q_FUNC_INFO << "Removing" << this->steps.size() << "MashStep rows for old Mash #" << this->mashObs->key();
-      this->beginRemoveRows(QModelIndex(), 0, this->steps.size() - 1);
+   if (this->mashObs && this->rows.size() > 0) {
+      qCDebug(lcUi) <<
+         Q_FUNC_INFO << "Removing" << this->rows.size() << "MashStep rows for old Mash #" << this->mashObs->key();
       // Remove mashObs and all steps.
       disconnect( mashObs, nullptr, this, nullptr );
-      for(int i = 0; i < this->steps.size(); ++i) {
-         disconnect(this->steps[i], nullptr, this, nullptr);
-      }
-      this->steps.clear();
-      this->endRemoveRows();
+      this->removeAll();
    }
 
    this->mashObs = m;
    if (this->mashObs) {
-      qDebug() << Q_FUNC_INFO << "Now watching Mash #" << this->mashObs->key();
+      qCDebug(lcUi) << Q_FUNC_INFO << "Now watching Mash #" << this->mashObs->key();
 
       // This has to happen outside of the if{} block to make sure the mash
       // signal is connected. Otherwise, empty mashes will never be not empty.
       connect( mashObs, &Mash::mashStepsChanged, this, &MashStepTableModel::mashChanged );
 
       QList<MashStep*> tmpSteps = this->mashObs->mashSteps();
-      if (tmpSteps.size() > 0){
-         qDebug() << Q_FUNC_INFO << "Inserting" << tmpSteps.size() << "MashStep rows";
-         this->beginInsertRows(QModelIndex(), 0, tmpSteps.size() - 1);
-         this->steps = tmpSteps;
-         for (int i = 0; i < this->steps.size(); ++i ) {
-            connect(this->steps[i], &NamedEntity::changed, this, &MashStepTableModel::mashStepChanged);
-         }
-         this->endInsertRows();
-     }
+      qCDebug(lcUi) << Q_FUNC_INFO << "Inserting" << tmpSteps.size() << "MashStep rows";
+      this->add(tmpSteps);
    }
 
    if (parentTableWidget) {
@@ -154,7 +125,7 @@ void MashStepTableModel::reorderMashStep(MashStep* step, int current) {
    int destChild   = step->stepNumber();
    int doSomething = destChild - current - 1;
 
-   qDebug() << Q_FUNC_INFO << "Swapping" << destChild << "with" << current << ", so doSomething=" << doSomething;
+   qCDebug(lcUi) << Q_FUNC_INFO << "Swapping" << destChild << "with" << current << ", so doSomething=" << doSomething;
 
    // Moving a step up or down generates two signals, one for each row
    // impacted. If we move row B above row A:
@@ -178,29 +149,29 @@ void MashStepTableModel::reorderMashStep(MashStep* step, int current) {
    }
 
    // We assert that we are swapping valid locations on the list as, to do otherwise implies a coding error
-   qDebug() <<
-      Q_FUNC_INFO << "Swap" << current + doSomething << "with" << current << ", in list of " << this->steps.size();
+   qCDebug(lcUi) <<
+      Q_FUNC_INFO << "Swap" << current + doSomething << "with" << current << ", in list of " << this->rows.size();
    Q_ASSERT(current >= 0);
    Q_ASSERT(current + doSomething >= 0);
-   Q_ASSERT(current < this->steps.size());
-   Q_ASSERT(current + doSomething < this->steps.size());
+   Q_ASSERT(current < this->rows.size());
+   Q_ASSERT(current + doSomething < this->rows.size());
 
    this->beginMoveRows(QModelIndex(), current, current, QModelIndex(), destChild);
    // doSomething is -1 if moving up and 1 if moving down. swap current with
    // current -1 when moving up, and swap current with current+1 when moving
    // down
 #if QT_VERSION < QT_VERSION_CHECK(5,13,0)
-   this->steps.swap(current, current+doSomething);
+   this->rows.swap(current, current+doSomething);
 #else
-   this->steps.swapItemsAt(current, current+doSomething);
+   this->rows.swapItemsAt(current, current+doSomething);
 #endif
    this->endMoveRows();
    return;
 }
 
 MashStep* MashStepTableModel::getMashStep(unsigned int i) {
-   if ( i < static_cast<unsigned int>(this->steps.size()) ) {
-      return this->steps[static_cast<int>(i)];
+   if ( i < static_cast<unsigned int>(this->rows.size()) ) {
+      return this->rows[static_cast<int>(i)];
    }
 
    return nullptr;
@@ -212,8 +183,8 @@ void MashStepTableModel::mashChanged() {
    return;
 }
 
-void MashStepTableModel::mashStepChanged(QMetaProperty prop, QVariant val) {
-   qDebug() << Q_FUNC_INFO;
+void MashStepTableModel::changed(QMetaProperty prop, QVariant val) {
+   qCDebug(lcUi) << Q_FUNC_INFO;
 
    MashStep* stepSender = qobject_cast<MashStep*>(sender());
    if (stepSender) {
@@ -227,15 +198,15 @@ void MashStepTableModel::mashStepChanged(QMetaProperty prop, QVariant val) {
          return;
       }
 
-      int ii = this->steps.indexOf(stepSender);
-      if (ii >= 0) {
-         if (prop.name() == PropertyNames::MashStep::stepNumber) {
+      if (prop.name() == PropertyNames::MashStep::stepNumber) {
+         int ii = this->rows.indexOf(stepSender);
+         if (ii >= 0) {
             this->reorderMashStep(stepSender, ii);
          }
-
-         emit dataChanged( QAbstractItemModel::createIndex(ii, 0),
-                           QAbstractItemModel::createIndex(ii, MASHSTEPNUMCOLS-1));
       }
+
+      // Row number is worked out when dataChanged is actually emitted, so it doesn't matter if we just moved it
+      this->rowChanged(stepSender);
    }
 
    if (this->parentTableWidget) {
@@ -246,7 +217,7 @@ void MashStepTableModel::mashStepChanged(QMetaProperty prop, QVariant val) {
 }
 
 int MashStepTableModel::rowCount(const QModelIndex& /*parent*/) const {
-   return this->steps.size();
+   return this->rowCountImpl();
 }
 
 int MashStepTableModel::columnCount(const QModelIndex& /*parent*/) const
@@ -265,12 +236,12 @@ QVariant MashStepTableModel::data( const QModelIndex& index, int role ) const
       return QVariant();
 
    // Ensure the row is ok.
-   if( index.row() >= static_cast<int>(this->steps.size()) ) {
+   if( index.row() >= static_cast<int>(this->rows.size()) ) {
       qWarning() << tr("Bad model index. row = %1").arg(index.row());
       return QVariant();
    }
 
-   row = this->steps[index.row()];
+   row = this->rows[index.row()];
 
    // Make sure we only respond to the DisplayRole role.
    if( role != Qt::DisplayRole )
@@ -352,11 +323,11 @@ bool MashStepTableModel::setData( const QModelIndex& index, const QVariant& valu
       return false;
    }
 
-   if( index.row() >= static_cast<int>(this->steps.size()) || role != Qt::EditRole ) {
+   if( index.row() >= static_cast<int>(this->rows.size()) || role != Qt::EditRole ) {
       return false;
    }
 
-   MashStep *row = this->steps[index.row()];
+   MashStep *row = this->rows[index.row()];
 
    Unit::unitDisplay dspUnit = displayUnit(index.column());
    Unit::unitScale   dspScl  = displayScale(index.column());
@@ -452,20 +423,20 @@ bool MashStepTableModel::setData( const QModelIndex& index, const QVariant& valu
 }
 
 void MashStepTableModel::moveStepUp(int i) {
-   if( this->mashObs == nullptr || i == 0 || i >= this->steps.size() ) {
+   if( this->mashObs == nullptr || i == 0 || i >= this->rows.size() ) {
       return;
    }
 
-   this->mashObs->swapMashSteps(*this->steps[i], *this->steps[i-1]);
+   this->mashObs->swapMashSteps(*this->rows[i], *this->rows[i-1]);
    return;
 }
 
 void MashStepTableModel::moveStepDown(int i) {
-   if( this->mashObs == nullptr ||  i+1 >= steps.size() ) {
+   if( this->mashObs == nullptr ||  i+1 >= this->rows.size() ) {
       return;
    }
 
-   this->mashObs->swapMashSteps(*this->steps[i], *this->steps[i+1]);
+   this->mashObs->swapMashSteps(*this->rows[i], *this->rows[i+1]);
    return;
 }
 
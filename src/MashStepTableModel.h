@@ -31,6 +31,7 @@
 #include <QVector>
 #include <QWidget>
 
+#include "BtTableModelBase.h"
 #include "model/MashStep.h"
 #include "model/Mash.h"
 #include "Unit.h"
@@ -44,10 +45,12 @@ enum{ MASHSTEPNAMECOL, MASHSTEPTYPECOL, MASHSTEPAMOUNTCOL, MASHSTEPTEMPCOL, MASH
  *
  * \brief Model for the list of mash steps in a mash.
  */
-class MashStepTableModel : public QAbstractTableModel
+class MashStepTableModel : public QAbstractTableModel, public BtTableModelBase<MashStepTableModel, MashStep>
 {
    Q_OBJECT
 
+   friend class BtTableModelBase<MashStepTableModel, MashStep>;
+
 public:
    MashStepTableModel(QTableView* parent=0);
    virtual ~MashStepTableModel() = default;
@@ -79,9 +82,6 @@ public:
    void setDisplayScale(int column, Unit::unitScale displayScale);
    QString generateName(int column) const;
 
-   //! \returns true if mashStep is successfully found and removed.
-   bool remove(MashStep * MashStep);
-
 public slots:
    //! \brief Add a MashStep to the model.
    void addMashStep(int mashStep);
@@ -91,7 +91,8 @@ public slots:
    void moveStepUp(int i);
    void moveStepDown(int i);
    void mashChanged();
-   void mashStepChanged(QMetaProperty,QVariant);
+   //! \brief Catch changes to our MashSteps
+   void changed(QMetaProperty,QVariant);
 
    void contextMenu(const QPoint &point);
 
@@ -99,7 +100,6 @@ public slots:
 private:
    Mash* mashObs;
    QTableView* parentTableWidget;
-   QList<MashStep*> steps;
 
    void reorderMashStep(MashStep *step, int current);
 };
@@ -226,6 +226,9 @@ void MiscDialog::newMisc(QString folder)
 
 void MiscDialog::filterMisc(QString searchExpression)
 {
-    miscTableProxy->setFilterCaseSensitivity(Qt::CaseInsensitive);
-    miscTableProxy->setFilterFixedString(searchExpression);
+    // The filter can only see rows the model has already handed out, so make sure that's all of them
+    if (!searchExpression.isEmpty()) {
+       miscTableModel->fetchAll();
+    }
+    miscTableProxy->setSearchText(searchExpression);
 }
@@ -29,6 +29,7 @@
 #include "BtHorizontalTabs.h"
 #include "config.h"
 #include "database/ObjectStoreWrapper.h"
+#include "Logging.h"
 #include "model/Misc.h"
 #include "Unit.h"
 
@@ -69,8 +70,8 @@ void MiscEditor::save()
       return;
    }
 
-   qDebug() << Q_FUNC_INFO << comboBox_type->currentIndex();
-   qDebug() << Q_FUNC_INFO << comboBox_use->currentIndex();
+   qCDebug(lcUi) << Q_FUNC_INFO << comboBox_type->currentIndex();
+   qCDebug(lcUi) << Q_FUNC_INFO << comboBox_use->currentIndex();
 
    m->setName(lineEdit_name->text());
    m->setType( static_cast<Misc::Type>(comboBox_type->currentIndex()) );
@@ -82,7 +83,7 @@ void MiscEditor::save()
    m->setNotes( textEdit_notes->toPlainText() );
 
    if ( m->cacheOnly() ) {
-      qDebug() << Q_FUNC_INFO << "Inserting into database";
+      qCDebug(lcUi) << Q_FUNC_INFO << "Inserting into database";
       ObjectStoreWrapper::insert(*m);
       m->setCacheOnly(false);
    }
@@ -61,12 +61,15 @@ bool MiscSortFilterProxyModel::lessThan(const QModelIndex &left,
 
 bool MiscSortFilterProxyModel::filterAcceptsRow( int source_row, const QModelIndex &source_parent) const
 {
+   Q_UNUSED(source_parent)
    MiscTableModel* model = qobject_cast<MiscTableModel*>(sourceModel());
-   QModelIndex index = sourceModel()->index(source_row, 0, source_parent);
+   Misc * misc = model->getMisc(source_row);
 
-   return !filter
-          ||
-          (  sourceModel()->data(index).toString().contains(filterRegExp())
-             && model->getMisc(source_row)->display()
-          );
+   return !filter || (misc->display() && this->search.matches(*misc));
+}
+
+void MiscSortFilterProxyModel::setSearchText(QString const & searchText) {
+   this->search.setText(searchText);
+   this->invalidateFilter();
+   return;
 }
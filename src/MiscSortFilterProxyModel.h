@@ -24,6 +24,11 @@
 class MiscSortFilterProxyModel;
 
 #include <QSortFilterProxyModel>
+#include <QString>
+
+#include "database/SearchIndex.h"
+
+class Misc;
 
 /*!
  * \class MiscSortFilterProxyModel
@@ -38,6 +43,12 @@ class MiscSortFilterProxyModel : public QSortFilterProxyModel
 public:
    MiscSortFilterProxyModel(QObject *parent = 0, bool filt = true);
 
+   /**
+    * \brief Only show rows whose searchable text (see \c SearchIndex) contains \c searchText.  An empty string
+    *        shows everything.
+    */
+   void setSearchText(QString const & searchText);
+
 protected:
 
    bool lessThan(const QModelIndex &left, const QModelIndex &right) const;
@@ -45,6 +56,7 @@ protected:
 
 private:
    bool filter;
+   SearchFilter<Misc> search;
 };
 
 #endif
@@ -38,11 +38,10 @@
 
 MiscTableModel::MiscTableModel(QTableView* parent, bool editable) :
    QAbstractTableModel(parent),
+   BtTableModelBase<MiscTableModel, Misc>(MISCNUMCOLS),
    editable(editable),
    _inventoryEditable(false),
-   recObs(nullptr),
    parentTableWidget(parent) {
-   miscObs.clear();
    setObjectName("miscTableModel");
 
    QHeaderView* headerView = parentTableWidget->horizontalHeader();
@@ -56,133 +55,24 @@ MiscTableModel::MiscTableModel(QTableView* parent, bool editable) :
    return;
 }
 
-void MiscTableModel::observeRecipe(Recipe* rec)
-{
-   if( recObs )
-   {
-      disconnect( recObs, nullptr, this, nullptr );
-      removeAll();
-   }
-
-   recObs = rec;
-   if( recObs )
-   {
-      connect( recObs, &NamedEntity::changed, this, &MiscTableModel::changed );
-      addMiscs( recObs->miscs() );
-   }
-}
-
-void MiscTableModel::observeDatabase(bool val) {
-   if (val) {
-      observeRecipe(nullptr);
-      removeAll();
-      connect(&ObjectStoreTyped<Misc>::getInstance(), &ObjectStoreTyped<Misc>::signalObjectInserted,  this, &MiscTableModel::addMisc);
-      connect(&ObjectStoreTyped<Misc>::getInstance(), &ObjectStoreTyped<Misc>::signalObjectDeleted,   this, &MiscTableModel::removeMisc);
-      addMiscs( ObjectStoreTyped<Misc>::getInstance().getAllRaw() );
-   } else {
-      removeAll();
-      disconnect(&ObjectStoreTyped<Misc>::getInstance(), nullptr, this, nullptr );
-   }
-   return;
-}
-
-void MiscTableModel::addMisc(int miscId) {
-   Misc* misc = ObjectStoreWrapper::getByIdRaw<Misc>(miscId);
-
-   if( miscObs.contains(misc) ) {
-      return;
-   }
-
-   // If we are observing the database, ensure that the item is undeleted and
-   // fit to display.
-   if (recObs == nullptr &&
-      (misc->deleted() || !misc->display())) {
-      return;
-   }
-
-   // If we are watching a Recipe and the new Misc does not belong to it then there is nothing for us to do
-   if (this->recObs) {
-      Recipe * recipeOfNewMisc = misc->getOwningRecipe();
-      if (recipeOfNewMisc && this->recObs->key() != recipeOfNewMisc->key()) {
-         qDebug() <<
-            Q_FUNC_INFO << "Ignoring signal about new Misc #" << misc->key() << "as it belongs to Recipe #" <<
-            recipeOfNewMisc->key() << "and we are watching Recipe #" << this->recObs->key();
-         return;
-      }
-   }
-
-   int size = miscObs.size();
-   beginInsertRows( QModelIndex(), size, size );
-   miscObs.append(misc);
-   connect( misc, &NamedEntity::changed, this, &MiscTableModel::changed );
-   //reset(); // Tell everybody that the table has changed.
-   endInsertRows();
-   return;
+QList<Misc *> MiscTableModel::recipeItems(Recipe const & recipe) const {
+   return recipe.miscs();
 }
 
-void MiscTableModel::addMiscs(QList<Misc*> miscs)
+int MiscTableModel::rowCount(const QModelIndex& /*parent*/) const
 {
-   QList<Misc*>::iterator i;
-   QList<Misc*> tmp;
-
-   for( i = miscs.begin(); i != miscs.end(); i++ )
-   {
-      if( recObs == nullptr && ( (*i)->deleted() || !(*i)->display() ) )
-         continue;
-      if( !miscObs.contains(*i) )
-         tmp.append(*i);
-   }
-
-   int size = miscObs.size();
-   if (size+tmp.size())
-   {
-      beginInsertRows( QModelIndex(), size, size+tmp.size()-1 );
-      miscObs.append(tmp);
-
-      for( i = tmp.begin(); i != tmp.end(); i++ )
-         connect( *i, &NamedEntity::changed, this, &MiscTableModel::changed );
-
-      endInsertRows();
-   }
-}
-
-// Returns true when misc is successfully found and removed.
-void MiscTableModel::removeMisc(int miscId, std::shared_ptr<QObject> object) {
-   this->remove(std::static_pointer_cast<Misc>(object).get());
-   return;
+   return this->rowCountImpl();
 }
 
-bool MiscTableModel::remove(Misc * misc) {
-   int i = miscObs.indexOf(misc);
-   if( i >= 0 ) {
-      beginRemoveRows( QModelIndex(), i, i );
-      disconnect( misc, nullptr, this, nullptr );
-      miscObs.removeAt(i);
-      //reset(); // Tell everybody the table has changed.
-      endRemoveRows();
-
-      return true;
-   }
-
-   return false;
-}
-
-void MiscTableModel::removeAll()
+bool MiscTableModel::canFetchMore(const QModelIndex& parent) const
 {
-   if (miscObs.size())
-   {
-      beginRemoveRows( QModelIndex(), 0, miscObs.size()-1 );
-      while( !miscObs.isEmpty() )
-      {
-         disconnect( miscObs.takeLast(), nullptr, this, nullptr );
-      }
-      endRemoveRows();
-   }
+   return this->canFetchMoreImpl(parent);
 }
 
-int MiscTableModel::rowCount(const QModelIndex& /*parent*/) const
+void MiscTableModel::fetchMore(const QModelIndex& parent)
 {
-   return miscObs.size();
+   this->fetchMoreImpl(parent);
+   return;
 }
 
 int MiscTableModel::columnCount(const QModelIndex& /*parent*/) const
@@ -193,17 +83,16 @@ int MiscTableModel::columnCount(const QModelIndex& /*parent*/) const
 QVariant MiscTableModel::data( const QModelIndex& index, int role ) const
 {
    Misc* row;
-   Unit::unitDisplay unit;
-   Unit::unitScale scale;
+   int col = index.column();
 
    // Ensure the row is ok.
-   if( index.row() >= static_cast<int>(miscObs.size() ))
+   if( index.row() >= static_cast<int>(this->rows.size() ))
    {
       qWarning() << QString("Bad model index. row = %1").arg(index.row());
       return QVariant();
    }
    else
-      row = miscObs[index.row()];
+      row = this->rows[index.row()];
 
    // Deal with the column and return the right data.
    switch( index.column() )
@@ -231,21 +120,23 @@ QVariant MiscTableModel::data( const QModelIndex& index, int role ) const
          if( role != Qt::DisplayRole )
             return QVariant();
 
-         scale = displayScale(MISCTIMECOL);
-
-         return QVariant( Brewtarget::displayAmount(row->time(), &Units::minutes, 3, Unit::noUnit, scale) );
+         return QVariant(this->formattedValueCache.get(row, col, [this, row]() {
+            return Brewtarget::displayAmount(row->time(), &Units::minutes, 3, Unit::noUnit, displayScale(MISCTIMECOL));
+         }));
       case MISCINVENTORYCOL:
          if( role != Qt::DisplayRole )
             return QVariant();
 
-         unit = displayUnit(index.column());
-         return QVariant( Brewtarget::displayAmount(row->inventory(), row->amountIsWeight()? &Units::kilograms : &Units::liters, 3, unit, Unit::noScale ) );
+         return QVariant(this->formattedValueCache.get(row, col, [this, row, col]() {
+            return Brewtarget::displayAmount(row->inventory(), row->amountIsWeight()? &Units::kilograms : &Units::liters, 3, displayUnit(col), Unit::noScale);
+         }));
       case MISCAMOUNTCOL:
          if( role != Qt::DisplayRole )
             return QVariant();
 
-         unit = displayUnit(index.column());
-         return QVariant( Brewtarget::displayAmount(row->amount(), row->amountIsWeight()? &Units::kilograms : &Units::liters, 3, unit, Unit::noScale ) );
+         return QVariant(this->formattedValueCache.get(row, col, [this, row, col]() {
+            return Brewtarget::displayAmount(row->amount(), row->amountIsWeight()? &Units::kilograms : &Units::liters, 3, displayUnit(col), Unit::noScale);
+         }));
 
       case MISCISWEIGHT:
          if( role == Qt::DisplayRole )
@@ -309,10 +200,10 @@ bool MiscTableModel::setData( const QModelIndex& index, const QVariant& value, i
    int col;
    Unit const * unit;
 
-   if( index.row() >= static_cast<int>(miscObs.size()) )
+   if( index.row() >= static_cast<int>(this->rows.size()) )
       return false;
    else
-      row = miscObs[index.row()];
+      row = this->rows[index.row()];
 
    col = index.column();
    unit = row->amountIsWeight() ? &Units::kilograms: &Units::liters;
@@ -395,11 +286,12 @@ bool MiscTableModel::setData( const QModelIndex& index, const QVariant& value, i
 
 void MiscTableModel::changedInventory(int invKey, BtStringConst const & propertyName) {
    if (propertyName == PropertyNames::Inventory::amount) {
-      for( int i = 0; i < miscObs.size(); ++i ) {
-         Misc* holdmybeer = miscObs.at(i);
+      for( int i = 0; i < this->rows.size(); ++i ) {
+         Misc* holdmybeer = this->rows.at(i);
 
          if ( invKey == holdmybeer->inventoryId() ) {
             // No need to update amount as it's only stored in one place (the inventory object) now
+            this->formattedValueCache.invalidateCell(holdmybeer, MISCINVENTORYCOL);
             emit dataChanged( QAbstractItemModel::createIndex(i,MISCINVENTORYCOL),
                               QAbstractItemModel::createIndex(i,MISCINVENTORYCOL) );
          }
@@ -412,21 +304,16 @@ void MiscTableModel::changed(QMetaProperty prop, QVariant /*val*/) {
    Misc* miscSender = qobject_cast<Misc*>(sender());
    if( miscSender )
    {
-      int i = miscObs.indexOf(miscSender);
-      if( i < 0 )
-         return;
-
-      emit dataChanged( QAbstractItemModel::createIndex(i, 0),
-                        QAbstractItemModel::createIndex(i, MISCNUMCOLS-1) );
+      this->rowChanged(miscSender);
       return;
    }
 
    // See if sender is our recipe.
    Recipe* recSender = qobject_cast<Recipe*>(sender());
-   if( recSender && recSender == recObs ) {
+   if( recSender && recSender == this->recObs ) {
       if( QString(prop.name()) == PropertyNames::Recipe::miscIds ) {
-         removeAll();
-         addMiscs( recObs->miscs() );
+         this->removeAll();
+         this->add( this->recObs->miscs() );
       }
       if( rowCount() > 0 ) {
          emit headerDataChanged( Qt::Vertical, 0, rowCount()-1 );
@@ -439,7 +326,7 @@ void MiscTableModel::changed(QMetaProperty prop, QVariant /*val*/) {
 
 Misc* MiscTableModel::getMisc(unsigned int i)
 {
-   return miscObs[static_cast<int>(i)];
+   return this->rows[static_cast<int>(i)];
 }
 
 Unit::unitDisplay MiscTableModel::displayUnit(int column) const
@@ -476,6 +363,11 @@ void MiscTableModel::setDisplayUnit(int column, Unit::unitDisplay displayUnit)
    PersistentSettings::insert(attribute,displayUnit,this->objectName(),PersistentSettings::UNIT);
    PersistentSettings::insert(attribute,Unit::noScale,this->objectName(),PersistentSettings::SCALE);
 
+   this->formattedValueCache.invalidateColumn(column);
+   if (this->rowCount() > 0) {
+      emit dataChanged(this->index(0, column), this->index(this->rowCount() - 1, column));
+   }
+
 }
 
 // Setting the scale should clear any cell-level scaling options
@@ -488,6 +380,11 @@ void MiscTableModel::setDisplayScale(int column, Unit::unitScale displayScale)
 
    PersistentSettings::insert(attribute,displayScale,this->objectName(),PersistentSettings::SCALE);
 
+   this->formattedValueCache.invalidateColumn(column);
+   if (this->rowCount() > 0) {
+      emit dataChanged(this->index(0, column), this->index(this->rowCount() - 1, column));
+   }
+
 }
 
 QString MiscTableModel::generateName(int column) const
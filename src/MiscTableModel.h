@@ -38,11 +38,12 @@
 
 #include "Unit.h"
 #include "brewtarget.h"
+#include "BtTableModelBase.h"
+#include "model/Misc.h"
 
 // Forward declarations.
 class BtStringConst;
 class MiscItemDelegate;
-class Misc;
 class MiscTableWidget;
 class Recipe;
 
@@ -53,22 +54,16 @@ enum{MISCNAMECOL, MISCTYPECOL, MISCUSECOL, MISCTIMECOL, MISCAMOUNTCOL, MISCINVEN
  *
  * \brief Table model for a list of miscs.
  */
-class MiscTableModel : public QAbstractTableModel {
+class MiscTableModel : public QAbstractTableModel, public BtTableModelBase<MiscTableModel, Misc> {
    Q_OBJECT
 
+   friend class BtTableModelBase<MiscTableModel, Misc>;
+
 public:
    MiscTableModel(QTableView* parent=nullptr, bool editable=true);
    virtual ~MiscTableModel() {}
-   //! \brief Observe a recipe's list of miscs.
-   void observeRecipe(Recipe* rec);
-   //! \brief If true, we model the database's list of miscs.
-   void observeDatabase(bool val);
-   //! \brief Add \c miscs to the model.
-   void addMiscs(QList<Misc*> miscs);
    //! \returns the \c Misc at model index \b i.
    Misc* getMisc(unsigned int i);
-   //! \brief Clear the model.
-   void removeAll();
 
    /*!
     * \brief True if the inventory column should be editable, false otherwise.
@@ -82,6 +77,10 @@ public:
    //! \brief Reimplemented from QAbstractTableModel
    virtual int columnCount(const QModelIndex& parent = QModelIndex()) const;
    //! \brief Reimplemented from QAbstractTableModel
+   virtual bool canFetchMore(const QModelIndex& parent) const;
+   //! \brief Reimplemented from QAbstractTableModel
+   virtual void fetchMore(const QModelIndex& parent);
+   //! \brief Reimplemented from QAbstractTableModel
    virtual QVariant data( const QModelIndex& index, int role = Qt::DisplayRole ) const;
    //! \brief Reimplemented from QAbstractTableModel
    virtual QVariant headerData( int section, Qt::Orientation orientation, int role = Qt::DisplayRole ) const;
@@ -95,14 +94,8 @@ public:
    void setDisplayUnit(int column, Unit::unitDisplay displayUnit);
    void setDisplayScale(int column, Unit::unitScale displayScale);
    QString generateName(int column) const;
-   bool remove(Misc * misc);
 
 public slots:
-   //! \brief Add a misc to the model.
-   void addMisc(int miscId);
-   //! \brief Remove a misc from the model.
-   void removeMisc(int miscId, std::shared_ptr<QObject> object);
-
    void contextMenu(const QPoint &point);
 
 private slots:
@@ -111,10 +104,11 @@ private slots:
    void changedInventory(int invKey, BtStringConst const & propertyName);
 
 private:
+   //! \brief Used by \c BtTableModelBase::observeRecipe()
+   QList<Misc *> recipeItems(Recipe const & recipe) const;
+
    bool editable;
    bool _inventoryEditable;
-   QList<Misc*> miscObs;
-   Recipe* recObs;
    QTableView* parentTableWidget;
 };
 
@@ -25,6 +25,7 @@
 
 #include "brewtarget.h"
 #include "database/ObjectStoreWrapper.h"
+#include "Logging.h"
 #include "model/Equipment.h"
 #include "model/Mash.h"
 #include "model/Recipe.h"
@@ -94,7 +95,7 @@ void NamedMashEditor::saveAndClose() {
       return;
    }
 
-   qDebug() << Q_FUNC_INFO << "Saving mash (#" << this->mashObs->key() << ")";
+   qCDebug(lcUi) << Q_FUNC_INFO << "Saving mash (#" << this->mashObs->key() << ")";
 
    // using toSI aon the spargePh is something of a cheat, but the btLineEdit
    // class will do the right thing. That is how a plan comes together.
@@ -147,7 +148,7 @@ void NamedMashEditor::showChanges(QMetaProperty* prop) {
    } else {
       propName = prop->name();
    }
-   qDebug() << Q_FUNC_INFO << "Updating" << (updateAll ? "all" : "property") << propName;
+   qCDebug(lcUi) << Q_FUNC_INFO << "Updating" << (updateAll ? "all" : "property") << propName;
 
    if( propName == PropertyNames::NamedEntity::name || updateAll ) {
       lineEdit_name->setText(mashObs->name());
@@ -29,8 +29,10 @@
 #include <QIcon>
 #include <QMap>
 #include <QMessageBox>
+#include <QProgressDialog>
 #include <QSizePolicy>
 #include <QString>
+#include <QStringList>
 #include <QVector>
 #include <QWidget>
 
@@ -42,6 +44,7 @@
 #include "PersistentSettings.h"
 #include "Unit.h"
 #include "UnitSystem.h"
+#include "utils/FormattedValueCache.h"
 
 //
 // Anonymous namespace for constants, global variables and functions used only in this file
@@ -232,7 +235,7 @@ public:
     * Determine which set of DB config params to show, based on whether PostgresSQL or SQLite is selected
     */
    void setDbDialog(OptionDialog & optionDialog, Database::DbType db) {
-      qDebug() << Q_FUNC_INFO << "Set " << (db == Database::PGSQL ? "PostgresSQL" : "SQLite") << " config params visible";
+      qCDebug(lcUi) << Q_FUNC_INFO << "Set " << (db == Database::PGSQL ? "PostgresSQL" : "SQLite") << " config params visible";
       optionDialog.groupBox_dbConfig->setVisible(false);
 
       this->clearLayout(optionDialog);
@@ -484,6 +487,9 @@ public:
 
    QVector<LanguageInfo> languageInfo;
 
+   // One per entry in Logging::categoryDetails, in the same order.  (Owned by groupBox_debugLogging.)
+   QVector<QCheckBox *> debugCategoryCheckBoxes;
+
 };
 
 OptionDialog::OptionDialog(QWidget * parent) : QDialog{},
@@ -571,6 +577,16 @@ void OptionDialog::configure_logging() {
    checkBox_LogFileLocationUseDefault->setChecked(Logging::getLogInConfigDir());
    lineEdit_LogFileLocation->setText(Logging::getDirectory().absolutePath());
    this->setFileLocationState(Logging::getLogInConfigDir());
+
+   // Detailed logging can be turned on and off for each part of the code, but only matters at the "Detailed" level
+   QStringList const debugCategories = Logging::getDebugCategories();
+   for (auto const & categoryDetail : Logging::categoryDetails) {
+      QCheckBox * checkBox = new QCheckBox(categoryDetail.description, groupBox_debugLogging);
+      checkBox->setChecked(debugCategories.contains(QString::fromLatin1(categoryDetail.category().categoryName())));
+      verticalLayout_debugLogging->addWidget(checkBox);
+      this->pimpl->debugCategoryCheckBoxes.append(checkBox);
+   }
+   groupBox_debugLogging->setEnabled(Logging::getLogLevel() == Logging::LogLevel_DEBUG);
    return;
 }
 
@@ -590,6 +606,10 @@ void OptionDialog::connect_signals() {
    // Set the signals
    connect(&this->pimpl->checkBox_savePgPassword, &QAbstractButton::clicked, this, &OptionDialog::savePassword);
    connect(this->checkBox_LogFileLocationUseDefault, &QAbstractButton::clicked, this, &OptionDialog::setFileLocationState);
+   connect(loggingLevelComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this](int index) {
+      Q_UNUSED(index)
+      groupBox_debugLogging->setEnabled(loggingLevelComboBox->currentData().toInt() == Logging::LogLevel_DEBUG);
+   });
 
    connect(&this->pimpl->input_pgHostname, &QLineEdit::editingFinished, this, &OptionDialog::testRequired);
    connect(&this->pimpl->input_pgPortNum,  &QLineEdit::editingFinished, this, &OptionDialog::testRequired);
@@ -778,6 +798,9 @@ void OptionDialog::saveAndClose() {
    // Set the right language.
    Brewtarget::setLanguage(this->comboBox_lang->currentData().toString());
 
+   // Default units and language feed into every amount shown in the ingredient tables
+   FormattedValueCache::invalidateAll();
+
    setVisible(false);
 }
 
@@ -810,6 +833,13 @@ void OptionDialog::saveFormulae() {
 void OptionDialog::saveLoggingSettings() {
    // Saving Logging Options to the Log object
    Logging::setLogLevel(static_cast<Logging::Level>(loggingLevelComboBox->currentData().toInt()));
+   QStringList debugCategories;
+   for (int ii = 0; ii < Logging::categoryDetails.size(); ++ii) {
+      if (this->pimpl->debugCategoryCheckBoxes.at(ii)->isChecked()) {
+         debugCategories.append(QString::fromLatin1(Logging::categoryDetails.at(ii).category().categoryName()));
+      }
+   }
+   Logging::setDebugCategories(debugCategories);
    Logging::setDirectory(
       checkBox_LogFileLocationUseDefault->isChecked() ?
       std::optional<QDir>(std::nullopt) : std::optional<QDir>(lineEdit_LogFileLocation->text())
@@ -880,12 +910,22 @@ bool OptionDialog::transferDatabase() {
       QString theQuestion =
          tr("Would you like Brewtarget to transfer your data to the new database? NOTE: If you've already loaded the data, say No");
       if (QMessageBox::Yes == QMessageBox::question(this, tr("Transfer database"), theQuestion)) {
+         // The copy can't be cancelled part-way through, so there is no cancel button
+         QProgressDialog progressDialog{tr("Transferring data..."), QString(), 0, 0, this};
+         progressDialog.setWindowTitle(tr("Transfer database"));
+         progressDialog.setWindowModality(Qt::WindowModal);
+         progressDialog.setMinimumDuration(0);
+         progressDialog.setValue(0);
          Database::instance().convertDatabase(this->pimpl->input_pgHostname.text(),
                                               this->pimpl->input_pgDbName.text(),
                                               this->pimpl->input_pgUsername.text(),
                                               this->pimpl->input_pgPassword.text(),
                                               this->pimpl->input_pgPortNum.text().toInt(),
-                                              static_cast<Database::DbType>(this->comboBox_engine->currentData().toInt()));
+                                              static_cast<Database::DbType>(this->comboBox_engine->currentData().toInt()),
+                                              [&progressDialog](int objectsCopied, int totalObjects) {
+                                                 progressDialog.setMaximum(totalObjects);
+                                                 progressDialog.setValue(objectsCopied);
+                                              });
       }
       // Database engine stuff
       int engine = comboBox_engine->currentData().toInt();
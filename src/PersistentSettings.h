@@ -44,10 +44,12 @@
 AddSettingName(check_version)
 AddSettingName(color_formula)
 AddSettingName(color_unit)
+AddSettingName(compactDbAtStartup)
 AddSettingName(config_version)
 AddSettingName(converted)
 AddSettingName(count)                            // backups section
 AddSettingName(date_format)
+AddSettingName(dbCompactionBackup)
 AddSettingName(dbHostname)
 AddSettingName(dbName)
 AddSettingName(dbPassword)
@@ -67,16 +69,21 @@ AddSettingName(ibu_formula)
 AddSettingName(language)
 AddSettingName(last_db_merge_req)
 AddSettingName(LogDirectory)
+AddSettingName(LoggingDebugCategories)
 AddSettingName(LoggingLevel)
 AddSettingName(mashHopAdjustment)
 AddSettingName(mashStepTableWidget_headerState)  // MainWindow section
 AddSettingName(maximum)                          // backups section
 AddSettingName(productionDate)
 AddSettingName(recipeKey)
+AddSettingName(sessionsSinceDbAnalyze)
+AddSettingName(sessionsSinceDbVacuum)
 AddSettingName(showsnapshots)
 AddSettingName(splitter_horizontal_State)        // MainWindow section
 AddSettingName(splitter_vertical_State)          // MainWindow section
+AddSettingName(sqlStatisticsLogAtExit)
 AddSettingName(temperature_scale)
+AddSettingName(tracingEnabled)
 AddSettingName(treeView_equip_headerState)       // MainWindow section
 AddSettingName(treeView_ferm_headerState)        // MainWindow section
 AddSettingName(treeView_hops_headerState)        // MainWindow section
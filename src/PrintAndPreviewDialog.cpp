@@ -28,15 +28,18 @@
 #include <QSizePolicy>
 #include <QStandardPaths>
 #include <QTextBrowser>
+#include <QTextStream>
 
 #include "InventoryFormatter.h"
+#include "Logging.h"
 
 /**
  * @brief Construct a new Print And Preview Dialog:: Print And Preview Dialog object
  *
  * @param parent
  */
-PrintAndPreviewDialog::PrintAndPreviewDialog(MainWindow * parent) : QDialog(parent) {
+PrintAndPreviewDialog::PrintAndPreviewDialog(MainWindow * parent) : QDialog(parent),
+                                                                   previewChanges{"PrintAndPreviewDialog"} {
    setupUi(this);
 
    mainWindow = parent;
@@ -151,7 +154,7 @@ void PrintAndPreviewDialog::collectSupportedPageSizes()
    }
    else if (radioButton_OutputPDF->isChecked())
    {
-      qDebug() << "generating a list of page sizes as there is no printer intalled on the system";
+      qCDebug(lcUi) << "generating a list of page sizes as there is no printer intalled on the system";
       supportedPageSizeList = generatePageSizeList();
    }
    foreach(QPageSize pageSize, supportedPageSizeList)
@@ -226,6 +229,10 @@ void PrintAndPreviewDialog::setupConnections() {
    connect(checkBox_inventoryYeast,         &QCheckBox::toggled,         this, &PrintAndPreviewDialog::checkBoxInventoryIngredient_toggle);
 
    connect(verticalTabWidget,               &QTabWidget::currentChanged, this, &PrintAndPreviewDialog::verticalTabWidget_currentChanged);
+
+   // Several of the above can fire in one go (eg checkBoxInventoryAll_toggle() changes four other checkboxes), so
+   // updatePreview() just asks for a refresh and we do it once they've all been handled
+   connect(&previewChanges,                 &ChangeDispatcher::refresh,  this, &PrintAndPreviewDialog::refreshPreview);
 }
 
 /**
@@ -298,6 +305,9 @@ void PrintAndPreviewDialog::verticalTabWidget_currentChanged(int index)
  *
  */
 void PrintAndPreviewDialog::handlePrinting() {
+   // Make sure we're not about to print or save something from before the latest change of options
+   this->previewChanges.flush();
+
    //make it short if we are printing to paper.
    if (radioButton_OutputPaper->isChecked())
    {
@@ -313,7 +323,7 @@ void PrintAndPreviewDialog::handlePrinting() {
          QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation),
          fileDialogFilter
          );
-      qDebug() << Q_FUNC_INFO << "Filename to save: " << filename;
+      qCDebug(lcUi) << Q_FUNC_INFO << "Filename to save: " << filename;
       if (radioButton_OutputPDF->isChecked())
       {
          printer->setOutputFormat(QPrinter::PdfFormat);
@@ -342,34 +352,40 @@ void PrintAndPreviewDialog::handlePrinting() {
 }
 
 /**
- * @brief updates the current view with the changed data. depanding on selected output.
+ * @brief Asks for the current view to be updated on the next turn of the event loop.
  *
- * @param checked
  */
 void PrintAndPreviewDialog::updatePreview() {
+   this->previewChanges.markDirty("preview");
+   return;
+}
+
+/**
+ * @brief updates the current view with the changed data. depanding on selected output.
+ *
+ * @param changes
+ */
+void PrintAndPreviewDialog::refreshPreview(QSet<QString> const & changes) {
+   Q_UNUSED(changes)
    if ( ! radioButton_OutputHTML->isChecked()) {
       previewWidget->updatePreview();
    } else {
-      QString pDoc = "";
+      QString pDoc;
+      QTextStream out{&pDoc};
 
       if (verticalTabWidget->currentIndex() == 0) {
          bool chkRec = checkBox_Recipe->isChecked();
          bool chkBDI = checkBox_BrewdayInstructions->isChecked();
          if (chkRec) {
-            pDoc = recipeFormatter->getHtmlFormat();
+            out << recipeFormatter->getHtmlFormat();
          }
          if ( chkBDI && !chkRec ) {
-            pDoc += brewDayFormatter->buildHtml();
+            out << brewDayFormatter->buildHtml();
          }
       } else if (verticalTabWidget->currentIndex() == 1) {
-         InventoryFormatter::HtmlGenerationFlags flags  = static_cast<InventoryFormatter::HtmlGenerationFlags>(
-            checkBox_inventoryFermentables->isChecked() * InventoryFormatter::FERMENTABLES   +
-            checkBox_inventoryHops->isChecked()         * InventoryFormatter::HOPS           +
-            checkBox_inventoryYeast->isChecked()        * InventoryFormatter::YEAST          +
-            checkBox_inventoryMicellaneous->isChecked() * InventoryFormatter::MISCELLANEOUS
-         );
-         pDoc = InventoryFormatter::createInventoryHtml(flags);
+         out << InventoryFormatter::createInventoryHtml(this->inventoryFlags());
       }
+      out.flush();
       // adding the generated HTML to the QTexBrowser.
       htmlDocument->setHtml(pDoc);
    }
@@ -389,6 +405,15 @@ void PrintAndPreviewDialog::updatePreview() {
    return;
 }
 
+InventoryFormatter::HtmlGenerationFlags PrintAndPreviewDialog::inventoryFlags() const {
+   return static_cast<InventoryFormatter::HtmlGenerationFlags>(
+      checkBox_inventoryFermentables->isChecked() * InventoryFormatter::FERMENTABLES   +
+      checkBox_inventoryHops->isChecked()         * InventoryFormatter::HOPS           +
+      checkBox_inventoryYeast->isChecked()        * InventoryFormatter::YEAST          +
+      checkBox_inventoryMicellaneous->isChecked() * InventoryFormatter::MISCELLANEOUS
+   );
+}
+
 /**
  * @brief Closes the Dialog
  *
@@ -515,7 +540,8 @@ void PrintAndPreviewDialog::printDocument(QPrinter * printer) {
    recipeFormatter->setRecipe(mainWindow->currentRecipe());
    //Setting up a blank page for drawing.
    QTextBrowser textBrowser;
-   QString hDoc = "";
+   QString hDoc;
+   QTextStream out{&hDoc};
    //if we are watching the Recipe tab we should print recipe stuff.
    if (Ui_BtPrintAndPreview::verticalTabWidget->currentIndex() == 0)
    {
@@ -524,27 +550,22 @@ void PrintAndPreviewDialog::printDocument(QPrinter * printer) {
       making the template editor for printouts where you can save your templates and use them or share them
       with other BT users.
       */
-      hDoc += recipeFormatter->buildHtmlHeader();
+      out << recipeFormatter->buildHtmlHeader();
       if ( checkBox_Recipe->isChecked())
       {
-         hDoc += recipeFormatter->getHtmlFormat();
+         out << recipeFormatter->getHtmlFormat();
       }
       if (checkBox_BrewdayInstructions->isChecked())
       {
-         hDoc += brewDayFormatter->buildInstructionHtml();
+         out << brewDayFormatter->buildInstructionHtml();
       }
-      hDoc += recipeFormatter->buildHtmlFooter();
+      out << recipeFormatter->buildHtmlFooter();
    }
    else if (verticalTabWidget->currentIndex() == 1)
    {
-      InventoryFormatter::HtmlGenerationFlags flags = static_cast<InventoryFormatter::HtmlGenerationFlags>(
-         checkBox_inventoryFermentables->isChecked() * InventoryFormatter::FERMENTABLES   +
-         checkBox_inventoryHops->isChecked()         * InventoryFormatter::HOPS           +
-         checkBox_inventoryYeast->isChecked()        * InventoryFormatter::YEAST          +
-         checkBox_inventoryMicellaneous->isChecked() * InventoryFormatter::MISCELLANEOUS
-      );
-      hDoc += InventoryFormatter::createInventoryHtml(flags);
+      out << InventoryFormatter::createInventoryHtml(this->inventoryFlags());
    }
+   out.flush();
 
    //Render the Page onto the painter/printer for preview/printing.
    textBrowser.setHtml(hDoc);
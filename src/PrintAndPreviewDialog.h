@@ -26,14 +26,17 @@
 #include <QPageSize>
 #include <QPrinter>
 #include <QPrintPreviewWidget>
+#include <QSet>
 #include <QString>
 #include <QTextBrowser>
 #include <QWidget>
 
 #include "BrewDayFormatter.h"
+#include "InventoryFormatter.h"
 #include "MainWindow.h"
 #include "model/Recipe.h"
 #include "RecipeFormatter.h"
+#include "utils/ChangeDispatcher.h"
 
 
 /*!
@@ -124,10 +127,21 @@ private:
    void handlePrinting();
 
    /**
-    * @brief Updates the preview to the currently set options.
+    * @brief Asks for the preview to be updated to the currently set options.  The update happens on the next turn of
+    *        the event loop, so several calls in a row only result in one update.
     */
    void updatePreview();
 
+   /**
+    * @brief Updates the preview to the currently set options.  Called from \c previewChanges.
+    */
+   void refreshPreview(QSet<QString> const & changes);
+
+   /**
+    * @brief Which inventory sections are ticked
+    */
+   InventoryFormatter::HtmlGenerationFlags inventoryFlags() const;
+
    QPrintPreviewWidget* previewWidget;
    RecipeFormatter* recipeFormatter;
    BrewDayFormatter* brewDayFormatter;
@@ -137,6 +151,7 @@ private:
    QMap<QString, QPageSize> PageSizeMap;
    QTextBrowser *htmlDocument;
    QPageSize currentlySelectedPageSize;
+   ChangeDispatcher previewChanges;
 
 };
 #endif
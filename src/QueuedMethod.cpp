@@ -23,6 +23,8 @@
 #include <QDebug>
 #include <QThread>
 
+#include "Logging.h"
+
 QList< QSharedPointer<QueuedMethod> > QueuedMethod::_queue;
 
 QueuedMethod::QueuedMethod(
@@ -46,8 +48,8 @@ QueuedMethod::QueuedMethod(
 
 QueuedMethod::~QueuedMethod()
 {
-   qDebug() << "~QueuedMethod()";
-   qDebug() << "   thread=" << QThread::currentThread();
+   qCDebug(lcUi) << "~QueuedMethod()";
+   qCDebug(lcUi) << "   thread=" << QThread::currentThread();
 }
 
 void QueuedMethod::run()
@@ -69,7 +71,7 @@ void QueuedMethod::executeFunction()
                 //QGenericReturnArgument(_retName, _retData),
                 QGenericArgument(_arg0Name, _arg0Data)
              );
-   //qDebug() << _methodName << ": " << success;
+   //qCDebug(lcUi) << _methodName << ": " << success;
    
    emit done(success);
    
@@ -89,7 +91,7 @@ void QueuedMethod::enqueue( QSharedPointer<QueuedMethod> qm )
 
 void QueuedMethod::dequeueMyself()
 {
-   //qDebug() << "Dequeueing: " << this;
+   //qCDebug(lcUi) << "Dequeueing: " << this;
    
    // First, find a shared-pointer that has internal pointer equal to 'this'
    QList< QSharedPointer<QueuedMethod> >::iterator i = _queue.begin();
@@ -110,7 +112,7 @@ QSharedPointer<QueuedMethod> QueuedMethod::chainWith( QSharedPointer<QueuedMetho
 
 void QueuedMethod::startChained()
 {
-   //qDebug() << "startChained(): " << this << _chainedMethod;
+   //qCDebug(lcUi) << "startChained(): " << this << _chainedMethod;
    if( _chainedMethod )
       _chainedMethod->start();
    
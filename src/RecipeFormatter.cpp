@@ -22,6 +22,7 @@
 
 #include <QClipboard>
 #include <QDebug>
+#include <QHash>
 #include <QHBoxLayout>
 #include <QObject>
 #include <QPrintDialog>
@@ -29,6 +30,7 @@
 #include <QPushButton>
 #include <QStringList>
 #include <QTextDocument>
+#include <QTextStream>
 #include <QVBoxLayout>
 
 #include "brewtarget.h"
@@ -47,6 +49,7 @@
 #include "model/Yeast.h"
 #include "PersistentSettings.h"
 #include "Unit.h"
+#include "utils/FormattedValueCache.h"
 
 namespace {
    //! Get the maximum number of characters in a list of strings.
@@ -144,7 +147,8 @@ public:
     * Constructor
     */
    impl() : textSeparator{nullptr},
-            rec{nullptr} {
+            rec{nullptr},
+            sectionsCache{} {
       return;
    }
 
@@ -211,22 +215,63 @@ public:
 
    //! Get an HTML view.
    QString getHtmlFormat() {
-      QString pDoc = this->buildHtmlHeader();
-      pDoc += this->buildStatTableHtml();
-      pDoc += this->buildFermentableTableHtml();
-      pDoc += this->buildHopsTableHtml();
-      pDoc += this->buildMiscTableHtml();
-      pDoc += this->buildYeastTableHtml();
-      pDoc += this->buildMashTableHtml();
-      pDoc += this->buildNotesHtml();
-      pDoc += this->buildInstructionTableHtml();
-      pDoc += this->buildBrewNotesHtml();
-
-      pDoc += this->buildHtmlFooter();
-
+      QString pDoc;
+      QTextStream out{&pDoc};
+      out << this->buildHtmlHeader();
+      this->writeRecipeHtml(out, true);
+      out << this->buildHtmlFooter();
+      out.flush();
       return pDoc;
    }
 
+   /**
+    * \brief Write the HTML for the current recipe (without header and footer) to \c out
+    *
+    * \param includeInstructions whether to include the instructions table
+    */
+   void writeRecipeHtml(QTextStream & out, bool includeInstructions) {
+      out << this->cachedSectionsHtml();
+      if (includeInstructions) {
+         out << this->buildInstructionTableHtml();
+      }
+      out << this->buildBrewNotesHtml();
+      return;
+   }
+
+   /**
+    * \brief Returns the HTML for the stats, ingredients, mash and notes of the current recipe, which only needs to be
+    *        regenerated when the recipe (or the display units) change.
+    *
+    *        Instructions and brew notes don't reliably tell the recipe when they change, so we don't cache those.
+    */
+   QString cachedSectionsHtml() {
+      if (this->rec == nullptr) {
+         return "";
+      }
+
+      unsigned int const changeStamp = this->rec->changeStamp();
+      unsigned int const displayGeneration = FormattedValueCache::currentGeneration();
+      auto cached = this->sectionsCache.constFind(this->rec);
+      if (cached != this->sectionsCache.cend() &&
+          cached->changeStamp == changeStamp &&
+          cached->displayGeneration == displayGeneration) {
+         return cached->html;
+      }
+
+      QString html;
+      QTextStream out{&html};
+      out << this->buildStatTableHtml()
+          << this->buildFermentableTableHtml()
+          << this->buildHopsTableHtml()
+          << this->buildMiscTableHtml()
+          << this->buildYeastTableHtml()
+          << this->buildMashTableHtml()
+          << this->buildNotesHtml();
+      out.flush();
+      this->sectionsCache.insert(this->rec, CachedHtml{changeStamp, displayGeneration, html});
+      return html;
+   }
+
    QString getTextSeparator() {
       if (this->textSeparator.get() != nullptr) {
          return *this->textSeparator;
@@ -1034,6 +1079,14 @@ public:
    std::unique_ptr<QString> textSeparator;
    Recipe* rec;
 
+   struct CachedHtml {
+      unsigned int changeStamp;
+      unsigned int displayGeneration;
+      QString html;
+   };
+   //! Because Recipe::changeStamp() values are never reused, it doesn't matter if a Recipe is deleted and another
+   //  one created at the same address
+   QHash<Recipe const *, CachedHtml> sectionsCache;
 };
 
 
@@ -1057,47 +1110,37 @@ void RecipeFormatter::setRecipe(Recipe* recipe) {
 QString RecipeFormatter::getHtmlFormat( QList<Recipe*> recipes ) {
    Recipe *current = this->pimpl->rec;
 
-   QString hDoc = this->pimpl->buildHtmlHeader();
+   QString hDoc;
+   QTextStream out{&hDoc};
+   out << this->pimpl->buildHtmlHeader();
 
    // build a toc -- why do I do this to myself?
-   hDoc += "<ul>";
-   foreach ( Recipe* foo, recipes ) {
-       hDoc += QString("<li><a href=\"#%1\">%1</a></li>").arg(foo->name());
+   out << "<ul>";
+   for (Recipe * foo : recipes) {
+      out << QString("<li><a href=\"#%1\">%1</a></li>").arg(foo->name());
    }
-   hDoc += "</ul>";
+   out << "</ul>";
 
-   foreach (Recipe* foo, recipes) {
+   for (Recipe * foo : recipes) {
       this->pimpl->rec = foo;
-      hDoc += QString("<a name=\"%1\"></a>").arg(foo->name());
-      hDoc += this->pimpl->buildStatTableHtml();
-      hDoc += this->pimpl->buildFermentableTableHtml();
-      hDoc += this->pimpl->buildHopsTableHtml();
-      hDoc += this->pimpl->buildMiscTableHtml();
-      hDoc += this->pimpl->buildYeastTableHtml();
-      hDoc += this->pimpl->buildMashTableHtml();
-      hDoc += this->pimpl->buildNotesHtml();
-      hDoc += this->pimpl->buildInstructionTableHtml();
-      hDoc += this->pimpl->buildBrewNotesHtml();
-      hDoc += "<p></p>";
+      out << QString("<a name=\"%1\"></a>").arg(foo->name());
+      this->pimpl->writeRecipeHtml(out, true);
+      out << "<p></p>";
    }
-   hDoc += this->pimpl->buildHtmlFooter();
+   out << this->pimpl->buildHtmlFooter();
+   out.flush();
 
    this->pimpl->rec = current;
    return hDoc;
 }
 
 QString RecipeFormatter::getHtmlFormat() {
-   QString pDoc = this->pimpl->buildHtmlHeader();
-   pDoc += this->pimpl->buildStatTableHtml();
-   pDoc += this->pimpl->buildFermentableTableHtml();
-   pDoc += this->pimpl->buildHopsTableHtml();
-   pDoc += this->pimpl->buildMiscTableHtml();
-   pDoc += this->pimpl->buildYeastTableHtml();
-   pDoc += this->pimpl->buildMashTableHtml();
-   pDoc += this->pimpl->buildNotesHtml();
-   pDoc += this->pimpl->buildBrewNotesHtml();
-   pDoc += this->pimpl->buildHtmlFooter();
-
+   QString pDoc;
+   QTextStream out{&pDoc};
+   out << this->pimpl->buildHtmlHeader();
+   this->pimpl->writeRecipeHtml(out, false);
+   out << this->pimpl->buildHtmlFooter();
+   out.flush();
    return pDoc;
 }
 
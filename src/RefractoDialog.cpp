@@ -23,6 +23,7 @@
 #include "RefractoDialog.h"
 #include "Algorithms.h"
 #include "brewtarget.h"
+#include "Logging.h"
 #include <cmath>
 #include <QMessageBox>
 
@@ -77,7 +78,7 @@ void RefractoDialog::calculate()
       lineEdit_op->setText(inputOG);
    }
    else if( (!haveOP) && (!haveOG) ) {
-      qDebug() << Q_FUNC_INFO << "no plato or og";
+      qCDebug(lcUi) << Q_FUNC_INFO << "no plato or og";
       return; // Can't do much if we don't have OG or OP.
    }
 
@@ -65,10 +65,10 @@ static QStringList saltNames = QStringList() << QObject::tr("None")
 
 SaltTableModel::SaltTableModel(QTableView* parent)
    : QAbstractTableModel(parent),
+     BtTableModelBase<SaltTableModel, Salt>(SALTNUMCOLS, true),
      m_rec(nullptr),
      parentTableWidget(parent)
 {
-   saltObs.clear();
    setObjectName("saltTable");
 
    QHeaderView* headerView = parentTableWidget->horizontalHeader();
@@ -82,7 +82,7 @@ SaltTableModel::SaltTableModel(QTableView* parent)
 
 SaltTableModel::~SaltTableModel()
 {
-   saltObs.clear();
+   this->rows.clear();
 }
 
 void SaltTableModel::observeRecipe(Recipe* rec)
@@ -107,42 +107,18 @@ void SaltTableModel::observeRecipe(Recipe* rec)
 
 void SaltTableModel::addSalt(Salt* salt)
 {
-   if( saltObs.contains(salt) ) {
-      return;
-   }
-
-   beginInsertRows( QModelIndex(), saltObs.size(), saltObs.size() );
-   saltObs.append(salt);
-   connect( salt, &NamedEntity::changed, this, &SaltTableModel::changed );
-   endInsertRows();
-
-   if (parentTableWidget) {
-      parentTableWidget->resizeColumnsToContents();
-      parentTableWidget->resizeRowsToContents();
-   }
+   this->add(QList<Salt*>{salt});
+   this->resizeToContents();
 }
 
 void SaltTableModel::addSalts(QList<Salt*> salts)
 {
-   QList<Salt*> tmp;
-
-   foreach (Salt* i, salts) {
-      if( !saltObs.contains(i) )
-         tmp.append(i);
-   }
-
-   int size = saltObs.size();
-   if (size+tmp.size()) {
-      beginInsertRows( QModelIndex(), size, size+tmp.size()-1 );
-      saltObs.append(tmp);
-      endInsertRows();
-
-      foreach (Salt* i, tmp) {
-         connect( i, &NamedEntity::changed, this, &SaltTableModel::changed );
-      }
-
-   }
+   this->add(salts);
+   this->resizeToContents();
+}
 
+void SaltTableModel::resizeToContents()
+{
    if( parentTableWidget ) {
       parentTableWidget->resizeColumnsToContents();
       parentTableWidget->resizeRowsToContents();
@@ -180,7 +156,7 @@ double SaltTableModel::multiplier(Salt *s) const
 double SaltTableModel::total_Ca() const
 {
    double ret = 0.0;
-   foreach(Salt* i, saltObs) {
+   foreach(Salt* i, this->rows) {
       double mult  = multiplier(i);
       ret += mult * i->Ca();
    }
@@ -190,7 +166,7 @@ double SaltTableModel::total_Ca() const
 double SaltTableModel::total_Cl() const
 {
    double ret = 0.0;
-   foreach(Salt* i, saltObs) {
+   foreach(Salt* i, this->rows) {
       double mult  = multiplier(i);
       ret += mult * i->Cl();
    }
@@ -201,7 +177,7 @@ double SaltTableModel::total_Cl() const
 double SaltTableModel::total_CO3() const
 {
    double ret = 0.0;
-   foreach(Salt* i, saltObs) {
+   foreach(Salt* i, this->rows) {
       double mult  = multiplier(i);
       ret += mult * i->CO3();
    }
@@ -212,7 +188,7 @@ double SaltTableModel::total_CO3() const
 double SaltTableModel::total_HCO3() const
 {
    double ret = 0.0;
-   foreach(Salt* i, saltObs) {
+   foreach(Salt* i, this->rows) {
       double mult  = multiplier(i);
       ret += mult * i->HCO3();
    }
@@ -223,7 +199,7 @@ double SaltTableModel::total_HCO3() const
 double SaltTableModel::total_Mg() const
 {
    double ret = 0.0;
-   foreach(Salt* i, saltObs) {
+   foreach(Salt* i, this->rows) {
       double mult  = multiplier(i);
       ret += mult * i->Mg();
    }
@@ -234,7 +210,7 @@ double SaltTableModel::total_Mg() const
 double SaltTableModel::total_Na() const
 {
    double ret = 0.0;
-   foreach(Salt* i, saltObs) {
+   foreach(Salt* i, this->rows) {
       double mult  = multiplier(i);
       ret += mult * i->Na();
    }
@@ -245,7 +221,7 @@ double SaltTableModel::total_Na() const
 double SaltTableModel::total_SO4() const
 {
    double ret = 0.0;
-   foreach(Salt* i, saltObs) {
+   foreach(Salt* i, this->rows) {
       double mult  = multiplier(i);
       ret += mult * i->SO4();
    }
@@ -271,7 +247,7 @@ double SaltTableModel::total(Salt::Types type) const
 {
    double ret = 0.0;
    if (type != Salt::NONE) {
-      foreach(Salt* i, saltObs) {
+      foreach(Salt* i, this->rows) {
          if ( i->type() == type && i->addTo() != Salt::NEVER) {
             double mult  = multiplier(i);
             ret += mult * i->amount();
@@ -288,7 +264,7 @@ double SaltTableModel::totalAcidWeight(Salt::Types type) const
 
    double ret = 0.0;
    if (type != Salt::NONE) {
-      foreach(Salt* i, saltObs) {
+      foreach(Salt* i, this->rows) {
          if ( i->type() == type && i->addTo() != Salt::NEVER) {
             double mult  = multiplier(i);
             // Acid malts are easy
@@ -314,20 +290,8 @@ double SaltTableModel::totalAcidWeight(Salt::Types type) const
 
 void SaltTableModel::removeSalt(Salt* salt)
 {
-   int i;
-
-   i = saltObs.indexOf(salt);
-
-   if( i >= 0 ) {
-      beginRemoveRows( QModelIndex(), i, i );
-      disconnect( salt, nullptr, this, nullptr );
-      saltObs.removeAt(i);
-      endRemoveRows();
-
-      if(parentTableWidget) {
-         parentTableWidget->resizeColumnsToContents();
-         parentTableWidget->resizeRowsToContents();
-      }
+   if( this->remove(salt) ) {
+      this->resizeToContents();
    }
    emit newTotals();
 }
@@ -338,51 +302,30 @@ void SaltTableModel::removeSalts(QList<int>deadSalts) {
    // I am removing the salts so the index of any salt
    // will change. I think this will work
    for (int i : deadSalts) {
-      dead.append( saltObs.at(i));
+      dead.append( this->rows.at(i));
    }
 
+   // Take all the rows out in one go, rather than one at a time
+   this->remove(dead);
+
    for(Salt * zombie : dead) {
-      int i = saltObs.indexOf(zombie);
-
-      if ( i >= 0 ) {
-         beginRemoveRows( QModelIndex(), i, i );
-         disconnect( zombie, nullptr, this, nullptr );
-         saltObs.removeAt(i);
-         endRemoveRows();
-
-         // Dead salts do not malinger in the database. This will
-         // delete the thing, not just mark it deleted
-         if ( ! zombie->cacheOnly() ) {
-            this->m_rec->remove(ObjectStoreWrapper::getSharedFromRaw(zombie));
-            ObjectStoreWrapper::hardDelete(*zombie);
-         }
+      // Dead salts do not malinger in the database. This will
+      // delete the thing, not just mark it deleted
+      if ( ! zombie->cacheOnly() ) {
+         this->m_rec->remove(ObjectStoreWrapper::getSharedFromRaw(zombie));
+         ObjectStoreWrapper::hardDelete(*zombie);
       }
    }
    emit newTotals();
    return;
 }
 
-void SaltTableModel::removeAll()
-{
-   beginRemoveRows( QModelIndex(), 0, saltObs.size()-1 );
-   while( !saltObs.isEmpty() ) {
-      disconnect( saltObs.takeLast(), nullptr, this, nullptr );
-   }
-   endRemoveRows();
-}
-
 void SaltTableModel::changed(QMetaProperty prop, QVariant /*val*/)
 {
-   int i;
-
    // Find the notifier in the list
    Salt* saltSender = qobject_cast<Salt*>(sender());
    if( saltSender ) {
-      i = saltObs.indexOf(saltSender);
-      if( i >= 0 )
-         emit dataChanged( QAbstractItemModel::createIndex(i, 0),
-                           QAbstractItemModel::createIndex(i, SALTNUMCOLS-1));
-         emit headerDataChanged( Qt::Vertical, i, i);
+      this->rowChanged(saltSender);
       return;
    }
 
@@ -391,7 +334,7 @@ void SaltTableModel::changed(QMetaProperty prop, QVariant /*val*/)
    if( recSender && recSender == m_rec )
    {
       if( QString(prop.name()) == "salts" ) {
-         removeAll();
+         this->removeAll();
          addSalts( m_rec->salts() );
       }
       if( rowCount() > 0 )
@@ -401,7 +344,7 @@ void SaltTableModel::changed(QMetaProperty prop, QVariant /*val*/)
 
 int SaltTableModel::rowCount(const QModelIndex& /*parent*/) const
 {
-   return saltObs.size();
+   return this->rowCountImpl();
 }
 
 int SaltTableModel::columnCount(const QModelIndex& /*parent*/) const
@@ -416,12 +359,12 @@ QVariant SaltTableModel::data( const QModelIndex& index, int role ) const
    Unit::unitDisplay unit;
 
    // Ensure the row is ok.
-   if( index.row() >= static_cast<int>(saltObs.size()) ) {
+   if( index.row() >= static_cast<int>(this->rows.size()) ) {
       qWarning() << tr("Bad model index. row = %1").arg(index.row());
       return QVariant();
    }
    else
-      row = saltObs[index.row()];
+      row = this->rows[index.row()];
 
    Unit const * rightUnit = row->amountIsWeight() ? &Units::kilograms: &Units::liters;
    switch( index.column() ) {
@@ -480,10 +423,10 @@ QVariant SaltTableModel::headerData( int section, Qt::Orientation orientation, i
 Qt::ItemFlags SaltTableModel::flags(const QModelIndex& index ) const
 {
    // Q_UNUSED(index)
-   if( index.row() >= saltObs.size() )
+   if( index.row() >= this->rows.size() )
       return Qt::ItemIsSelectable | Qt::ItemIsEditable | Qt::ItemIsDragEnabled | Qt::ItemIsEnabled;
 
-   Salt* row = saltObs[index.row()];
+   Salt* row = this->rows[index.row()];
 
    if ( !row->isAcid() && index.column() == SALTPCTACIDCOL )  {
       return Qt::NoItemFlags;
@@ -496,11 +439,11 @@ bool SaltTableModel::setData( const QModelIndex& index, const QVariant& value, i
    Salt *row;
    bool retval = false;
 
-   if( index.row() >= saltObs.size() || role != Qt::EditRole ) {
+   if( index.row() >= this->rows.size() || role != Qt::EditRole ) {
       return false;
    }
 
-   row = saltObs[index.row()];
+   row = this->rows[index.row()];
 
    Unit const * unit = row->amountIsWeight() ? &Units::kilograms: &Units::liters;
    Unit::unitDisplay dspUnit = displayUnit(index.column());
@@ -655,7 +598,7 @@ void SaltTableModel::contextMenu(const QPoint &point)
 void SaltTableModel::saveAndClose() {
    // all of the writes should have been instantaneous unless
    // we've added a new salt. Wonder if this will work?
-   for (Salt* i : saltObs) {
+   for (Salt* i : this->rows) {
       if ( i->cacheOnly() && i->type() != Salt::NONE && i->addTo() != Salt::NEVER ) {
          std::shared_ptr<Salt> salt{i};
          ObjectStoreWrapper::insert(salt);
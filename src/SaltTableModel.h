@@ -30,6 +30,7 @@
 #include <QVariant>
 #include <QWidget>
 
+#include "BtTableModelBase.h"
 #include "model/Salt.h"
 #include "model/Water.h"
 
@@ -51,17 +52,18 @@ enum{ SALTNAMECOL,
  *
  * \brief Table model for salts.
  */
-class SaltTableModel : public QAbstractTableModel
+class SaltTableModel : public QAbstractTableModel, public BtTableModelBase<SaltTableModel, Salt>
 {
    Q_OBJECT
 
+   friend class BtTableModelBase<SaltTableModel, Salt>;
+
 public:
    SaltTableModel(QTableView* parent=nullptr);
    ~SaltTableModel();
    void observeRecipe(Recipe* rec);
    void addSalt(Salt* salt);
    void addSalts(QList<Salt*> salts);
-   void removeAll();
 
    //! Reimplemented from QAbstractTableModel.
    virtual int rowCount(const QModelIndex& parent = QModelIndex()) const;
@@ -101,7 +103,8 @@ signals:
    void newTotals();
 
 private:
-   QList<Salt*> saltObs;
+   void resizeToContents();
+
    Recipe* m_rec;
    QTableView* parentTableWidget;
    double spargePct;
@@ -23,6 +23,7 @@
 //#include <sstream>      // std::ostringstream
 
 #include "brewtarget.h" // For logging
+#include "Logging.h"
 
 SimpleUndoableUpdate::SimpleUndoableUpdate(QObject & updatee,
                                            BtStringConst const & propertyName,
@@ -35,7 +36,7 @@ SimpleUndoableUpdate::SimpleUndoableUpdate(QObject & updatee,
 // Uncomment this block if the assert below is tripping, as it will usually help find the bug quickly
 //   std::ostringstream stacktrace;
 //   stacktrace << boost::stacktrace::stacktrace();
-//   qDebug().noquote() << Q_FUNC_INFO << this->propertyName << " " << QString::fromStdString(stacktrace.str());
+//   qCDebug(lcUi).noquote() << Q_FUNC_INFO << this->propertyName << " " << QString::fromStdString(stacktrace.str());
    Q_ASSERT(this->oldValue.isValid() && "Trying to update non-existent property");
 
    this->setText(description);
@@ -0,0 +1,206 @@
+/*
+ * SqlStatisticsDialog.cpp is part of Brewtarget, and is Copyright the following
+ * authors 2021
+ * - Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "SqlStatisticsDialog.h"
+
+#include <cmath>
+
+#include <QHeaderView>
+
+#include "database/BtSqlQuery.h"
+#include "PersistentSettings.h"
+
+namespace {
+   enum Column {
+      Executions,
+      TotalTime,
+      MeanTime,
+      MaxTime,
+      Rows,
+      Query,
+      NumColumns
+   };
+
+   double toMilliseconds(std::chrono::nanoseconds duration) {
+      return std::chrono::duration<double, std::milli>(duration).count();
+   }
+
+   /**
+    * \brief Numbers are stored as numbers (rather than text) so that sorting by column works properly
+    */
+   QTableWidgetItem * makeItem(QVariant const & value) {
+      auto item = new QTableWidgetItem;
+      item->setData(Qt::DisplayRole, value);
+      item->setFlags(Qt::ItemIsSelectable | Qt::ItemIsEnabled);
+      if (value.type() != QVariant::String) {
+         item->setTextAlignment(Qt::AlignRight | Qt::AlignVCenter);
+      }
+      return item;
+   }
+
+   double roundedMilliseconds(std::chrono::nanoseconds duration) {
+      return std::round(toMilliseconds(duration) * 100.0) / 100.0;
+   }
+}
+
+SqlStatisticsDialog::SqlStatisticsDialog(QWidget* parent) : QDialog(parent),
+                                                            label_summary     {new QLabel      (this)},
+                                                            tableWidget       {new QTableWidget(this)},
+                                                            checkBox_logAtExit{new QCheckBox   (this)},
+                                                            checkBox_compactAtStartup{new QCheckBox   (this)},
+                                                            pushButton_refresh{new QPushButton (this)},
+                                                            pushButton_reset  {new QPushButton (this)},
+                                                            pushButton_close  {new QPushButton (this)},
+                                                            hLayout           {new QHBoxLayout },
+                                                            vLayout           {new QVBoxLayout (this)} {
+   this->doLayout();
+   this->checkBox_logAtExit->setChecked(
+      PersistentSettings::value(PersistentSettings::Names::sqlStatisticsLogAtExit, false).toBool()
+   );
+   this->checkBox_compactAtStartup->setChecked(
+      PersistentSettings::value(PersistentSettings::Names::compactDbAtStartup, false).toBool()
+   );
+   connect(this->pushButton_refresh, &QAbstractButton::clicked, this, &SqlStatisticsDialog::refresh);
+   connect(this->pushButton_reset,   &QAbstractButton::clicked, this, &SqlStatisticsDialog::reset);
+   connect(this->pushButton_close,   &QAbstractButton::clicked, this, &QDialog::close);
+   connect(this->checkBox_logAtExit, &QAbstractButton::toggled, this, &SqlStatisticsDialog::setLogAtExit);
+   connect(this->checkBox_compactAtStartup,
+           &QAbstractButton::toggled,
+           this,
+           &SqlStatisticsDialog::setCompactAtStartup);
+   return;
+}
+
+SqlStatisticsDialog::~SqlStatisticsDialog() = default;
+
+void SqlStatisticsDialog::doLayout() {
+   this->resize(900, 500);
+
+   this->tableWidget->setColumnCount(NumColumns);
+   this->tableWidget->setSortingEnabled(true);
+   this->tableWidget->setSelectionBehavior(QAbstractItemView::SelectRows);
+   this->tableWidget->verticalHeader()->setVisible(false);
+   this->tableWidget->horizontalHeader()->setStretchLastSection(true);
+
+   this->pushButton_refresh->setAutoDefault(false);
+   this->pushButton_reset->setAutoDefault(false);
+   this->pushButton_close->setDefault(true);
+
+   this->hLayout->addWidget(this->checkBox_logAtExit);
+   this->hLayout->addWidget(this->checkBox_compactAtStartup);
+   this->hLayout->addStretch();
+   this->hLayout->addWidget(this->pushButton_refresh);
+   this->hLayout->addWidget(this->pushButton_reset);
+   this->hLayout->addWidget(this->pushButton_close);
+
+   this->vLayout->addWidget(this->label_summary);
+   this->vLayout->addWidget(this->tableWidget);
+   this->vLayout->addLayout(this->hLayout);
+
+   this->retranslateUi();
+   return;
+}
+
+void SqlStatisticsDialog::retranslateUi() {
+   this->setWindowTitle(tr("Database Statistics"));
+   this->tableWidget->setHorizontalHeaderLabels(
+      {tr("Executions"), tr("Total (ms)"), tr("Mean (ms)"), tr("Max (ms)"), tr("Rows"), tr("Query")}
+   );
+   this->checkBox_logAtExit->setText(tr("Write to log on exit"));
+   this->checkBox_compactAtStartup->setText(tr("Delete unused records at startup"));
+   this->pushButton_refresh->setText(tr("Refresh"));
+   this->pushButton_reset->setText(tr("Reset"));
+   this->pushButton_close->setText(tr("Close"));
+
+#ifndef QT_NO_TOOLTIP
+   this->tableWidget->setToolTip(
+      tr("Queries that differ only in their literal values are counted together.  Rows are those returned or changed.")
+   );
+   this->pushButton_reset->setToolTip(tr("Zero all the statistics"));
+   this->checkBox_compactAtStartup->setToolTip(
+      tr("Permanently delete deleted and orphaned records when the program starts, and periodically shrink the "
+         "database file.  A backup of the database is taken before the first time this is done.")
+   );
+#endif // QT_NO_TOOLTIP
+   return;
+}
+
+void SqlStatisticsDialog::refresh() {
+   QVector<BtSqlQuery::Statistics> const statistics = BtSqlQuery::getStatistics();
+
+   // Turn sorting off while we fill the table, otherwise rows move around under us
+   this->tableWidget->setSortingEnabled(false);
+   this->tableWidget->setRowCount(statistics.size());
+   long long totalExecutions = 0;
+   std::chrono::nanoseconds totalTime{0};
+   int row = 0;
+   for (auto const & entry : statistics) {
+      totalExecutions += entry.executions;
+      totalTime += entry.totalTime;
+      this->tableWidget->setItem(row, Executions, makeItem(entry.executions));
+      this->tableWidget->setItem(row, TotalTime,  makeItem(roundedMilliseconds(entry.totalTime)));
+      this->tableWidget->setItem(row, MeanTime,   makeItem(roundedMilliseconds(entry.totalTime / entry.executions)));
+      this->tableWidget->setItem(row, MaxTime,    makeItem(roundedMilliseconds(entry.maxTime)));
+      this->tableWidget->setItem(row, Rows,       makeItem(entry.rows));
+      auto queryItem = makeItem(entry.query);
+      queryItem->setToolTip(entry.query);
+      this->tableWidget->setItem(row, Query, queryItem);
+      ++row;
+   }
+   this->tableWidget->setSortingEnabled(true);
+   this->tableWidget->sortByColumn(TotalTime, Qt::DescendingOrder);
+   this->tableWidget->resizeColumnsToContents();
+
+   this->label_summary->setText(
+      tr("%1 distinct queries, %2 executions, %3 ms in total")
+         .arg(statistics.size())
+         .arg(totalExecutions)
+         .arg(toMilliseconds(totalTime), 0, 'f', 1)
+   );
+   return;
+}
+
+void SqlStatisticsDialog::reset() {
+   BtSqlQuery::resetStatistics();
+   this->refresh();
+   return;
+}
+
+void SqlStatisticsDialog::setLogAtExit(bool logAtExit) {
+   PersistentSettings::insert(PersistentSettings::Names::sqlStatisticsLogAtExit, logAtExit);
+   return;
+}
+
+void SqlStatisticsDialog::setCompactAtStartup(bool compactAtStartup) {
+   PersistentSettings::insert(PersistentSettings::Names::compactDbAtStartup, compactAtStartup);
+   return;
+}
+
+void SqlStatisticsDialog::changeEvent(QEvent* event) {
+   if (event->type() == QEvent::LanguageChange) {
+      this->retranslateUi();
+   }
+   QDialog::changeEvent(event);
+   return;
+}
+
+void SqlStatisticsDialog::showEvent(QShowEvent* event) {
+   this->refresh();
+   QDialog::showEvent(event);
+   return;
+}
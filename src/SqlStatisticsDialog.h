@@ -0,0 +1,74 @@
+/*
+ * SqlStatisticsDialog.h is part of Brewtarget, and is Copyright the following
+ * authors 2021
+ * - Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef SQLSTATISTICSDIALOG_H
+#define SQLSTATISTICSDIALOG_H
+#pragma once
+
+#include <QCheckBox>
+#include <QDialog>
+#include <QEvent>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QPushButton>
+#include <QShowEvent>
+#include <QTableWidget>
+#include <QVBoxLayout>
+#include <QWidget>
+
+/*!
+ * \brief Diagnostics dialog showing, for each database query, how often it has run and how long it took (as recorded
+ *        by \c BtSqlQuery).  Mostly of interest to developers and to users reporting performance problems.  Also where
+ *        the user can turn on compaction of the database at startup (see \c Compaction).
+ */
+class SqlStatisticsDialog : public QDialog {
+   Q_OBJECT
+
+public:
+   SqlStatisticsDialog(QWidget* parent = nullptr);
+   virtual ~SqlStatisticsDialog();
+
+public slots:
+   //! \brief Re-read the statistics into the table
+   void refresh();
+   //! \brief Zero the statistics, eg before doing something whose database use you want to measure
+   void reset();
+   void setLogAtExit(bool logAtExit);
+   //! \brief Turn on or off hard-deleting unused records at startup (see \c Compaction::start())
+   void setCompactAtStartup(bool compactAtStartup);
+
+protected:
+   virtual void changeEvent(QEvent* event);
+   virtual void showEvent(QShowEvent* event);
+
+private:
+   QLabel       * label_summary;
+   QTableWidget * tableWidget;
+   QCheckBox    * checkBox_logAtExit;
+   QCheckBox    * checkBox_compactAtStartup;
+   QPushButton  * pushButton_refresh;
+   QPushButton  * pushButton_reset;
+   QPushButton  * pushButton_close;
+   QHBoxLayout  * hLayout;
+   QVBoxLayout  * vLayout;
+
+   void doLayout();
+   void retranslateUi();
+};
+
+#endif
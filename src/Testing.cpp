@@ -21,6 +21,7 @@
 #include "Testing.h"
 
 #include <exception>
+#include <functional>
 #include <iostream> // For std::cout
 #include <math.h>
 #include <memory>
@@ -29,6 +30,9 @@
 
 #include <QDebug>
 #include <QDir>
+#include <QFile>
+#include <QMap>
+#include <QSqlDatabase>
 #include <QString>
 #include <QtTest/QtTest>
 #if QT_VERSION < QT_VERSION_CHECK(5,10,0)
@@ -37,15 +41,23 @@
 #include <QRandomGenerator>
 #endif
 
+#include "database/BtSqlQuery.h"
+#include "database/Compaction.h"
+#include "database/Database.h"
+#include "database/DatabaseSchemaHelper.h"
+#include "database/ObjectStoreSnapshot.h"
 #include "database/ObjectStoreWrapper.h"
+#include "database/SearchIndex.h"
 #include "Logging.h"
 #include "model/Equipment.h"
 #include "model/Fermentable.h"
 #include "model/Hop.h"
+#include "model/Instruction.h"
 #include "model/Mash.h"
 #include "model/MashStep.h"
 #include "model/Recipe.h"
 #include "PersistentSettings.h"
+#include "utils/ChangeDispatcher.h"
 
 namespace {
 
@@ -84,6 +96,40 @@ namespace {
       return randSTR;
    }
 
+   //! \brief Summary of the things a Recipe can share with its other versions, for checking one hasn't changed
+   QStringList describeSharedContents(Recipe const & recipe) {
+      QStringList contents;
+      for (Hop const * hop : recipe.hops()) {
+         contents << QString("Hop %1 %2kg %3").arg(hop->name()).arg(hop->amount_kg()).arg(hop->deleted());
+      }
+      if (recipe.mash()) {
+         for (MashStep const * mashStep : recipe.mash()->mashSteps()) {
+            contents << QString("MashStep %1 %2").arg(mashStep->name()).arg(mashStep->deleted());
+         }
+      }
+      for (Instruction const * instruction : recipe.instructions()) {
+         contents <<
+            QString("Instruction %1 %2 %3").arg(instruction->name()).arg(instruction->directions()).arg(
+               instruction->deleted()
+            );
+      }
+      return contents;
+   }
+
+   //! \brief Read some columns of one row of the hop table, as strings (or an empty list if there's no such row)
+   QStringList readHopRow(QSqlDatabase connection, int id, QStringList const & columns) {
+      BtSqlQuery sqlQuery{connection};
+      sqlQuery.prepare(QString("SELECT %1 FROM hop WHERE id = ?").arg(columns.join(", ")));
+      sqlQuery.addBindValue(id);
+      QStringList row;
+      if (sqlQuery.exec() && sqlQuery.next()) {
+         for (int ii = 0; ii < columns.size(); ++ii) {
+            row << sqlQuery.value(ii).toString();
+         }
+      }
+      return row;
+   }
+
 }
 
 QTEST_MAIN(Testing)
@@ -346,6 +392,9 @@ void Testing::testLogRotation() {
    // Put logging back to normal
    Logging::setLoggingToStderr(true);
 
+   // Log messages are written asynchronously, so wait for them all to get to disk before we look
+   Logging::flush();
+
    QFileInfoList fileList = Logging::getLogFileList();
    //There is always a "logFileCount" number of old files + 1 current file
    QCOMPARE(fileList.size(), Logging::logFileCount + 1);
@@ -359,6 +408,438 @@ void Testing::testLogRotation() {
    return;
 }
 
+void Testing::testObjectStoreSnapshot() {
+   QString const dbFilePath{QDir::temp().filePath("snapshotTest.sqlite")};
+   QString const snapshotFilePath{QDir::temp().filePath("snapshotTest.sqlite.snapshot")};
+   {
+      QFile dbFile{dbFilePath};
+      QVERIFY(dbFile.open(QIODevice::WriteOnly | QIODevice::Truncate));
+      dbFile.write("Not really a database");
+   }
+
+   BtStringConst const tableName{"test_table"};
+   QStringList const columnNames{"id", "name", "amount"};
+   ObjectStoreSnapshot::Rows const rowsWritten{
+      {QVariant(1), QVariant(QString("Cascade")), QVariant(0.5)},
+      {QVariant(2), QVariant(QVariant::String),   QVariant(1.25)}
+   };
+
+   ObjectStoreSnapshot & snapshot = ObjectStoreSnapshot::instance();
+   snapshot.addTable(tableName, columnNames, rowsWritten);
+   QVERIFY(snapshot.write(snapshotFilePath, QFileInfo{dbFilePath}, 1));
+
+   // Wrong schema version should be rejected
+   QVERIFY(!snapshot.open(snapshotFilePath, QFileInfo{dbFilePath}, 2));
+
+   // Right schema version, and unchanged DB file, should give us back what we wrote
+   QVERIFY(snapshot.open(snapshotFilePath, QFileInfo{dbFilePath}, 1));
+   ObjectStoreSnapshot::Rows rowsRead;
+   QVERIFY(snapshot.readTable(tableName, columnNames, rowsRead));
+   QCOMPARE(rowsRead, rowsWritten);
+   QVERIFY(rowsRead[1][1].isNull());
+
+   // Each table can only be read once, and we unmap once everything is read
+   QVERIFY(!snapshot.isOpen());
+   QVERIFY(!snapshot.readTable(tableName, columnNames, rowsRead));
+
+   // A change to the DB file should invalidate the snapshot
+   {
+      QFile dbFile{dbFilePath};
+      QVERIFY(dbFile.open(QIODevice::WriteOnly | QIODevice::Append));
+      dbFile.write(" -- modified");
+   }
+   QVERIFY(!snapshot.open(snapshotFilePath, QFileInfo{dbFilePath}, 1));
+
+   snapshot.close();
+   ObjectStoreSnapshot::remove(snapshotFilePath);
+   QFile::remove(dbFilePath);
+   return;
+}
+
+void Testing::testChangeDispatcher() {
+   ChangeDispatcher dispatcher{"testChangeDispatcher"};
+   QList<QSet<QString> > refreshes;
+   connect(&dispatcher, &ChangeDispatcher::refresh, [&refreshes](QSet<QString> const & changedProperties) {
+      refreshes.append(changedProperties);
+   });
+
+   dispatcher.markDirty("og");
+   dispatcher.markDirty("fg");
+   dispatcher.markDirty("og");
+   QVERIFY(refreshes.isEmpty());
+
+   // The refresh is queued for the next turn of the event loop
+   QTRY_COMPARE(refreshes.size(), 1);
+   QCOMPARE(refreshes.at(0), (QSet<QString>{"og", "fg"}));
+   QCOMPARE(dispatcher.notificationCount(), 3u);
+   QCOMPARE(dispatcher.refreshCount(), 1u);
+   QCOMPARE(dispatcher.savedRefreshCount(), 2u);
+
+   // Nothing should come out for changes that were discarded
+   dispatcher.markDirty("color_srm");
+   dispatcher.discardPending();
+   dispatcher.flush();
+   QCOMPARE(refreshes.size(), 1);
+   return;
+}
+
+void Testing::testSearchIndex() {
+   SearchIndex & index = SearchIndex::getInstance<Hop>();
+   int const cascadeId = this->cascade_4pct->key();
+
+   QVERIFY(index.search("CASCADE 4").contains(cascadeId));
+   QVERIFY(index.search("ca").contains(cascadeId));
+   QVERIFY(!index.search("cascade 5").contains(cascadeId));
+
+   // Changing a searchable property should be reflected straight away
+   unsigned int const generation = index.generation();
+   this->cascade_4pct->setOrigin("Yakima Valley");
+   QVERIFY(index.generation() != generation);
+   QVERIFY(index.search("kima val").contains(cascadeId));
+   // Fields are searched separately, so we shouldn't match across the end of one and the start of the next
+   QVERIFY(!index.search("pctyakima").contains(cascadeId));
+
+   // Whereas other properties changing should not cause a re-index
+   unsigned int const generationAfterOrigin = index.generation();
+   this->cascade_4pct->setAlpha_pct(4.0);
+   QCOMPARE(index.generation(), generationAfterOrigin);
+   return;
+}
+
+void Testing::testDbWriteThread() {
+   Database & database = Database::instance();
+   int const numInserts = 100;
+
+   std::future<bool> created = database.enqueueWrite(
+      [](QSqlDatabase & connection) {
+         BtSqlQuery sqlQuery{connection};
+         return sqlQuery.exec("CREATE TABLE test_write_thread (sequence INTEGER, value TEXT)");
+      }
+   );
+
+   QVector<int> completionOrder;
+   for (int ii = 1; ii <= numInserts; ++ii) {
+      database.enqueueWrite(
+         [ii](QSqlDatabase & connection) {
+            BtSqlQuery sqlQuery{connection};
+            sqlQuery.prepare("INSERT INTO test_write_thread (sequence, value) VALUES (?, ?)");
+            sqlQuery.addBindValue(ii);
+            sqlQuery.addBindValue(QString{"Row %1"}.arg(ii));
+            return sqlQuery.exec();
+         },
+         [&completionOrder, ii](bool succeeded) {
+            completionOrder.append(succeeded ? ii : -ii);
+            return;
+         }
+      );
+   }
+
+   // A write that fails should be rolled back, without affecting the ones either side of it
+   std::future<bool> failed = database.enqueueWrite(
+      [](QSqlDatabase & connection) {
+         BtSqlQuery sqlQuery{connection};
+         sqlQuery.exec("INSERT INTO test_write_thread (sequence, value) VALUES (-1, 'Rolled back')");
+         return false;
+      }
+   );
+   std::future<bool> lastInsert = database.enqueueWrite(
+      [](QSqlDatabase & connection) {
+         BtSqlQuery sqlQuery{connection};
+         return sqlQuery.exec("INSERT INTO test_write_thread (sequence, value) VALUES (0, 'After failure')");
+      }
+   );
+
+   QVERIFY(created.get());
+   QVERIFY(!failed.get());
+   QVERIFY(lastInsert.get());
+
+   // Once the queue has drained, everything we wrote should be visible to other connections
+   database.flush();
+   {
+      BtSqlQuery sqlQuery{database.sqlDatabase()};
+      QVERIFY(sqlQuery.exec("SELECT sequence FROM test_write_thread ORDER BY rowid"));
+      QVector<int> sequences;
+      while (sqlQuery.next()) {
+         sequences.append(sqlQuery.value(0).toInt());
+      }
+      QCOMPARE(sequences.size(), numInserts + 1);
+      for (int ii = 0; ii < numInserts; ++ii) {
+         QCOMPARE(sequences.at(ii), ii + 1);
+      }
+      QCOMPARE(sequences.last(), 0);
+   }
+
+   // Completions come back on this thread, via the event loop, in the order the writes were queued
+   QTRY_COMPARE(completionOrder.size(), numInserts);
+   for (int ii = 0; ii < numInserts; ++ii) {
+      QCOMPARE(completionOrder.at(ii), ii + 1);
+   }
+
+   QVERIFY(database.enqueueWrite(
+      [](QSqlDatabase & connection) {
+         BtSqlQuery sqlQuery{connection};
+         return sqlQuery.exec("DROP TABLE test_write_thread");
+      }
+   ).get());
+   return;
+}
+
+void Testing::testCompactionPlan() {
+   // A Recipe we keep, and a soft-deleted previous version of it that shares its hop addition
+   auto keptRecipe = std::make_shared<Recipe>("Compaction test kept");
+   ObjectStoreWrapper::insert(keptRecipe);
+   std::shared_ptr<Hop> sharedHop = keptRecipe->add<Hop>(this->cascade_4pct);
+   auto sharingRecipe = std::make_shared<Recipe>(*keptRecipe, Recipe::CopyMode::SharedVersion);
+   ObjectStoreWrapper::insert(sharingRecipe);
+   QVERIFY(sharingRecipe->uses(*sharedHop));
+   ObjectStoreWrapper::softDelete(*sharingRecipe);
+
+   // A soft-deleted Recipe with a hop addition of its own
+   auto deletedRecipe = std::make_shared<Recipe>("Compaction test deleted");
+   ObjectStoreWrapper::insert(deletedRecipe);
+   std::shared_ptr<Hop> unsharedHop = deletedRecipe->add<Hop>(this->cascade_4pct);
+   ObjectStoreWrapper::softDelete(*deletedRecipe);
+
+   // A hop addition that no Recipe uses
+   auto orphanedHop = std::make_shared<Hop>(*this->cascade_4pct);
+   orphanedHop->makeChild(*this->cascade_4pct);
+   ObjectStoreWrapper::insert(orphanedHop);
+
+   QString const recipeTable{*ObjectStoreTyped<Recipe>::getInstance().tableName()};
+   QString const hopTable{*ObjectStoreTyped<Hop>::getInstance().tableName()};
+   ObjectStore::ObjectReference const keptRecipeRef   {recipeTable, keptRecipe->key()};
+   ObjectStore::ObjectReference const sharingRecipeRef{recipeTable, sharingRecipe->key()};
+   ObjectStore::ObjectReference const deletedRecipeRef{recipeTable, deletedRecipe->key()};
+   ObjectStore::ObjectReference const sharedHopRef    {hopTable,    sharedHop->key()};
+   ObjectStore::ObjectReference const unsharedHopRef  {hopTable,    unsharedHop->key()};
+   ObjectStore::ObjectReference const orphanedHopRef  {hopTable,    orphanedHop->key()};
+   ObjectStore::ObjectReference const cascadeRef      {hopTable,    this->cascade_4pct->key()};
+
+   QVector<ObjectStore::ObjectReference> const plan = Compaction::planDeletions();
+
+   // Nothing that a Recipe we're keeping uses can go, nor can a deleted Recipe that shares it (as deleting that Recipe
+   // would delete what it shares)
+   QVERIFY(!plan.contains(keptRecipeRef));
+   QVERIFY(!plan.contains(sharedHopRef));
+   QVERIFY(!plan.contains(sharingRecipeRef));
+   QVERIFY(!plan.contains(cascadeRef));
+
+   // But the deleted Recipe that shares nothing, its hop addition and the unused hop addition can all go, with the
+   // Recipe going before the hop addition it refers to
+   QVERIFY(plan.contains(deletedRecipeRef));
+   QVERIFY(plan.contains(unsharedHopRef));
+   QVERIFY(plan.contains(orphanedHopRef));
+   QVERIFY(plan.indexOf(deletedRecipeRef) < plan.indexOf(unsharedHopRef));
+
+   // Ordering doesn't depend on the order we're given things in
+   QVector<ObjectStore::ObjectReference> const ordered =
+      Compaction::orderForDeletion({unsharedHopRef, orphanedHopRef, deletedRecipeRef});
+   QCOMPARE(ordered.size(), 3);
+   QVERIFY(ordered.contains(orphanedHopRef));
+   QVERIFY(ordered.indexOf(deletedRecipeRef) < ordered.indexOf(unsharedHopRef));
+
+   // Planning shouldn't have changed anything
+   QVERIFY(ObjectStoreTyped<Recipe>::getInstance().contains(deletedRecipe->key()));
+   QVERIFY(ObjectStoreTyped<Hop>::getInstance().contains(orphanedHop->key()));
+   return;
+}
+
+void Testing::testRecipeVersionIsolation() {
+   auto recipe = std::make_shared<Recipe>("Versioning test");
+   ObjectStoreWrapper::insert(recipe);
+   std::shared_ptr<Hop> hop = recipe->add<Hop>(this->cascade_4pct);
+
+   auto mash = std::make_shared<Mash>();
+   mash->setName("Versioning test mash");
+   ObjectStoreWrapper::insert(mash);
+   recipe->setMash(mash.get());
+   for (QString const & stepName : {"Protein rest", "Conversion", "Mash out"}) {
+      auto mashStep = std::make_shared<MashStep>();
+      mashStep->setName(stepName);
+      recipe->mash()->addMashStep(mashStep);
+   }
+
+   for (QString const & instructionName : {"Mash in", "Sparge"}) {
+      auto instruction = std::make_shared<Instruction>();
+      instruction->setName(instructionName);
+      instruction->setDirections("As usual");
+      recipe->add(instruction);
+   }
+
+   //
+   // Each change gets a new previous version to share everything with the current one, so that it's the first change
+   // to each thing that's tested.  Whatever the change, the previous version must be left as it was.
+   //
+   std::function<void(char const *, std::function<void()>)> checkPreviousVersionUnchangedBy =
+      [recipe](char const * description, std::function<void()> change) {
+         auto previousVersion = std::make_shared<Recipe>(*recipe, Recipe::CopyMode::SharedVersion);
+         ObjectStoreWrapper::insert(previousVersion);
+         recipe->setAncestor(*previousVersion);
+         QStringList const before = describeSharedContents(*previousVersion);
+         change();
+         QVERIFY2(describeSharedContents(*previousVersion) == before, description);
+         return;
+      };
+
+   checkPreviousVersionUnchangedBy("Edit hop", [hop]() { hop->setAmount_kg(hop->amount_kg() * 2.0); });
+   checkPreviousVersionUnchangedBy("Add hop", [this, recipe]() { recipe->add<Hop>(this->cascade_4pct); });
+   checkPreviousVersionUnchangedBy("Remove hop", [recipe, hop]() { recipe->remove<Hop>(hop); });
+
+   checkPreviousVersionUnchangedBy(
+      "Edit mash step", [recipe]() { recipe->mash()->mashSteps().first()->setName("Acid rest"); }
+   );
+   checkPreviousVersionUnchangedBy(
+      "Add mash step", [recipe]() { recipe->mash()->addMashStep(std::make_shared<MashStep>()); }
+   );
+   checkPreviousVersionUnchangedBy(
+      "Remove mash step",
+      [recipe]() {
+         recipe->mash()->removeMashStep(ObjectStoreWrapper::getSharedFromRaw(recipe->mash()->mashSteps().last()));
+      }
+   );
+   checkPreviousVersionUnchangedBy("Remove all mash steps", [recipe]() { recipe->mash()->removeAllMashSteps(); });
+
+   checkPreviousVersionUnchangedBy(
+      "Edit instruction", [recipe]() { recipe->instructions().first()->setDirections("Slowly"); }
+   );
+   checkPreviousVersionUnchangedBy(
+      "Add instruction", [recipe]() { recipe->add(std::make_shared<Instruction>()); }
+   );
+   checkPreviousVersionUnchangedBy(
+      "Remove instruction",
+      [recipe]() { recipe->remove(ObjectStoreWrapper::getSharedFromRaw(recipe->instructions().first())); }
+   );
+   checkPreviousVersionUnchangedBy("Clear instructions", [recipe]() { recipe->clearInstructions(); });
+   return;
+}
+
+void Testing::testParentDataMigration() {
+   //
+   // Upgrade a copy of the last default DB we shipped (schema v9), which has lots of hop additions that are children
+   // of catalogue hops.  We need a new connection name so as not to disturb the connection to the DB under test.
+   //
+   QString const dbFileName = QDir::temp().filePath("brewtarget-test-migration.sqlite");
+   QString const connectionName{"testParentDataMigration"};
+   QFile::remove(dbFileName);
+   QVERIFY(QFile::copy(Brewtarget::getResourceDir().filePath("default_db.sqlite"), dbFileName));
+   QFile::setPermissions(dbFileName, QFileDevice::ReadOwner | QFileDevice::WriteOwner);
+   {
+      QSqlDatabase connection = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+      connection.setDatabaseName(dbFileName);
+      QVERIFY(connection.open());
+
+      QMap<int, int> parentIds;
+      {
+         BtSqlQuery sqlQuery{connection};
+         QVERIFY(sqlQuery.exec("SELECT child_id, parent_id FROM hop_children WHERE child_id <> parent_id"));
+         while (sqlQuery.next()) {
+            parentIds.insert(sqlQuery.value(0).toInt(), sqlQuery.value(1).toInt());
+         }
+      }
+      QVERIFY(!parentIds.isEmpty());
+
+      QStringList const columns{"name", "alpha", "origin"};
+      QMap<int, QStringList> originalRows;
+      for (int const childId : parentIds.keys()) {
+         originalRows.insert(childId, readHopRow(connection, childId, columns));
+      }
+
+      QVERIFY(DatabaseSchemaHelper::migrate(Database::instance(), 9, DatabaseSchemaHelper::dbVersion, connection));
+
+      //
+      // Each child's name is the same as its parent's, so that at least must now be read from the parent, with an
+      // empty placeholder in the child's row (as the column is NOT NULL).  And, filling in from the parent whatever
+      // the child says it inherits, we must get back exactly what the child stored before.
+      //
+      QStringList const columnsAndInheritedFields = columns + QStringList{"inherited_fields"};
+      for (int const childId : parentIds.keys()) {
+         QStringList const childRow  = readHopRow(connection, childId,               columnsAndInheritedFields);
+         QStringList const parentRow = readHopRow(connection, parentIds.value(childId), columnsAndInheritedFields);
+         QCOMPARE(childRow.size(), columnsAndInheritedFields.size());
+         QCOMPARE(parentRow.size(), columnsAndInheritedFields.size());
+         QCOMPARE(parentRow.last(), QString{""});
+         QStringList const inheritedFields = childRow.last().split(',');
+         QVERIFY(inheritedFields.contains("name"));
+         QCOMPARE(childRow.first(), QString{""});
+         QStringList filledInRow;
+         for (int ii = 0; ii < columns.size(); ++ii) {
+            filledInRow << (inheritedFields.contains(columns[ii]) ? parentRow[ii] : childRow[ii]);
+         }
+         QCOMPARE(filledInRow, originalRows.value(childId));
+      }
+      connection.close();
+   }
+   QSqlDatabase::removeDatabase(connectionName);
+   QFile::remove(dbFileName);
+   return;
+}
+
+void Testing::testParentDataSharing() {
+   Database & database = Database::instance();
+   ObjectStoreTyped<Hop> & hopStore = ObjectStoreTyped<Hop>::getInstance();
+   QStringList const columns{"name", "alpha", "origin", "inherited_fields"};
+
+   auto parent = std::make_shared<Hop>();
+   parent->setName("Parent data sharing test");
+   parent->setAlpha_pct(4.5);
+   parent->setOrigin("Kent");
+   ObjectStoreWrapper::insert(parent);
+
+   // One child the same as its parent, and one with its own origin
+   auto sameChild = std::make_shared<Hop>(*parent);
+   sameChild->makeChild(*parent);
+   ObjectStoreWrapper::insert(sameChild);
+   auto differentChild = std::make_shared<Hop>(*parent);
+   differentChild->makeChild(*parent);
+   differentChild->setOrigin("Worcestershire");
+   ObjectStoreWrapper::insert(differentChild);
+   hopStore.writeDirtyProperties();
+   database.flush();
+
+   // Children store placeholders for, and list, what they read from their parent
+   QCOMPARE(readHopRow(database.sqlDatabase(), parent->key(), columns),
+            (QStringList{"Parent data sharing test", "4.5", "Kent", ""}));
+   QStringList row = readHopRow(database.sqlDatabase(), sameChild->key(), columns);
+   QCOMPARE(row.mid(0, 3), (QStringList{"", "0", ""}));
+   QVERIFY(row.last().split(',').contains("name"));
+   QVERIFY(row.last().split(',').contains("alpha"));
+   QVERIFY(row.last().split(',').contains("origin"));
+   row = readHopRow(database.sqlDatabase(), differentChild->key(), columns);
+   QCOMPARE(row.mid(0, 3), (QStringList{"", "0", "Worcestershire"}));
+   QVERIFY(!row.last().split(',').contains("origin"));
+
+   // When the parent changes, a child that no longer has the same value must store its own
+   parent->setAlpha_pct(6.0);
+   hopStore.writeDirtyProperties();
+   database.flush();
+   QCOMPARE(readHopRow(database.sqlDatabase(), parent->key(), columns).at(1), QString{"6"});
+   row = readHopRow(database.sqlDatabase(), sameChild->key(), columns);
+   QCOMPARE(row.mid(0, 3), (QStringList{"", "4.5", ""}));
+   QVERIFY(!row.last().split(',').contains("alpha"));
+   QVERIFY(row.last().split(',').contains("name"));
+
+   // Reading everything back fills in what the children read from their parent
+   std::unique_ptr<ObjectStoreTyped<Hop> > reloadedStore = ObjectStoreTyped<Hop>::createUnshared();
+   reloadedStore->loadAll(&database);
+   for (std::shared_ptr<Hop> const & hop : {parent, sameChild, differentChild}) {
+      std::shared_ptr<Hop> reloaded = reloadedStore->getById(hop->key());
+      QVERIFY(reloaded);
+      QCOMPARE(reloaded->name(), hop->name());
+      QCOMPARE(reloaded->alpha_pct(), hop->alpha_pct());
+      QCOMPARE(reloaded->origin(), hop->origin());
+   }
+
+   // Once the parent is gone, its children store everything themselves
+   ObjectStoreWrapper::hardDelete(*parent);
+   database.flush();
+   QVERIFY(readHopRow(database.sqlDatabase(), parent->key(), columns).isEmpty());
+   QCOMPARE(readHopRow(database.sqlDatabase(), sameChild->key(), columns),
+            (QStringList{"Parent data sharing test", "4.5", "Kent", ""}));
+   QCOMPARE(readHopRow(database.sqlDatabase(), differentChild->key(), columns),
+            (QStringList{"Parent data sharing test", "4.5", "Worcestershire", ""}));
+   return;
+}
+
 void Testing::cleanupTestCase()
 {
    Brewtarget::cleanup();
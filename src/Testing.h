@@ -75,6 +75,30 @@ private slots:
 
    //! \brief Verify Log rotation is working
    void testLogRotation();
+
+   //! \brief Verify the start-up snapshot round-trips and is rejected when the DB file or schema changes
+   void testObjectStoreSnapshot();
+
+   //! \brief Verify a burst of changes results in a single refresh with all of them in it
+   void testChangeDispatcher();
+
+   //! \brief Verify the search index finds objects by any indexed field and keeps up with changes
+   void testSearchIndex();
+
+   //! \brief Verify queued DB writes run in order, each in its own transaction, with completions called back in order
+   void testDbWriteThread();
+
+   //! \brief Verify compaction only plans to delete objects nothing needs, and deletes referrers before what they refer to
+   void testCompactionPlan();
+
+   //! \brief Verify adding, removing and editing things in a Recipe doesn't change a previous version that shares them
+   void testRecipeVersionIsolation();
+
+   //! \brief Verify upgrading an old DB makes hop additions read what they share from their parents, losing nothing
+   void testParentDataMigration();
+
+   //! \brief Verify children's rows keep up with their parents as the parents change and are deleted
+   void testParentDataSharing();
 };
 
 #endif
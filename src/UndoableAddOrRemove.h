@@ -28,6 +28,7 @@
 #include <QUndoCommand>
 
 #include "database/ObjectStoreWrapper.h"
+#include "Logging.h"
 
 class MainWindow;
 
@@ -132,12 +133,12 @@ private:
       // will cause it to be stored in the DB with a new ID.
       //
       if (!isUndo) {
-         qDebug() <<
+         qCDebug(lcUi) <<
             Q_FUNC_INFO << (this->everDone ? "Redo" : "Do" ) << this->text() << "for " <<
             this->whatToAddOrRemove->metaObject()->className() << "#" << this->whatToAddOrRemove->key();
 
          this->whatToAddOrRemove = (this->updatee.*(this->doer))(this->whatToAddOrRemove);
-         qDebug() <<
+         qCDebug(lcUi) <<
             Q_FUNC_INFO << (this->everDone ? "Redo" : "Do" ) << "Returned " <<
             this->whatToAddOrRemove->metaObject()->className() << "#" << this->whatToAddOrRemove->key();
 
@@ -149,12 +150,12 @@ private:
          // be able to distinguish the two cases.
          this->everDone = true;
       } else {
-         qDebug() <<
+         qCDebug(lcUi) <<
             Q_FUNC_INFO << "Undo" << this->text() << "for " << this->whatToAddOrRemove->metaObject()->className() <<
             "#" << this->whatToAddOrRemove->key();
 
          this->whatToAddOrRemove = (this->updatee.*(this->undoer))(this->whatToAddOrRemove);
-         qDebug() <<
+         qCDebug(lcUi) <<
             Q_FUNC_INFO << "Undo Returned " << this->whatToAddOrRemove->metaObject()->className() << "#" <<
             this->whatToAddOrRemove->key();
 
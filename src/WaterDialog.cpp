@@ -31,6 +31,7 @@
 #include "BtDigitWidget.h"
 #include "ColorMethods.h"
 #include "database/ObjectStoreWrapper.h"
+#include "Logging.h"
 #include "model/Fermentable.h"
 #include "model/Mash.h"
 #include "model/MashStep.h"
@@ -489,7 +490,7 @@ double WaterDialog::calculateMashpH()
       double saltpH    = calculateAddedSaltpH();
       double acids     = calculateAcidpH();
 
-      // qDebug() << "basepH =" << basepH << "gristph =" << gristpH << "saltpH =" << saltpH << "acids =" << acids;
+      // qCDebug(lcUi) << "basepH =" << basepH << "gristph =" << gristpH << "saltpH =" << saltpH << "acids =" << acids;
       // residual alkalinity is handled by basepH
       mashpH = basepH + gristpH + saltpH - acids;
    }
@@ -25,6 +25,7 @@
 
 #include "brewtarget.h"
 #include "database/ObjectStoreWrapper.h"
+#include "Logging.h"
 #include "model/Water.h"
 
 WaterEditor::WaterEditor(QWidget *parent) : QDialog(parent), obs{nullptr} {
@@ -50,7 +51,7 @@ WaterEditor::WaterEditor(QWidget *parent) : QDialog(parent), obs{nullptr} {
 }
 
 void WaterEditor::setWater(Water *water) {
-   qDebug() << Q_FUNC_INFO;
+   qCDebug(lcUi) << Q_FUNC_INFO;
 
    if (this->obs) {
       disconnect( this->obs, nullptr, this, nullptr );
@@ -73,7 +74,7 @@ void WaterEditor::newWater(QString folder) {
       return;
    }
 
-   qDebug() << Q_FUNC_INFO << "Creating new Water, " << name;
+   qCDebug(lcUi) << Q_FUNC_INFO << "Creating new Water, " << name;
 
    Water* w = new Water(name);
    if ( ! folder.isEmpty() ) {
@@ -181,7 +182,7 @@ void WaterEditor::saveAndClose()
    this->obs->setNotes( plainTextEdit_notes->toPlainText());
 
    if (this->obs->cacheOnly()) {
-      qDebug() << Q_FUNC_INFO << "writing " << this->obs->name();
+      qCDebug(lcUi) << Q_FUNC_INFO << "writing " << this->obs->name();
       ObjectStoreWrapper::insert(*this->obs);
       this->obs->setCacheOnly(false);
    }
@@ -192,7 +193,7 @@ void WaterEditor::saveAndClose()
 
 void WaterEditor::clearAndClose()
 {
-   qDebug() << Q_FUNC_INFO;
+   qCDebug(lcUi) << Q_FUNC_INFO;
    setWater(nullptr);
    setVisible(false); // Hide the window.
    return;
@@ -41,155 +41,54 @@
 #include "WaterTableWidget.h"
 
 WaterTableModel::WaterTableModel(WaterTableWidget* parent)
-   : QAbstractTableModel(parent), recObs(nullptr), parentTableWidget(parent)
+   : QAbstractTableModel(parent),
+     BtTableModelBase<WaterTableModel, Water>(WATERNUMCOLS),
+     parentTableWidget(parent)
 {
+   connect( this, &QAbstractItemModel::rowsInserted, this, &WaterTableModel::resizeToContents );
+   connect( this, &QAbstractItemModel::rowsRemoved,  this, &WaterTableModel::resizeToContents );
 }
 
-void WaterTableModel::observeRecipe(Recipe* rec)
+QList<Water *> WaterTableModel::recipeItems(Recipe const & recipe) const
 {
-   if( recObs )
-   {
-      disconnect( recObs, nullptr, this, nullptr );
-      removeAll();
-   }
-
-   recObs = rec;
-   if( recObs )
-   {
-      connect( recObs, &NamedEntity::changed, this, &WaterTableModel::changed );
-      addWaters( recObs->waters() );
-   }
-}
-
-void WaterTableModel::observeDatabase(bool val) {
-   if( val ) {
-      observeRecipe(nullptr);
-      removeAll();
-      connect(&ObjectStoreTyped<Water>::getInstance(), &ObjectStoreTyped<Water>::signalObjectInserted, this, &WaterTableModel::addWater);
-      connect(&ObjectStoreTyped<Water>::getInstance(), &ObjectStoreTyped<Water>::signalObjectDeleted,  this, &WaterTableModel::removeWater);
-      this->addWaters( ObjectStoreTyped<Water>::getInstance().getAllRaw() );
-   } else {
-      removeAll();
-      disconnect(&ObjectStoreTyped<Water>::getInstance(), nullptr, this, nullptr);
-   }
-   return;
-}
-
-void WaterTableModel::addWater(int waterId) {
-   Water* water = ObjectStoreWrapper::getByIdRaw<Water>(waterId);
-   if (this->waterObs.contains(water)) {
-      return;
-   }
-   // If we are observing the database, ensure that the item is undeleted and
-   // fit to display.
-   if (this->recObs == nullptr &&
-       (water->deleted() || !water->display())) {
-      return;
-   }
-
-   // If we are watching a Recipe and the new Water does not belong to it then there is nothing for us to do
-   if (this->recObs) {
-      Recipe * recipeOfNewWater = water->getOwningRecipe();
-      if (recipeOfNewWater && this->recObs->key() != recipeOfNewWater->key()) {
-         qDebug() <<
-            Q_FUNC_INFO << "Ignoring signal about new Water #" << water->key() << "as it belongs to Recipe #" <<
-            recipeOfNewWater->key() << "and we are watching Recipe #" << this->recObs->key();
-         return;
-      }
-   }
-
-   beginInsertRows( QModelIndex(), waterObs.size(), waterObs.size() );
-   waterObs.append(water);
-   connect( water, &NamedEntity::changed, this, &WaterTableModel::changed );
-   endInsertRows();
-
-   if(parentTableWidget)
-   {
-      parentTableWidget->resizeColumnsToContents();
-      parentTableWidget->resizeRowsToContents();
-   }
+   return recipe.waters();
 }
 
-void WaterTableModel::addWaters(QList<Water*> waters)
+void WaterTableModel::resizeToContents()
 {
-   QList<Water*>::iterator i;
-   QList<Water*> tmp;
-
-   for( i = waters.begin(); i != waters.end(); i++ )
-   {
-      if( !waterObs.contains(*i) )
-         tmp.append(*i);
-   }
-
-   int size = waterObs.size();
-   if (size+tmp.size())
-   {
-      beginInsertRows( QModelIndex(), size, size+tmp.size()-1 );
-      waterObs.append(tmp);
-
-      for( i = tmp.begin(); i != tmp.end(); i++ )
-         connect( *i, &NamedEntity::changed, this, &WaterTableModel::changed );
-
-      endInsertRows();
-   }
-
    if( parentTableWidget )
    {
       parentTableWidget->resizeColumnsToContents();
       parentTableWidget->resizeRowsToContents();
    }
-
-}
-
-void WaterTableModel::removeWater(int waterId, std::shared_ptr<QObject> object) {
-   Water* water = std::static_pointer_cast<Water>(object).get();
-   int i = waterObs.indexOf(water);
-   if( i >= 0 )
-   {
-      beginRemoveRows( QModelIndex(), i, i );
-      disconnect( water, nullptr, this, nullptr );
-      waterObs.removeAt(i);
-      endRemoveRows();
-
-      if(parentTableWidget)
-      {
-         parentTableWidget->resizeColumnsToContents();
-         parentTableWidget->resizeRowsToContents();
-      }
-   }
-}
-
-void WaterTableModel::removeAll()
-{
-   beginRemoveRows( QModelIndex(), 0, waterObs.size()-1 );
-   while( !waterObs.isEmpty() )
-   {
-      disconnect( waterObs.takeLast(), nullptr, this, nullptr );
-   }
-   endRemoveRows();
 }
 
 void WaterTableModel::changed(QMetaProperty prop, QVariant val)
 {
-   int i;
-
    Q_UNUSED(prop)
    Q_UNUSED(val)
    // Find the notifier in the list
    Water* waterSender = qobject_cast<Water*>(sender());
    if( waterSender )
    {
-      i = waterObs.indexOf(waterSender);
-      if( i >= 0 )
-         emit dataChanged( QAbstractItemModel::createIndex(i, 0),
-                           QAbstractItemModel::createIndex(i, WATERNUMCOLS-1));
+      this->rowChanged(waterSender);
       return;
    }
 }
 
 int WaterTableModel::rowCount(const QModelIndex& /*parent*/) const
 {
-   return waterObs.size();
+   return this->rowCountImpl();
+}
+
+bool WaterTableModel::canFetchMore(const QModelIndex& parent) const
+{
+   return this->canFetchMoreImpl(parent);
+}
+
+void WaterTableModel::fetchMore(const QModelIndex& parent)
+{
+   this->fetchMoreImpl(parent);
 }
 
 int WaterTableModel::columnCount(const QModelIndex& /*parent*/) const
@@ -202,13 +101,13 @@ QVariant WaterTableModel::data( const QModelIndex& index, int role ) const
    Water* row;
 
    // Ensure the row is ok.
-   if( index.row() >= waterObs.size() )
+   if( index.row() >= this->rows.size() )
    {
       qWarning() << tr("Bad model index. row = %1").arg(index.row());
       return QVariant();
    }
    else
-      row = waterObs[index.row()];
+      row = this->rows[index.row()];
 
    // Make sure we only respond to the DisplayRole role.
    if( role != Qt::DisplayRole )
@@ -287,10 +186,10 @@ bool WaterTableModel::setData( const QModelIndex& index, const QVariant& value,
    Water *row;
    bool retval = false;
 
-   if( index.row() >= waterObs.size() || role != Qt::EditRole )
+   if( index.row() >= this->rows.size() || role != Qt::EditRole )
       return false;
    else
-      row = waterObs[index.row()];
+      row = this->rows[index.row()];
 
    retval = value.canConvert(QVariant::String);
    if ( ! retval )
@@ -32,9 +32,10 @@
 #include <QVariant>
 #include <QWidget>
 
+#include "BtTableModelBase.h"
+#include "model/Water.h"
 #include "Unit.h"
 // Forward declarations.
-class Water;
 class WaterTableWidget;
 class Recipe;
 
@@ -49,23 +50,25 @@ enum{ WATERNAMECOL, WATERAMOUNTCOL, WATERCALCIUMCOL, WATERBICARBONATECOL,
  *
  * \brief Table model for waters.
  */
-class WaterTableModel : public QAbstractTableModel
+class WaterTableModel : public QAbstractTableModel, public BtTableModelBase<WaterTableModel, Water>
 {
    Q_OBJECT
 
+   friend class BtTableModelBase<WaterTableModel, Water>;
+
 public:
    WaterTableModel(WaterTableWidget* parent=0);
    virtual ~WaterTableModel() {}
-   void addWaters(QList<Water*> waters);
-   void observeRecipe(Recipe* rec);
-   void observeDatabase(bool val);
-   void removeAll();
 
    //! Reimplemented from QAbstractTableModel.
    virtual int rowCount(const QModelIndex& parent = QModelIndex()) const;
    //! Reimplemented from QAbstractTableModel.
    virtual int columnCount(const QModelIndex& parent = QModelIndex()) const;
    //! Reimplemented from QAbstractTableModel.
+   virtual bool canFetchMore(const QModelIndex& parent) const;
+   //! Reimplemented from QAbstractTableModel.
+   virtual void fetchMore(const QModelIndex& parent);
+   //! Reimplemented from QAbstractTableModel.
    virtual QVariant data( const QModelIndex& index, int role = Qt::DisplayRole ) const;
    //! Reimplemented from QAbstractTableModel.
    virtual QVariant headerData( int section, Qt::Orientation orientation, int role = Qt::DisplayRole ) const;
@@ -76,12 +79,12 @@ public:
 
 public slots:
    void changed(QMetaProperty,QVariant);
-   void addWater(int waterId);
-   void removeWater(int waterId, std::shared_ptr<QObject> object);
 
 private:
-   QList<Water*> waterObs;
-   Recipe* recObs;
+   //! Used by BtTableModelBase::observeRecipe()
+   QList<Water *> recipeItems(Recipe const & recipe) const;
+   void resizeToContents();
+
    WaterTableWidget* parentTableWidget;
 
    void setDisplayUnit(int column, Unit::unitDisplay displayUnit);
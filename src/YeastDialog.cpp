@@ -227,6 +227,9 @@ void YeastDialog::newYeast(QString folder)
 
 void YeastDialog::filterYeasts(QString searchExpression)
 {
-    yeastTableProxy->setFilterCaseSensitivity(Qt::CaseInsensitive);
-    yeastTableProxy->setFilterFixedString(searchExpression);
+    // The filter can only see rows the model has already handed out, so make sure that's all of them
+    if (!searchExpression.isEmpty()) {
+       yeastTableModel->fetchAll();
+    }
+    yeastTableProxy->setSearchText(searchExpression);
 }
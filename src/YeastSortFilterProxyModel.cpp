@@ -61,12 +61,15 @@ bool YeastSortFilterProxyModel::lessThan(const QModelIndex &left,
 
 bool YeastSortFilterProxyModel::filterAcceptsRow( int source_row, const QModelIndex &source_parent) const
 {
+   Q_UNUSED(source_parent)
    YeastTableModel* model = qobject_cast<YeastTableModel*>(sourceModel());
-   QModelIndex index = sourceModel()->index(source_row, 0, source_parent);
+   Yeast * yeast = model->getYeast(source_row);
 
-   return !filter
-          ||
-           ( sourceModel()->data(index).toString().contains(filterRegExp())
-             && model->getYeast(source_row)->display()
-           );
+   return !filter || (yeast->display() && this->search.matches(*yeast));
+}
+
+void YeastSortFilterProxyModel::setSearchText(QString const & searchText) {
+   this->search.setText(searchText);
+   this->invalidateFilter();
+   return;
 }
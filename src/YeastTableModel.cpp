@@ -46,12 +46,11 @@
 
 YeastTableModel::YeastTableModel(QTableView* parent, bool editable) :
    QAbstractTableModel(parent),
+   BtTableModelBase<YeastTableModel, Yeast>(YEASTNUMCOLS),
    editable(editable),
    _inventoryEditable(false),
-   parentTableWidget(parent),
-   recObs(nullptr) {
+   parentTableWidget(parent) {
 
-   yeastObs.clear();
    setObjectName("yeastTableModel");
 
    QHeaderView* headerView = parentTableWidget->horizontalHeader();
@@ -65,132 +64,14 @@ YeastTableModel::YeastTableModel(QTableView* parent, bool editable) :
    return;
 }
 
-void YeastTableModel::addYeast(int yeastId) {
-   Yeast* yeast = ObjectStoreWrapper::getByIdRaw<Yeast>(yeastId);
-
-   if (this->yeastObs.contains(yeast)) {
-      return;
-   }
-
-   // If we are observing the database, ensure that the item is undeleted and
-   // fit to display.
-   if (this->recObs == nullptr &&
-       (yeast->deleted() || !yeast->display())) {
-      return;
-   }
-
-   // If we are watching a Recipe and the new Yeast does not belong to it then there is nothing for us to do
-   if (this->recObs) {
-      Recipe * recipeOfNewYeast = yeast->getOwningRecipe();
-      if (recipeOfNewYeast && this->recObs->key() != recipeOfNewYeast->key()) {
-         qDebug() <<
-            Q_FUNC_INFO << "Ignoring signal about new Yeast #" << yeast->key() << "as it belongs to Recipe #" <<
-            recipeOfNewYeast->key() << "and we are watching Recipe #" << this->recObs->key();
-         return;
-      }
-   }
-
-   int size = yeastObs.size();
-   beginInsertRows( QModelIndex(), size, size );
-   yeastObs.append(yeast);
-   connect( yeast, &NamedEntity::changed, this, &YeastTableModel::changed );
-   //reset(); // Tell everybody that the table has changed.
-   endInsertRows();
-}
-
-void YeastTableModel::observeRecipe(Recipe* rec)
-{
-   if( recObs )
-   {
-      disconnect( recObs, nullptr, this, nullptr );
-      removeAll();
-   }
-
-   recObs = rec;
-   if( recObs )
-   {
-      connect( recObs, &NamedEntity::changed, this, &YeastTableModel::changed );
-      addYeasts( recObs->yeasts() );
-   }
-}
-
-void YeastTableModel::observeDatabase(bool val) {
-   if( val ) {
-      observeRecipe(nullptr);
-
-      removeAll();
-      connect(&ObjectStoreTyped<Yeast>::getInstance(), &ObjectStoreTyped<Yeast>::signalObjectInserted, this, &YeastTableModel::addYeast);
-      connect(&ObjectStoreTyped<Yeast>::getInstance(), &ObjectStoreTyped<Yeast>::signalObjectDeleted,  this, &YeastTableModel::removeYeast);
-      addYeasts( ObjectStoreTyped<Yeast>::getInstance().getAllRaw() );
-   } else {
-      removeAll();
-      disconnect(&ObjectStoreTyped<Yeast>::getInstance(), nullptr, this, nullptr);
-   }
-}
-
-void YeastTableModel::addYeasts(QList<Yeast*> yeasts)
-{
-   QList<Yeast*>::iterator i;
-   QList<Yeast*> tmp;
-
-   for( i = yeasts.begin(); i != yeasts.end(); i++ )
-   {
-      if( recObs == nullptr && ( (*i)->deleted() || !(*i)->display() ) )
-         continue;
-
-      if( !yeastObs.contains(*i) )
-         tmp.append(*i);
-   }
-
-   int size = yeastObs.size();
-   if (size+tmp.size())
-   {
-      beginInsertRows( QModelIndex(), size, size+tmp.size()-1 );
-      yeastObs.append(tmp);
-
-      for( i = tmp.begin(); i != tmp.end(); i++ )
-         connect( *i, &NamedEntity::changed, this, &YeastTableModel::changed );
-
-      endInsertRows();
-   }
-}
-
-void YeastTableModel::removeYeast(int yeastId, std::shared_ptr<QObject> object) {
-   this->remove(std::static_pointer_cast<Yeast>(object).get());
-   return;
-}
-
-void YeastTableModel::remove(Yeast * yeast) {
-
-   int i = yeastObs.indexOf(yeast);
-
-   if( i >= 0 )
-   {
-      beginRemoveRows( QModelIndex(), i, i );
-      disconnect( yeast, nullptr, this, nullptr );
-      yeastObs.removeAt(i);
-      //reset(); // Tell everybody the table has changed.
-      endRemoveRows();
-   }
-}
-
-void YeastTableModel::removeAll()
-{
-   if (yeastObs.size())
-   {
-      beginRemoveRows( QModelIndex(), 0, yeastObs.size()-1 );
-      while( !yeastObs.isEmpty() )
-      {
-         disconnect( yeastObs.takeLast(), nullptr, this, nullptr );
-      }
-      endRemoveRows();
-   }
+QList<Yeast *> YeastTableModel::recipeItems(Recipe const & recipe) const {
+   return recipe.yeasts();
 }
 
 void YeastTableModel::changedInventory(int invKey, BtStringConst const & propertyName) {
    if (propertyName == PropertyNames::Inventory::amount) {
-      for( int i = 0; i < yeastObs.size(); ++i ) {
-         Yeast* holdmybeer = yeastObs.at(i);
+      for( int i = 0; i < this->rows.size(); ++i ) {
+         Yeast* holdmybeer = this->rows.at(i);
          if ( invKey == holdmybeer->inventoryId() ) {
             emit dataChanged( QAbstractItemModel::createIndex(i,YEASTINVENTORYCOL),
                               QAbstractItemModel::createIndex(i,YEASTINVENTORYCOL) );
@@ -202,29 +83,22 @@ void YeastTableModel::changedInventory(int invKey, BtStringConst const & propert
 
 void YeastTableModel::changed(QMetaProperty prop, QVariant /*val*/)
 {
-   int i;
-
    // Find the notifier in the list
    Yeast* yeastSender = qobject_cast<Yeast*>(sender());
    if( yeastSender )
    {
-      i = yeastObs.indexOf(yeastSender);
-      if( i < 0 )
-         return;
-
-      emit dataChanged( QAbstractItemModel::createIndex(i, 0),
-                        QAbstractItemModel::createIndex(i, YEASTNUMCOLS-1));
+      this->rowChanged(yeastSender);
       return;
    }
 
    // See if sender is our recipe.
    Recipe* recSender = qobject_cast<Recipe*>(sender());
-   if( recSender && recSender == recObs )
+   if( recSender && recSender == this->recObs )
    {
       if( QString(prop.name()) == PropertyNames::Recipe::yeastIds )
       {
-         removeAll();
-         addYeasts( recObs->yeasts() );
+         this->removeAll();
+         this->add( this->recObs->yeasts() );
       }
       if( rowCount() > 0 )
          emit headerDataChanged( Qt::Vertical, 0, rowCount()-1 );
@@ -234,7 +108,18 @@ void YeastTableModel::changed(QMetaProperty prop, QVariant /*val*/)
 
 int YeastTableModel::rowCount(const QModelIndex& /*parent*/) const
 {
-   return yeastObs.size();
+   return this->rowCountImpl();
+}
+
+bool YeastTableModel::canFetchMore(const QModelIndex& parent) const
+{
+   return this->canFetchMoreImpl(parent);
+}
+
+void YeastTableModel::fetchMore(const QModelIndex& parent)
+{
+   this->fetchMoreImpl(parent);
+   return;
 }
 
 int YeastTableModel::columnCount(const QModelIndex& /*parent*/) const
@@ -245,16 +130,16 @@ int YeastTableModel::columnCount(const QModelIndex& /*parent*/) const
 QVariant YeastTableModel::data( const QModelIndex& index, int role ) const
 {
    Yeast* row;
-   Unit::unitDisplay unit;
+   int col = index.column();
 
    // Ensure the row is ok.
-   if( index.row() >= static_cast<int>(yeastObs.size() ))
+   if( index.row() >= static_cast<int>(this->rows.size() ))
    {
       qWarning() << tr("Bad model index. row = %1").arg(index.row());
       return QVariant();
    }
    else
-      row = yeastObs[index.row()];
+      row = this->rows[index.row()];
 
    switch( index.column() )
    {
@@ -295,13 +180,13 @@ QVariant YeastTableModel::data( const QModelIndex& index, int role ) const
          if( role != Qt::DisplayRole )
             return QVariant();
 
-         unit  = displayUnit(index.column());
-
-         return QVariant(Brewtarget::displayAmount(row->amount(),
-                                                row->amountIsWeight() ? &Units::kilograms : &Units::liters,
-                                                3,
-                                                unit,
-                                                Unit::noScale));
+         return QVariant(this->formattedValueCache.get(row, col, [this, row, col]() {
+            return Brewtarget::displayAmount(row->amount(),
+                                             row->amountIsWeight() ? &Units::kilograms : &Units::liters,
+                                             3,
+                                             displayUnit(col),
+                                             Unit::noScale);
+         }));
 
       default :
          qWarning() << tr("Bad column: %1").arg(index.column());
@@ -358,10 +243,10 @@ bool YeastTableModel::setData( const QModelIndex& index, const QVariant& value,
    Yeast *row;
    Unit const * unit;
 
-   if( index.row() >= static_cast<int>(yeastObs.size()) || role != Qt::EditRole )
+   if( index.row() >= static_cast<int>(this->rows.size()) || role != Qt::EditRole )
       return false;
    else
-      row = yeastObs[index.row()];
+      row = this->rows[index.row()];
 
    Unit::unitDisplay dspUnit = displayUnit(index.column());
    Unit::unitScale   dspScl  = displayScale(index.column());
@@ -437,7 +322,7 @@ bool YeastTableModel::setData( const QModelIndex& index, const QVariant& value,
 
 Yeast* YeastTableModel::getYeast(unsigned int i)
 {
-   return yeastObs[static_cast<int>(i)];
+   return this->rows[static_cast<int>(i)];
 }
 
 Unit::unitDisplay YeastTableModel::displayUnit(int column) const
@@ -475,6 +360,11 @@ void YeastTableModel::setDisplayUnit(int column, Unit::unitDisplay displayUnit)
    PersistentSettings::insert(attribute,displayUnit,this->objectName(),PersistentSettings::UNIT);
    PersistentSettings::insert(attribute,Unit::noScale,this->objectName(),PersistentSettings::SCALE);
 
+   this->formattedValueCache.invalidateColumn(column);
+   if (this->rowCount() > 0) {
+      emit dataChanged(this->index(0, column), this->index(this->rowCount() - 1, column));
+   }
+
    /* Disabled cell-specific code
    for (int i = 0; i < rowCount(); ++i )
    {
@@ -496,6 +386,11 @@ void YeastTableModel::setDisplayScale(int column, Unit::unitScale displayScale)
 
    PersistentSettings::insert(attribute,displayScale,this->objectName(),PersistentSettings::SCALE);
 
+   this->formattedValueCache.invalidateColumn(column);
+   if (this->rowCount() > 0) {
+      emit dataChanged(this->index(0, column), this->index(this->rowCount() - 1, column));
+   }
+
    /* disabled cell-specific code
    for (int i = 0; i < rowCount(); ++i )
    {
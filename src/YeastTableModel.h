@@ -36,10 +36,11 @@
 #include <QWidget>
 
 #include "brewtarget.h"
+#include "BtTableModelBase.h"
+#include "model/Yeast.h"
 #include "Unit.h"
 
 // Forward declarations.
-class Yeast;
 class YeastTableWidget;
 class YeastItemDelegate;
 class Recipe;
@@ -51,22 +52,16 @@ enum{ YEASTNAMECOL, YEASTLABCOL, YEASTPRODIDCOL, YEASTTYPECOL, YEASTFORMCOL, YEA
  *
  * \brief Table model for yeasts.
  */
-class YeastTableModel : public QAbstractTableModel {
+class YeastTableModel : public QAbstractTableModel, public BtTableModelBase<YeastTableModel, Yeast> {
    Q_OBJECT
 
+   friend class BtTableModelBase<YeastTableModel, Yeast>;
+
 public:
    YeastTableModel(QTableView* parent=nullptr, bool editable=true);
    virtual ~YeastTableModel() {}
-   //! \brief Observe a recipe's list of fermentables.
-   void observeRecipe(Recipe* rec);
-   //! \brief If true, we model the database's list of yeasts.
-   void observeDatabase(bool val);
-   //! \brief Add \c yeasts to the model.
-   void addYeasts(QList<Yeast*> yeasts);
    //! \brief Get the yeast at model index \c i.
    Yeast* getYeast(unsigned int i);
-   //! \brief Clear the model.
-   void removeAll();
 
    /*!
     * \brief True if the inventory column should be editable, false otherwise.
@@ -80,6 +75,10 @@ public:
    //! \brief Reimplemented from QAbstractTableModel.
    virtual int columnCount(const QModelIndex& parent = QModelIndex()) const;
    //! \brief Reimplemented from QAbstractTableModel.
+   virtual bool canFetchMore(const QModelIndex& parent) const;
+   //! \brief Reimplemented from QAbstractTableModel.
+   virtual void fetchMore(const QModelIndex& parent);
+   //! \brief Reimplemented from QAbstractTableModel.
    virtual QVariant data( const QModelIndex& index, int role = Qt::DisplayRole ) const;
    //! \brief Reimplemented from QAbstractTableModel.
    virtual QVariant headerData( int section, Qt::Orientation orientation, int role = Qt::DisplayRole ) const;
@@ -93,14 +92,8 @@ public:
    void setDisplayUnit(int column, Unit::unitDisplay displayUnit);
    void setDisplayScale(int column, Unit::unitScale displayScale);
    QString generateName(int column) const;
-   void remove(Yeast * yeast);
 
 public slots:
-   //! \brief Add a \c yeast to the model.
-   void addYeast(int yeastId);
-   //! \brief Remove a \c yeast from the model.
-   void removeYeast(int yeastId, std::shared_ptr<QObject> object);
-
    void contextMenu(const QPoint &point);
 private slots:
    //! \brief Catch changes to Recipe, Database, and Yeast.
@@ -108,11 +101,12 @@ private slots:
    void changedInventory(int invKey, BtStringConst const & propertyName);
 
 private:
+   //! \brief Used by \c BtTableModelBase::observeRecipe()
+   QList<Yeast *> recipeItems(Recipe const & recipe) const;
+
    bool editable;
    bool _inventoryEditable;
-   QList<Yeast*> yeastObs;
    QTableView* parentTableWidget;
-   Recipe* recObs;
 };
 
 /*!
@@ -47,6 +47,7 @@
 #include <QSplashScreen>
 #include <QString>
 #include <QTextStream>
+#include <QTimer>
 #include <QtNetwork/QNetworkAccessManager>
 #include <QtNetwork/QNetworkReply>
 #include <QtNetwork/QNetworkRequest>
@@ -55,6 +56,8 @@
 #include "Algorithms.h"
 #include "BtSplashScreen.h"
 #include "config.h"
+#include "database/BtSqlQuery.h"
+#include "database/Compaction.h"
 #include "database/Database.h"
 #include "database/ObjectStoreWrapper.h"
 #include "MainWindow.h"
@@ -69,6 +72,7 @@
 #include "PersistentSettings.h"
 #include "Unit.h"
 #include "UnitSystem.h"
+#include "utils/StartupProfile.h"
 
 // Needed for kill(2)
 #if defined(Q_OS_UNIX)
@@ -418,6 +422,8 @@ QDir Brewtarget::getResourceDir() {
 
 bool Brewtarget::initialize()
 {
+   StartupProfile::Phase const phase{"Brewtarget::initialize"};
+
    // Need these for changed(QMetaProperty,QVariant) to be emitted across threads.
    qRegisterMetaType<QMetaProperty>();
    qRegisterMetaType<Equipment*>();
@@ -454,6 +460,9 @@ bool Brewtarget::initialize()
 
 void Brewtarget::cleanup() {
    qDebug() << "Brewtarget is cleaning up.";
+   if (PersistentSettings::value(PersistentSettings::Names::sqlStatisticsLogAtExit, false).toBool()) {
+      BtSqlQuery::logStatistics();
+   }
    // Should I do qApp->removeTranslator() first?
    delete defaultTrans;
    delete btTrans;
@@ -477,19 +486,39 @@ int Brewtarget::run() {
    int ret = 0;
 
    BtSplashScreen splashScreen;
-   splashScreen.show();
-   qApp->processEvents();
+   {
+      StartupProfile::Phase const phase{"Splash screen"};
+      splashScreen.show();
+      qApp->processEvents();
+   }
    if( !initialize() )
    {
+      StartupProfile::finish();
       cleanup();
       return 1;
    }
    qInfo() << QString("Starting Brewtarget v%1 on %2.").arg(VERSIONSTRING).arg(QSysInfo::prettyProductName());
-   Database::instance().checkForNewDefaultData();
-   m_mainWindow = new MainWindow();
+   {
+      StartupProfile::Phase const phase{"Database::checkForNewDefaultData"};
+      Database::instance().checkForNewDefaultData();
+   }
+   {
+      StartupProfile::Phase const phase{"MainWindow constructor"};
+      m_mainWindow = new MainWindow();
+   }
    m_mainWindow->init();
-   m_mainWindow->setVisible(true);
-   splashScreen.finish(m_mainWindow);
+   {
+      StartupProfile::Phase const phase{"Show main window"};
+      m_mainWindow->setVisible(true);
+      splashScreen.finish(m_mainWindow);
+   }
+
+   // Startup is done once the event loop has had a chance to paint the main window
+   QTimer::singleShot(0, [](){ StartupProfile::finish(); });
+
+   // Now that nothing is being loaded or edited, work out which soft-deleted and orphaned objects can be hard-deleted,
+   // if the user has turned that on.  The deletes themselves are done in batches once the event loop is running.
+   Compaction::start(Database::instance());
 
    checkForNewVersion(m_mainWindow);
    do {
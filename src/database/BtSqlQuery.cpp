@@ -18,18 +18,83 @@
  */
 #include "database/BtSqlQuery.h"
 
+#include <algorithm>
+#include <mutex>
 #include <stdexcept>
 
 #include <QDebug>
+#include <QHash>
 #include <QSqlError>
 
+namespace {
+   using Clock = std::chrono::steady_clock;
+
+   std::mutex statisticsMutex;
+   QHash<QString, BtSqlQuery::Statistics> statistics;
+
+   bool isIdentifierCharacter(QChar const cc) {
+      return cc.isLetterOrNumber() || cc == '_';
+   }
+
+   /**
+    * \brief Collapse runs of white space and replace literal numbers and strings with ?, so that queries differing only
+    *        in layout or literal values are counted together
+    */
+   QString normalise(QString const & query) {
+      QString normalised;
+      normalised.reserve(query.size());
+      int const length = query.size();
+      for (int ii = 0; ii < length; ++ii) {
+         QChar const cc = query.at(ii);
+         if (cc.isSpace()) {
+            while (ii + 1 < length && query.at(ii + 1).isSpace()) {
+               ++ii;
+            }
+            if (!normalised.isEmpty()) {
+               normalised.append(' ');
+            }
+         } else if (cc == '\'') {
+            // Skip to the closing quote, allowing for '' as an escaped quote inside the string
+            while (ii + 1 < length) {
+               ++ii;
+               if (query.at(ii) == '\'') {
+                  if (ii + 1 < length && query.at(ii + 1) == '\'') {
+                     ++ii;
+                  } else {
+                     break;
+                  }
+               }
+            }
+            normalised.append('?');
+         } else if (cc.isDigit() &&
+                    (normalised.isEmpty() || !isIdentifierCharacter(normalised.at(normalised.size() - 1)))) {
+            // A number on its own, rather than part of an identifier such as hop_id2
+            while (ii + 1 < length && (query.at(ii + 1).isDigit() || query.at(ii + 1) == '.')) {
+               ++ii;
+            }
+            normalised.append('?');
+         } else {
+            normalised.append(cc);
+         }
+      }
+      return normalised.trimmed();
+   }
+}
+
+BtSqlQuery::~BtSqlQuery() {
+   this->recordRowsRead();
+   return;
+}
+
 bool BtSqlQuery::prepare(const QString & query) {
    //
    // We don't want to call QSqlQuery::prepare() because if there are no bind values and the DB is PostgreSQL then we'll
    // get an error.
    //
+   this->recordRowsRead();
    this->bt_query = query;
    this->bt_boundValues = false;
+   this->bt_statisticsKey.clear();
 
    // Since we didn't actually call QSqlQuery::prepare() (yet), there's no possibility of an error to return
    return true;
@@ -71,6 +136,8 @@ void BtSqlQuery::bindValue(int pos, const QVariant &val, QSql::ParamType paramTy
    *        as a parameter
    */
 bool BtSqlQuery::exec() {
+   this->recordRowsRead();
+   auto const startTime = Clock::now();
    bool result;
    if (this->bt_boundValues) {
       result = this->QSqlQuery::exec();
@@ -79,9 +146,113 @@ bool BtSqlQuery::exec() {
       // pass it to QSqlQuery for execution
       result = this->QSqlQuery::exec(this->bt_query);
    }
+   this->recordExecution(Clock::now() - startTime);
 
    // If someone wants to reuse the object, eg to insert multiple rows with the same query, it's already in the correct
    // state (whether or not there were bound variables, so we're done here.
 
    return result;
 }
+
+bool BtSqlQuery::exec(const QString & query) {
+   this->recordRowsRead();
+   this->bt_query = query;
+   this->bt_boundValues = false;
+   this->bt_statisticsKey.clear();
+   auto const startTime = Clock::now();
+   bool const result = this->QSqlQuery::exec(query);
+   this->recordExecution(Clock::now() - startTime);
+   return result;
+}
+
+bool BtSqlQuery::next() {
+   bool const result = this->QSqlQuery::next();
+   if (result) {
+      // We don't want to take the statistics lock for every row, so we just count here and add the total later
+      ++this->bt_rowsRead;
+   }
+   return result;
+}
+
+void BtSqlQuery::recordExecution(std::chrono::steady_clock::duration elapsed) {
+   if (this->bt_statisticsKey.isEmpty()) {
+      this->bt_statisticsKey = normalise(this->bt_query);
+   }
+   auto const elapsedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed);
+   // For a SELECT, rows get counted as the caller reads them
+   int const rowsAffected = this->isSelect() ? 0 : std::max(0, this->numRowsAffected());
+
+   std::lock_guard<std::mutex> lock{statisticsMutex};
+   auto entry = statistics.find(this->bt_statisticsKey);
+   if (entry == statistics.end()) {
+      entry = statistics.insert(
+         this->bt_statisticsKey,
+         Statistics{this->bt_statisticsKey, 0, std::chrono::nanoseconds{0}, std::chrono::nanoseconds{0}, 0}
+      );
+   }
+   ++entry->executions;
+   entry->totalTime += elapsedNs;
+   entry->maxTime = std::max(entry->maxTime, elapsedNs);
+   entry->rows += rowsAffected;
+   return;
+}
+
+void BtSqlQuery::recordRowsRead() {
+   if (this->bt_rowsRead == 0 || this->bt_statisticsKey.isEmpty()) {
+      return;
+   }
+   std::lock_guard<std::mutex> lock{statisticsMutex};
+   auto entry = statistics.find(this->bt_statisticsKey);
+   // The entry can only be missing if someone reset the statistics while we were reading
+   if (entry != statistics.end()) {
+      entry->rows += this->bt_rowsRead;
+   }
+   this->bt_rowsRead = 0;
+   return;
+}
+
+QVector<BtSqlQuery::Statistics> BtSqlQuery::getStatistics() {
+   QVector<Statistics> result;
+   {
+      std::lock_guard<std::mutex> lock{statisticsMutex};
+      result.reserve(statistics.size());
+      for (auto const & entry : statistics) {
+         result.append(entry);
+      }
+   }
+   std::sort(result.begin(), result.end(), [](Statistics const & lhs, Statistics const & rhs) {
+      return lhs.totalTime > rhs.totalTime;
+   });
+   return result;
+}
+
+void BtSqlQuery::resetStatistics() {
+   std::lock_guard<std::mutex> lock{statisticsMutex};
+   statistics.clear();
+   return;
+}
+
+void BtSqlQuery::logStatistics(int maxQueries) {
+   QVector<Statistics> const allStatistics = BtSqlQuery::getStatistics();
+   long long totalExecutions = 0;
+   std::chrono::nanoseconds totalTime{0};
+   for (auto const & entry : allStatistics) {
+      totalExecutions += entry.executions;
+      totalTime += entry.totalTime;
+   }
+   qInfo() <<
+      Q_FUNC_INFO << allStatistics.size() << "distinct queries," << totalExecutions << "executions," <<
+      std::chrono::duration<double, std::milli>(totalTime).count() << "ms in total.  Top" <<
+      std::min(maxQueries, allStatistics.size()) << "by total time:";
+   for (int ii = 0; ii < std::min(maxQueries, allStatistics.size()); ++ii) {
+      Statistics const & entry = allStatistics.at(ii);
+      qInfo().noquote() <<
+         QString{"%1 executions, %2 ms total, %3 ms max, %4 rows: %5"}
+            .arg(entry.executions)
+            .arg(std::chrono::duration<double, std::milli>(entry.totalTime).count(), 0, 'f', 2)
+            .arg(std::chrono::duration<double, std::milli>(entry.maxTime).count(), 0, 'f', 2)
+            .arg(entry.rows)
+            .arg(entry.query);
+   }
+   return;
+}
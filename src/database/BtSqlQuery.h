@@ -20,8 +20,11 @@
 #define DATABASE_BTSQLQUERY_H
 #pragma once
 
+#include <chrono>
+
 #include <QString>
 #include <QSqlQuery>
+#include <QVector>
 
 /**
  * \class BtSqlQuery is an extension of \c QSqlQuery with more helpful behaviour around prepared statements
@@ -50,12 +53,23 @@
  *        Note that a syntax error in a prepared statement will not get reported until the first call to \c bindValue()
  *        (and will be reported via logging + run-time exception rather than return value), but otherwise behaviour
  *        should be similar to the way you would want \c QSqlQuery to work.
+ *
+ *        We also keep statistics, for each distinct query, of how many times it was executed, how long that took and
+ *        how many rows it returned (or changed), so we can see which queries dominate database time.  Queries are
+ *        grouped after "normalising" them, ie collapsing white space and replacing literal numbers and strings with
+ *        \c ?, so that, eg, the same \c SELECT for different IDs counts as one query.  The statistics can be viewed in
+ *        the Tools > Database Statistics dialog, and logged at exit if the sqlStatisticsLogAtExit setting is on.
+ *
+ *        For rows returned to be counted, callers need to step through results with \c BtSqlQuery::next() (ie with the
+ *        static type of the query object being \c BtSqlQuery), which is what all our code does.
  */
 class BtSqlQuery : public QSqlQuery {
 public:
    // Use the same constructors as QSqlQuery
    using QSqlQuery::QSqlQuery;
 
+   ~BtSqlQuery();
+
    /**
     * \brief As \c QSqlQuery::prepare() except we don't actually call QSqlQuery::prepare() unless and until a value is
     *        bound to the query (via \c bindValue)
@@ -66,22 +80,60 @@ public:
    void bindValue(const QString &placeholder, const QVariant &val, QSql::ParamType paramType = QSql::In);
    void bindValue(int pos, const QVariant &val, QSql::ParamType paramType = QSql::In);
 
-   // Allow access to the version of QSqlQuery::exec() that we don't override
-   using QSqlQuery::exec;
-
    /**
     * \brief As \c QSqlQuery::exec() except that if no values were bound to the query, we pass the SQL from \c prepare()
     *        as a parameter
     */
    bool exec();
 
+   /**
+    * \brief As \c QSqlQuery::exec(const QString &), but recording statistics
+    */
+   bool exec(const QString & query);
+
+   /**
+    * \brief As \c QSqlQuery::next(), but counting rows for the statistics
+    */
+   bool next();
+
+   /**
+    * \brief Statistics for one (normalised) query
+    */
+   struct Statistics {
+      QString query;
+      long long executions;
+      std::chrono::nanoseconds totalTime;
+      std::chrono::nanoseconds maxTime;
+      // Rows returned by SELECTs, plus rows affected by other statements
+      long long rows;
+   };
+
+   /**
+    * \brief Get statistics for all queries executed since the start of the program (or the last call to
+    *        \c resetStatistics()), in descending order of total time
+    */
+   static QVector<Statistics> getStatistics();
+
+   static void resetStatistics();
+
+   /**
+    * \brief Write the statistics for the \c maxQueries queries with the most total time to the log at info level
+    */
+   static void logStatistics(int maxQueries = 50);
+
 private:
    // We need to be careful about names to avoid clashes with anything in the base class
    QString bt_query;
    bool bt_boundValues = false;
+   // The normalised form of bt_query, under which we record statistics.  Calculated when first needed.
+   QString bt_statisticsKey;
+   // Rows read by next() since the last exec, not yet added to the statistics
+   long long bt_rowsRead = 0;
 
    void reallyPrepare();
 
+   void recordExecution(std::chrono::steady_clock::duration elapsed);
+   void recordRowsRead();
 
 };
 
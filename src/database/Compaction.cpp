@@ -0,0 +1,475 @@
+/*
+ * database/Compaction.cpp is part of Brewtarget, and is copyright the following
+ * authors 2021:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "database/Compaction.h"
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+
+#include <QDebug>
+#include <QFileInfo>
+#include <QHash>
+#include <QSet>
+#include <QTimer>
+#include <QVector>
+
+#include "database/Database.h"
+#include "database/DatabaseSchemaHelper.h"
+#include "database/ObjectStoreTyped.h"
+#include "Logging.h"
+#include "model/BrewNote.h"
+#include "model/Equipment.h"
+#include "model/Fermentable.h"
+#include "model/Hop.h"
+#include "model/Instruction.h"
+#include "model/Mash.h"
+#include "model/MashStep.h"
+#include "model/Misc.h"
+#include "model/Recipe.h"
+#include "model/Salt.h"
+#include "model/Style.h"
+#include "model/Water.h"
+#include "model/Yeast.h"
+#include "PersistentSettings.h"
+
+//
+// Anonymous namespace for constants, global variables and functions used only in this file
+//
+namespace {
+   using ObjectReference = ObjectStore::ObjectReference;
+
+   // How many objects we hard-delete each time round the event loop, so that the UI stays responsive
+   int const deletionsPerBatch = 100;
+
+   // VACUUM rewrites the whole DB, so we don't want to do it every session
+   int const sessionsBetweenVacuum = 30;
+
+   // ...unless we have just deleted enough to make it worthwhile straight away
+   int const deletionsForImmediateVacuum = 1000;
+
+   /**
+    * \brief How objects of a given type are kept from being collected
+    */
+   enum class Role {
+      // Kept if not soft-deleted and not an ingredient use, or if referenced by something we keep
+      Independent,
+      // Kept only if referenced by something we keep (eg Instruction, which only exists as part of a Recipe)
+      Referenced,
+      // Kept if and only if the owner its foreign key points to is kept (eg BrewNote, whose Recipe owns it)
+      Owned
+   };
+
+   /**
+    * \brief What we need to know about each type of object we collect
+    */
+   struct CollectableType {
+      ObjectStore const * objectStore;
+      Role role;
+      // Hard-deleting objects of this type (ie Recipe) also hard-deletes what they refer to in junction tables
+      bool deleteCascadesToJunctionTables;
+      std::function<QVector<int>()> getAllIds;
+      // Soft-deleted or an ingredient use
+      std::function<bool(int)> isDeletedOrUse;
+      // Does nothing if the object has already gone, eg because it was deleted along with its owner
+      std::function<void(int)> hardDelete;
+   };
+
+   template<class NE> CollectableType makeCollectableType(Role role, bool deleteCascadesToJunctionTables = false) {
+      ObjectStoreTyped<NE> & objectStore = ObjectStoreTyped<NE>::getInstance();
+      return CollectableType{
+         &objectStore,
+         role,
+         deleteCascadesToJunctionTables,
+         [&objectStore]() {
+            QVector<int> ids;
+            for (NE const * ne : objectStore.getAllRaw()) {
+               ids.append(ne->key());
+            }
+            return ids;
+         },
+         [&objectStore](int id) {
+            auto ne = objectStore.getById(id);
+            return ne && (ne->deleted() || ne->getParentKey() > 0);
+         },
+         [&objectStore](int id) {
+            if (objectStore.contains(id)) {
+               objectStore.hardDelete(id);
+            }
+            return;
+         }
+      };
+   }
+
+   /**
+    * \brief Works out what can be hard-deleted, and in what order, from the contents of the object stores.  Doesn't
+    *        change anything.
+    */
+   class Planner {
+   public:
+      Planner() : types{},
+                  typeByTableName{} {
+         this->addType(makeCollectableType<Recipe>     (Role::Independent, true));
+         this->addType(makeCollectableType<BrewNote>   (Role::Owned));
+         this->addType(makeCollectableType<Equipment>  (Role::Independent));
+         this->addType(makeCollectableType<Fermentable>(Role::Independent));
+         this->addType(makeCollectableType<Hop>        (Role::Independent));
+         this->addType(makeCollectableType<Instruction>(Role::Referenced));
+         this->addType(makeCollectableType<Mash>       (Role::Independent));
+         this->addType(makeCollectableType<MashStep>   (Role::Owned));
+         this->addType(makeCollectableType<Misc>       (Role::Independent));
+         this->addType(makeCollectableType<Salt>       (Role::Referenced));
+         this->addType(makeCollectableType<Style>      (Role::Independent));
+         this->addType(makeCollectableType<Water>      (Role::Independent));
+         this->addType(makeCollectableType<Yeast>      (Role::Independent));
+         return;
+      }
+
+      /**
+       * \brief Work out what to delete and in what order
+       */
+      QVector<ObjectReference> planDeletions() const {
+         //
+         // The Recipe the main window shows at startup is kept even if it's been soft-deleted, as the UI is using it
+         //
+         QSet<ObjectReference> extraRoots;
+         int const currentRecipeId = PersistentSettings::value(PersistentSettings::Names::recipeKey, -1).toInt();
+         if (currentRecipeId > 0) {
+            extraRoots.insert(
+               ObjectReference{*ObjectStoreTyped<Recipe>::getInstance().tableName(), currentRecipeId}
+            );
+         }
+
+         //
+         // Deleting a Recipe also deletes everything in its junction tables (ingredients, instructions etc), so we can
+         // only delete one whose junction table contents are all garbage.  If that's not the case, we keep the Recipe,
+         // which means keeping what it refers to, so we have to go round again.
+         //
+         QSet<ObjectReference> reachable;
+         QVector<ObjectReference> garbage;
+         for (;;) {
+            reachable = this->findReachable(extraRoots);
+            garbage = this->findGarbage(reachable);
+            int const numExtraRoots = extraRoots.size();
+            for (auto const & objectReference : garbage) {
+               CollectableType const & type = this->types[this->typeByTableName.value(objectReference.first)];
+               if (!type.deleteCascadesToJunctionTables) {
+                  continue;
+               }
+               QVector<ObjectReference> foreignKeyReferences;
+               QVector<ObjectReference> junctionTableReferences;
+               type.objectStore->getReferencedIds(objectReference.second,
+                                                  foreignKeyReferences,
+                                                  junctionTableReferences);
+               if (std::any_of(junctionTableReferences.cbegin(),
+                               junctionTableReferences.cend(),
+                               [&reachable](ObjectReference const & ii) { return reachable.contains(ii); })) {
+                  qCDebug(lcDatabase) <<
+                     Q_FUNC_INFO << "Keeping" << objectReference << "as it shares objects with something we're keeping";
+                  extraRoots.insert(objectReference);
+               }
+            }
+            if (extraRoots.size() == numExtraRoots) {
+               break;
+            }
+         }
+
+         return this->orderForDeletion(garbage);
+      }
+
+      /**
+       * \brief The DB enforces foreign key constraints, so we must delete anything that refers to an object before we
+       *        delete the object itself.  (If it's already been deleted along with its owner by the time we get to it,
+       *        that's fine.)
+       */
+      QVector<ObjectReference> orderForDeletion(QVector<ObjectReference> const & garbage) const {
+         QSet<ObjectReference> garbageSet;
+         for (auto const & objectReference : garbage) {
+            garbageSet.insert(objectReference);
+         }
+         QHash<ObjectReference, QVector<ObjectReference> > referencedBy;
+         QHash<ObjectReference, int> numReferences;
+         for (auto const & objectReference : garbage) {
+            QVector<ObjectReference> foreignKeyReferences;
+            QVector<ObjectReference> junctionTableReferences;
+            this->types[this->typeByTableName.value(objectReference.first)].objectStore->getReferencedIds(
+               objectReference.second,
+               foreignKeyReferences,
+               junctionTableReferences
+            );
+            for (auto const & referenced : foreignKeyReferences + junctionTableReferences) {
+               if (garbageSet.contains(referenced)) {
+                  referencedBy[objectReference].append(referenced);
+                  ++numReferences[referenced];
+               }
+            }
+         }
+
+         QVector<ObjectReference> ordered;
+         ordered.reserve(garbage.size());
+         QVector<ObjectReference> ready;
+         for (auto const & objectReference : garbage) {
+            if (numReferences.value(objectReference) == 0) {
+               ready.append(objectReference);
+            }
+         }
+         while (!ready.isEmpty()) {
+            ObjectReference const objectReference = ready.takeLast();
+            ordered.append(objectReference);
+            for (auto const & referenced : referencedBy.value(objectReference)) {
+               if (--numReferences[referenced] == 0) {
+                  ready.append(referenced);
+               }
+            }
+         }
+
+         if (ordered.size() < garbage.size()) {
+            // Shouldn't happen, as nothing we store refers round in a circle, but, if it does, we'd rather keep the
+            // objects than risk the DB rejecting the deletes
+            qWarning() <<
+               Q_FUNC_INFO << "Not deleting" << garbage.size() - ordered.size() << "objects that refer to each other";
+         }
+         return ordered;
+      }
+
+      void hardDelete(ObjectReference const & objectReference) const {
+         this->types[this->typeByTableName.value(objectReference.first)].hardDelete(objectReference.second);
+         return;
+      }
+
+      int countObjects() const {
+         int count = 0;
+         for (auto const & type : this->types) {
+            count += type.objectStore->size();
+         }
+         return count;
+      }
+
+   private:
+      void addType(CollectableType const & type) {
+         this->typeByTableName.insert(*type.objectStore->tableName(), this->types.size());
+         this->types.append(type);
+         return;
+      }
+
+      /**
+       * \brief Mark everything we need to keep, starting from the "roots" (objects that are kept for their own sake)
+       *        and following references from there.
+       */
+      QSet<ObjectReference> findReachable(QSet<ObjectReference> const & extraRoots) const {
+         // Owned objects refer to their owner, but we need to get from the owner to them
+         QHash<ObjectReference, QVector<ObjectReference> > ownedObjects;
+         QVector<ObjectReference> toVisit;
+         for (auto const & type : this->types) {
+            QString const tableName{*type.objectStore->tableName()};
+            for (int id : type.getAllIds()) {
+               ObjectReference const objectReference{tableName, id};
+               if (type.role == Role::Owned) {
+                  QVector<ObjectReference> foreignKeyReferences;
+                  QVector<ObjectReference> junctionTableReferences;
+                  type.objectStore->getReferencedIds(id, foreignKeyReferences, junctionTableReferences);
+                  for (auto const & owner : foreignKeyReferences) {
+                     ownedObjects[owner].append(objectReference);
+                  }
+               } else if (type.role == Role::Independent && !type.isDeletedOrUse(id)) {
+                  toVisit.append(objectReference);
+               }
+            }
+         }
+         for (auto const & extraRoot : extraRoots) {
+            toVisit.append(extraRoot);
+         }
+
+         QSet<ObjectReference> reachable;
+         while (!toVisit.isEmpty()) {
+            ObjectReference const objectReference = toVisit.takeLast();
+            if (reachable.contains(objectReference)) {
+               continue;
+            }
+            reachable.insert(objectReference);
+            toVisit.append(ownedObjects.value(objectReference));
+
+            // Objects we don't collect (eg inventory records) don't keep anything else alive.  Nor do owned objects,
+            // as their only references are back to their owner.
+            int const typeIndex = this->typeByTableName.value(objectReference.first, -1);
+            if (typeIndex < 0 || this->types[typeIndex].role == Role::Owned) {
+               continue;
+            }
+            QVector<ObjectReference> foreignKeyReferences;
+            QVector<ObjectReference> junctionTableReferences;
+            this->types[typeIndex].objectStore->getReferencedIds(objectReference.second,
+                                                                 foreignKeyReferences,
+                                                                 junctionTableReferences);
+            toVisit.append(foreignKeyReferences);
+            toVisit.append(junctionTableReferences);
+         }
+         return reachable;
+      }
+
+      QVector<ObjectReference> findGarbage(QSet<ObjectReference> const & reachable) const {
+         QVector<ObjectReference> garbage;
+         for (auto const & type : this->types) {
+            QString const tableName{*type.objectStore->tableName()};
+            for (int id : type.getAllIds()) {
+               ObjectReference const objectReference{tableName, id};
+               if (!reachable.contains(objectReference)) {
+                  garbage.append(objectReference);
+               }
+            }
+         }
+         return garbage;
+      }
+
+      QVector<CollectableType> types;
+      QHash<QString, int> typeByTableName;
+   };
+
+   /**
+    * \brief Does the work for \c Compaction::start().  Lives until the last batch of deletes has been scheduled.
+    */
+   class Collector {
+   public:
+      Collector(Database & database) : database{database},
+                                       planner{},
+                                       deletionOrder{},
+                                       nextDeletion{0},
+                                       objectsBefore{0} {
+         this->objectsBefore = this->planner.countObjects();
+         this->deletionOrder = this->planner.planDeletions();
+         qInfo() <<
+            Q_FUNC_INFO << "Found" << this->deletionOrder.size() << "unused objects (out of" << this->objectsBefore <<
+            ") to hard-delete";
+         return;
+      }
+
+      /**
+       * \brief Delete the next batch of objects, then either schedule the next batch or finish off
+       *
+       * \return \c true if there is more to do, \c false if we are finished
+       */
+      bool deleteNextBatch() {
+         int const batchEnd = std::min(this->nextDeletion + deletionsPerBatch, this->deletionOrder.size());
+         for (; this->nextDeletion < batchEnd; ++this->nextDeletion) {
+            this->planner.hardDelete(this->deletionOrder.at(this->nextDeletion));
+         }
+         if (this->nextDeletion < this->deletionOrder.size()) {
+            return true;
+         }
+         this->finish();
+         return false;
+      }
+
+   private:
+      /**
+       * \brief Log what we did and, if it's due, queue a VACUUM to run after the DB deletes
+       */
+      void finish() {
+         int const objectsDeleted = this->objectsBefore - this->planner.countObjects();
+         qInfo() << Q_FUNC_INFO << "Hard-deleted" << objectsDeleted << "unused objects";
+
+         int const sessions =
+            PersistentSettings::value(PersistentSettings::Names::sessionsSinceDbVacuum, 0).toInt() + 1;
+         PersistentSettings::insert(PersistentSettings::Names::sessionsSinceDbVacuum, sessions);
+         if (sessions < sessionsBetweenVacuum && objectsDeleted < deletionsForImmediateVacuum) {
+            return;
+         }
+
+         // The write thread runs the VACUUM, and logs how much space it reclaimed.  The counter is only reset if it
+         // worked, so that, otherwise, we try again next time.
+         Database & database = this->database;
+         database.enqueueMaintenance(
+            [&database](QSqlDatabase & connection) {
+               return DatabaseSchemaHelper::vacuum(database, connection);
+            },
+            [](bool succeeded) {
+               if (succeeded) {
+                  PersistentSettings::insert(PersistentSettings::Names::sessionsSinceDbVacuum, 0);
+               }
+               return;
+            }
+         );
+         return;
+      }
+
+      Database & database;
+      Planner const planner;
+      QVector<ObjectReference> deletionOrder;
+      int nextDeletion;
+      int objectsBefore;
+   };
+
+   std::unique_ptr<Collector> collector;
+
+   void runNextBatch() {
+      if (!collector) {
+         return;
+      }
+      if (collector->deleteNextBatch()) {
+         QTimer::singleShot(0, runNextBatch);
+      } else {
+         collector.reset();
+      }
+      return;
+   }
+}
+
+void Compaction::start(Database & database) {
+   //
+   // Compaction permanently deletes things, so it only happens if the user has asked for it
+   //
+   if (!PersistentSettings::value(PersistentSettings::Names::compactDbAtStartup, false).toBool()) {
+      qCDebug(lcDatabase) << Q_FUNC_INFO << "Compaction at startup is not turned on";
+      return;
+   }
+
+   if (collector) {
+      qWarning() << Q_FUNC_INFO << "Compaction already running";
+      return;
+   }
+
+   //
+   // The first time we compact a DB, we take a backup of it first, so that, if we delete something the user wanted,
+   // they can get it back.  If we can't take a backup (eg because it's a PostgreSQL DB, which we can't just copy), we
+   // don't compact.
+   //
+   QString const backupFileName = PersistentSettings::value(PersistentSettings::Names::dbCompactionBackup).toString();
+   if (backupFileName.isEmpty() || !QFileInfo::exists(backupFileName)) {
+      QString const newBackupFileName =
+         PersistentSettings::getUserDataDir().filePath("database-before-first-compaction.sqlite");
+      if (database.dbType() != Database::SQLITE || !database.backupToFile(newBackupFileName)) {
+         qWarning() << Q_FUNC_INFO << "Not compacting DB as unable to take backup" << newBackupFileName;
+         return;
+      }
+      qInfo() << Q_FUNC_INFO << "Backed up DB to" << newBackupFileName << "before compacting it for the first time";
+      PersistentSettings::insert(PersistentSettings::Names::dbCompactionBackup, newBackupFileName);
+   }
+
+   collector = std::make_unique<Collector>(database);
+   QTimer::singleShot(0, runNextBatch);
+   return;
+}
+
+QVector<ObjectStore::ObjectReference> Compaction::planDeletions() {
+   return Planner{}.planDeletions();
+}
+
+QVector<ObjectStore::ObjectReference> Compaction::orderForDeletion(
+   QVector<ObjectStore::ObjectReference> const & garbage
+) {
+   return Planner{}.orderForDeletion(garbage);
+}
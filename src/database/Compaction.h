@@ -0,0 +1,76 @@
+/*
+ * database/Compaction.h is part of Brewtarget, and is copyright the following
+ * authors 2021:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef DATABASE_COMPACTION_H
+#define DATABASE_COMPACTION_H
+#pragma once
+
+#include <QVector>
+
+#include "database/ObjectStore.h"
+
+class Database;
+
+/**
+ * \brief Garbage collection for the object stores and the DB.
+ *
+ *        Deleting something from the UI only soft-deletes it (see \c ObjectStoreTyped::softDelete), and each Recipe
+ *        has its own copies of the ingredients it uses, so, over time, the DB and the in-memory cache fill up with
+ *        objects that nothing can ever see again.  Once a session, we work out which objects are still needed, by
+ *        following references (foreign keys and junction tables) from everything that is neither soft-deleted nor an
+ *        ingredient use (ie an object with a parent, such as the copy of a Hop used in a Recipe).  Anything of the same
+ *        types that we don't reach this way is hard-deleted, a batch at a time, from the GUI thread's event loop, with
+ *        the DB deletes being done in the background on the DB write thread.
+ *
+ *        Then, every so often (or straight away if we deleted a lot), we VACUUM the DB so that the space is given back
+ *        to the file system, and log how much space was reclaimed.
+ *
+ *        Because the deletes are permanent, none of this happens unless the user has turned it on (with the
+ *        compactDbAtStartup setting, which is off by default and can be changed on the Tools > Database Statistics
+ *        dialog), and, the first time it does, we take a backup of the DB first.
+ *
+ *        BrewNotes and MashSteps belong to their Recipe and Mash respectively, so they are kept if and only if their
+ *        owner is.  Instructions and Salts only exist as part of a Recipe, so they are kept only if a Recipe we keep
+ *        uses them.  Inventory records are left alone.
+ */
+namespace Compaction {
+
+   /**
+    * \brief If compaction is turned on, work out what can be hard-deleted and schedule the deletes to run once the
+    *        event loop is going.  Should be called once, at the end of startup, on the GUI thread.
+    *
+    *        If we have not previously done so (or the backup has since been removed), we first back up the DB (see
+    *        \c Database::backupToFile()).  If that isn't possible, nothing is deleted.
+    */
+   void start(Database & database);
+
+   /**
+    * \brief Work out what \c start() would hard-delete, in the order it would delete it, without changing anything
+    */
+   QVector<ObjectStore::ObjectReference> planDeletions();
+
+   /**
+    * \brief Put the supplied objects in an order in which they can be hard-deleted without breaking the DB's foreign
+    *        key constraints, ie so that anything that refers to an object comes before it.  Objects that refer to each
+    *        other in a circle are left out.
+    */
+   QVector<ObjectStore::ObjectReference> orderForDeletion(QVector<ObjectStore::ObjectReference> const & garbage);
+
+}
+
+#endif
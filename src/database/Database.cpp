@@ -51,6 +51,7 @@
 #include <QMutex>
 #include <QMutexLocker>
 #include <QObject>
+#include <QSemaphore>
 #include <QSqlDriver>
 #include <QSqlError>
 #include <QSqlField>
@@ -61,8 +62,13 @@
 #include "config.h"
 #include "database/BtSqlQuery.h"
 #include "database/DatabaseSchemaHelper.h"
+#include "database/DbWriteThread.h"
+#include "database/ObjectStoreSnapshot.h"
+#include "database/ObjectStoreTyped.h"
+#include "Logging.h"
 #include "PersistentSettings.h"
 #include "utils/BtStringConst.h"
+#include "utils/StartupProfile.h"
 
 namespace {
 
@@ -150,6 +156,27 @@ namespace {
       {Database::PGSQL,  QString{"%1-%2"}.arg(getDbNativeName(displayableDbType, Database::PGSQL)).arg(reinterpret_cast<quintptr>(QThread::currentThreadId()), 0, 36)}
    };
 
+   //
+   // Similarly, a thread that uses Database::ReadOnlyConnection needs a separate connection for that.  Note that these
+   // names need to start with the same prefix as the ones above so that Database::unload() closes them too.
+   //
+   thread_local QMap<int, QString> const readOnlyConnectionNamesForThisThread {
+      {Database::SQLITE, QString{"%1-ro-%2"}.arg(getDbNativeName(displayableDbType, Database::SQLITE)).arg(reinterpret_cast<quintptr>(QThread::currentThreadId()), 0, 36)},
+      {Database::PGSQL,  QString{"%1-ro-%2"}.arg(getDbNativeName(displayableDbType, Database::PGSQL)).arg(reinterpret_cast<quintptr>(QThread::currentThreadId()), 0, 36)}
+   };
+
+   //
+   // How long an SQLite connection waits for another connection's lock to be released before giving up with "database
+   // is locked".  In WAL mode, readers never need to wait for the writer, but this covers the brief exclusive lock
+   // taken at checkpoint, and the (rare) case of two threads writing at once.
+   //
+   int const sqliteBusyTimeoutMs = 5000;
+
+   //
+   // How many sessions we go between updating the query planner statistics (see DatabaseSchemaHelper::analyze()).
+   //
+   int const sessionsBetweenAnalyze = 10;
+
    //
    // At start-up, we know what type of database to talk to (and thus what type of Database object to return from
    // Database::instance()) by looking in PersistentSettings (and defaulting to SQLite if nothing is marked there).  But
@@ -223,7 +250,9 @@ public:
                                    dbConName{},
                                    loaded{false},
                                    loadWasSuccessful{false},
-                                   mutex{} {
+                                   mutex{},
+                                   readOnlyConnectionsAvailable{Database::maxReadOnlyConnections},
+                                   writeThread{} {
       return;
    }
 
@@ -234,22 +263,25 @@ public:
 
    // Don't know where to put this, so it goes here for right now
    bool loadSQLite(Database & database) {
-      qDebug() << "Loading SQLITE...";
+      qCDebug(lcDatabase) << "Loading SQLITE...";
 
       // Set file names.
       this->dbFileName = PersistentSettings::getUserDataDir().filePath("database.sqlite");
       this->dataDbFileName = Brewtarget::getResourceDir().filePath("default_db.sqlite");
-      qDebug().noquote() <<
+      qCDebug(lcDatabase).noquote() <<
          Q_FUNC_INFO << "dbFileName = \"" << this->dbFileName << "\"\ndataDbFileName=\"" << this->dataDbFileName << "\"";
       // Set the files.
       this->dbFile.setFileName(this->dbFileName);
       this->dataDbFile.setFileName(this->dataDbFileName);
+      this->snapshotFileName = QString("%1.snapshot").arg(this->dbFileName);
 
       // If user restored the database from a backup, make the backup into the primary.
       {
          QFile newdb(QString("%1.new").arg(this->dbFileName));
          if (newdb.exists()) {
             this->dbFile.remove();
+            this->removeWalFiles();
+            ObjectStoreSnapshot::remove(this->snapshotFileName);
             newdb.copy(this->dbFileName);
             QFile::setPermissions(this->dbFileName, QFile::ReadOwner | QFile::WriteOwner | QFile::ReadGroup );
             newdb.remove();
@@ -260,6 +292,10 @@ public:
       if (!this->dbFile.exists()) {
          Brewtarget::userDatabaseDidNotExist = true;
 
+         // A write-ahead log without the DB it belongs to is no use to anyone, and would corrupt whatever DB we put in
+         // its place
+         this->removeWalFiles();
+
          // Have to wait until db is open before creating from scratch.
          if (this->dataDbFile.exists()) {
             this->dataDbFile.copy(this->dbFileName);
@@ -270,6 +306,13 @@ public:
          Database::lastDbMergeRequest = QDateTime::currentDateTime();
       }
 
+      // Now we know which file we're using, see whether we can read everything from the start-up snapshot instead.
+      // This needs to happen before we open any connection to the DB.  (If it turns out below that we need to create
+      // or upgrade the DB then Database::load() will close the snapshot again.)
+      ObjectStoreSnapshot::instance().open(this->snapshotFileName,
+                                           QFileInfo{this->dbFileName},
+                                           DatabaseSchemaHelper::dbVersion);
+
       // Open SQLite DB
       // It's a coding error if we didn't already establish that SQLite is the type of DB we're talking to, so assert
       // that and then call the generic code to get a connection
@@ -277,7 +320,7 @@ public:
       QSqlDatabase connection = database.sqlDatabase();
 
       this->dbConName = connection.connectionName();
-      qDebug() << Q_FUNC_INFO << "dbConName=" << this->dbConName;
+      qCDebug(lcDatabase) << Q_FUNC_INFO << "dbConName=" << this->dbConName;
 
       //
       // It's quite useful to record the DB version in the logs
@@ -293,24 +336,24 @@ public:
       QVariant fieldValue = sqlQuery.value("version");
       qInfo() << Q_FUNC_INFO << "SQLite version" << fieldValue;
 
-      // NOTE: synchronous=off reduces query time by an order of magnitude!
+      //
+      // We used to open the DB with locking_mode = EXCLUSIVE, but that stops any other connection (including those
+      // from our own background threads) reading it.  Instead, we use write-ahead logging, which lets readers carry on
+      // (seeing the last committed state of the DB) whilst the writer writes.  Unlike the other pragmas (which are set
+      // for each connection in openConnection()), the journal mode is stored in the DB file, so we only need to set it
+      // once -- but it is harmless to do so every time.  The pragma returns the journal mode actually in force.
+      //
       BtSqlQuery pragma(connection);
-      if ( ! pragma.exec( "PRAGMA synchronous = off" ) ) {
-         qCritical() << Q_FUNC_INFO << "Could not disable synchronous writes: " << pragma.lastError().text();
+      if (!pragma.exec("PRAGMA journal_mode = WAL") || !pragma.next()) {
+         qCritical() << Q_FUNC_INFO << "Could not enable write-ahead logging: " << pragma.lastError().text();
          return false;
       }
-      if ( ! pragma.exec( "PRAGMA foreign_keys = on")) {
-         qCritical() << Q_FUNC_INFO << "Could not enable foreign keys: " << pragma.lastError().text();
-         return false;
-      }
-      if ( ! pragma.exec( "PRAGMA locking_mode = EXCLUSIVE")) {
-         qCritical() << Q_FUNC_INFO << "Could not enable exclusive locks: " << pragma.lastError().text();
-         return false;
-      }
-      if ( ! pragma.exec("PRAGMA temp_store = MEMORY") ) {
-         qCritical() << Q_FUNC_INFO << "Could not enable temporary memory: " << pragma.lastError().text();
-         return false;
+      QString const journalMode = pragma.value(0).toString();
+      if (journalMode.toLower() != "wal") {
+         // We can still run, it's just that background threads will have to wait for the GUI thread's writes
+         qWarning() << Q_FUNC_INFO << "Journal mode is" << journalMode << "rather than WAL";
       }
+      pragma.finish();
 
       // older sqlite databases may not have a settings table. I think I will
       // just check to see if anything is in there.
@@ -360,7 +403,7 @@ public:
       QSqlDatabase connection = database.sqlDatabase();
 
       this->dbConName = connection.connectionName();
-      qDebug() << Q_FUNC_INFO << "dbConName=" << this->dbConName;
+      qCDebug(lcDatabase) << Q_FUNC_INFO << "dbConName=" << this->dbConName;
 
       //
       // It's quite useful to record the DB version in the logs
@@ -404,6 +447,202 @@ public:
    }
 
 
+   /**
+    * \brief Create, open and configure a new connection with the given name.  Throws a QString if this fails, as
+    *        there's not much we can do to recover if we can't talk to the DB.
+    */
+   QSqlDatabase openConnection(QString const & connectionName, bool readOnly) {
+      //
+      // Create a new connection in Qt's register of connections.  (NB: The call to QSqlDatabase::addDatabase() is
+      // thread-safe, so we don't need to worry about mutexes here.)
+      //
+      QString driverType{this->dbType == Database::PGSQL ? "QPSQL" : "QSQLITE"};
+      qCDebug(lcDatabase) <<
+         Q_FUNC_INFO << "Creating" << (readOnly ? "read-only" : "read-write") << "connection " << connectionName <<
+         " with " << driverType << " driver";
+      QSqlDatabase connection = QSqlDatabase::addDatabase(driverType, connectionName);
+      if (!connection.isValid()) {
+         //
+         // If the connection is not valid, it means the specified driver type is not available or could not be loaded
+         // Log an error here in the knowledge that we'll also throw an exception below
+         //
+         qCritical() << Q_FUNC_INFO << "Unable to load " << driverType << " database driver";
+      }
+
+      qCDebug(lcDatabase) << Q_FUNC_INFO << "Created connection of type" << connection.driver()->handle().typeName();
+
+      //
+      // Initialisation parameters depend on the DB type
+      //
+      if (this->dbType == Database::PGSQL) {
+         connection.setHostName    (this->dbHostname);
+         connection.setDatabaseName(this->dbName);
+         connection.setUserName    (this->dbUsername);
+         connection.setPort        (this->dbPortnum);
+         connection.setPassword    (this->dbPassword);
+      } else {
+         connection.setDatabaseName(this->dbFileName);
+         QString connectOptions = QString{"QSQLITE_BUSY_TIMEOUT=%1"}.arg(sqliteBusyTimeoutMs);
+         if (readOnly) {
+            connectOptions += ";QSQLITE_OPEN_READONLY";
+         }
+         connection.setConnectOptions(connectOptions);
+      }
+
+      //
+      // The moment of truth is when we try to open the new connection
+      //
+      if (!connection.open()) {
+         QString errorMessage;
+         if (this->dbType == Database::PGSQL) {
+            errorMessage = QString{
+               QObject::tr("Could not open PostgreSQL DB connection to %1.\n%2")
+            }.arg(this->dbHostname).arg(connection.lastError().text());
+         } else {
+            errorMessage = QString{
+               QObject::tr("Could not open SQLite DB file %1.\n%2")
+            }.arg(this->dbFileName).arg(connection.lastError().text());
+         }
+         qCritical() << Q_FUNC_INFO << errorMessage;
+
+         if (Brewtarget::isInteractive()) {
+            QMessageBox::critical(nullptr,
+                                  QObject::tr("Database Failure"),
+                                  errorMessage);
+         }
+
+         // If we can't talk to the DB, there's not much we can do to recover
+         throw errorMessage;
+      }
+
+      if (!this->configureConnection(connection, readOnly)) {
+         QString errorMessage = QString{
+            QObject::tr("Could not configure DB connection %1.\n%2")
+         }.arg(connectionName).arg(connection.lastError().text());
+         qCritical() << Q_FUNC_INFO << errorMessage;
+         throw errorMessage;
+      }
+
+      return connection;
+   }
+
+   /**
+    * \brief Settings that need to be made on each connection (as opposed to once for the DB)
+    */
+   bool configureConnection(QSqlDatabase & connection, bool readOnly) {
+      BtSqlQuery pragma(connection);
+      if (this->dbType == Database::PGSQL) {
+         if (readOnly &&
+             !pragma.exec("SET SESSION CHARACTERISTICS AS TRANSACTION READ ONLY")) {
+            qCritical() << Q_FUNC_INFO << "Could not make session read-only: " << pragma.lastError().text();
+            return false;
+         }
+         return true;
+      }
+
+      // NOTE: synchronous=off reduces query time by an order of magnitude!
+      if ( ! pragma.exec( "PRAGMA synchronous = off" ) ) {
+         qCritical() << Q_FUNC_INFO << "Could not disable synchronous writes: " << pragma.lastError().text();
+         return false;
+      }
+      if ( ! pragma.exec( "PRAGMA foreign_keys = on")) {
+         qCritical() << Q_FUNC_INFO << "Could not enable foreign keys: " << pragma.lastError().text();
+         return false;
+      }
+      if ( ! pragma.exec("PRAGMA temp_store = MEMORY") ) {
+         qCritical() << Q_FUNC_INFO << "Could not enable temporary memory: " << pragma.lastError().text();
+         return false;
+      }
+      // Belt-and-braces with QSQLITE_OPEN_READONLY
+      if (readOnly && !pragma.exec("PRAGMA query_only = 1")) {
+         qCritical() << Q_FUNC_INFO << "Could not make connection read-only: " << pragma.lastError().text();
+         return false;
+      }
+      return true;
+   }
+
+   /**
+    * \brief Remove any write-ahead log and its shared-memory index for the SQLite DB file.  Only safe when there are no
+    *        open connections to the DB.
+    */
+   void removeWalFiles() {
+      QFile::remove(QString("%1-wal").arg(this->dbFileName));
+      QFile::remove(QString("%1-shm").arg(this->dbFileName));
+      return;
+   }
+
+   /**
+    * \brief In WAL mode, recently committed changes may be in the write-ahead log rather than the main SQLite DB
+    *        file.  Before we copy the DB file, we need to move them into it.  (If there are no connections open on this
+    *        thread, there is nothing to do, because, when the last connection to a DB closes, SQLite checkpoints the
+    *        log and deletes it.)
+    */
+   void checkpoint() {
+      QString const connectionName = dbConnectionNamesForThisThread.value(Database::SQLITE);
+      if (this->dbType != Database::SQLITE || !QSqlDatabase::contains(connectionName)) {
+         return;
+      }
+      QSqlDatabase connection = QSqlDatabase::database(connectionName);
+      BtSqlQuery pragma(connection);
+      // The first column of the result is non-zero if the checkpoint could not complete because another connection
+      // was using the DB
+      if (!pragma.exec("PRAGMA wal_checkpoint(TRUNCATE)") || !pragma.next()) {
+         qWarning() << Q_FUNC_INFO << "Could not checkpoint write-ahead log: " << pragma.lastError().text();
+      } else if (pragma.value(0).toInt() != 0) {
+         qWarning() << Q_FUNC_INFO << "Write-ahead log checkpoint incomplete as DB busy";
+      }
+      return;
+   }
+
+   /**
+    * \brief Every few sessions, and after the schema has been created or changed, update the query planner
+    *        statistics, so that they keep up with the tables growing.  We do this at shutdown rather than start-up so as
+    *        not to keep the user waiting.
+    */
+   void periodicAnalyze(Database & database) {
+      int sessions = PersistentSettings::value(PersistentSettings::Names::sessionsSinceDbAnalyze, 0).toInt() + 1;
+      if (sessions >= sessionsBetweenAnalyze || this->createFromScratch || this->schemaUpdated) {
+         //
+         // ANALYZE writes to the DB, so, like any other write, it goes via the write thread (if it's running), after
+         // whatever is already queued.  We need to know whether it worked before we can update the counter, so we wait
+         // for it.
+         //
+         std::future<bool> analyzed = this->enqueue(
+            database,
+            [](QSqlDatabase & connection) { return DatabaseSchemaHelper::analyze(connection); },
+            nullptr,
+            true
+         );
+         if (analyzed.get()) {
+            sessions = 0;
+         }
+      }
+      PersistentSettings::insert(PersistentSettings::Names::sessionsSinceDbAnalyze, sessions);
+      return;
+   }
+
+   /**
+    * \brief Does the work for \c Database::enqueueWrite() and \c Database::enqueueMaintenance()
+    */
+   std::future<bool> enqueue(Database & database,
+                             Database::WriteCommand command,
+                             std::function<void(bool)> onCompletion,
+                             bool inTransaction) {
+      if (this->writeThread && this->writeThread->isRunning()) {
+         return this->writeThread->enqueue(std::move(command), std::move(onCompletion), inTransaction);
+      }
+
+      // No write thread, so just do the write here and now
+      QSqlDatabase connection = database.sqlDatabase();
+      bool const succeeded = DbWriteThread::runWrite(database, connection, command, inTransaction);
+      if (onCompletion) {
+         onCompletion(succeeded);
+      }
+      std::promise<bool> result;
+      result.set_value(succeeded);
+      return result.get_future();
+   }
+
    void automaticBackup(Database & database) {
       int count = PersistentSettings::value(PersistentSettings::Names::count, 0, PersistentSettings::Sections::backups).toInt() + 1;
       int frequency = PersistentSettings::value(PersistentSettings::Names::frequency, 4, PersistentSettings::Sections::backups).toInt();
@@ -501,11 +740,18 @@ public:
    // Used for locking member functions that must be single-threaded
    QMutex mutex;
 
+   // Counts the read-only connections not currently leased out by Database::ReadOnlyConnection
+   QSemaphore readOnlyConnectionsAvailable;
+
+   // Runs the writes queued by Database::enqueueWrite() whilst we are loaded
+   std::unique_ptr<DbWriteThread> writeThread;
+
    // These are for SQLite databases
    QFile dbFile;
    QString dbFileName;
    QFile dataDbFile;
    QString dataDbFileName;
+   QString snapshotFileName;
 
    // And these are for Postgres databases
    QString dbHostname;
@@ -552,72 +798,38 @@ QSqlDatabase Database::sqlDatabase() const {
    Q_ASSERT(!connectionName.isEmpty());
    QSqlDatabase connection = QSqlDatabase::database(connectionName);
    if (connection.isValid()) {
-      qDebug() << Q_FUNC_INFO << "Returning connection " << connectionName;
+      qCDebug(lcDatabase) << Q_FUNC_INFO << "Returning connection " << connectionName;
       return connection;
    }
 
-   //
-   // Create a new connection in Qt's register of connections.  (NB: The call to QSqlDatabase::addDatabase() is thread-
-   // safe, so we don't need to worry about mutexes here.)
-   //
-   QString driverType{this->pimpl->dbType == Database::PGSQL ? "QPSQL" : "QSQLITE"};
-   qDebug() <<
-      Q_FUNC_INFO << "Creating connection " << connectionName << " with " << driverType << " driver";
-   connection = QSqlDatabase::addDatabase(driverType, connectionName);
-   if (!connection.isValid()) {
-      //
-      // If the connection is not valid, it means the specified driver type is not available or could not be loaded
-      // Log an error here in the knowledge that we'll also throw an exception below
-      //
-      qCritical() << Q_FUNC_INFO << "Unable to load " << driverType << " database driver";
-   }
-
-   qDebug() << Q_FUNC_INFO << "Created connection of type" << connection.driver()->handle().typeName();
-
-   //
-   // Initialisation parameters depend on the DB type
-   //
-   if (this->pimpl->dbType == Database::PGSQL) {
-      connection.setHostName    (this->pimpl->dbHostname);
-      connection.setDatabaseName(this->pimpl->dbName);
-      connection.setUserName    (this->pimpl->dbUsername);
-      connection.setPort        (this->pimpl->dbPortnum);
-      connection.setPassword    (this->pimpl->dbPassword);
-   } else {
-      connection.setDatabaseName(this->pimpl->dbFileName);
-   }
+   return this->pimpl->openConnection(connectionName, false);
+}
 
-   //
-   // The moment of truth is when we try to open the new connection
-   //
-   if (!connection.open()) {
-      QString errorMessage;
-      if (this->pimpl->dbType == Database::PGSQL) {
-         errorMessage = QString{
-            QObject::tr("Could not open PostgreSQL DB connection to %1.\n%2")
-         }.arg(this->pimpl->dbHostname).arg(connection.lastError().text());
-      } else {
-         errorMessage = QString{
-            QObject::tr("Could not open SQLite DB file %1.\n%2")
-         }.arg(this->pimpl->dbFileName).arg(connection.lastError().text());
-      }
-      qCritical() << Q_FUNC_INFO << errorMessage;
+Database::ReadOnlyConnection::ReadOnlyConnection(Database const & database) : database{database} {
+   this->database.pimpl->readOnlyConnectionsAvailable.acquire();
+   return;
+}
 
-      if (Brewtarget::isInteractive()) {
-         QMessageBox::critical(nullptr,
-                               QObject::tr("Database Failure"),
-                               errorMessage);
-      }
+Database::ReadOnlyConnection::~ReadOnlyConnection() {
+   this->database.pimpl->readOnlyConnectionsAvailable.release();
+   return;
+}
 
-      // If we can't talk to the DB, there's not much we can do to recover
-      throw errorMessage;
+QSqlDatabase Database::ReadOnlyConnection::sqlDatabase() const {
+   Q_ASSERT(this->database.pimpl->dbType != Database::NODB);
+   QString connectionName = readOnlyConnectionNamesForThisThread.value(this->database.pimpl->dbType);
+   Q_ASSERT(!connectionName.isEmpty());
+   QSqlDatabase connection = QSqlDatabase::database(connectionName);
+   if (connection.isValid()) {
+      return connection;
    }
 
-   return connection;
+   return this->database.pimpl->openConnection(connectionName, true);
 }
 
 
 bool Database::load() {
+   StartupProfile::Phase const phase{"Database::load"};
    this->pimpl->createFromScratch = false;
    this->pimpl->schemaUpdated = false;
    this->pimpl->loadWasSuccessful = false;
@@ -647,6 +859,10 @@ bool Database::load() {
 
    // Update the database if need be. This has to happen before we do anything
    // else or we dump core
+   //
+   // Creating and migrating the schema are the only writes we do directly on this thread's connection.  That's OK
+   // because the write thread isn't started until afterwards, so there's nothing else writing to the DB.
+   Q_ASSERT(!this->pimpl->writeThread);
    bool schemaErr = false;
    this->pimpl->schemaUpdated = this->pimpl->updateSchema(*this, &schemaErr);
 
@@ -661,7 +877,17 @@ bool Database::load() {
       return false;
    }
 
+   // Anything in the start-up snapshot will be out of date if we just created or upgraded the DB
+   if (this->pimpl->createFromScratch || this->pimpl->schemaUpdated) {
+      ObjectStoreSnapshot::instance().close();
+   }
+
    this->pimpl->loadWasSuccessful = true;
+
+   // From now on, object stores' writes go through the write thread
+   this->pimpl->writeThread = std::make_unique<DbWriteThread>(*this);
+   this->pimpl->writeThread->start();
+
    return this->pimpl->loadWasSuccessful;
 }
 
@@ -672,6 +898,7 @@ void Database::checkForNewDefaultData() {
        !Brewtarget::userDatabaseDidNotExist &&
        QFileInfo(this->pimpl->dataDbFile).lastModified() > Database::lastDbMergeRequest) {
       if( Brewtarget::isInteractive() &&
+         DatabaseSchemaHelper::hasNewDefaultData() &&
          QMessageBox::question(
             nullptr,
             tr("Merge Database"),
@@ -702,7 +929,7 @@ void Database::checkForNewDefaultData() {
             );
             qCritical() << Q_FUNC_INFO << userMessage;
          }
-         qDebug() << Q_FUNC_INFO << "Message box text : " << messageBoxText;
+         qCDebug(lcDatabase) << Q_FUNC_INFO << "Message box text : " << messageBoxText;
          QMessageBox msgBox{succeeded ? QMessageBox::Information : QMessageBox::Critical,
                             messageBoxTitle,
                             messageBoxText};
@@ -748,23 +975,70 @@ void Database::unload() {
    // We really don't want this function to be called twice on the same object or when we didn't get as far as making a
    // connection to the DB etc.
    if (!this->pimpl->loaded) {
-      qDebug() <<
+      qCDebug(lcDatabase) <<
          Q_FUNC_INFO << "Nothing to do for Database object for" <<
          getDbNativeName(displayableDbType, this->pimpl->dbType) << "as not loaded";
       return;
    }
 
+   //
+   // Write anything that's been changed in memory but not yet saved and, if it's due, update the query planner
+   // statistics, then finish any outstanding writes and close the write thread's connection
+   //
+   WriteDirtyPropertiesInAllObjectStores(*this);
+   if (this->pimpl->loadWasSuccessful) {
+      this->pimpl->periodicAnalyze(*this);
+   }
+   if (this->pimpl->writeThread) {
+      this->pimpl->writeThread->stop();
+      this->pimpl->writeThread.reset();
+   }
+
    // This RAII wrapper does all the hard work on mutex.lock() and mutex.unlock() in an exception-safe way
    QMutexLocker locker(&this->pimpl->mutex);
 
+   //
+   // Give any background threads reading the DB a chance to finish before we close their connections.  We don't wait
+   // forever though, as it's better to exit with a warning than to hang.
+   //
+   if (!this->pimpl->readOnlyConnectionsAvailable.tryAcquire(Database::maxReadOnlyConnections, 10000)) {
+      qWarning() << Q_FUNC_INFO << "Closing DB connections whilst read-only connections still in use";
+   } else {
+      this->pimpl->readOnlyConnectionsAvailable.release(Database::maxReadOnlyConnections);
+   }
+
+   //
+   // Before we close the connections, take a snapshot of the DB contents to speed up loading next time.  (It doesn't
+   // get written to disk until the connections are closed, so that we can record the final state of the DB file.)
+   //
+   // We read through a read-only connection, which only ever sees committed data, so that what we snapshot is exactly
+   // what is in the DB file whose modification time we record.
+   //
+   bool snapshotReady = false;
+   if (this->pimpl->loadWasSuccessful && this->dbType() == Database::SQLITE) {
+      try {
+         Database::ReadOnlyConnection readOnlyConnection{*this};
+         // NB: This QSqlDatabase object needs to be out of scope before the calls to QSqlDatabase::removeDatabase()
+         // below
+         QSqlDatabase connection = readOnlyConnection.sqlDatabase();
+         snapshotReady = AddAllObjectStoresToSnapshot(*this, connection);
+      } catch (QString const & errorMessage) {
+         qWarning() << Q_FUNC_INFO << "Unable to open read-only connection for start-up snapshot:" << errorMessage;
+      }
+      if (!snapshotReady) {
+         qWarning() << Q_FUNC_INFO << "Unable to read DB contents for start-up snapshot";
+         ObjectStoreSnapshot::instance().discardPendingWrite();
+      }
+   }
+
    // We only want to close connections that relate to this instance of Database
    QString ourConnectionPrefix = QString{"%1-"}.arg(getDbNativeName(displayableDbType, this->pimpl->dbType));
 
-   // So far, it seems we only create one connection to the db per database type, so this is likely overkill
+   // This includes the connections for other threads and the read-only connections
    QStringList allConnectionNames{QSqlDatabase::connectionNames()};
    for (QString conName : allConnectionNames) {
       if (0 == conName.indexOf(ourConnectionPrefix)) {
-         qDebug() << Q_FUNC_INFO << "Closing connection " << conName;
+         qCDebug(lcDatabase) << Q_FUNC_INFO << "Closing connection " << conName;
          {
             //
             // Extra braces here are to ensure that this QSqlDatabase object is out of scope before the call to
@@ -778,22 +1052,29 @@ void Database::unload() {
          }
          QSqlDatabase::removeDatabase(conName);
       } else {
-         qDebug() <<
+         qCDebug(lcDatabase) <<
             Q_FUNC_INFO << "Ignoring connection" << conName << "as does not start with" << ourConnectionPrefix;
       }
    }
 
-   qDebug() << Q_FUNC_INFO << "DB connections all closed";
+   qCDebug(lcDatabase) << Q_FUNC_INFO << "DB connections all closed";
 
    if (this->pimpl->loadWasSuccessful && this->dbType() == Database::SQLITE ) {
       this->pimpl->dbFile.close();
+      if (!snapshotReady ||
+          !ObjectStoreSnapshot::instance().write(this->pimpl->snapshotFileName,
+                                                 QFileInfo{this->pimpl->dbFileName},
+                                                 DatabaseSchemaHelper::dbVersion)) {
+         // Better no snapshot than a stale one
+         ObjectStoreSnapshot::remove(this->pimpl->snapshotFileName);
+      }
       this->pimpl->automaticBackup(*this);
    }
 
    this->pimpl->loaded = false;
    this->pimpl->loadWasSuccessful = false;
 
-   qDebug() << Q_FUNC_INFO << "Drop Instance done";
+   qCDebug(lcDatabase) << Q_FUNC_INFO << "Drop Instance done";
 
    return;
 }
@@ -849,9 +1130,11 @@ bool Database::backupToFile(QString newDbFileName) {
    // the copy() operation will succeed.
    QFile::remove(newDbFileName);
 
+   this->flush();
+   this->pimpl->checkpoint();
    bool success = this->pimpl->dbFile.copy(newDbFileName);
 
-   qDebug() << QString("Database backup to \"%1\" %2").arg(newDbFileName, success ? "succeeded" : "failed");
+   qCDebug(lcDatabase) << QString("Database backup to \"%1\" %2").arg(newDbFileName, success ? "succeeded" : "failed");
 
    return success;
 }
@@ -932,9 +1215,13 @@ bool Database::verifyDbConnection(Database::DbType testDb, QString const& hostna
 
 void Database::convertDatabase(QString const& Hostname, QString const& DbName,
                                QString const& Username, QString const& Password,
-                               int Portnum, Database::DbType newType) {
+                               int Portnum, Database::DbType newType,
+                               std::function<void(int, int)> const & progress) {
    QSqlDatabase connectionNew;
 
+   // Make sure the current DB is up-to-date before we copy it
+   this->flush();
+
    try {
       if ( newType == Database::NODB ) {
          throw QString("No type found for the new database.");
@@ -957,7 +1244,9 @@ void Database::convertDatabase(QString const& Hostname, QString const& DbName,
       // Don't get newDatabase via Database::instance() as we don't want to use the connection details from
       // PersistentSettings (or to attempt to read data from newDatabase)
       Database newDatabase{newType};
-      DatabaseSchemaHelper::copyToNewDatabase(newDatabase, connectionNew);
+      if (!DatabaseSchemaHelper::copyToNewDatabase(newDatabase, connectionNew, progress)) {
+         throw QString("Could not copy data to new database");
+      }
    }
    catch (QString e) {
       qCritical() << QString("%1 %2").arg(Q_FUNC_INFO).arg(e);
@@ -965,6 +1254,22 @@ void Database::convertDatabase(QString const& Hostname, QString const& DbName,
    }
 }
 
+std::future<bool> Database::enqueueWrite(Database::WriteCommand command, std::function<void(bool)> onCompletion) {
+   return this->pimpl->enqueue(*this, std::move(command), std::move(onCompletion), true);
+}
+
+std::future<bool> Database::enqueueMaintenance(Database::WriteCommand command,
+                                               std::function<void(bool)> onCompletion) {
+   return this->pimpl->enqueue(*this, std::move(command), std::move(onCompletion), false);
+}
+
+void Database::flush() {
+   if (this->pimpl->writeThread) {
+      this->pimpl->writeThread->flush();
+   }
+   return;
+}
+
 Database::DbType Database::dbType() const {
    return this->pimpl->dbType;
 }
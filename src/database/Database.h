@@ -32,6 +32,8 @@
 #define DATABASE_H
 #pragma once
 
+#include <functional>
+#include <future>
 #include <memory> // For PImpl
 
 #include <QCoreApplication>
@@ -102,6 +104,92 @@ public:
     */
    QSqlDatabase sqlDatabase() const;
 
+   /**
+    * \brief Maximum number of \c ReadOnlyConnection objects that can be in use at once.  Once this many are in use,
+    *        constructing another one blocks until one of the existing ones is destroyed.
+    */
+   static int const maxReadOnlyConnections = 4;
+
+   /**
+    * \brief RAII lease on a read-only database connection, for background threads (eg doing batch recalculation,
+    *        export, search indexing or integrity checks) that need to read the DB whilst the GUI thread carries on
+    *        writing to it via \c sqlDatabase().
+    *
+    *        For SQLite, this relies on the DB being in WAL mode, where readers see the last committed state of the DB
+    *        and neither block nor are blocked by the writer.
+    *
+    *        As with \c sqlDatabase(), a Qt database connection can only be used on the thread that created it, so the
+    *        underlying connection is specific to the calling thread.  It is kept open after the lease ends so that
+    *        (typically pooled) threads that do repeated background work do not have to keep reconnecting; all such
+    *        connections are closed by \c unload().  What we limit is how many leases can be held at once, so that
+    *        background work cannot starve the GUI thread.
+    *
+    *        Because it only ever sees committed data, \c unload() also uses one to read the DB contents for the start-up
+    *        snapshot (see \c ObjectStoreSnapshot).
+    *
+    *        Usage:
+    *           Database::ReadOnlyConnection readOnlyConnection{Database::instance()};
+    *           BtSqlQuery sqlQuery{readOnlyConnection.sqlDatabase()};
+    *
+    *        The same caveats as for \c sqlDatabase() apply to the returned \c QSqlDatabase object, which must also not
+    *        outlive the \c ReadOnlyConnection.
+    */
+   class ReadOnlyConnection {
+   public:
+      explicit ReadOnlyConnection(Database const & database);
+      ~ReadOnlyConnection();
+
+      QSqlDatabase sqlDatabase() const;
+
+   private:
+      Database const & database;
+
+      // RAII objects shouldn't be copied or moved
+      ReadOnlyConnection(ReadOnlyConnection const &) = delete;
+      ReadOnlyConnection & operator=(ReadOnlyConnection const &) = delete;
+      ReadOnlyConnection(ReadOnlyConnection &&) = delete;
+      ReadOnlyConnection & operator=(ReadOnlyConnection &&) = delete;
+   };
+
+   /**
+    * \brief A database write to be run by \c enqueueWrite().  It is given the connection to use and is run inside a
+    *        transaction, which is committed if it returns \c true and rolled back otherwise.
+    *
+    *        Because it (usually) runs on another thread, a \c WriteCommand must not touch model objects (or anything
+    *        else the GUI thread might be changing at the same time).  Everything it needs should be captured by value
+    *        when it is created.
+    */
+   using WriteCommand = std::function<bool(QSqlDatabase & connection)>;
+
+   /**
+    * \brief Queue a write to be run on the DB write thread (see \c DbWriteThread), so that the caller does not have to
+    *        wait for the DB.  Writes are run in the order they are queued.
+    *
+    *        If the write thread is not running (eg before \c load() has finished or after \c unload()), the write is run
+    *        straight away on the calling thread instead.
+    *
+    * \param command
+    * \param onCompletion If set, called back on the GUI thread once \c command has run, with \c true if it succeeded
+    *                     and \c false otherwise.  Completions are called in the same order as the writes were queued.
+    *
+    * \return A future that is set, with the same value passed to \c onCompletion, once \c command has run.  Callers
+    *         that need the outcome of the write before they can continue (eg to get the primary key of an inserted row)
+    *         can wait on this.
+    */
+   std::future<bool> enqueueWrite(WriteCommand command, std::function<void(bool)> onCompletion = nullptr);
+
+   /**
+    * \brief As \c enqueueWrite(), but for maintenance commands, such as VACUUM, that can't be run inside a transaction.
+    *        The command is run on the same queue, so it happens after everything queued before it.
+    */
+   std::future<bool> enqueueMaintenance(WriteCommand command, std::function<void(bool)> onCompletion = nullptr);
+
+   /**
+    * \brief Wait until all the writes queued by \c enqueueWrite() have been run.  Needs to be called before anything
+    *        that reads the DB other than through the object stores, eg backup, copying to another DB, or shut-down.
+    */
+   void flush();
+
    //! \brief Should be called when we are about to close down.
    void unload();
 
@@ -130,9 +218,12 @@ public:
 
    //! \brief Figures out what databases we are copying to and from, opens what
    //   needs opens and then calls the appropriate workhorse to get it done.
+   //   If \c progress is set, it is called as the copy proceeds with the number of objects copied so far and the total
+   //   number to copy.  Throws a QString on failure.
    void convertDatabase(QString const& Hostname, QString const& DbName,
                         QString const& Username, QString const& Password,
-                        int Portnum, Database::DbType newType);
+                        int Portnum, Database::DbType newType,
+                        std::function<void(int, int)> const & progress = nullptr);
 
    /*!
     * \brief If we are supporting multiple databases, we need some way to
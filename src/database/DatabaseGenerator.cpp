@@ -0,0 +1,368 @@
+/*
+ * database/DatabaseGenerator.cpp is part of Brewtarget, and is copyright the
+ * following authors 2021:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "database/DatabaseGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <random>
+
+#include <QDate>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QStringList>
+#include <QVector>
+
+#include "database/Database.h"
+#include "database/ObjectStoreWrapper.h"
+#include "Logging.h"
+#include "model/BrewNote.h"
+#include "model/Equipment.h"
+#include "model/Fermentable.h"
+#include "model/Hop.h"
+#include "model/Misc.h"
+#include "model/Recipe.h"
+#include "model/Style.h"
+#include "model/Yeast.h"
+#include "PersistentSettings.h"
+
+namespace {
+
+   /**
+    * \brief Pseudo-random numbers that come out the same on every platform for a given seed
+    */
+   class Random {
+   public:
+      explicit Random(unsigned int seed) : engine{seed} {
+         return;
+      }
+
+      //! \brief Uniform in [0, 1)
+      double real() {
+         // std::mt19937 output is always in [0, 2^32)
+         return static_cast<double>(this->engine()) / 4294967296.0;
+      }
+
+      //! \brief Uniform in [min, max]
+      double real(double min, double max) {
+         return min + this->real() * (max - min);
+      }
+
+      //! \brief Uniform in [min, max]
+      int integer(int min, int max) {
+         return min + static_cast<int>(this->real() * (max - min + 1));
+      }
+
+      /**
+       * \brief In [0, count), with lower numbers more likely the bigger \c skew is.  (A skew of 1 is uniform.)  Used to
+       *        make some ingredients much more popular than others, some recipes brewed much more often, etc.
+       */
+      int skewedIndex(int count, double skew) {
+         return std::min(count - 1, static_cast<int>(count * std::pow(this->real(), skew)));
+      }
+
+      //! \brief Number of "failures before first success", so 0, 1, 2, ... with the given mean
+      int geometric(double mean) {
+         double const probabilityOfSuccess = 1.0 / (1.0 + mean);
+         int result = 0;
+         while (this->real() >= probabilityOfSuccess) {
+            ++result;
+         }
+         return result;
+      }
+
+      template<class T> T const & pick(QVector<T> const & choices) {
+         return choices.at(this->integer(0, choices.size() - 1));
+      }
+
+   private:
+      std::mt19937 engine;
+   };
+
+   QVector<QString> const origins{
+      "Belgium", "Canada", "Czech Republic", "England", "Germany", "New Zealand", "Slovenia", "UK", "US"
+   };
+   QVector<QString> const suppliers{"Briess", "Crisp", "Dingemans", "Muntons", "Simpsons", "Weyermann"};
+   QVector<QString> const laboratories{"Fermentis", "Imperial", "Lallemand", "Omega", "White Labs", "Wyeast"};
+   QVector<QString> const nameWords{
+      "Amber", "Autumn", "Black", "Bright", "Copper", "Crystal", "Dark", "Golden", "Harvest", "Hazy", "Midnight",
+      "Northern", "Old", "Pale", "Red", "Ruby", "Smoked", "Summer", "Velvet", "Wild", "Winter"
+   };
+   QVector<QString> const beerWords{
+      "Ale", "Bitter", "Bock", "Dubbel", "IPA", "Kölsch", "Lager", "Pils", "Porter", "Saison", "Stout", "Tripel",
+      "Weizen"
+   };
+
+   /**
+    * \brief Folder names are deliberately unevenly used, and about a third of things are not in a folder at all
+    */
+   QString folderName(Random & random, Parameters const & parameters, QString const & topLevel) {
+      if (parameters.folders <= 0 || random.real() < 0.33) {
+         return QString{};
+      }
+      return QString{"/%1/Folder %2"}.arg(topLevel).arg(random.skewedIndex(parameters.folders, 2.0) + 1);
+   }
+
+   template<class NE> using Library = QVector<std::shared_ptr<NE> >;
+
+   /**
+    * \brief Make \c count objects with \c make and store each one in the database
+    */
+   template<class NE>
+   Library<NE> makeLibrary(int count, std::function<std::shared_ptr<NE>(int)> make) {
+      Library<NE> library;
+      library.reserve(count);
+      for (int ii = 0; ii < count; ++ii) {
+         auto ne = make(ii);
+         ObjectStoreWrapper::insert(ne);
+         library.append(ne);
+      }
+      qInfo() << Q_FUNC_INFO << "Made" << count << NE::staticMetaObject.className() << "objects";
+      return library;
+   }
+}
+
+bool DatabaseGenerator::parseParameters(QString const & text, Parameters & parameters, QTextStream & userMessage) {
+   QHash<QString, int *> const fields{
+      {"ingredients",    &parameters.ingredients   },
+      {"recipes",        &parameters.recipes       },
+      {"ingredientuses", &parameters.ingredientUses},
+      {"brewnotes",      &parameters.brewNotes     },
+      {"versions",       &parameters.versions      },
+      {"folders",        &parameters.folders       }
+   };
+
+   for (auto const & setting : text.split(',', QString::SkipEmptyParts)) {
+      QStringList const nameAndValue = setting.split('=');
+      bool ok = nameAndValue.size() == 2;
+      QString const name = nameAndValue.first().trimmed().toLower();
+      unsigned int const value = ok ? nameAndValue.last().trimmed().toUInt(&ok) : 0;
+      if (!ok) {
+         userMessage << "Could not understand \"" << setting << "\" (expected name=number)";
+         return false;
+      }
+      if (name == "seed") {
+         parameters.seed = value;
+      } else if (fields.contains(name)) {
+         *fields.value(name) = static_cast<int>(value);
+      } else {
+         userMessage << "Unknown parameter \"" << name << "\"";
+         return false;
+      }
+   }
+
+   if (parameters.ingredients < 1) {
+      userMessage << "Need at least one of each ingredient";
+      return false;
+   }
+   return true;
+}
+
+bool DatabaseGenerator::generate(Parameters const & parameters, QTextStream & userMessage) {
+   QElapsedTimer timer;
+   timer.start();
+
+   //
+   // An empty file is a valid (empty) SQLite database, and, when Database finds it has no tables, it creates them
+   // with DatabaseSchemaHelper::create().  We do it this way, rather than Database::createBlank(), because the latter
+   // needs Database::instance(), which would otherwise copy in the default database before we got the chance.
+   //
+   QDir const userDataDir = PersistentSettings::getUserDataDir();
+   QString const dbFileName = userDataDir.filePath(Database::getDefaultBackupFileName());
+   if (QFile::exists(dbFileName)) {
+      userMessage << dbFileName << " already exists.  Please choose a new directory.";
+      return false;
+   }
+   QFile dbFile{dbFileName};
+   if (!QDir{}.mkpath(userDataDir.absolutePath()) || !dbFile.open(QIODevice::WriteOnly)) {
+      userMessage << "Could not create " << dbFileName;
+      return false;
+   }
+   dbFile.close();
+
+   Database & database = Database::instance(Database::SQLITE);
+   if (!database.loadSuccessful()) {
+      userMessage << "Could not create database in " << dbFileName;
+      return false;
+   }
+
+   qInfo() <<
+      Q_FUNC_INFO << "Generating database in" << dbFileName << "with seed" << parameters.seed << ":" <<
+      parameters.ingredients << "of each ingredient," << parameters.recipes << "recipes," <<
+      parameters.ingredientUses << "ingredient uses per recipe," << parameters.brewNotes << "brew notes," <<
+      parameters.versions << "versions," << parameters.folders << "folders";
+
+   // We're making the versions ourselves, so we don't want adding brew notes etc to trigger any
+   RecipeHelper::SuspendRecipeVersioning suspendRecipeVersioning;
+
+   Random random{parameters.seed};
+
+   //
+   // First the "library" of ingredients, styles and equipment that recipes are made from
+   //
+   auto hops = makeLibrary<Hop>(parameters.ingredients, [&](int ii) {
+      auto hop = std::make_shared<Hop>();
+      hop->setName(QString{"%1 %2 Hop"}.arg(random.pick(nameWords)).arg(ii + 1));
+      hop->setFolder(folderName(random, parameters, "Hops"));
+      hop->setOrigin(random.pick(origins));
+      hop->setAlpha_pct(random.real(2.0, 16.0));
+      hop->setType(static_cast<Hop::Type>(random.integer(Hop::Bittering, Hop::Both)));
+      hop->setForm(random.real() < 0.8 ? Hop::Pellet : Hop::Leaf);
+      return hop;
+   });
+   auto fermentables = makeLibrary<Fermentable>(parameters.ingredients, [&](int ii) {
+      auto fermentable = std::make_shared<Fermentable>();
+      fermentable->setName(QString{"%1 Malt %2"}.arg(random.pick(nameWords)).arg(ii + 1));
+      fermentable->setFolder(folderName(random, parameters, "Fermentables"));
+      fermentable->setOrigin(random.pick(origins));
+      fermentable->setSupplier(random.pick(suppliers));
+      fermentable->setType(random.real() < 0.85 ? Fermentable::Grain : Fermentable::Sugar);
+      fermentable->setYield_pct(random.real(60.0, 82.0));
+      // Most malts are pale, a few are very dark
+      fermentable->setColor_srm(1.5 + 550.0 * std::pow(random.real(), 6.0));
+      fermentable->setIsMashed(fermentable->type() == Fermentable::Grain);
+      return fermentable;
+   });
+   auto miscs = makeLibrary<Misc>(parameters.ingredients, [&](int ii) {
+      auto misc = std::make_shared<Misc>();
+      misc->setName(QString{"Misc %1"}.arg(ii + 1));
+      misc->setFolder(folderName(random, parameters, "Miscs"));
+      misc->setType(static_cast<Misc::Type>(random.integer(Misc::Spice, Misc::Other)));
+      misc->setUse(random.real() < 0.7 ? Misc::Boil : Misc::Mash);
+      return misc;
+   });
+   auto yeasts = makeLibrary<Yeast>(parameters.ingredients, [&](int ii) {
+      auto yeast = std::make_shared<Yeast>();
+      yeast->setName(QString{"%1 Yeast %2"}.arg(random.pick(beerWords)).arg(ii + 1));
+      yeast->setFolder(folderName(random, parameters, "Yeasts"));
+      yeast->setLaboratory(random.pick(laboratories));
+      yeast->setProductID(QString::number(1000 + ii));
+      yeast->setType(random.real() < 0.8 ? Yeast::Ale : Yeast::Lager);
+      yeast->setForm(random.real() < 0.6 ? Yeast::Liquid : Yeast::Dry);
+      yeast->setAttenuation_pct(random.real(65.0, 85.0));
+      return yeast;
+   });
+   auto styles = makeLibrary<Style>(std::max(1, parameters.ingredients / 10), [&](int ii) {
+      auto style = std::make_shared<Style>();
+      style->setName(QString{"%1 %2 %3"}.arg(random.pick(nameWords)).arg(random.pick(beerWords)).arg(ii + 1));
+      style->setCategory(random.pick(beerWords));
+      style->setStyleGuide("Generated");
+      return style;
+   });
+   auto equipments = makeLibrary<Equipment>(10, [&](int ii) {
+      auto equipment = std::make_shared<Equipment>();
+      double const batchSize_l = 10.0 * (ii + 1);
+      equipment->setName(QString{"%1 L System"}.arg(batchSize_l));
+      equipment->setBatchSize_l(batchSize_l);
+      equipment->setBoilSize_l(batchSize_l * 1.2);
+      equipment->setBoilTime_min(60.0);
+      equipment->setEvapRate_lHr(batchSize_l * 0.1);
+      return equipment;
+   });
+
+   //
+   // Now the recipes.  Some ingredients, styles and equipment are much more popular than others.
+   //
+   Library<Recipe> recipes;
+   recipes.reserve(parameters.recipes);
+   // Split of ingredient uses between fermentables, hops, miscs and yeasts -- roughly what you'd see in real recipes
+   double const meanFermentables = parameters.ingredientUses * 0.35;
+   double const meanHops         = parameters.ingredientUses * 0.40;
+   double const meanMiscs        = parameters.ingredientUses * 0.15;
+   for (int ii = 0; ii < parameters.recipes; ++ii) {
+      auto recipe = std::make_shared<Recipe>(
+         QString{"%1 %2 #%3"}.arg(random.pick(nameWords)).arg(random.pick(beerWords)).arg(ii + 1)
+      );
+      recipe->setFolder(folderName(random, parameters, "Recipes"));
+      recipe->setType("All Grain");
+      recipe->setBrewer("Generated");
+      recipe->setEfficiency_pct(random.real(65.0, 80.0));
+      ObjectStoreWrapper::insert(recipe);
+
+      Equipment * equipment = equipments.at(random.skewedIndex(equipments.size(), 2.0)).get();
+      recipe->setEquipment(equipment);
+      recipe->setBatchSize_l(equipment->batchSize_l());
+      recipe->setBoilSize_l(equipment->boilSize_l());
+      recipe->setStyle(styles.at(random.skewedIndex(styles.size(), 2.0)).get());
+
+      // Every recipe has at least one fermentable, one hop and one yeast
+      for (int jj = 1 + random.geometric(std::max(0.0, meanFermentables - 1.0)); jj > 0; --jj) {
+         auto use = recipe->add(fermentables.at(random.skewedIndex(fermentables.size(), 3.0)));
+         use->setAmount_kg(random.real(0.1, 5.0));
+      }
+      for (int jj = 1 + random.geometric(std::max(0.0, meanHops - 1.0)); jj > 0; --jj) {
+         auto use = recipe->add(hops.at(random.skewedIndex(hops.size(), 3.0)));
+         use->setAmount_kg(random.real(0.005, 0.1));
+         use->setTime_min(random.pick(QVector<int>{0, 5, 10, 15, 30, 60, 90}));
+      }
+      for (int jj = random.geometric(meanMiscs); jj > 0; --jj) {
+         auto use = recipe->add(miscs.at(random.skewedIndex(miscs.size(), 3.0)));
+         use->setAmount(random.real(0.001, 0.05));
+      }
+      recipe->add(yeasts.at(random.skewedIndex(yeasts.size(), 3.0)));
+
+      recipes.append(recipe);
+      if ((ii + 1) % 1000 == 0) {
+         qInfo() << Q_FUNC_INFO << "Made" << ii + 1 << "recipes after" << timer.elapsed() / 1000 << "s";
+      }
+   }
+
+   //
+   // Prior versions, made the same way as RecipeHelper does when a brewed recipe is changed.  Popular recipes get more
+   // versions.
+   //
+   for (int ii = 0; ii < parameters.versions && !recipes.isEmpty(); ++ii) {
+      auto & owner = recipes.at(random.skewedIndex(recipes.size(), 2.0));
+      auto priorVersion = std::make_shared<Recipe>(*owner, Recipe::CopyMode::SharedVersion);
+      ObjectStoreWrapper::insert(priorVersion);
+      owner->setAncestor(*priorVersion);
+   }
+   qInfo() << Q_FUNC_INFO << "Made" << parameters.versions << "prior versions of recipes";
+
+   //
+   // Brew notes, again more of them for the popular recipes, with dates over the last ten years or so
+   //
+   QDate const firstBrewDate{2010, 1, 1};
+   for (int ii = 0; ii < parameters.brewNotes && !recipes.isEmpty(); ++ii) {
+      auto const & recipe = recipes.at(random.skewedIndex(recipes.size(), 3.0));
+      auto brewNote = std::make_shared<BrewNote>(*recipe);
+      brewNote->setBrewDate(firstBrewDate.addDays(random.integer(0, 365 * 11)));
+      double const og = random.real(1.035, 1.090);
+      brewNote->setOg(og);
+      brewNote->setSg(og - random.real(0.0, 0.004));
+      brewNote->setFg(1.0 + (og - 1.0) * random.real(0.15, 0.30));
+      brewNote->setBrewhouseEff_pct(random.real(60.0, 80.0));
+      brewNote->setFinalVolume_l(recipe->batchSize_l() * random.real(0.9, 1.05));
+      ObjectStoreWrapper::insert(brewNote);
+      if ((ii + 1) % 10000 == 0) {
+         qInfo() << Q_FUNC_INFO << "Made" << ii + 1 << "brew notes after" << timer.elapsed() / 1000 << "s";
+      }
+   }
+
+   database.unload();
+
+   userMessage <<
+      "Generated " << dbFileName << " in " << timer.elapsed() / 1000 << "s: " << parameters.recipes << " recipes, " <<
+      parameters.versions << " prior versions, " << parameters.brewNotes << " brew notes";
+   return true;
+}
@@ -0,0 +1,78 @@
+/*
+ * database/DatabaseGenerator.h is part of Brewtarget, and is copyright the
+ * following authors 2021:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef DATABASE_DATABASEGENERATOR_H
+#define DATABASE_DATABASEGENERATOR_H
+#pragma once
+
+#include <QString>
+#include <QTextStream>
+
+/**
+ * \brief Generates a new SQLite database full of made-up (but plausible-looking) recipes, ingredients, brew notes and
+ *        recipe versions, so that we can benchmark and load-test against databases much bigger than the default one.
+ *
+ *        The database is created (via \c DatabaseSchemaHelper::create) in the current user data directory, which must
+ *        not already contain a database, and then filled using the normal \c ObjectStoreTyped machinery, so what ends
+ *        up in it is exactly what the program itself would have written.
+ *
+ *        Given the same parameters (including the seed), the same database is generated every time, on any platform.
+ *        (We only use the raw output of \c std::mt19937, which the standard fully specifies, and do our own arithmetic
+ *        on it, as the distribution classes in \c <random> are allowed to differ between standard library
+ *        implementations.)
+ *
+ *        Run from the command line with, eg:
+ *           brewtarget --generate-db /tmp/bigdb --generate-params recipes=10000,brewnotes=100000,seed=42
+ */
+namespace DatabaseGenerator {
+
+   struct Parameters {
+      //! Seed for the pseudo-random number generator
+      unsigned int seed = 1;
+      //! Number of each of hops, fermentables, miscs and yeasts in the ingredient library
+      int ingredients = 500;
+      //! Number of (current versions of) recipes
+      int recipes = 1000;
+      //! Average number of ingredient uses (ie hop, fermentable, misc and yeast additions) per recipe
+      int ingredientUses = 10;
+      //! Total number of brew notes, spread unevenly over the recipes
+      int brewNotes = 2000;
+      //! Total number of prior versions of recipes, spread unevenly over the recipes
+      int versions = 200;
+      //! Number of folders the recipes and ingredients are spread over
+      int folders = 20;
+   };
+
+   /**
+    * \brief Read parameters from a string of the form "name=value,name=value,...".  Names are those of the fields of
+    *        \c Parameters, case-insensitive.  Anything not mentioned keeps its default value.
+    *
+    * \return \b false (with an explanation in \c userMessage) if the string could not be parsed
+    */
+   bool parseParameters(QString const & text, Parameters & parameters, QTextStream & userMessage);
+
+   /**
+    * \brief Create and fill the database
+    *
+    * \return \b false (with an explanation in \c userMessage) if something went wrong
+    */
+   bool generate(Parameters const & parameters, QTextStream & userMessage);
+
+}
+
+#endif
@@ -22,28 +22,37 @@
  */
 #include "database/DatabaseSchemaHelper.h"
 
-#include <algorithm> // For std::sort and std::set_difference
+#include <algorithm> // For std::sort, std::set_difference and std::copy_if
 
+#include <QCryptographicHash>
 #include <QDebug>
+#include <QDir>
+#include <QFile>
 #include <QMessageBox>
+#include <QRegularExpression>
+#include <QSet>
 #include <QSqlError>
 #include <QSqlField>
 #include <QSqlRecord>
 #include <QString>
+#include <QTemporaryFile>
+#include <QTextCodec>
 #include <QTextStream>
 #include <QVariant>
+#include <QXmlStreamReader>
 
 #include "brewtarget.h"
 #include "database/BtSqlQuery.h"
 #include "database/Database.h"
 #include "database/DbTransaction.h"
 #include "database/ObjectStoreWrapper.h"
+#include "Logging.h"
 #include "model/BrewNote.h"
 #include "model/Recipe.h"
 #include "model/Water.h"
 #include "xml/BeerXml.h"
 
-int const DatabaseSchemaHelper::dbVersion = 10;
+int const DatabaseSchemaHelper::dbVersion = 13;
 
 namespace {
    char const * const FOLDER_FOR_SUPPLIED_RECIPES = "brewtarget";
@@ -85,7 +94,7 @@ namespace {
             // one query in a row to be dependent on a single "dummy-run" query
             continue;
          }
-         qDebug() << Q_FUNC_INFO << query.sql;
+         qCDebug(lcDatabase) << Q_FUNC_INFO << query.sql;
 
          q.prepare(query.sql);
          for (auto & bv : query.bindValues) {
@@ -115,10 +124,10 @@ namespace {
       QString queryString{"ALTER TABLE brewnote ADD COLUMN projected_ferm_points "};
       QTextStream queryStringAsStream{&queryString};
       queryStringAsStream << db.getDbNativeTypeName<double>() << ";"; // Previously DEFAULT 0.0
-      qDebug() << Q_FUNC_INFO << queryString;
+      qCDebug(lcDatabase) << Q_FUNC_INFO << queryString;
       ret &= q.exec(queryString);
       queryString = "ALTER TABLE brewnote SET projected_ferm_points = -1.0;";
-      qDebug() << Q_FUNC_INFO << queryString;
+      qCDebug(lcDatabase) << Q_FUNC_INFO << queryString;
       ret &= q.exec(queryString);
 
       // Add the settings table
@@ -127,7 +136,7 @@ namespace {
          "id " << db.getDbNativePrimaryKeyDeclaration() << ",\n"
          "repopulatechildrenonnextstart " << db.getDbNativeTypeName<int>() << ",\n" // Previously DEFAULT 0
          "version " << db.getDbNativeTypeName<int>() << ");"; // Previously DEFAULT 0
-      qDebug() << Q_FUNC_INFO << queryString;
+      qCDebug(lcDatabase) << Q_FUNC_INFO << queryString;
       ret &= q.exec(queryString);
 
       return ret;
@@ -531,11 +540,294 @@ namespace {
       return executeSqlQueries(q, migrationQueries);
    }
 
+   //
+   // Secondary indexes, first added in migrate_to_11 and also created for new DBs in DatabaseSchemaHelper::create().
+   // Because all DB changes then go through the migrate_to_Xyz functions, if you need to change these, do it in a new
+   // migration rather than by editing this list.
+   //
+   // For junction tables, ObjectStore::loadAll() reads the whole table ordered by the "this" key column (eg recipe_id)
+   // and then the "other" (or ordering) column, and deleting a record deletes its junction rows by the "this" key, so a
+   // composite index on those two columns serves both.  The index on the "other" column is for when we delete, eg, a
+   // Hop, and the DB has to check the foreign key constraints on hop_in_recipe.  The same applies to the *_children
+   // tables, where the "this" key is child_id.
+   //
+   // SQLite and PostgreSQL (from 9.5) both support CREATE INDEX IF NOT EXISTS, and, in both, index names are unique
+   // per schema rather than per table, hence the table name prefixes.
+   //
+   QVector<QueryAndParameters> const secondaryIndexQueries{
+      {"CREATE INDEX IF NOT EXISTS fermentable_in_recipe_recipe_idx ON fermentable_in_recipe (recipe_id, fermentable_id)"},
+      {"CREATE INDEX IF NOT EXISTS fermentable_in_recipe_fermentable_idx ON fermentable_in_recipe (fermentable_id)"},
+      {"CREATE INDEX IF NOT EXISTS hop_in_recipe_recipe_idx ON hop_in_recipe (recipe_id, hop_id)"},
+      {"CREATE INDEX IF NOT EXISTS hop_in_recipe_hop_idx ON hop_in_recipe (hop_id)"},
+      {"CREATE INDEX IF NOT EXISTS instruction_in_recipe_recipe_idx ON instruction_in_recipe (recipe_id, instruction_number)"},
+      {"CREATE INDEX IF NOT EXISTS instruction_in_recipe_instruction_idx ON instruction_in_recipe (instruction_id)"},
+      {"CREATE INDEX IF NOT EXISTS misc_in_recipe_recipe_idx ON misc_in_recipe (recipe_id, misc_id)"},
+      {"CREATE INDEX IF NOT EXISTS misc_in_recipe_misc_idx ON misc_in_recipe (misc_id)"},
+      {"CREATE INDEX IF NOT EXISTS salt_in_recipe_recipe_idx ON salt_in_recipe (recipe_id, salt_id)"},
+      {"CREATE INDEX IF NOT EXISTS salt_in_recipe_salt_idx ON salt_in_recipe (salt_id)"},
+      {"CREATE INDEX IF NOT EXISTS water_in_recipe_recipe_idx ON water_in_recipe (recipe_id, water_id)"},
+      {"CREATE INDEX IF NOT EXISTS water_in_recipe_water_idx ON water_in_recipe (water_id)"},
+      {"CREATE INDEX IF NOT EXISTS yeast_in_recipe_recipe_idx ON yeast_in_recipe (recipe_id, yeast_id)"},
+      {"CREATE INDEX IF NOT EXISTS yeast_in_recipe_yeast_idx ON yeast_in_recipe (yeast_id)"},
+      {"CREATE INDEX IF NOT EXISTS equipment_children_child_idx ON equipment_children (child_id, parent_id)"},
+      {"CREATE INDEX IF NOT EXISTS equipment_children_parent_idx ON equipment_children (parent_id)"},
+      {"CREATE INDEX IF NOT EXISTS fermentable_children_child_idx ON fermentable_children (child_id, parent_id)"},
+      {"CREATE INDEX IF NOT EXISTS fermentable_children_parent_idx ON fermentable_children (parent_id)"},
+      {"CREATE INDEX IF NOT EXISTS hop_children_child_idx ON hop_children (child_id, parent_id)"},
+      {"CREATE INDEX IF NOT EXISTS hop_children_parent_idx ON hop_children (parent_id)"},
+      {"CREATE INDEX IF NOT EXISTS misc_children_child_idx ON misc_children (child_id, parent_id)"},
+      {"CREATE INDEX IF NOT EXISTS misc_children_parent_idx ON misc_children (parent_id)"},
+      {"CREATE INDEX IF NOT EXISTS style_children_child_idx ON style_children (child_id, parent_id)"},
+      {"CREATE INDEX IF NOT EXISTS style_children_parent_idx ON style_children (parent_id)"},
+      {"CREATE INDEX IF NOT EXISTS water_children_child_idx ON water_children (child_id, parent_id)"},
+      {"CREATE INDEX IF NOT EXISTS water_children_parent_idx ON water_children (parent_id)"},
+      {"CREATE INDEX IF NOT EXISTS yeast_children_child_idx ON yeast_children (child_id, parent_id)"},
+      {"CREATE INDEX IF NOT EXISTS yeast_children_parent_idx ON yeast_children (parent_id)"},
+      // Other foreign keys that we look up by, or that are checked when the referenced record is deleted
+      {"CREATE INDEX IF NOT EXISTS brewnote_recipe_idx ON brewnote (recipe_id)"},
+      {"CREATE INDEX IF NOT EXISTS mashstep_mash_idx ON mashstep (mash_id)"},
+      {"CREATE INDEX IF NOT EXISTS recipe_ancestor_idx ON recipe (ancestor_id)"}
+   };
+
+   bool migrate_to_11(Database & db, BtSqlQuery q) {
+      return executeSqlQueries(q, secondaryIndexQueries);
+   }
+
+   //
+   // The manifest of default data records we have already merged into the user's DB -- see
+   // DatabaseSchemaHelper::updateDatabase().  Like the settings table, it's only used in this file, so it doesn't have
+   // an ObjectStore.
+   //
+   QString createDefaultDataManifestSql(Database & db) {
+      return QString("CREATE TABLE default_data_manifest ("
+                        "id           %1, "
+                        "record_type  %2, "
+                        "content_hash %2 not null"
+                     ");").arg(db.getDbNativePrimaryKeyDeclaration(), db.getDbNativeTypeName<QString>());
+   }
+
+   bool migrate_to_12(Database & db, BtSqlQuery q) {
+      QVector<QueryAndParameters> const migrationQueries{
+         {createDefaultDataManifestSql(db)}
+      };
+      return executeSqlQueries(q, migrationQueries);
+   }
+
+   //
+   // The "instance of use of" copies of Hops, Fermentables, etc no longer store the catalogue data that is the same as
+   // in their parents (see comments in database/ObjectStore.h).  Tables of objects that can have children get a new
+   // inherited_fields column listing, for each child, which fields it reads from its parent.  We then shrink existing
+   // data by replacing each such field in a child's row with a placeholder.
+   //
+   bool migrate_to_13(Database & db, QSqlDatabase & connection) {
+      return ShareParentDataInAllObjectStores(db, connection);
+   }
+
+   /**
+    * \brief One top-level record (eg a single <HOP>...</HOP>) from the default data file
+    */
+   struct DefaultDataRecord {
+      // Eg "HOPS" for a HOP record
+      QString listTag;
+      // Eg "HOP"
+      QString recordType;
+      // The record exactly as it appears in the file
+      QString text;
+      QString contentHash;
+   };
+
+   /**
+    * \brief Split a BeerXML file into its top-level records and hash each one.  This is a lot quicker than importing
+    *        the file, as we only need to find where each record starts and ends, not validate it or make objects from
+    *        it.
+    *
+    * \param fileName
+    * \param xmlDeclaration Set to the first line of the file
+    * \param codec Set to the codec for the file's encoding
+    * \param records Where to put the results, in the order they appear in the file
+    *
+    * \return \c true if succeeded, \c false otherwise
+    */
+   bool readDefaultDataRecords(QString const & fileName,
+                               QString & xmlDeclaration,
+                               QTextCodec * & codec,
+                               QVector<DefaultDataRecord> & records) {
+      QFile inputFile{fileName};
+      if (!inputFile.open(QIODevice::ReadOnly)) {
+         qWarning() << Q_FUNC_INFO << "Could not open" << fileName << "for reading";
+         return false;
+      }
+      QByteArray const firstLine = inputFile.readLine();
+      QByteArray const remainder = inputFile.readAll();
+
+      // BeerXML is usually ISO-8859-1, but go by whatever the XML declaration says
+      QRegularExpressionMatch const match =
+         QRegularExpression{"encoding=\"([^\"]+)\""}.match(QString::fromLatin1(firstLine));
+      codec = match.hasMatch() ? QTextCodec::codecForName(match.captured(1).toLatin1()) : nullptr;
+      if (!codec) {
+         codec = QTextCodec::codecForName("UTF-8");
+      }
+      xmlDeclaration = codec->toUnicode(firstLine);
+
+      //
+      // As in BeerXML::validateAndLoad(), we need to wrap everything after the XML declaration in a root element to
+      // make it valid XML.  Records are then at the third level, eg <BEER_XML><HOPS><HOP>.
+      //
+      // Because we are reading from a QString, QXmlStreamReader::characterOffset() gives us positions in that string.
+      // Whitespace between elements comes through as separate tokens, so the offset before reading a start element is
+      // where the element's start tag begins.
+      //
+      QString const document = QString{"<BEER_XML>\n"} + codec->toUnicode(remainder) + QString{"\n</BEER_XML>"};
+      QXmlStreamReader reader{document};
+      int depth = 0;
+      qint64 recordStart = 0;
+      QString listTag;
+      records.clear();
+      while (!reader.atEnd()) {
+         qint64 const tokenStart = reader.characterOffset();
+         reader.readNext();
+         if (reader.isStartElement()) {
+            ++depth;
+            if (depth == 2) {
+               listTag = reader.name().toString();
+            } else if (depth == 3) {
+               recordStart = tokenStart;
+            }
+         } else if (reader.isEndElement()) {
+            if (depth == 3) {
+               DefaultDataRecord record;
+               record.listTag = listTag;
+               record.recordType = reader.name().toString();
+               record.text = document.mid(static_cast<int>(recordStart),
+                                          static_cast<int>(reader.characterOffset() - recordStart));
+               record.contentHash = QString::fromLatin1(
+                  QCryptographicHash::hash(record.text.toUtf8(), QCryptographicHash::Sha256).toHex()
+               );
+               records.append(record);
+            }
+            --depth;
+         }
+      }
+      if (reader.hasError()) {
+         qWarning() <<
+            Q_FUNC_INFO << "Error reading" << fileName << "at line" << reader.lineNumber() << ":" <<
+            reader.errorString();
+         return false;
+      }
+
+      qCDebug(lcDatabase) << Q_FUNC_INFO << "Read" << records.size() << "records from" << fileName;
+      return true;
+   }
+
+   /**
+    * \brief Read the manifest of default data records that have been merged into a DB.  (Only the \c recordType and
+    *        \c contentHash fields of the returned records are set.)
+    */
+   QVector<DefaultDataRecord> readDefaultDataManifest(QSqlDatabase connection) {
+      QVector<DefaultDataRecord> manifest;
+      BtSqlQuery sqlQuery{"SELECT record_type, content_hash FROM default_data_manifest", connection};
+      while (sqlQuery.next()) {
+         DefaultDataRecord record;
+         record.recordType = sqlQuery.value(0).toString();
+         record.contentHash = sqlQuery.value(1).toString();
+         manifest.append(record);
+      }
+      return manifest;
+   }
+
+   /**
+    * \brief Of the supplied default data records, return those whose hashes are not in the manifest in the user's DB
+    */
+   QVector<DefaultDataRecord> getUnmergedDefaultDataRecords(QVector<DefaultDataRecord> const & records) {
+      QSet<QString> mergedHashes;
+      for (auto const & mergedRecord : readDefaultDataManifest(Database::instance().sqlDatabase())) {
+         mergedHashes.insert(mergedRecord.contentHash);
+      }
+
+      QVector<DefaultDataRecord> unmergedRecords;
+      std::copy_if(records.cbegin(),
+                   records.cend(),
+                   std::back_inserter(unmergedRecords),
+                   [&mergedHashes](DefaultDataRecord const & record) {
+                      return !mergedHashes.contains(record.contentHash);
+                   });
+      qCDebug(lcDatabase) <<
+         Q_FUNC_INFO << unmergedRecords.size() << "of" << records.size() << "default data records not yet merged";
+      return unmergedRecords;
+   }
+
+   /**
+    * \brief Record in the manifest that the supplied default data records have been merged into a DB.  Caller's
+    *        responsibility to handle transactions.
+    */
+   bool insertIntoDefaultDataManifest(QSqlDatabase connection, QVector<DefaultDataRecord> const & records) {
+      BtSqlQuery sqlQuery{connection};
+      QString const queryString{"INSERT INTO default_data_manifest (record_type, content_hash) VALUES (?, ?)"};
+      sqlQuery.prepare(queryString);
+      for (auto const & record : records) {
+         sqlQuery.addBindValue(record.recordType);
+         sqlQuery.addBindValue(record.contentHash);
+         if (!sqlQuery.exec()) {
+            qCritical() <<
+               Q_FUNC_INFO << "Error executing database query " << queryString << ": " << sqlQuery.lastError().text();
+            return false;
+         }
+      }
+      return true;
+   }
+
+   /**
+    * \brief As \c insertIntoDefaultDataManifest(), but in its own transaction.  Only for use on a DB that the write
+    *        thread isn't writing to (ie a new DB we're copying to).
+    */
+   bool addToDefaultDataManifest(Database & database,
+                                 QSqlDatabase connection,
+                                 QVector<DefaultDataRecord> const & records) {
+      DbTransaction dbTransaction{database, connection};
+      if (!insertIntoDefaultDataManifest(connection, records)) {
+         return false;
+      }
+      return dbTransaction.commit();
+   }
+
+   /**
+    * \brief Write the supplied records out as a BeerXML file that can be imported in the usual way
+    */
+   bool writeDefaultDataRecords(QFile & outputFile,
+                                QString const & xmlDeclaration,
+                                QTextCodec * codec,
+                                QVector<DefaultDataRecord> const & records) {
+      QString document = xmlDeclaration;
+      // Records of the same type need to go together inside the list tag (eg <HOPS>...</HOPS>)
+      QStringList listTags;
+      for (auto const & record : records) {
+         if (!listTags.contains(record.listTag)) {
+            listTags.append(record.listTag);
+         }
+      }
+      for (auto const & listTag : listTags) {
+         document += QString{"<%1>\n"}.arg(listTag);
+         for (auto const & record : records) {
+            if (record.listTag == listTag) {
+               document += record.text;
+               document += "\n";
+            }
+         }
+         document += QString{"</%1>\n"}.arg(listTag);
+      }
+      QByteArray const documentData = codec->fromUnicode(document);
+      if (outputFile.write(documentData) != documentData.size() || !outputFile.flush()) {
+         qWarning() << Q_FUNC_INFO << "Could not write" << outputFile.fileName() << ":" << outputFile.errorString();
+         return false;
+      }
+      return true;
+   }
+
    /*!
     * \brief Migrate from version \c oldVersion to \c oldVersion+1
     */
    bool migrateNext(Database & database, int oldVersion, QSqlDatabase db ) {
-      qDebug() << Q_FUNC_INFO << "Migrating DB schema from v" << oldVersion << "to v" << oldVersion + 1;
+      qCDebug(lcDatabase) << Q_FUNC_INFO << "Migrating DB schema from v" << oldVersion << "to v" << oldVersion + 1;
       BtSqlQuery sqlQuery(db);
       bool ret = true;
 
@@ -569,6 +861,15 @@ namespace {
          case 9:
             ret &= migrate_to_10(database, sqlQuery);
             break;
+         case 10:
+            ret &= migrate_to_11(database, sqlQuery);
+            break;
+         case 11:
+            ret &= migrate_to_12(database, sqlQuery);
+            break;
+         case 12:
+            ret &= migrate_to_13(database, db);
+            break;
          default:
             qCritical() << QString("Unknown version %1").arg(oldVersion);
             return false;
@@ -614,7 +915,7 @@ bool DatabaseSchemaHelper::create(Database & database, QSqlDatabase connection)
    // having called dbTransaction.commit().
    DbTransaction dbTransaction{database, connection};
 
-   qDebug() << Q_FUNC_INFO;
+   qCDebug(lcDatabase) << Q_FUNC_INFO;
    if (!CreateAllDatabaseTables(database, connection)) {
       return false;
    }
@@ -627,8 +928,8 @@ bool DatabaseSchemaHelper::create(Database & database, QSqlDatabase connection)
    //
    QVector<QueryAndParameters> const setUpQueries{
       {QString("CREATE TABLE settings (id %2, repopulatechildrenonnextstart %1, version %1)").arg(database.getDbNativeTypeName<int>(), database.getDbNativePrimaryKeyDeclaration())},
-      {QString("INSERT INTO settings (repopulatechildrenonnextstart, version) VALUES (?, ?)"), {QVariant(1), QVariant(dbVersion)}}
-
+      {QString("INSERT INTO settings (repopulatechildrenonnextstart, version) VALUES (?, ?)"), {QVariant(1), QVariant(dbVersion)}},
+      {createDefaultDataManifestSql(database)}
    };
    BtSqlQuery sqlQuery{connection};
 
@@ -636,6 +937,10 @@ bool DatabaseSchemaHelper::create(Database & database, QSqlDatabase connection)
       return false;
    }
 
+   if (!executeSqlQueries(sqlQuery, secondaryIndexQueries)) {
+      return false;
+   }
+
    // If we got here, everything went well, so we can commit the DB transaction now, otherwise it will have aborted when
    // we returned from an error branch above.
    dbTransaction.commit();
@@ -645,13 +950,13 @@ bool DatabaseSchemaHelper::create(Database & database, QSqlDatabase connection)
 
 bool DatabaseSchemaHelper::migrate(Database & database, int oldVersion, int newVersion, QSqlDatabase connection) {
    if( oldVersion >= newVersion || newVersion > dbVersion ) {
-      qDebug() << Q_FUNC_INFO <<
+      qCDebug(lcDatabase) << Q_FUNC_INFO <<
          QString("Requested backwards migration from %1 to %2: You are an imbecile").arg(oldVersion).arg(newVersion);
       return false;
    }
 
    bool ret = true;
-   qDebug() << Q_FUNC_INFO << "Migrating database schema from v" << oldVersion << "to v" << newVersion;
+   qCDebug(lcDatabase) << Q_FUNC_INFO << "Migrating database schema from v" << oldVersion << "to v" << newVersion;
 
    // Start transaction
    // By the magic of RAII, this will abort if we exit this function (including by throwing an exception) without
@@ -671,6 +976,57 @@ bool DatabaseSchemaHelper::migrate(Database & database, int oldVersion, int newV
    return ret;
 }
 
+bool DatabaseSchemaHelper::analyze(QSqlDatabase connection) {
+   // The statement is the same for SQLite and PostgreSQL.  Neither needs it to be run outside a transaction (unlike,
+   // eg, PostgreSQL's VACUUM).
+   BtSqlQuery sqlQuery{connection};
+   if (!sqlQuery.exec("ANALYZE")) {
+      qWarning() << Q_FUNC_INFO << "Error running ANALYZE: " << sqlQuery.lastError().text();
+      return false;
+   }
+   qInfo() << Q_FUNC_INFO << "Updated query planner statistics";
+   return true;
+}
+
+bool DatabaseSchemaHelper::vacuum(Database & database, QSqlDatabase connection) {
+   bool const isSqlite = database.dbType() == Database::SQLITE;
+
+   // Returns the size of the DB in bytes, or -1 if we couldn't get it
+   auto getDbSize = [isSqlite, &connection]() -> qint64 {
+      BtSqlQuery sqlQuery{connection};
+      if (isSqlite) {
+         if (!sqlQuery.exec("PRAGMA page_count") || !sqlQuery.next()) {
+            return -1;
+         }
+         qint64 const pageCount = sqlQuery.value(0).toLongLong();
+         if (!sqlQuery.exec("PRAGMA page_size") || !sqlQuery.next()) {
+            return -1;
+         }
+         return pageCount * sqlQuery.value(0).toLongLong();
+      }
+      if (!sqlQuery.exec("SELECT pg_database_size(current_database())") || !sqlQuery.next()) {
+         return -1;
+      }
+      return sqlQuery.value(0).toLongLong();
+   };
+
+   qint64 const sizeBefore = getDbSize();
+   BtSqlQuery sqlQuery{connection};
+   if (!sqlQuery.exec(isSqlite ? "VACUUM" : "VACUUM ANALYZE")) {
+      qWarning() << Q_FUNC_INFO << "Error running VACUUM: " << sqlQuery.lastError().text();
+      return false;
+   }
+   qint64 const sizeAfter = getDbSize();
+   if (sizeBefore < 0 || sizeAfter < 0) {
+      qInfo() << Q_FUNC_INFO << "Vacuumed DB (unable to measure how much space was reclaimed)";
+   } else {
+      qInfo() <<
+         Q_FUNC_INFO << "Vacuumed DB from" << sizeBefore << "to" << sizeAfter << "bytes, reclaiming" <<
+         (sizeBefore - sizeAfter) << "bytes";
+   }
+   return true;
+}
+
 int DatabaseSchemaHelper::currentVersion(QSqlDatabase db) {
    // Version was a string field in early versions of the code and then became an integer field
    // We'll read it into a QVariant and then work out whether it's a string or an integer
@@ -685,7 +1041,7 @@ int DatabaseSchemaHelper::currentVersion(QSqlDatabase db) {
 
    // Get the string before we kill it by convert()-ing
    QString stringVer( ver.toString() );
-   qDebug() << Q_FUNC_INFO << "Database schema version" << stringVer;
+   qCDebug(lcDatabase) << Q_FUNC_INFO << "Database schema version" << stringVer;
 
    // Initially, versioning was done with strings, so we need to convert
    // the old version strings to integer versions
@@ -709,7 +1065,9 @@ int DatabaseSchemaHelper::currentVersion(QSqlDatabase db) {
    return -1;
 }
 
-bool DatabaseSchemaHelper::copyToNewDatabase(Database & newDatabase, QSqlDatabase & connectionNew) {
+bool DatabaseSchemaHelper::copyToNewDatabase(Database & newDatabase,
+                                             QSqlDatabase & connectionNew,
+                                             std::function<void(int, int)> const & progress) {
 
    // this is to prevent us from over-writing or doing heavens knows what to an existing db
    if (connectionNew.tables().contains(QLatin1String("settings"))) {
@@ -724,11 +1082,18 @@ bool DatabaseSchemaHelper::copyToNewDatabase(Database & newDatabase, QSqlDatabas
       return false;
    }
 
-   if (!WriteAllObjectStoresToNewDb(newDatabase, connectionNew)) {
+   if (!WriteAllObjectStoresToNewDb(newDatabase, connectionNew, progress)) {
       qCritical() << Q_FUNC_INFO << "Error writing data to new DB";
       return false;
    }
 
+   // Not essential, but saves the next default data merge re-examining everything
+   if (!addToDefaultDataManifest(newDatabase,
+                                 connectionNew,
+                                 readDefaultDataManifest(Database::instance().sqlDatabase()))) {
+      qWarning() << Q_FUNC_INFO << "Unable to copy default data manifest to new DB";
+   }
+
    return true;
 }
 
@@ -754,8 +1119,39 @@ bool DatabaseSchemaHelper::copyToNewDatabase(Database & newDatabase, QSqlDatabas
  *           - Our XML import code already does duplicate detection, so don't need the special tracking tables any more.
  *             We just try to import all the default data, and any records that the user already has will be skipped
  *             over.
+ *
+ *        Importing the whole of DefaultData.xml takes a few seconds though, nearly all of it spent establishing that
+ *        records are duplicates.  So we also keep, in the default_data_manifest table, a hash of each default data
+ *        record we have merged.  Then we only need to import the records that are new or have changed since the last
+ *        merge.  (Duplicate detection still applies to those, eg for a user who had imported the same record from
+ *        elsewhere.)
  */
 bool DatabaseSchemaHelper::updateDatabase(QTextStream & userMessage) {
+   QString const defaultDataFileName = Brewtarget::getResourceDir().filePath("DefaultData.xml");
+   QString xmlDeclaration;
+   QTextCodec * codec = nullptr;
+   QVector<DefaultDataRecord> allRecords;
+   if (!readDefaultDataRecords(defaultDataFileName, xmlDeclaration, codec, allRecords)) {
+      userMessage << QObject::tr("Could not read %1").arg(defaultDataFileName);
+      return false;
+   }
+   QVector<DefaultDataRecord> const newRecords = getUnmergedDefaultDataRecords(allRecords);
+   if (newRecords.isEmpty()) {
+      userMessage << QObject::tr("No new default data found");
+      return true;
+   }
+
+   // The import code reads from a file, so we write the records it needs to look at to a temporary one
+   QTemporaryFile newRecordsFile{QDir::temp().filePath("brewtarget-default-data-XXXXXX.xml")};
+   if (!newRecordsFile.open() ||
+       !writeDefaultDataRecords(newRecordsFile, xmlDeclaration, codec, newRecords)) {
+      userMessage << QObject::tr("Could not write temporary file %1").arg(newRecordsFile.fileName());
+      return false;
+   }
+   newRecordsFile.close();
+   qInfo() <<
+      Q_FUNC_INFO << "Importing" << newRecords.size() << "of" << allRecords.size() << "default data records via" <<
+      newRecordsFile.fileName();
 
    //
    // We'd like to put any newly-imported default Recipes in the same folder as the other default ones.  To do this, we
@@ -763,17 +1159,16 @@ bool DatabaseSchemaHelper::updateDatabase(QTextStream & userMessage) {
    // folder.
    //
    QList<Recipe *> allRecipesBeforeImport = ObjectStoreWrapper::getAllRaw<Recipe>();
-   qDebug() << Q_FUNC_INFO << allRecipesBeforeImport.size() << "Recipes before import";
+   qCDebug(lcDatabase) << Q_FUNC_INFO << allRecipesBeforeImport.size() << "Recipes before import";
 
-   QString const defaultDataFileName = Brewtarget::getResourceDir().filePath("DefaultData.xml");
-   bool succeeded = BeerXML::getInstance().importFromXML(defaultDataFileName, userMessage);
+   bool succeeded = BeerXML::getInstance().importFromXML(newRecordsFile.fileName(), userMessage);
 
    if (succeeded) {
       //
       // Now see what Recipes exist that weren't there before the import
       //
       QList<Recipe *> allRecipesAfterImport = ObjectStoreWrapper::getAllRaw<Recipe>();
-      qDebug() << Q_FUNC_INFO << allRecipesAfterImport.size() << "Recipes after import";
+      qCDebug(lcDatabase) << Q_FUNC_INFO << allRecipesAfterImport.size() << "Recipes after import";
 
       //
       // Once the lists are sorted, finding the difference is just a library call
@@ -785,11 +1180,40 @@ bool DatabaseSchemaHelper::updateDatabase(QTextStream & userMessage) {
       std::set_difference(allRecipesAfterImport.begin(), allRecipesAfterImport.end(),
                           allRecipesBeforeImport.begin(), allRecipesBeforeImport.end(),
                           std::back_inserter(newlyImportedRecipes));
-      qDebug() << Q_FUNC_INFO << newlyImportedRecipes.size() << "newly imported Recipes";
+      qCDebug(lcDatabase) << Q_FUNC_INFO << newlyImportedRecipes.size() << "newly imported Recipes";
       for (auto recipe : newlyImportedRecipes) {
          recipe->setFolder(FOLDER_FOR_SUPPLIED_RECIPES);
       }
+
+      //
+      // The import wrote the new records via the DB write thread, so the manifest update needs to go the same way,
+      // rather than our opening a write transaction on this thread's connection that would contend with it.  If we
+      // can't update the manifest, the import still happened; we'll just do more work than necessary next time.
+      //
+      Database::instance().enqueueWrite(
+         [newRecords](QSqlDatabase & connection) {
+            return insertIntoDefaultDataManifest(connection, newRecords);
+         },
+         [](bool succeeded) {
+            if (!succeeded) {
+               qWarning() << Q_FUNC_INFO << "Unable to update default data manifest";
+            }
+            return;
+         }
+      );
    }
 
    return succeeded;
 }
+
+bool DatabaseSchemaHelper::hasNewDefaultData() {
+   QString const defaultDataFileName = Brewtarget::getResourceDir().filePath("DefaultData.xml");
+   QString xmlDeclaration;
+   QTextCodec * codec = nullptr;
+   QVector<DefaultDataRecord> allRecords;
+   if (!readDefaultDataRecords(defaultDataFileName, xmlDeclaration, codec, allRecords)) {
+      // If we can't tell, let updateDatabase() try and report the problem
+      return true;
+   }
+   return !getUnmergedDefaultDataRecords(allRecords).isEmpty();
+}
@@ -23,6 +23,8 @@
 #define DATABASE_DATABASESCHEMAHELPER_H
 #pragma once
 
+#include <functional>
+
 #include <QSqlDatabase>
 
 #include "Database.h"
@@ -49,11 +51,36 @@ namespace DatabaseSchemaHelper {
     */
    bool migrate(Database & database, int oldVersion, int newVersion, QSqlDatabase connection);
 
+   /*!
+    * \brief Gather the statistics about table contents that the DB's query planner uses to decide which indexes to
+    *        use.  Until this has been run, SQLite in particular has to guess, and can guess badly.  Statistics go out
+    *        of date as tables grow, but not quickly, so \c Database runs this every few sessions rather than every
+    *        time.
+    *
+    * \return \c true if succeeded, \c false otherwise
+    */
+   bool analyze(QSqlDatabase connection);
+
+   /*!
+    * \brief Give the space freed up by deleted rows back to the file system (and, for PostgreSQL, update the query
+    *        planner statistics at the same time), logging how much space was reclaimed.  Must NOT be called inside a
+    *        transaction.  This can take a while on a big DB, so \c Compaction only runs it every so often.
+    *
+    * \return \c true if succeeded, \c false otherwise
+    */
+   bool vacuum(Database & database, QSqlDatabase connection);
+
    //! \brief Current schema version of the given database
    int currentVersion(QSqlDatabase db = QSqlDatabase());
 
-   //! \brief does the heavy lifting to copy the contents from one db to the next
-   bool copyToNewDatabase(Database & newDatabase, QSqlDatabase & connectionNew);
+   /*!
+    * \brief does the heavy lifting to copy the contents from one db to the next
+    *
+    * \param progress See \c WriteAllObjectStoresToNewDb
+    */
+   bool copyToNewDatabase(Database & newDatabase,
+                          QSqlDatabase & connectionNew,
+                          std::function<void(int, int)> const & progress = nullptr);
 
    /**
     * \brief Populates (or updates) default Recipes, Hops, Styles, etc in the DB
@@ -61,6 +88,12 @@ namespace DatabaseSchemaHelper {
     * \return \c true if succeeded, \c false otherwise
     */
    bool updateDatabase(QTextStream & userMessage);
+
+   /**
+    * \brief Whether there are any default data records that \c updateDatabase() has not yet merged into the DB.  This
+    *        is quick to check, so we can use it to avoid bothering the user when there is nothing to merge.
+    */
+   bool hasNewDefaultData();
 }
 
 #endif
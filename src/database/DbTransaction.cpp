@@ -22,6 +22,7 @@
 #include <QSqlError>
 
 #include "database/Database.h"
+#include "Logging.h"
 
 
 DbTransaction::DbTransaction(Database & database, QSqlDatabase & connection, DbTransaction::SpecialBehaviours specialBehaviours) :
@@ -36,7 +37,7 @@ DbTransaction::DbTransaction(Database & database, QSqlDatabase & connection, DbT
    }
 
    bool succeeded = this->connection.transaction();
-   qDebug() << Q_FUNC_INFO << "Database transaction begin: " << (succeeded ? "succeeded" : "failed");
+   qCDebug(lcDatabase) << Q_FUNC_INFO << "Database transaction begin: " << (succeeded ? "succeeded" : "failed");
    if (!succeeded) {
       qCritical() << Q_FUNC_INFO << "Unable to start database transaction:" << connection.lastError().text();
       Q_ASSERT(false); // .:TODO-DATABASE:. COMMENT OUT THIS ASSERT!
@@ -45,10 +46,10 @@ DbTransaction::DbTransaction(Database & database, QSqlDatabase & connection, DbT
 }
 
 DbTransaction::~DbTransaction() {
-   qDebug() << Q_FUNC_INFO;
+   qCDebug(lcDatabase) << Q_FUNC_INFO;
    if (!committed) {
       bool succeeded = this->connection.rollback();
-      qDebug() << Q_FUNC_INFO << "Database transaction rollback: " << (succeeded ? "succeeded" : "failed");
+      qCDebug(lcDatabase) << Q_FUNC_INFO << "Database transaction rollback: " << (succeeded ? "succeeded" : "failed");
       if (!succeeded) {
          qCritical() << Q_FUNC_INFO << "Unable to rollback database transaction:" << connection.lastError().text();
       }
@@ -63,7 +64,7 @@ DbTransaction::~DbTransaction() {
 
 bool DbTransaction::commit() {
    this->committed = connection.commit();
-   qDebug() << Q_FUNC_INFO << "Database transaction commit: " << (this->committed ? "succeeded" : "failed");
+   qCDebug(lcDatabase) << Q_FUNC_INFO << "Database transaction commit: " << (this->committed ? "succeeded" : "failed");
    if (!this->committed) {
       qCritical() << Q_FUNC_INFO << "Unable to commit database transaction:" << connection.lastError().text();
    }
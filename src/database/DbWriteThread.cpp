@@ -0,0 +1,182 @@
+/*
+ * database/DbWriteThread.cpp is part of Brewtarget, and is copyright the following
+ * authors 2021:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "database/DbWriteThread.h"
+
+#include <QDebug>
+#include <QMutexLocker>
+
+#include "database/DbTransaction.h"
+#include "Logging.h"
+
+DbWriteThread::DbWriteThread(Database & database) : QThread{},
+                                                    database{database},
+                                                    mutex{},
+                                                    writeQueued{},
+                                                    queueDrained{},
+                                                    queue{},
+                                                    busy{false},
+                                                    stopRequested{false},
+                                                    lastSequenceNumber{0},
+                                                    completions{} {
+   this->setObjectName("DbWriteThread");
+   // This object lives on the thread that created it, so, although writeFinished() is emitted on the write thread,
+   // callCompletion() will be called back on the creating thread
+   connect(this, &DbWriteThread::writeFinished, this, &DbWriteThread::callCompletion, Qt::QueuedConnection);
+   return;
+}
+
+DbWriteThread::~DbWriteThread() {
+   this->stop();
+   return;
+}
+
+std::future<bool> DbWriteThread::enqueue(Database::WriteCommand command,
+                                         std::function<void(bool)> onCompletion,
+                                         bool inTransaction) {
+   QMutexLocker locker(&this->mutex);
+   QueuedWrite queuedWrite{++this->lastSequenceNumber, std::move(command), inTransaction, std::promise<bool>{}};
+   std::future<bool> result = queuedWrite.result.get_future();
+   if (onCompletion) {
+      this->completions.insert(queuedWrite.sequenceNumber, std::move(onCompletion));
+   }
+   this->queue.push_back(std::move(queuedWrite));
+   this->writeQueued.wakeOne();
+   return result;
+}
+
+void DbWriteThread::flush() {
+   QMutexLocker locker(&this->mutex);
+   if (!this->queue.empty() || this->busy) {
+      qCDebug(lcDatabase) << Q_FUNC_INFO << "Waiting for" << this->queue.size() << "queued DB write(s)";
+   }
+   while (!this->queue.empty() || this->busy) {
+      this->queueDrained.wait(&this->mutex);
+   }
+   return;
+}
+
+void DbWriteThread::stop() {
+   if (!this->isRunning()) {
+      return;
+   }
+   {
+      QMutexLocker locker(&this->mutex);
+      this->stopRequested = true;
+      this->writeQueued.wakeOne();
+   }
+   // The thread runs everything still on the queue before it exits
+   this->wait();
+   return;
+}
+
+bool DbWriteThread::runWrite(Database & database,
+                             QSqlDatabase & connection,
+                             Database::WriteCommand const & command,
+                             bool inTransaction) {
+   if (!inTransaction) {
+      return command(connection);
+   }
+
+   // By the magic of RAII, this will roll back if we return without having called dbTransaction.commit()
+   DbTransaction dbTransaction{database, connection};
+   if (!command(connection)) {
+      return false;
+   }
+   return dbTransaction.commit();
+}
+
+void DbWriteThread::run() {
+   qCDebug(lcDatabase) << Q_FUNC_INFO << "DB write thread started";
+
+   // We only open our DB connection when we first need it, and we close it when we finish
+   QString connectionName;
+   for (;;) {
+      QueuedWrite queuedWrite;
+      {
+         QMutexLocker locker(&this->mutex);
+         while (this->queue.empty() && !this->stopRequested) {
+            this->writeQueued.wait(&this->mutex);
+         }
+         if (this->queue.empty()) {
+            // Stop requested and nothing left to do
+            break;
+         }
+         queuedWrite = std::move(this->queue.front());
+         this->queue.pop_front();
+         this->busy = true;
+      }
+
+      bool succeeded = false;
+      try {
+         QSqlDatabase connection = this->database.sqlDatabase();
+         connectionName = connection.connectionName();
+         succeeded = DbWriteThread::runWrite(this->database,
+                                             connection,
+                                             queuedWrite.command,
+                                             queuedWrite.inTransaction);
+      } catch (QString const & errorMessage) {
+         // Database::sqlDatabase() throws if it can't open a connection
+         qCritical() << Q_FUNC_INFO << "Unable to run DB write #" << queuedWrite.sequenceNumber << ":" << errorMessage;
+      }
+      if (!succeeded) {
+         qCritical() << Q_FUNC_INFO << "DB write #" << queuedWrite.sequenceNumber << "failed";
+      }
+      queuedWrite.result.set_value(succeeded);
+      emit this->writeFinished(queuedWrite.sequenceNumber, succeeded);
+
+      {
+         QMutexLocker locker(&this->mutex);
+         this->busy = false;
+         if (this->queue.empty()) {
+            this->queueDrained.wakeAll();
+         }
+      }
+   }
+
+   //
+   // Per the comments in Database.h, the QSqlDatabase object has to be out of scope before we remove the connection.
+   // (Database::unload() would also remove it, but a Qt connection should be closed on the thread that opened it.)
+   //
+   if (!connectionName.isEmpty()) {
+      {
+         QSqlDatabase connection = QSqlDatabase::database(connectionName, false);
+         connection.close();
+      }
+      QSqlDatabase::removeDatabase(connectionName);
+   }
+
+   {
+      QMutexLocker locker(&this->mutex);
+      this->stopRequested = false;
+   }
+   qCDebug(lcDatabase) << Q_FUNC_INFO << "DB write thread finished";
+   return;
+}
+
+void DbWriteThread::callCompletion(quint64 sequenceNumber, bool succeeded) {
+   std::function<void(bool)> onCompletion;
+   {
+      QMutexLocker locker(&this->mutex);
+      onCompletion = this->completions.take(sequenceNumber);
+   }
+   if (onCompletion) {
+      onCompletion(succeeded);
+   }
+   return;
+}
@@ -0,0 +1,123 @@
+/*
+ * database/DbWriteThread.h is part of Brewtarget, and is copyright the following
+ * authors 2021:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef DATABASE_DBWRITETHREAD_H
+#define DATABASE_DBWRITETHREAD_H
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <future>
+
+#include <QHash>
+#include <QMutex>
+#include <QSqlDatabase>
+#include <QThread>
+#include <QWaitCondition>
+
+#include "database/Database.h"
+
+/**
+ * \class DbWriteThread
+ *
+ * \brief The thread on which \c Database runs the writes queued by \c Database::enqueueWrite(), so that a slow disk or
+ *        a remote PostgreSQL server does not make the GUI wait.
+ *
+ *        Writes are run one at a time, in the order they were queued, each in its own transaction on this thread's
+ *        own DB connection (obtained in the usual way from \c Database::sqlDatabase()).  When each one has run, we
+ *        emit \c writeFinished() and call its completion callback (if any) back on the thread that owns this object
+ *        (ie the GUI thread).  Because queued signals are delivered in order, completions arrive in the same order as
+ *        the writes were queued.
+ *
+ *        The connection is closed when the thread finishes, which it does when \c stop() is called.
+ */
+class DbWriteThread : public QThread {
+   Q_OBJECT
+
+public:
+   DbWriteThread(Database & database);
+   virtual ~DbWriteThread();
+
+   /**
+    * \brief See \c Database::enqueueWrite() and \c Database::enqueueMaintenance()
+    *
+    * \param inTransaction \c false for maintenance commands, such as VACUUM, that can't be run inside a transaction
+    */
+   std::future<bool> enqueue(Database::WriteCommand command,
+                             std::function<void(bool)> onCompletion,
+                             bool inTransaction = true);
+
+   /**
+    * \brief Block until every write queued so far has been run
+    */
+   void flush();
+
+   /**
+    * \brief Run any outstanding writes, then finish the thread and wait for it to exit
+    */
+   void stop();
+
+   /**
+    * \brief Run a write in a transaction on the supplied connection, committing it if the write succeeds.  Also used
+    *        by \c Database to run writes on the calling thread when there is no write thread running.
+    *
+    * \param inTransaction If \c false, the command is just run, without a transaction
+    *
+    * \return \c true if the write succeeded (and, if applicable, was committed), \c false otherwise
+    */
+   static bool runWrite(Database & database,
+                        QSqlDatabase & connection,
+                        Database::WriteCommand const & command,
+                        bool inTransaction = true);
+
+signals:
+   /**
+    * \brief Emitted, in order, as each queued write has been run.  Sequence numbers start at 1 and increase by one for
+    *        each write queued.
+    */
+   void writeFinished(quint64 sequenceNumber, bool succeeded);
+
+protected:
+   virtual void run();
+
+private slots:
+   void callCompletion(quint64 sequenceNumber, bool succeeded);
+
+private:
+   struct QueuedWrite {
+      quint64 sequenceNumber;
+      Database::WriteCommand command;
+      bool inTransaction;
+      std::promise<bool> result;
+   };
+
+   Database & database;
+
+   // Guards all the member variables below it
+   QMutex mutex;
+   QWaitCondition writeQueued;
+   QWaitCondition queueDrained;
+   std::deque<QueuedWrite> queue;
+   // Set whilst this thread is running a write that it has taken off the queue
+   bool busy;
+   bool stopRequested;
+   quint64 lastSequenceNumber;
+   QHash<quint64, std::function<void(bool)> > completions;
+};
+
+#endif
@@ -18,19 +18,27 @@
  */
 #include "database/ObjectStore.h"
 
+#include <algorithm>
 #include <cstring>
 
 #include <QDebug>
 #include <QHash>
+#include <QSet>
 #include <QSqlDriver>
 #include <QSqlError>
 #include <QSqlField>
 #include <QSqlRecord>
+#include <QTimer>
 
 #include "database/BtSqlQuery.h"
 #include "database/Database.h"
 #include "database/DbTransaction.h"
+#include "database/ObjectStoreSnapshot.h"
+#include "Logging.h"
+#include "model/NamedEntity.h"
 #include "model/NamedParameterBundle.h"
+#include "utils/StartupProfile.h"
+#include "utils/Tracing.h"
 
 // Private implementation details that don't need access to class member variables
 namespace {
@@ -92,7 +100,7 @@ namespace {
       bool firstFieldOutput = false;
       for (auto const & fieldDefn: tableDefinition.tableFields) {
          if (fieldDefn.foreignKeyTo != nullptr) {
-            qDebug() << Q_FUNC_INFO << "Skipping" << fieldDefn.columnName << "as foreign key";
+            qCDebug(lcDatabase) << Q_FUNC_INFO << "Skipping" << fieldDefn.columnName << "as foreign key";
             // It's (currently) a coding error if a foreign key is anything other than an integer
             Q_ASSERT(fieldDefn.fieldType == ObjectStore::FieldType::Int);
             continue;
@@ -124,7 +132,7 @@ namespace {
       }
       queryStringAsStream << "\n);";
 
-      qDebug().noquote() << Q_FUNC_INFO << "Table creation: " << queryString;
+      qCDebug(lcDatabase).noquote() << Q_FUNC_INFO << "Table creation: " << queryString;
 
       BtSqlQuery sqlQuery{connection};
       sqlQuery.prepare(queryString);
@@ -183,7 +191,7 @@ namespace {
             ).arg(
                *fieldDefn.foreignKeyTo->tableFields[0].columnName
             );
-            qDebug().noquote() << Q_FUNC_INFO << "Foreign keys: " << queryString;
+            qCDebug(lcDatabase).noquote() << Q_FUNC_INFO << "Foreign keys: " << queryString;
 
             sqlQuery.prepare(queryString);
             if (!sqlQuery.exec()) {
@@ -201,7 +209,7 @@ namespace {
     * Return a string containing all the bound values on a query.   This is quite a useful thing to have logged when
     * you get an error!
     *
-    * NB: This can be a long string.  It includes newlines, and is intended to be logged with qDebug().noquote() or
+    * NB: This can be a long string.  It includes newlines, and is intended to be logged with qCDebug(lcDatabase).noquote() or
     *     similar.
     */
    QString BoundValuesToString(BtSqlQuery const & sqlQuery) {
@@ -271,6 +279,50 @@ namespace {
       return match->string;
    }
 
+   //
+   // For a type whose objects can have parents, the extra column in the primary table that lists, for each child, the
+   // columns whose values it reads from its parent's row (see comments in database/ObjectStore.h).  The column names
+   // are separated by commas.
+   //
+   char const * const inheritedFieldsColumn = "inherited_fields";
+
+   /**
+    * \brief What we store, in a child's row, in a column whose value the child reads from its parent.  The value is
+    *        never read back, but it has to be one the column accepts (eg name columns are NOT NULL in older DBs), and
+    *        there's no point in it being big.
+    */
+   QVariant getInheritedFieldPlaceholder(ObjectStore::FieldType const fieldType) {
+      switch (fieldType) {
+         case ObjectStore::FieldType::Bool:   return QVariant{false};
+         case ObjectStore::FieldType::Int:    return QVariant{0};
+         case ObjectStore::FieldType::UInt:   return QVariant{0u};
+         case ObjectStore::FieldType::Double: return QVariant{0.0};
+         // NB: An empty string, not a null one, which would be stored as NULL
+         case ObjectStore::FieldType::String: return QVariant{QString{""}};
+         case ObjectStore::FieldType::Enum:   return QVariant{QString{""}};
+         default:
+            break;
+      }
+      // Dates are all that's left, and they can be NULL
+      return QVariant{};
+   }
+
+   /**
+    * \brief Combine two writes into one, so that they happen in the same DB transaction (see
+    *        \c Database::enqueueWrite()).  Either or both can be empty.
+    */
+   Database::WriteCommand combineWrites(Database::WriteCommand first, Database::WriteCommand second) {
+      if (!first) {
+         return second;
+      }
+      if (!second) {
+         return first;
+      }
+      return [first, second](QSqlDatabase & connection) {
+         return first(connection) && second(connection);
+      };
+   }
+
    //
    // Convenience functions for accessing specific fields of a JunctionTableDefinition struct
    //
@@ -288,10 +340,81 @@ namespace {
    }
 
    /**
-    * \brief Insert data from an object property to a junction table
+    * \brief Get the IDs that an object property stores in a junction table, in the order they should be written
     *
     * \param junctionTable
     * \param object
+    * \param primaryKey  Only used for logging
+    * \param propertyValues Where to put the results
+    *
+    * \return \c true if succeeded, \c false otherwise
+    */
+   bool getJunctionTablePropertyValues(ObjectStore::JunctionTableDefinition const & junctionTable,
+                                       QObject const & object,
+                                       int primaryKey,
+                                       QVector<int> & propertyValues) {
+      propertyValues.clear();
+      QVariant propertyValuesWrapper = object.property(*GetJunctionTableDefinitionPropertyName(junctionTable));
+      if (!propertyValuesWrapper.isValid()) {
+         // It's a programming error if we couldn't read a property value
+         qCritical() <<
+            Q_FUNC_INFO << "Unable to read" << object.metaObject()->className() << "property" <<
+            GetJunctionTableDefinitionPropertyName(junctionTable);
+         Q_ASSERT(false); // Stop here on debug builds
+         return false;
+      }
+
+      // We now need to extract the property values from their QVariant wrapper
+      if (junctionTable.assumedNumEntries == ObjectStore::MAX_ONE_ENTRY) {
+         // If it's single entry only, just turn it into a one-item list so that the remaining processing is the same
+         bool succeeded = false;
+         int theValue = propertyValuesWrapper.toInt(&succeeded);
+         if (!succeeded) {
+            qCritical() << Q_FUNC_INFO << "Can't convert QVariant of" << propertyValuesWrapper.typeName() << "to int";
+            Q_ASSERT(false); // Stop here on debug builds
+            return false;    // Continue but bail out of the current DB transaction on other builds
+         }
+
+         // If the foreign key returned is not valid, it's not an error, it just means there is no associated object,
+         // eg this Hop does not have a parent.
+         if (theValue <= 0) {
+            qCDebug(lcDatabase) <<
+               Q_FUNC_INFO << "Property" << GetJunctionTableDefinitionPropertyName(junctionTable) << "of" <<
+               object.metaObject()->className() << "#" << primaryKey << "is" << theValue <<
+               "which we assume means \"unset\", so nothing to write to junction table" <<
+               junctionTable.tableName;
+            return true;
+         }
+
+         propertyValues.append(theValue);
+      } else {
+         //
+         // The propertyValuesWrapper QVariant should hold QVector<int>.  If it doesn't it's a coding error (because we have a
+         // property getter that's returning something else).
+         //
+         // Note that QVariant::toList() is NOT going to be useful to us here because that ONLY works if the contained
+         // type is QList<QVariant> (aka QVariantList) or QStringList.  If your QVariant contains some other list-like
+         // structure then toList() will just return an empty list.
+         //
+         if (!propertyValuesWrapper.canConvert< QVector<int> >()) {
+            qCritical() <<
+               Q_FUNC_INFO << "Can't convert QVariant of" << propertyValuesWrapper.typeName() << "to QVector<int>";
+            Q_ASSERT(false); // Stop here on debug builds
+            return false;    // Continue but bail out of the current DB transaction on other builds
+         }
+         propertyValues = propertyValuesWrapper.value< QVector<int> >();
+      }
+      return true;
+   }
+
+   /**
+    * \brief Insert data from an object property to a junction table
+    *
+    *        NB: As this is run on the DB write thread, the caller supplies the property values (obtained on the GUI
+    *            thread from \c getJunctionTablePropertyValues()) rather than the object.
+    *
+    * \param junctionTable
+    * \param propertyValues
     * \param primaryKey  Note that this must be supplied separately as, for a new object, we may not (yet) have set its
     *                    primary key (ie we cannot just read primary key from object)
     * \param connection
@@ -299,13 +422,12 @@ namespace {
     * \return \c true if succeeded, \c false otherwise
     */
    bool insertIntoJunctionTableDefinition(ObjectStore::JunctionTableDefinition const & junctionTable,
-                                          QObject const & object,
+                                          QVector<int> const & propertyValues,
                                           QVariant const & primaryKey,
                                           QSqlDatabase & connection) {
-      qDebug() <<
-         Q_FUNC_INFO << "Writing" << object.metaObject()->className() << "property" <<
-         GetJunctionTableDefinitionPropertyName(junctionTable) << " into junction table " <<
-         junctionTable.tableName;
+      qCDebug(lcDatabase) <<
+         Q_FUNC_INFO << "Writing property" << GetJunctionTableDefinitionPropertyName(junctionTable) <<
+         " into junction table " << junctionTable.tableName;
 
       //
       // It's a coding error if the caller has supplied us anything other than an int inside the primaryKey QVariant.
@@ -334,7 +456,8 @@ namespace {
       // However, we DON"T do this.  The variable binding is more complicated/error-prone than when just doing
       // individual inserts.  (Even with BtSqlQuery::execBatch(), we'd have to loop to construct the lists of bind
       // parameters.)  And there's likely no noticeable performance benefit given that we're typically inserting only
-      // a handful of rows at a time (eg all the Hops in a Recipe).
+      // a handful of rows at a time (eg all the Hops in a Recipe).  (The exception is when we are writing out the whole
+      // DB, where ObjectStore::writeAllToNewDb() does use multi-row inserts -- see insertRowsInBatches() below.)
       //
       // So instead, we just do individual inserts.  Note that orderByColumn column is only used if specified, and
       // that, if it is, we assume it's an integer type and that we create the values ourselves.
@@ -364,72 +487,18 @@ namespace {
       BtSqlQuery sqlQuery{connection};
       sqlQuery.prepare(queryString);
 
-      // Get the list of data to bind to it
-      QVariant propertyValuesWrapper = object.property(*GetJunctionTableDefinitionPropertyName(junctionTable));
-      if (!propertyValuesWrapper.isValid()) {
-         // It's a programming error if we couldn't read a property value
-         qCritical() <<
-            Q_FUNC_INFO << "Unable to read" << object.metaObject()->className() << "property" <<
-            GetJunctionTableDefinitionPropertyName(junctionTable);
-         Q_ASSERT(false); // Stop here on debug builds
-         return false;
-      }
-
-      // We now need to extract the property values from their QVariant wrapper
-      QVector<int> propertyValues;
-      if (junctionTable.assumedNumEntries == ObjectStore::MAX_ONE_ENTRY) {
-         // If it's single entry only, just turn it into a one-item list so that the remaining processing is the same
-         bool succeeded = false;
-         int theValue = propertyValuesWrapper.toInt(&succeeded);
-         if (!succeeded) {
-            qCritical() << Q_FUNC_INFO << "Can't convert QVariant of" << propertyValuesWrapper.typeName() << "to int";
-            Q_ASSERT(false); // Stop here on debug builds
-            return false;    // Continue but bail out of the current DB transaction on other builds
-         }
-
-         // If the foreign key returned is not valid, it's not an error, it just means there is no associated object,
-         // eg this Hop does not have a parent.
-         if (theValue <= 0) {
-            qDebug() <<
-               Q_FUNC_INFO << "Property" << GetJunctionTableDefinitionPropertyName(junctionTable) << "of" <<
-               object.metaObject()->className() << "#" << primaryKey.toInt() << "is" << theValue <<
-               "which we assume means \"unset\", so nothing to write to junction table" <<
-               junctionTable.tableName;
-            return true;
-         }
-
-         propertyValues.append(theValue);
-      } else {
-         //
-         // The propertyValuesWrapper QVariant should hold QVector<int>.  If it doesn't it's a coding error (because we have a
-         // property getter that's returning something else).
-         //
-         // Note that QVariant::toList() is NOT going to be useful to us here because that ONLY works if the contained
-         // type is QList<QVariant> (aka QVariantList) or QStringList.  If your QVariant contains some other list-like
-         // structure then toList() will just return an empty list.
-         //
-         if (!propertyValuesWrapper.canConvert< QVector<int> >()) {
-            qCritical() <<
-               Q_FUNC_INFO << "Can't convert QVariant of" << propertyValuesWrapper.typeName() << "to QVector<int>";
-            Q_ASSERT(false); // Stop here on debug builds
-            return false;    // Continue but bail out of the current DB transaction on other builds
-         }
-         propertyValues = propertyValuesWrapper.value< QVector<int> >();
-      }
-
       // Now loop through and bind/run the insert query once for each item in the list
       int itemNumber = 1;
-      qDebug() <<
-         Q_FUNC_INFO << propertyValues.size() << "value(s) (in" << propertyValuesWrapper.typeName() << ") for property" <<
-         GetJunctionTableDefinitionPropertyName(junctionTable) << "of" << object.metaObject()->className() <<
-         "#" << primaryKey.toInt();
+      qCDebug(lcDatabase) <<
+         Q_FUNC_INFO << propertyValues.size() << "value(s) for property" <<
+         GetJunctionTableDefinitionPropertyName(junctionTable) << "of #" << primaryKey.toInt();
       for (int curValue : propertyValues) {
          sqlQuery.bindValue(thisPrimaryKeyBindName, primaryKey);
          sqlQuery.bindValue(otherPrimaryKeyBindName, curValue);
          if (!GetJunctionTableDefinitionOrderByColumn(junctionTable).isNull()) {
             sqlQuery.bindValue(orderByBindName, itemNumber);
          }
-         qDebug() <<
+         qCDebug(lcDatabase) <<
             Q_FUNC_INFO << itemNumber << ": " <<
             GetJunctionTableDefinitionThisPrimaryKeyColumn(junctionTable) << " #" << primaryKey.toInt() << " <-> " <<
             GetJunctionTableDefinitionOtherPrimaryKeyColumn(junctionTable) << " #" << curValue;
@@ -458,7 +527,7 @@ namespace {
                                           QVariant const & primaryKey,
                                           QSqlDatabase & connection) {
 
-      qDebug() <<
+      qCDebug(lcDatabase) <<
          Q_FUNC_INFO << "Deleting property " << GetJunctionTableDefinitionPropertyName(junctionTable) <<
          " in junction table " << junctionTable.tableName;
 
@@ -476,7 +545,7 @@ namespace {
 
       // Bind the primary key value
       sqlQuery.bindValue(thisPrimaryKeyBindName, primaryKey);
-      qDebug().noquote() << Q_FUNC_INFO << "Bind values:" << BoundValuesToString(sqlQuery);
+      qCDebug(lcDatabase).noquote() << Q_FUNC_INFO << "Bind values:" << BoundValuesToString(sqlQuery);
 
       // Run the query
       if (!sqlQuery.exec()) {
@@ -488,6 +557,164 @@ namespace {
       return true;
    }
 
+   /**
+    * \brief The values, read from an object property on the GUI thread, to write to one junction table
+    */
+   struct JunctionTableValues {
+      ObjectStore::JunctionTableDefinition const * junctionTable;
+      QVector<int> values;
+   };
+
+   /**
+    * \brief Replace the rows relating to a particular object in a junction table
+    *
+    *        The simplest thing to do with a junction table is to blat any rows relating to the current object and then
+    *        write out data based on the current property value.  This may often mean we're deleting rows and rewriting
+    *        them but, for the small number of rows per object we're talking about, it doesn't seem worth the complexity
+    *        of working out the minimal set of deletes and inserts.
+    *
+    * \return \c true if succeeded, \c false otherwise
+    */
+   bool rewriteJunctionTable(JunctionTableValues const & junctionTableValues,
+                             QVariant const & primaryKey,
+                             QSqlDatabase & connection) {
+      return deleteFromJunctionTableDefinition(*junctionTableValues.junctionTable, primaryKey, connection) &&
+             insertIntoJunctionTableDefinition(*junctionTableValues.junctionTable,
+                                               junctionTableValues.values,
+                                               primaryKey,
+                                               connection);
+   }
+
+   /**
+    * \brief The columns we read from a junction table in \c ObjectStore::loadAll(), in the order we read them
+    */
+   QStringList getJunctionTableColumnNames(ObjectStore::JunctionTableDefinition const & junctionTable) {
+      return QStringList{*GetJunctionTableDefinitionThisPrimaryKeyColumn(junctionTable),
+                         *GetJunctionTableDefinitionOtherPrimaryKeyColumn(junctionTable)};
+   }
+
+   /**
+    * \brief Read the raw (this, other) rows from a junction table
+    *
+    * \param connection
+    * \param junctionTable
+    * \param rows Where to put the results
+    *
+    * \return \c true if succeeded, \c false otherwise
+    */
+   bool readJunctionTableRows(QSqlDatabase & connection,
+                              ObjectStore::JunctionTableDefinition const & junctionTable,
+                              ObjectStoreSnapshot::Rows & rows) {
+      //
+      // Order first by the object we're adding the other IDs to, then order either by the other IDs or by another
+      // column if one is specified.
+      //
+      QString queryString{"SELECT "};
+      QTextStream queryStringAsStream{&queryString};
+      queryStringAsStream <<
+         GetJunctionTableDefinitionThisPrimaryKeyColumn(junctionTable) << ", " <<
+         GetJunctionTableDefinitionOtherPrimaryKeyColumn(junctionTable) <<
+         " FROM " << junctionTable.tableName <<
+         " ORDER BY " << GetJunctionTableDefinitionThisPrimaryKeyColumn(junctionTable) << ", ";
+      if (!GetJunctionTableDefinitionOrderByColumn(junctionTable).isNull()) {
+         queryStringAsStream << GetJunctionTableDefinitionOrderByColumn(junctionTable);
+      } else {
+         queryStringAsStream << GetJunctionTableDefinitionOtherPrimaryKeyColumn(junctionTable);
+      }
+      queryStringAsStream << ";";
+
+      BtSqlQuery sqlQuery{connection};
+      sqlQuery.prepare(queryString);
+      if (!sqlQuery.exec()) {
+         qCritical() <<
+            Q_FUNC_INFO << "Error executing database query " << queryString << ": " << sqlQuery.lastError().text();
+         return false;
+      }
+
+      qCDebug(lcDatabase) << Q_FUNC_INFO << "Reading junction table rows from database query " << queryString;
+
+      rows.clear();
+      while (sqlQuery.next()) {
+         rows.append(QVector<QVariant>{sqlQuery.value(0), sqlQuery.value(1)});
+      }
+      return true;
+   }
+
+   //
+   // The most values we bind in one query.  Older versions of SQLite (before 3.32) have a default limit of 999 "host
+   // parameters" per statement.  PostgreSQL allows 65535, but there's little to gain from going higher.
+   //
+   int const maxBindValuesPerQuery = 999;
+
+   /**
+    * \brief Insert rows into a table using as few multi-row INSERT statements as the bind value limit allows, ie:
+    *           INSERT INTO table (columnA, columnB, ..., columnN)
+    *                VALUES       (?, ?, ..., ?),
+    *                             (?, ?, ..., ?),
+    *                             ...;
+    *        This is much faster than one statement per row when writing out a whole DB, especially to PostgreSQL where
+    *        each statement is a round trip to the server.  (PostgreSQL's COPY would be faster still, but Qt's PostgreSQL
+    *        driver does not support it.)
+    *
+    * \param connection
+    * \param tableName
+    * \param columnNames
+    * \param rows Values in the same order as \c columnNames
+    *
+    * \return \c true if succeeded, \c false otherwise
+    */
+   bool insertRowsInBatches(QSqlDatabase & connection,
+                            BtStringConst const & tableName,
+                            QStringList const & columnNames,
+                            ObjectStoreSnapshot::Rows const & rows) {
+      int const numColumns = columnNames.size();
+      int const rowsPerBatch = std::max(1, maxBindValuesPerQuery / numColumns);
+
+      QStringList placeholders;
+      for (int ii = 0; ii < numColumns; ++ii) {
+         placeholders.append("?");
+      }
+      QString const rowPlaceholders = QString{"(%1)"}.arg(placeholders.join(", "));
+
+      //
+      // All batches except (usually) the last one are the same size, so we only need to re-prepare the query for the
+      // last one
+      //
+      BtSqlQuery sqlQuery{connection};
+      QString queryString;
+      int preparedBatchSize = 0;
+      for (int firstRow = 0; firstRow < rows.size(); firstRow += rowsPerBatch) {
+         int const batchSize = std::min(rowsPerBatch, rows.size() - firstRow);
+         if (batchSize != preparedBatchSize) {
+            QStringList allRowPlaceholders;
+            for (int ii = 0; ii < batchSize; ++ii) {
+               allRowPlaceholders.append(rowPlaceholders);
+            }
+            queryString = QString{"INSERT INTO %1 (%2) VALUES %3;"}.arg(*tableName,
+                                                                        columnNames.join(", "),
+                                                                        allRowPlaceholders.join(", "));
+            sqlQuery.prepare(queryString);
+            preparedBatchSize = batchSize;
+         }
+
+         for (int rowIndex = firstRow; rowIndex < firstRow + batchSize; ++rowIndex) {
+            for (auto const & value : rows[rowIndex]) {
+               sqlQuery.addBindValue(value);
+            }
+         }
+
+         if (!sqlQuery.exec()) {
+            qCritical() <<
+               Q_FUNC_INFO << "Error inserting" << batchSize << "rows into" << tableName << ":" <<
+               sqlQuery.lastError().text();
+            return false;
+         }
+      }
+
+      qCDebug(lcDatabase) << Q_FUNC_INFO << "Inserted" << rows.size() << "rows into" << tableName;
+      return true;
+   }
+
 }
 
 // This private implementation class holds all private non-virtual members of ObjectStore
@@ -498,10 +725,19 @@ public:
     * Constructor
     */
    impl(TableDefinition const &           primaryTable,
-        JunctionTableDefinitions const & junctionTables) : primaryTable{primaryTable},
-                                                           junctionTables{junctionTables},
-                                                           allObjects{},
-                                                           database{nullptr} {
+        JunctionTableDefinitions const & junctionTables,
+        UseOfPropertyNames const &       useOfPropertyNames) : primaryTable{primaryTable},
+                                                               junctionTables{junctionTables},
+                                                               useOfPropertyNames{useOfPropertyNames},
+                                                               parentSharingInitialised{false},
+                                                               parentJunctionTable{nullptr},
+                                                               sharedFieldIndexes{},
+                                                               allObjects{},
+                                                               database{nullptr},
+                                                               childIdsByParentId{},
+                                                               parentIdByChildId{},
+                                                               dirtyProperties{},
+                                                               dirtyWriteScheduled{false} {
       return;
    }
 
@@ -538,9 +774,72 @@ public:
             queryStringAsStream << fieldDefn.columnName;
          }
       }
+      if (this->hasParentSharing()) {
+         queryStringAsStream << ", " << (prependColons ? ":" : "") << inheritedFieldsColumn;
+      }
       return;
    }
 
+   /**
+    * \brief Get, in order, the names of all the columns in the primary table, ie those of
+    *        this->primaryTable.tableFields followed, if our objects can have parents, by \c inheritedFieldsColumn
+    */
+   QStringList getPrimaryTableColumnNames() {
+      QStringList columnNames;
+      for (auto const & fieldDefn: this->primaryTable.tableFields) {
+         columnNames.append(*fieldDefn.columnName);
+      }
+      if (this->hasParentSharing()) {
+         columnNames.append(inheritedFieldsColumn);
+      }
+      return columnNames;
+   }
+
+   /**
+    * \brief Read the raw rows from the primary table, with columns in the order of \c getPrimaryTableColumnNames()
+    *
+    * \return \c true if succeeded, \c false otherwise
+    */
+   bool readPrimaryTableRows(QSqlDatabase & connection, ObjectStoreSnapshot::Rows & rows) {
+      //
+      // Using QSqlTableModel would save us having to write a SELECT statement, however it is a bit hard to use it to
+      // reliably get the number of rows in a table.  Eg, QSqlTableModel::rowCount() is not implemented for all
+      // databases, and there is no documented way to detect the index supplied to QSqlTableModel::record(int row) is
+      // valid.  (In testing with SQLite, the returned QSqlRecord object for an index one beyond the end of he table
+      // still gave a false return to QSqlRecord::isEmpty() but then returned invalid record values.)
+      //
+      // So, instead, we create the appropriate SELECT query from scratch.  We specify the column names rather than
+      // just do SELECT * because it's small extra effort and will give us an early error if an invalid column is
+      // specified.
+      //
+      QString queryString{"SELECT "};
+      QTextStream queryStringAsStream{&queryString};
+      this->appendColumNames(queryStringAsStream, true, false);
+      queryStringAsStream << "\n FROM " << this->primaryTable.tableName << ";";
+      BtSqlQuery sqlQuery{connection};
+      sqlQuery.prepare(queryString);
+      if (!sqlQuery.exec()) {
+         qCritical() <<
+            Q_FUNC_INFO << "Error executing database query " << queryString << ": " << sqlQuery.lastError().text();
+         return false;
+      }
+
+      qCDebug(lcDatabase) <<
+         Q_FUNC_INFO << "Reading main table rows from" << this->primaryTable.tableName <<
+         "database table using query " << queryString;
+
+      rows.clear();
+      int const numColumns = this->getPrimaryTableColumnNames().size();
+      while (sqlQuery.next()) {
+         QVector<QVariant> row(numColumns);
+         for (int columnIndex = 0; columnIndex < numColumns; ++columnIndex) {
+            row[columnIndex] = sqlQuery.value(columnIndex);
+         }
+         rows.append(row);
+      }
+      return true;
+   }
+
    /**
     * \brief Get the name of the DB column that holds the primary key
     */
@@ -565,31 +864,473 @@ public:
    }
 
    /**
-    * \brief Update the specified property on an object
-    *
-    *        NB: Caller is responsible for handling transactions
-    *
-    * \return \c true if succeeded, \c false otherwise
+    * \brief Work out, the first time we need to know, whether our objects can have parents and, if so, which fields a
+    *        child shares with its parent.  (We can't do this in the constructor, because object stores are constructed
+    *        during static initialisation, when the property name constants in other files might not yet be.)
     */
-   bool updatePropertyInDb(QSqlDatabase & connection, QObject const & object, BtStringConst const & propertyName) {
-      // We'll need some of this info even if it's a junction table property we're updating
-      BtStringConst const & primaryKeyColumn {this->getPrimaryKeyColumn()};
-      QVariant const        primaryKey       {this->getPrimaryKey(object)};
+   void initParentSharing() {
+      if (this->parentSharingInitialised) {
+         return;
+      }
+      this->parentSharingInitialised = true;
 
-      //
-      // First check whether this is a simple property.  (If not we look for it in the ones we store in junction tables.)
-      //
-      auto matchingFieldDefn = std::find_if(
-         this->primaryTable.tableFields.begin(),
-         this->primaryTable.tableFields.end(),
+      // The parent is stored in a junction table whose "other" column refers back to our own primary table
+      for (auto const & junctionTable : this->junctionTables) {
+         if (junctionTable.assumedNumEntries == ObjectStore::MAX_ONE_ENTRY &&
+             junctionTable.tableFields.size() > 2 &&
+             junctionTable.tableFields[2].foreignKeyTo == &this->primaryTable) {
+            this->parentJunctionTable = &junctionTable;
+            break;
+         }
+      }
+      if (!this->parentJunctionTable) {
+         return;
+      }
+
+      // By convention the first field is the primary key
+      for (int ii = 1; ii < this->primaryTable.tableFields.size(); ++ii) {
+         auto const & fieldDefn = this->primaryTable.tableFields[ii];
+         if (fieldDefn.foreignKeyTo ||
+             fieldDefn.propertyName == PropertyNames::NamedEntity::display ||
+             fieldDefn.propertyName == PropertyNames::NamedEntity::deleted ||
+             fieldDefn.propertyName == PropertyNames::NamedEntity::folder) {
+            continue;
+         }
+         if (std::any_of(this->useOfPropertyNames.cbegin(),
+                         this->useOfPropertyNames.cend(),
+                         [&fieldDefn](BtStringConst const * propertyName) {
+                            return fieldDefn.propertyName == *propertyName;
+                         })) {
+            continue;
+         }
+         this->sharedFieldIndexes.append(ii);
+      }
+      qCDebug(lcDatabase) <<
+         Q_FUNC_INFO << "Children in" << this->primaryTable.tableName << "share" << this->sharedFieldIndexes.size() <<
+         "of" << this->primaryTable.tableFields.size() << "fields with their parents";
+      return;
+   }
+
+   /**
+    * \brief Returns the parent of an object, or \c nullptr if it doesn't have one (or it's not in our cache)
+    */
+   QObject const * getParent(QObject const & object) {
+      this->initParentSharing();
+      if (!this->parentJunctionTable) {
+         return nullptr;
+      }
+      BtStringConst const & parentKeyProperty = GetJunctionTableDefinitionPropertyName(*this->parentJunctionTable);
+      int const parentKey = object.property(*parentKeyProperty).toInt();
+      if (parentKey <= 0 || parentKey == this->getPrimaryKey(object).toInt()) {
+         return nullptr;
+      }
+      return this->allObjects.value(parentKey).get();
+   }
+
+   /**
+    * \brief Returns the objects whose parent is the supplied one
+    */
+   QList<QObject const *> getChildren(QObject const & object) {
+      QList<QObject const *> children;
+      for (int const childId : this->childIdsByParentId.value(this->getPrimaryKey(object).toInt())) {
+         QObject const * child = this->allObjects.value(childId).get();
+         if (child) {
+            children.append(child);
+         }
+      }
+      return children;
+   }
+
+   /**
+    * \brief Record, in this->childIdsByParentId, the current parent of an object, forgetting any previous one.  Needs
+    *        to be called whenever a stored object's parent key is set.
+    */
+   void indexParent(QObject const & object) {
+      this->initParentSharing();
+      int const childId = this->getPrimaryKey(object).toInt();
+      if (!this->parentJunctionTable || childId <= 0) {
+         return;
+      }
+      this->unindexParent(childId);
+      BtStringConst const & parentKeyProperty = GetJunctionTableDefinitionPropertyName(*this->parentJunctionTable);
+      int const parentId = object.property(*parentKeyProperty).toInt();
+      if (parentId > 0 && parentId != childId) {
+         this->parentIdByChildId.insert(childId, parentId);
+         this->childIdsByParentId[parentId].insert(childId);
+      }
+      return;
+   }
+
+   /**
+    * \brief Remove an object, as a child, from this->childIdsByParentId
+    */
+   void unindexParent(int childId) {
+      auto parentId = this->parentIdByChildId.find(childId);
+      if (parentId == this->parentIdByChildId.end()) {
+         return;
+      }
+      auto siblingIds = this->childIdsByParentId.find(*parentId);
+      if (siblingIds != this->childIdsByParentId.end()) {
+         siblingIds->remove(childId);
+         if (siblingIds->isEmpty()) {
+            this->childIdsByParentId.erase(siblingIds);
+         }
+      }
+      this->parentIdByChildId.erase(parentId);
+      return;
+   }
+
+   /**
+    * \brief Whether our objects can have parents, and therefore whether the primary table has an
+    *        \c inheritedFieldsColumn
+    */
+   bool hasParentSharing() {
+      this->initParentSharing();
+      return this->parentJunctionTable != nullptr;
+   }
+
+   /**
+    * \brief If our objects can have parents, add the \c inheritedFieldsColumn to the primary table.  (It doesn't hold
+    *        a property, so it's not in this->primaryTable.tableFields.)
+    *
+    * \return \c true if succeeded, \c false otherwise
+    */
+   bool addInheritedFieldsColumn(Database & database, QSqlDatabase & connection) {
+      if (!this->hasParentSharing()) {
+         return true;
+      }
+      QString const queryString = QString{"ALTER TABLE %1 ADD COLUMN %2 %3 DEFAULT ''"}.arg(
+         *this->primaryTable.tableName,
+         inheritedFieldsColumn,
+         database.getDbNativeTypeName<QString>()
+      );
+      BtSqlQuery sqlQuery{connection};
+      if (!sqlQuery.exec(queryString)) {
+         qCritical() <<
+            Q_FUNC_INFO << "Error executing database query " << queryString << ": " << sqlQuery.lastError().text();
+         return false;
+      }
+      return true;
+   }
+
+   /**
+    * \brief Whether the child's row stores, in place of the value of a field, a placeholder, with the value to be read
+    *        from the parent's row -- ie the field is one that children share with their parents, the object has a
+    *        parent, and the two values are the same.
+    *
+    * \param object
+    * \param fieldIndex Index into this->primaryTable.tableFields
+    */
+   bool isInheritedFromParent(QObject const & object, int fieldIndex) {
+      QObject const * parent = this->getParent(object);
+      if (!parent || !this->sharedFieldIndexes.contains(fieldIndex)) {
+         return false;
+      }
+      BtStringConst const & propertyName = this->primaryTable.tableFields[fieldIndex].propertyName;
+      return parent->property(*propertyName) == object.property(*propertyName);
+   }
+
+   /**
+    * \brief Get the value to write to the DB for one field of an object, ie the property value (converted to a string
+    *        in the case of an enum) -- unless the child reads the field from its parent (see
+    *        \c isInheritedFromParent()), in which case we write a placeholder.
+    *
+    * \param object
+    * \param fieldIndex Index into this->primaryTable.tableFields
+    * \param shareWithParent Set to \c false to write the value regardless, eg because the parent is being deleted
+    */
+   QVariant getBindValue(QObject const & object, int fieldIndex, bool shareWithParent = true) {
+      auto const & fieldDefn = this->primaryTable.tableFields[fieldIndex];
+      if (shareWithParent && this->isInheritedFromParent(object, fieldIndex)) {
+         return getInheritedFieldPlaceholder(fieldDefn.fieldType);
+      }
+      QVariant bindValue{object.property(*fieldDefn.propertyName)};
+      // Enums need to be converted to strings first
+      if (fieldDefn.fieldType == ObjectStore::Enum) {
+         bindValue = QVariant{enumToString(fieldDefn, bindValue)};
+      }
+      return bindValue;
+   }
+
+   /**
+    * \brief Get the value to write to the \c inheritedFieldsColumn of an object, ie the columns for which
+    *        \c getBindValue() writes a placeholder.  Whenever we write this, we must also write all the fields that
+    *        children share with their parents, so that the placeholders and the list of them are always in step.
+    *
+    * \param object
+    * \param shareWithParent As for \c getBindValue()
+    */
+   QString getInheritedFieldsBindValue(QObject const & object, bool shareWithParent = true) {
+      // NB: An empty string, not a null one, which would be stored as NULL
+      QString inheritedFields{""};
+      if (shareWithParent) {
+         for (int fieldIndex : this->sharedFieldIndexes) {
+            if (this->isInheritedFromParent(object, fieldIndex)) {
+               if (!inheritedFields.isEmpty()) {
+                  inheritedFields += ',';
+               }
+               inheritedFields += *this->primaryTable.tableFields[fieldIndex].columnName;
+            }
+         }
+      }
+      return inheritedFields;
+   }
+
+   /**
+    * \brief Make the write that updates, for some objects, all the fields that children share with their parents,
+    *        along with the \c inheritedFieldsColumn.  We need this because what is stored for a child depends on its
+    *        parent (see \c getBindValue()), so, eg, when some fields of a parent change, its children need rewriting.
+    *
+    * \param objects
+    * \param shareWithParent As for \c getBindValue()
+    *
+    * \return The write, or an empty \c Database::WriteCommand if there is nothing to write
+    */
+   Database::WriteCommand makeUpdateSharedFieldsCommand(QList<QObject const *> const & objects,
+                                                        bool shareWithParent) {
+      if (objects.isEmpty() || !this->hasParentSharing()) {
+         return nullptr;
+      }
+
+      //
+      // As in ObjectStore::update(), the SQL will be of the form
+      //
+      //    UPDATE tablename
+      //    SET firstColumn = :firstColumn, secondColumn = :secondColumn, ..., inherited_fields = :inherited_fields
+      //    WHERE primaryKeyColumn = :primaryKeyColumn;
+      //
+      // but here we run it once for each object.
+      //
+      BtStringConst const & primaryKeyColumn{this->getPrimaryKeyColumn()};
+      QString queryString{"UPDATE "};
+      QTextStream queryStringAsStream{&queryString};
+      queryStringAsStream << this->primaryTable.tableName << " SET ";
+      QStringList bindNames;
+      for (int fieldIndex : this->sharedFieldIndexes) {
+         BtStringConst const & columnName = this->primaryTable.tableFields[fieldIndex].columnName;
+         queryStringAsStream << columnName << " = :" << columnName << ", ";
+         bindNames.append(QString{":"} + *columnName);
+      }
+      queryStringAsStream << inheritedFieldsColumn << " = :" << inheritedFieldsColumn;
+      bindNames.append(QString{":"} + inheritedFieldsColumn);
+      queryStringAsStream << " WHERE " << primaryKeyColumn << " = :" << primaryKeyColumn << ";";
+      QString const primaryKeyBindName{QString{":"} + *primaryKeyColumn};
+
+      QVector<QPair<QVariant, QVector<QVariant> > > rows;
+      for (QObject const * object : objects) {
+         QVector<QVariant> bindValues;
+         for (int fieldIndex : this->sharedFieldIndexes) {
+            bindValues.append(this->getBindValue(*object, fieldIndex, shareWithParent));
+         }
+         bindValues.append(QVariant{this->getInheritedFieldsBindValue(*object, shareWithParent)});
+         rows.append(qMakePair(this->getPrimaryKey(*object), bindValues));
+      }
+
+      return [queryString, bindNames, primaryKeyBindName, rows](QSqlDatabase & connection) {
+         BtSqlQuery sqlQuery{connection};
+         sqlQuery.prepare(queryString);
+         for (auto const & row : rows) {
+            for (int ii = 0; ii < bindNames.size(); ++ii) {
+               sqlQuery.bindValue(bindNames[ii], row.second[ii]);
+            }
+            sqlQuery.bindValue(primaryKeyBindName, row.first);
+            if (!sqlQuery.exec()) {
+               qCritical() <<
+                  Q_FUNC_INFO << "Error executing database query " << queryString << ": " <<
+                  sqlQuery.lastError().text();
+               return false;
+            }
+         }
+         return true;
+      };
+   }
+
+   /**
+    * \brief Make the write that removes, from the parent junction table, the rows linking children to a parent that is
+    *        about to be deleted.  (Otherwise, the foreign key from the junction table would stop us deleting it.)
+    *
+    * \return The write, or an empty \c Database::WriteCommand if our objects can't have parents
+    */
+   Database::WriteCommand makeDetachChildrenCommand(QVariant const & parentKey) {
+      if (!this->hasParentSharing()) {
+         return nullptr;
+      }
+
+      //
+      // The SQL will be of the form
+      //
+      //    DELETE FROM parentJunctionTable
+      //    WHERE parentColumn = :parentColumn AND childColumn <> parentColumn;
+      //
+      // (A parent can be listed as its own parent, and that row is removed along with the parent itself.)
+      //
+      BtStringConst const & childColumn = GetJunctionTableDefinitionThisPrimaryKeyColumn(*this->parentJunctionTable);
+      BtStringConst const & parentColumn = GetJunctionTableDefinitionOtherPrimaryKeyColumn(*this->parentJunctionTable);
+      QString queryString{"DELETE FROM "};
+      QTextStream queryStringAsStream{&queryString};
+      queryStringAsStream <<
+         this->parentJunctionTable->tableName << " WHERE " << parentColumn << " = :" << parentColumn << " AND " <<
+         childColumn << " <> " << parentColumn << ";";
+      QString const parentBindName{QString{":"} + *parentColumn};
+
+      return [queryString, parentBindName, parentKey](QSqlDatabase & connection) {
+         BtSqlQuery sqlQuery{connection};
+         sqlQuery.prepare(queryString);
+         sqlQuery.bindValue(parentBindName, parentKey);
+         if (!sqlQuery.exec()) {
+            qCritical() <<
+               Q_FUNC_INFO << "Error executing database query " << queryString << ": " << sqlQuery.lastError().text();
+            return false;
+         }
+         return true;
+      };
+   }
+
+   /**
+    * \brief Make the write of the rewrites that writing some properties of an object makes necessary, ie (a) if the
+    *        object's parent changed, its own shared fields and (b) if any of those fields changed, the shared fields of
+    *        the object's children.  Callers combine this with the write of the properties themselves (see
+    *        \c combineWrites()), so that the DB never has one without the other.
+    *
+    * \return The write, or an empty \c Database::WriteCommand if there is nothing more to write
+    */
+   Database::WriteCommand makeSharedFieldsCommand(QObject const & object, QSet<QString> const & writtenProperties) {
+      if (!this->hasParentSharing()) {
+         return nullptr;
+      }
+
+      Database::WriteCommand command;
+      if (writtenProperties.contains(*GetJunctionTableDefinitionPropertyName(*this->parentJunctionTable))) {
+         command = this->makeUpdateSharedFieldsCommand({&object}, true);
+      }
+
+      if (std::none_of(this->sharedFieldIndexes.cbegin(),
+                       this->sharedFieldIndexes.cend(),
+                       [this, &writtenProperties](int fieldIndex) {
+                          return writtenProperties.contains(*this->primaryTable.tableFields[fieldIndex].propertyName);
+                       })) {
+         // Saves us looking for children
+         return command;
+      }
+      QList<QObject const *> const children = this->getChildren(object);
+      if (!children.isEmpty()) {
+         qCDebug(lcDatabase) <<
+            Q_FUNC_INFO << "Rewriting shared fields of" << children.size() << "children of" <<
+            object.metaObject()->className() << "#" << this->getPrimaryKey(object).toInt();
+         command = combineWrites(std::move(command), this->makeUpdateSharedFieldsCommand(children, true));
+      }
+      return command;
+   }
+
+   /**
+    * \brief Fill in, from their parents' rows, the fields that children read from their parents (see
+    *        \c getBindValue()).  Where a child's value is the same as its parent's anyway, we also make the child's row
+    *        hold the parent's copy of it, so that, eg, the objects for a Hop and all its children end up sharing the
+    *        same (implicitly-shared) string data for name, notes, etc.
+    *
+    * \param rows Primary table rows, with columns in the order of \c getPrimaryTableColumnNames()
+    * \param parentJunctionTableRows Rows of (child ID, parent ID)
+    */
+   void fillInSharedFields(ObjectStoreSnapshot::Rows & rows,
+                           ObjectStoreSnapshot::Rows const & parentJunctionTableRows) {
+      // The inheritedFieldsColumn comes after all the ones for properties
+      int const inheritedFieldsIndex = this->primaryTable.tableFields.size();
+
+      QHash<int, int> rowIndexById;
+      for (int ii = 0; ii < rows.size(); ++ii) {
+         // By convention the first field is the primary key
+         rowIndexById.insert(rows.at(ii).value(0).toInt(), ii);
+      }
+      QHash<int, int> parentRowIndexByRowIndex;
+      for (auto const & junctionTableRow : parentJunctionTableRows) {
+         int const childRowIndex  = rowIndexById.value(junctionTableRow.value(0).toInt(), -1);
+         int const parentRowIndex = rowIndexById.value(junctionTableRow.value(1).toInt(), -1);
+         if (childRowIndex < 0 || childRowIndex == parentRowIndex) {
+            continue;
+         }
+         if (parentRowIndex < 0) {
+            if (!rows.at(childRowIndex).value(inheritedFieldsIndex).toString().isEmpty()) {
+               qWarning() <<
+                  Q_FUNC_INFO << "Parent #" << junctionTableRow.value(1).toInt() << "of" <<
+                  this->primaryTable.tableName << "#" << junctionTableRow.value(0).toInt() << "not found, so the" <<
+                  "fields it reads from its parent will have placeholder values";
+            }
+            continue;
+         }
+         parentRowIndexByRowIndex.insert(childRowIndex, parentRowIndex);
+      }
+
+      //
+      // Parents are not normally children themselves, but, in case one is, we have to fill in its row before those of
+      // its children.  (We also guard against loops, which would only happen with bad data.)
+      //
+      QSet<int> filledIn;
+      for (auto ii = parentRowIndexByRowIndex.cbegin(); ii != parentRowIndexByRowIndex.cend(); ++ii) {
+         QVector<int> rowIndexesToFillIn;
+         int rowIndex = ii.key();
+         while (parentRowIndexByRowIndex.contains(rowIndex) &&
+                !filledIn.contains(rowIndex) &&
+                !rowIndexesToFillIn.contains(rowIndex)) {
+            rowIndexesToFillIn.append(rowIndex);
+            rowIndex = parentRowIndexByRowIndex.value(rowIndex);
+         }
+         for (auto childRowIndex = rowIndexesToFillIn.crbegin();
+              childRowIndex != rowIndexesToFillIn.crend();
+              ++childRowIndex) {
+            QVector<QVariant> & childRow = rows[*childRowIndex];
+            QVector<QVariant> const & parentRow = rows.at(parentRowIndexByRowIndex.value(*childRowIndex));
+#if QT_VERSION < QT_VERSION_CHECK(5,15,0)
+            QStringList const inheritedColumns =
+               childRow.value(inheritedFieldsIndex).toString().split(",", QString::SkipEmptyParts);
+#else
+            QStringList const inheritedColumns =
+               childRow.value(inheritedFieldsIndex).toString().split(",", Qt::SkipEmptyParts);
+#endif
+            for (int fieldIndex : this->sharedFieldIndexes) {
+               if (inheritedColumns.contains(*this->primaryTable.tableFields[fieldIndex].columnName) ||
+                   childRow.at(fieldIndex) == parentRow.at(fieldIndex)) {
+                  childRow[fieldIndex] = parentRow.at(fieldIndex);
+               }
+            }
+            filledIn.insert(*childRowIndex);
+         }
+      }
+      return;
+   }
+
+   /**
+    * \brief Make the write that updates the specified property of an object in the database.  The property value is
+    *        read now (ie on the GUI thread), so that the write does not need to touch the object.
+    *
+    * \return The write, or an empty \c Database::WriteCommand if there was an error
+    */
+   Database::WriteCommand makeUpdatePropertyCommand(QObject const & object, BtStringConst const & propertyName) {
+      // We'll need some of this info even if it's a junction table property we're updating
+      BtStringConst const & primaryKeyColumn {this->getPrimaryKeyColumn()};
+      QVariant const        primaryKey       {this->getPrimaryKey(object)};
+
+      //
+      // First check whether this is a simple property.  (If not we look for it in the ones we store in junction tables.)
+      //
+      auto matchingFieldDefn = std::find_if(
+         this->primaryTable.tableFields.begin(),
+         this->primaryTable.tableFields.end(),
          [propertyName](TableField const & fd) {return fd.propertyName == propertyName;}
       );
 
       if (matchingFieldDefn != this->primaryTable.tableFields.end()) {
          //
-         // We're updating a simple property
+         // We're updating a simple property.  If it's one that children can read from their parents, we rewrite all
+         // of those together with the list of which ones the object reads from its parent, so that they stay in step.
          //
-         // Construct the SQL, which will be of the form
+         int const fieldIndex =
+            static_cast<int>(std::distance(this->primaryTable.tableFields.begin(), matchingFieldDefn));
+         if (this->hasParentSharing() && this->sharedFieldIndexes.contains(fieldIndex)) {
+            return this->makeUpdateSharedFieldsCommand({&object}, true);
+         }
+
+         //
+         // Otherwise, construct the SQL, which will be of the form
          //
          //    UPDATE tablename
          //    SET columnName = :columnName
@@ -604,97 +1345,127 @@ public:
          queryStringAsStream << " " << columnToUpdateInDb << " = :" << columnToUpdateInDb;
          queryStringAsStream << " WHERE " << primaryKeyColumn << " = :" << primaryKeyColumn << ";";
 
-         qDebug() <<
+         qCDebug(lcDatabase) <<
             Q_FUNC_INFO << "Updating" << object.metaObject()->className() << "property" << propertyName <<
             "with database query" << queryString;
 
          //
-         // Bind the values
+         // Get the value to bind
          //
-         BtSqlQuery sqlQuery{connection};
-         sqlQuery.prepare(queryString);
-         QVariant propertyBindValue{object.property(*propertyName)};
-         // Enums need to be converted to strings first
-         auto fieldDefn = std::find_if(
-            this->primaryTable.tableFields.begin(),
-            this->primaryTable.tableFields.end(),
-            [propertyName](TableField const & fd){return propertyName == fd.propertyName;}
-         );
-         // It's a coding error if we're trying to update a property that's not in the field definitions
-         Q_ASSERT(fieldDefn != this->primaryTable.tableFields.end());
-         if (fieldDefn->fieldType == ObjectStore::Enum) {
-            propertyBindValue = QVariant{enumToString(*fieldDefn, propertyBindValue)};
-         }
-         sqlQuery.bindValue(QString{":%1"}.arg(*columnToUpdateInDb), propertyBindValue);
-         sqlQuery.bindValue(QString{":%1"}.arg(*primaryKeyColumn), primaryKey);
-         qDebug().noquote() << Q_FUNC_INFO << "Bind values:" << BoundValuesToString(sqlQuery);
+         QVariant const propertyBindValue{this->getBindValue(object, fieldIndex)};
+         QString const propertyBindName{QString{":%1"}.arg(*columnToUpdateInDb)};
+         QString const primaryKeyBindName{QString{":%1"}.arg(*primaryKeyColumn)};
+
+         return [queryString, propertyBindName, propertyBindValue, primaryKeyBindName, primaryKey](
+            QSqlDatabase & connection
+         ) {
+            BtSqlQuery sqlQuery{connection};
+            sqlQuery.prepare(queryString);
+            sqlQuery.bindValue(propertyBindName, propertyBindValue);
+            sqlQuery.bindValue(primaryKeyBindName, primaryKey);
+            qCDebug(lcDatabase).noquote() << Q_FUNC_INFO << "Bind values:" << BoundValuesToString(sqlQuery);
 
-         //
-         // Run the query
-         //
-         if (!sqlQuery.exec()) {
-            qCritical() <<
-               Q_FUNC_INFO << "Error executing database query " << queryString << ": " << sqlQuery.lastError().text();
-            return false;
-         }
-      } else {
-         //
-         // The property we've been given isn't a simple property, so look for it in the ones we store in junction tables
-         //
-         auto matchingJunctionTableDefinitionDefn = std::find_if(
-            this->junctionTables.begin(),
-            this->junctionTables.end(),
-            [propertyName](JunctionTableDefinition const & jt) {
-               return GetJunctionTableDefinitionPropertyName(jt) == propertyName;
+            //
+            // Run the query
+            //
+            if (!sqlQuery.exec()) {
+               qCritical() <<
+                  Q_FUNC_INFO << "Error executing database query " << queryString << ": " <<
+                  sqlQuery.lastError().text();
+               return false;
             }
-         );
+            return true;
+         };
+      }
 
-         // It's a coding error if we couldn't find the property either as a simple field or an associative entity
-         if (matchingJunctionTableDefinitionDefn == this->junctionTables.end()) {
-            qCritical() <<
-               Q_FUNC_INFO << "Unable to find rule for storing property" << object.metaObject()->className() << "::" <<
-               propertyName << "in either" << this->primaryTable.tableName << "or any associated table";
-            Q_ASSERT(false);
+      //
+      // The property we've been given isn't a simple property, so look for it in the ones we store in junction tables
+      //
+      auto matchingJunctionTableDefinitionDefn = std::find_if(
+         this->junctionTables.begin(),
+         this->junctionTables.end(),
+         [propertyName](JunctionTableDefinition const & jt) {
+            return GetJunctionTableDefinitionPropertyName(jt) == propertyName;
          }
+      );
 
-         //
-         // As elsewhere, the simplest way to update a junction table is to blat any rows relating to the current object and then
-         // write out data based on the current property values.
-         //
-         qDebug() <<
-            Q_FUNC_INFO << "Updating" << object.metaObject()->className() << "property" << propertyName <<
-            "in junction table" << matchingJunctionTableDefinitionDefn->tableName;
-         if (!deleteFromJunctionTableDefinition(*matchingJunctionTableDefinitionDefn, primaryKey, connection)) {
-            return false;
-         }
-         if (!insertIntoJunctionTableDefinition(*matchingJunctionTableDefinitionDefn, object, primaryKey, connection)) {
-            return false;
-         }
+      // It's a coding error if we couldn't find the property either as a simple field or an associative entity
+      if (matchingJunctionTableDefinitionDefn == this->junctionTables.end()) {
+         qCritical() <<
+            Q_FUNC_INFO << "Unable to find rule for storing property" << object.metaObject()->className() << "::" <<
+            propertyName << "in either" << this->primaryTable.tableName << "or any associated table";
+         Q_ASSERT(false);
+         return nullptr;
       }
 
-      // If we made it this far then everything worked
-      return true;
+      qCDebug(lcDatabase) <<
+         Q_FUNC_INFO << "Updating" << object.metaObject()->className() << "property" << propertyName <<
+         "in junction table" << matchingJunctionTableDefinitionDefn->tableName;
+      JunctionTableValues junctionTableValues{&*matchingJunctionTableDefinitionDefn, {}};
+      if (!getJunctionTablePropertyValues(*matchingJunctionTableDefinitionDefn,
+                                          object,
+                                          primaryKey.toInt(),
+                                          junctionTableValues.values)) {
+         return nullptr;
+      }
+      return [junctionTableValues, primaryKey](QSqlDatabase & connection) {
+         return rewriteJunctionTable(junctionTableValues, primaryKey, connection);
+      };
    }
 
    /**
-    * \brief Insert an object in the database
+    * \brief Get the values to write to the primary table for an object, in the order of
+    *        \c getPrimaryTableColumnNames()
     *
-    *        NB: Caller is responsible for handling transactions
+    * \param object
+    * \param includePrimaryKey If \c false, the primary key (which, by convention, is the first field) is omitted
+    */
+   QVector<QVariant> getInsertBindValues(QObject const & object, bool includePrimaryKey) {
+      QVector<QVariant> bindValues;
+      for (int ii = (includePrimaryKey ? 0 : 1); ii < this->primaryTable.tableFields.size(); ++ii) {
+         auto const & fieldDefn = this->primaryTable.tableFields[ii];
+
+         QVariant bindValue{this->getBindValue(object, ii)};
+         if (fieldDefn.foreignKeyTo && bindValue.toInt() <= 0) {
+            // If the field is a foreign key and the value we would otherwise put in it is not a valid key (eg we are
+            // inserting a Recipe on which the Equipment has not yet been set) then the query would barf at the invalid
+            // key.  So, in this case, we need to insert NULL.
+            bindValue = QVariant();
+         }
+         bindValues.append(bindValue);
+      }
+      if (this->hasParentSharing()) {
+         bindValues.append(QVariant{this->getInheritedFieldsBindValue(object)});
+      }
+      return bindValues;
+   }
+
+   /**
+    * \brief Make the write that inserts a new object in the database.  As with \c makeUpdatePropertyCommand(), the
+    *        object's property values are read now.
     *
-    * \param connection
     * \param object
-    * \param writePrimaryKey Normally this is \c false, meaning we are going to let the DB assign a primary key to the
-    *                        new object we are inserting.  However, if we are writing existing objects out to a new
-    *                        database, then this will be \c true, meaning we write out the existing primary keys (to
-    *                        keep any foreign key references to them valid.  (In this latter circumstance, we are also
-    *                        assuming the caller has disabled foreign key constraints for the duration of the
-    *                        transaction.)
+    * \param primaryKeyInDb Where the write puts the primary key that the DB assigned to the new object, or -1 if there
+    *                       was an error.  Note that it is the \b caller's responsibility to update the object with its
+    *                       new primary key.
     *
-    * \return the primary key of the inserted object, or -1 if there was an error.  Note that, in the case that
-    *         \c writePrimaryKey is \c false (ie we are inserting a new object), it is the \b caller's responsibility to
-    *         update the object with its new primary key.
+    * \return The write, or an empty \c Database::WriteCommand if there was an error
     */
-   int insertObjectInDb(QSqlDatabase & connection, QObject const & object, bool writePrimaryKey) {
+   Database::WriteCommand makeInsertCommand(QObject const & object, std::shared_ptr<int> primaryKeyInDb) {
+      //
+      // Where we're inserting a new object, it should not already have a valid primary key.
+      //
+      // .:TBD:. Maybe if we're doing undelete, this is the place to handle that case.
+      //
+      int const currentPrimaryKey = this->getPrimaryKey(object).toInt();
+      if (currentPrimaryKey > 0) {
+         // This is almost certainly a coding error
+         qCritical() <<
+            Q_FUNC_INFO << "Inserting new" << object.metaObject()->className() << "in database but it already has " <<
+            "primary key" << currentPrimaryKey;
+         Q_ASSERT(false); // Stop here on debug build
+      }
+
       //
       // Construct the SQL, which will be of the form
       //
@@ -702,69 +1473,69 @@ public:
       //    VALUES (:firstColumn, :secondColumn, ...);
       //
       // We omit the primary key column because we can't know its value in advance.  We'll find out what value the DB
-      // assigned to it after the query was run -- see below.
+      // assigned to it after the query was run -- see below.  (When we are writing existing objects out to a new
+      // database, we _do_ write the primary keys, to keep any foreign key references to them valid, but that is done
+      // in bulk by ObjectStore::writeAllToNewDb().)
       //
       QString queryString{"INSERT INTO "};
       QTextStream queryStringAsStream{&queryString};
       queryStringAsStream << this->primaryTable.tableName << " (";
-      this->appendColumNames(queryStringAsStream, writePrimaryKey, false);
+      this->appendColumNames(queryStringAsStream, false, false);
       queryStringAsStream << ") VALUES (";
-      this->appendColumNames(queryStringAsStream, writePrimaryKey, true);
+      this->appendColumNames(queryStringAsStream, false, true);
       queryStringAsStream << ");";
 
-      qDebug() <<
-         Q_FUNC_INFO << "Inserting" << object.metaObject()->className() << "main table row with database query " <<
-         queryString;
+      QString const className{object.metaObject()->className()};
+      qCDebug(lcDatabase) <<
+         Q_FUNC_INFO << "Inserting" << className << "main table row with database query " << queryString;
 
       //
-      // Bind the values
+      // Get the values to bind, and the data for the junction tables
       //
-      BtSqlQuery sqlQuery{connection};
-      sqlQuery.prepare(queryString);
-      for (int ii = (writePrimaryKey ? 0 : 1); ii < this->primaryTable.tableFields.size(); ++ii) {
-         auto const & fieldDefn = this->primaryTable.tableFields[ii];
-
-         QVariant bindValue{object.property(*fieldDefn.propertyName)};
-         if (fieldDefn.fieldType == ObjectStore::Enum) {
-            // Enums need to be converted to strings first
-            bindValue = QVariant{enumToString(fieldDefn, bindValue)};
-         } else if (fieldDefn.foreignKeyTo && bindValue.toInt() <= 0) {
-            // If the field is a foreign key and the value we would otherwise put in it is not a valid key (eg we are
-            // inserting a Recipe on which the Equipment has not yet been set) then the query would barf at the invalid
-            // key.  So, in this case, we need to insert NULL.
-            bindValue = QVariant();
+      QVector<QVariant> const bindValues = this->getInsertBindValues(object, false);
+      QStringList bindNames;
+      for (int ii = 1; ii < this->primaryTable.tableFields.size(); ++ii) {
+         bindNames.append(QString{":"} + *this->primaryTable.tableFields[ii].columnName);
+      }
+      if (this->hasParentSharing()) {
+         bindNames.append(QString{":"} + inheritedFieldsColumn);
+      }
+      QVector<JunctionTableValues> allJunctionTableValues;
+      for (auto const & junctionTable : this->junctionTables) {
+         JunctionTableValues junctionTableValues{&junctionTable, {}};
+         if (!getJunctionTablePropertyValues(junctionTable, object, currentPrimaryKey, junctionTableValues.values)) {
+            return nullptr;
          }
-
-         sqlQuery.bindValue(QString{":"} + *fieldDefn.columnName, bindValue);
+         allJunctionTableValues.append(junctionTableValues);
       }
 
-      qDebug().noquote() << Q_FUNC_INFO << "Bind values:" << BoundValuesToString(sqlQuery);
+      return [queryString, className, bindNames, bindValues, allJunctionTableValues, primaryKeyInDb](
+         QSqlDatabase & connection
+      ) {
+         *primaryKeyInDb = -1;
 
-      //
-      // Run the query
-      //
-      if (!sqlQuery.exec()) {
-         qCritical() <<
-            Q_FUNC_INFO << "Error executing database query " << queryString << ": " << sqlQuery.lastError().text();
-         return -1;
-      }
+         BtSqlQuery sqlQuery{connection};
+         sqlQuery.prepare(queryString);
+         for (int ii = 0; ii < bindValues.size(); ++ii) {
+            sqlQuery.bindValue(bindNames[ii], bindValues[ii]);
+         }
+         qCDebug(lcDatabase).noquote() << Q_FUNC_INFO << "Bind values:" << BoundValuesToString(sqlQuery);
 
-      int currentPrimaryKey = object.property(*this->getPrimaryKeyProperty()).toInt();
-      int primaryKeyInDb;
-      if (writePrimaryKey) {
          //
-         // We already know the ID of the object we wrote to the database, so we don't need to ask the database what it
-         // was (and indeed attempts to do so may not work, per the comment below in the other branch of this if
-         // statement.
+         // Run the query
          //
-         primaryKeyInDb = currentPrimaryKey;
-      } else {
+         if (!sqlQuery.exec()) {
+            qCritical() <<
+               Q_FUNC_INFO << "Error executing database query " << queryString << ": " << sqlQuery.lastError().text();
+            return false;
+         }
+
          //
-         // If we didn't have an ID and asked the DB to generate one, we need to find out what it was.
+         // We asked the DB to generate an ID, so we need to find out what it was.
          //
          // Assert that we are only using database drivers that support returning the last insert ID.  (It is
-         // frustratingly hard to find documentation about this, as, eg, https://doc.qt.io/qt-5/sql-driver.html does not
-         // explicitly list which supplied drivers support which features.  However, in reality, we know SQLite and
+         // frustratingly hard to find documentation about this, as, eg, https://doc.qt.io/qt-5/sql-driver.html does
+         // not explicitly list which supplied drivers support which features.  However, in reality, we know SQLite and
          // PostgreSQL drivers both support this, so it would likely only be a problem if a new type of DB were
          // introduced.)
          //
@@ -773,60 +1544,74 @@ public:
          // reset after you've done one or more inserts with explicitly set IDs.  Asking for the last insert ID gets the
          // current state of the sequence and so only works when the sequence was used to generate the ID.)
          //
-         // Note too that we have to explicitly put the primary key into an int, because, by default it might come back
-         // as long long int rather than int (ie 64-bits rather than 32-bits in the C++ implementations we care about).
+         // Note too that we have to explicitly put the primary key into an int, because, by default it might come
+         // back as long long int rather than int (ie 64-bits rather than 32-bits in the C++ implementations we care
+         // about).
          //
          Q_ASSERT(sqlQuery.driver()->hasFeature(QSqlDriver::LastInsertId));
          QVariant rawPrimaryKey = sqlQuery.lastInsertId();
          Q_ASSERT(rawPrimaryKey.canConvert(QMetaType::Int));
-         primaryKeyInDb = rawPrimaryKey.toInt();
+         int const newPrimaryKey = rawPrimaryKey.toInt();
+
+         qCDebug(lcDatabase) <<
+            Q_FUNC_INFO << className << "#" << newPrimaryKey << "inserted in database using" << queryString;
 
          //
-         // Where we're not explicitly writing the primary key it's because the object we are inserting should not
-         // already have a valid primary key.
-         //
-         // Where we are writing the primary key, it shouldn't get changed by the write.
-         //
-         // .:TBD:. Maybe if we're doing undelete, this is the place to handle that case.
+         // Now save data to the junction tables
          //
-         if (currentPrimaryKey > 0) {
-            // This is almost certainly a coding error
-            qCritical() <<
-               Q_FUNC_INFO << "Wrote new" << object.metaObject()->className() << " to database (with primary key " <<
-               primaryKeyInDb << ") but it already had primary key" << currentPrimaryKey;
-            Q_ASSERT(false); // Stop here on debug build
-         }
-      }
-
-      qDebug() <<
-         Q_FUNC_INFO << object.metaObject()->className() << "#" << primaryKeyInDb << "inserted in database using" <<
-         queryString;
-
-      //
-      // Now save data to the junction tables
-      //
-      for (auto const & junctionTable : this->junctionTables) {
-         if (!insertIntoJunctionTableDefinition(junctionTable, object, primaryKeyInDb, connection)) {
-            qCritical() <<
-               Q_FUNC_INFO << "Error writing to junction tables:" << connection.lastError().text();
-            return -1;
+         for (auto const & junctionTableValues : allJunctionTableValues) {
+            if (!insertIntoJunctionTableDefinition(*junctionTableValues.junctionTable,
+                                                   junctionTableValues.values,
+                                                   QVariant{newPrimaryKey},
+                                                   connection)) {
+               qCritical() <<
+                  Q_FUNC_INFO << "Error writing to junction tables:" << connection.lastError().text();
+               return false;
+            }
          }
-      }
 
-      return primaryKeyInDb;
+         *primaryKeyInDb = newPrimaryKey;
+         return true;
+      };
    }
 
    TableDefinition const & primaryTable;
    JunctionTableDefinitions const & junctionTables;
+   UseOfPropertyNames const useOfPropertyNames;
+
+   // See initParentSharing()
+   bool parentSharingInitialised;
+   JunctionTableDefinition const * parentJunctionTable;
+   QVector<int> sharedFieldIndexes;
+
    QHash<int, std::shared_ptr<QObject> > allObjects;
    Database * database;
+
+   //
+   // For types whose objects can have parents, the primary keys of each parent's children (and, so we can keep that
+   // up-to-date when a child's parent changes, the primary key of each child's parent).  This saves looking through
+   // every object in the store, of which there can be a lot (eg one for each use of a Hop in every version of every
+   // Recipe), each time a parent changes.  See indexParent().
+   //
+   QHash<int, QSet<int> > childIdsByParentId;
+   QHash<int, int> parentIdByChildId;
+
+   //
+   // For each stored object (by primary key), the properties (primary table columns and junction table lists) that
+   // have been changed in memory but not yet written to the database.  Objects with nothing outstanding have no entry.
+   //
+   QHash<int, QSet<QString> > dirtyProperties;
+
+   // Whether there is already a call to writeDirtyProperties() waiting to run at the end of the current event loop turn
+   bool dirtyWriteScheduled;
 };
 
 
 ObjectStore::ObjectStore(TableDefinition const &           primaryTable,
-                         JunctionTableDefinitions const & junctionTables) :
-   pimpl{ std::make_unique<impl>(primaryTable, junctionTables) } {
-   qDebug() << Q_FUNC_INFO << "Construct of object store for primary table" << this->pimpl->primaryTable.tableName;
+                         JunctionTableDefinitions const & junctionTables,
+                         UseOfPropertyNames const &       useOfPropertyNames) :
+   pimpl{ std::make_unique<impl>(primaryTable, junctionTables, useOfPropertyNames) } {
+   qCDebug(lcDatabase) << Q_FUNC_INFO << "Construct of object store for primary table" << this->pimpl->primaryTable.tableName;
    return;
 }
 
@@ -836,7 +1621,7 @@ ObjectStore::ObjectStore(TableDefinition const &           primaryTable,
 ObjectStore::~ObjectStore() {
    // Normally we try to avoid logging things here, as it's possible that the objects used in Logging.cpp have already
    // been destroyed, but it can be useful to turn this on when debugging ObjectStore problems.
-   //qDebug() <<
+   //qCDebug(lcDatabase) <<
    //   Q_FUNC_INFO << "Destruct of object store for primary table" << this->pimpl->primaryTable.tableName <<
    //   "(containing" << this->pimpl->allObjects.size() << "objects)";
    return;
@@ -855,6 +1640,9 @@ bool ObjectStore::createTables(Database & database, QSqlDatabase & connection) c
    if (!createTableWithoutForeignKeys(database, connection, this->pimpl->primaryTable)) {
       return false;
    }
+   if (!this->pimpl->addInheritedFieldsColumn(database, connection)) {
+      return false;
+   }
 
    //
    // Now create the junction tables
@@ -887,6 +1675,8 @@ bool ObjectStore::addTableConstraints(Database & database, QSqlDatabase & connec
 }
 
 void ObjectStore::loadAll(Database * database) {
+   Tracing::Span const span{"ObjectStore::loadAll"};
+   auto const startTime = std::chrono::steady_clock::now();
    if (database) {
       this->pimpl->database = database;
    } else {
@@ -901,32 +1691,41 @@ void ObjectStore::loadAll(Database * database) {
    DbTransaction dbTransaction{*this->pimpl->database, connection};
 
    //
-   // Using QSqlTableModel would save us having to write a SELECT statement, however it is a bit hard to use it to
-   // reliably get the number of rows in a table.  Eg, QSqlTableModel::rowCount() is not implemented for all databases,
-   // and there is no documented way to detect the index supplied to QSqlTableModel::record(int row) is valid.  (In
-   // testing with SQLite, the returned QSqlRecord object for an index one beyond the end of he table still gave a
-   // false return to QSqlRecord::isEmpty() but then returned invalid record values.)
-   //
-   // So, instead, we create the appropriate SELECT query from scratch.  We specify the column names rather than just
-   // do SELECT * because it's small extra effort and will give us an early error if an invalid column is specified.
+   // If we closed down cleanly last time, we can usually skip the SQL and get the same rows out of the start-up
+   // snapshot (see comments in database/ObjectStoreSnapshot.h).
    //
-   QString queryString{"SELECT "};
-   QTextStream queryStringAsStream{&queryString};
-   this->pimpl->appendColumNames(queryStringAsStream, true, false);
-   queryStringAsStream << "\n FROM " << this->pimpl->primaryTable.tableName << ";";
-   BtSqlQuery sqlQuery{connection};
-   sqlQuery.prepare(queryString);
-   if (!sqlQuery.exec()) {
-      qCritical() <<
-         Q_FUNC_INFO << "Error executing database query " << queryString << ": " << sqlQuery.lastError().text();
+   ObjectStoreSnapshot::Rows primaryTableRows;
+   if (!ObjectStoreSnapshot::instance().readTable(this->pimpl->primaryTable.tableName,
+                                                  this->pimpl->getPrimaryTableColumnNames(),
+                                                  primaryTableRows) &&
+       !this->pimpl->readPrimaryTableRows(connection, primaryTableRows)) {
       return;
    }
 
-   qDebug() <<
-      Q_FUNC_INFO << "Reading main table rows from" << this->pimpl->primaryTable.tableName <<
-      "database table using query " << queryString;
+   // Junction tables can also come from the snapshot or, failing that, the DB
+   auto readJunctionTable = [&connection](JunctionTableDefinition const & junctionTable,
+                                          ObjectStoreSnapshot::Rows & rows) {
+      return ObjectStoreSnapshot::instance().readTable(junctionTable.tableName,
+                                                       getJunctionTableColumnNames(junctionTable),
+                                                       rows) ||
+             readJunctionTableRows(connection, junctionTable, rows);
+   };
+
+   //
+   // Children don't store the fields they share with their parents (see comments in ObjectStore.h), so, before we can
+   // construct them, we need to know who their parents are.  We hang on to the rows for when we do the other junction
+   // tables below.
+   //
+   this->pimpl->initParentSharing();
+   ObjectStoreSnapshot::Rows parentJunctionTableRows;
+   if (this->pimpl->parentJunctionTable) {
+      if (!readJunctionTable(*this->pimpl->parentJunctionTable, parentJunctionTableRows)) {
+         return;
+      }
+      this->pimpl->fillInSharedFields(primaryTableRows, parentJunctionTableRows);
+   }
 
-   while (sqlQuery.next()) {
+   for (auto const & row : primaryTableRows) {
       //
       // We want to pull all the fields for the current row from the database and use them to construct a new
       // object.
@@ -971,23 +1770,23 @@ void ObjectStore::loadAll(Database * database) {
       //     allow a wider range of types.
       //
       bool readPrimaryKey = false;
+      int columnIndex = 0;
       for (auto const & fieldDefn : this->pimpl->primaryTable.tableFields) {
-         QVariant fieldValue = sqlQuery.value(*fieldDefn.columnName);
-         //qDebug() <<
+         QVariant fieldValue = row.value(columnIndex++);
+         //qCDebug(lcDatabase) <<
          //   Q_FUNC_INFO << "Reading col" << fieldDefn.columnName << "(=" << fieldValue << ") into property" <<
          //   fieldDefn.propertyName;
          if (!fieldValue.isValid()) {
             qCritical() <<
                Q_FUNC_INFO << "Error reading column " << fieldDefn.columnName << " (" << fieldValue.toString() <<
-               ") from database table " << this->pimpl->primaryTable.tableName << ". SQL error message: " <<
-               sqlQuery.lastError().text();
+               ") from database table " << this->pimpl->primaryTable.tableName;
             break;
          }
 
          // Enums need to be converted from their string representation in the DB to a numeric value
          if (fieldDefn.fieldType == ObjectStore::Enum) {
             fieldValue = QVariant(stringToEnum(fieldDefn, fieldValue));
-            //qDebug() <<
+            //qCDebug(lcDatabase) <<
             //   Q_FUNC_INFO << "Value for property" << fieldDefn.propertyName << "after enum conversion: " <<
             //   fieldValue;
          }
@@ -1015,12 +1814,12 @@ void ObjectStore::loadAll(Database * database) {
       this->pimpl->allObjects.insert(primaryKey, object);
       // Normally leave this debug output commented, as it generates a lot of logging at start-up, but can be useful to
       // enable for debugging.
-//      qDebug() <<
+//      qCDebug(lcDatabase) <<
 //         Q_FUNC_INFO << "Cached" << object->metaObject()->className() << "#" << primaryKey << "in" <<
 //         this->metaObject()->className();
    }
 
-   qDebug() <<
+   qCDebug(lcDatabase) <<
       Q_FUNC_INFO << "Read" << this->pimpl->allObjects.size() << "entries from primary table" <<
       this->pimpl->primaryTable.tableName;
 
@@ -1031,45 +1830,26 @@ void ObjectStore::loadAll(Database * database) {
    // optimising every single SQL query (because the amount of data in the DB is not enormous), we prefer the
    // simplicity of separate queries.
    //
+   int numJunctionTableRows = 0;
    for (auto const & junctionTable : this->pimpl->junctionTables) {
-      qDebug() <<
+      qCDebug(lcDatabase) <<
          Q_FUNC_INFO << "Reading junction table " << junctionTable.tableName << " into " <<
          GetJunctionTableDefinitionPropertyName(junctionTable);
 
-      //
-      // Order first by the object we're adding the other IDs to, then order either by the other IDs or by another
-      // column if one is specified.
-      //
-      queryString = "SELECT ";
-      queryStringAsStream <<
-         GetJunctionTableDefinitionThisPrimaryKeyColumn(junctionTable) << ", " <<
-         GetJunctionTableDefinitionOtherPrimaryKeyColumn(junctionTable) <<
-         " FROM " << junctionTable.tableName <<
-         " ORDER BY " << GetJunctionTableDefinitionThisPrimaryKeyColumn(junctionTable) << ", ";
-      if (!GetJunctionTableDefinitionOrderByColumn(junctionTable).isNull()) {
-         queryStringAsStream << GetJunctionTableDefinitionOrderByColumn(junctionTable);
-      } else {
-         queryStringAsStream << GetJunctionTableDefinitionOtherPrimaryKeyColumn(junctionTable);
-      }
-      queryStringAsStream << ";";
-
-      sqlQuery = BtSqlQuery{connection};
-      sqlQuery.prepare(queryString);
-      if (!sqlQuery.exec()) {
-         qCritical() <<
-            Q_FUNC_INFO << "Error executing database query " << queryString << ": " << sqlQuery.lastError().text();
+      ObjectStoreSnapshot::Rows junctionTableRows;
+      if (&junctionTable == this->pimpl->parentJunctionTable) {
+         junctionTableRows = parentJunctionTableRows;
+      } else if (!readJunctionTable(junctionTable, junctionTableRows)) {
          return;
       }
-
-      qDebug() << Q_FUNC_INFO << "Reading junction table rows from database query " << queryString;
+      numJunctionTableRows += junctionTableRows.size();
 
       //
       // The simplest way to process the data is first to build the raw ID-to-ID map in memory...
       //
       QMultiHash<int, QVariant> thisToOtherKeys;
-      while (sqlQuery.next()) {
-         thisToOtherKeys.insert(sqlQuery.value(*GetJunctionTableDefinitionThisPrimaryKeyColumn(junctionTable)).toInt(),
-                                sqlQuery.value(*GetJunctionTableDefinitionOtherPrimaryKeyColumn(junctionTable)));
+      for (auto const & row : junctionTableRows) {
+         thisToOtherKeys.insert(row.value(0).toInt(), row.value(1));
       }
 
       //
@@ -1096,7 +1876,7 @@ void ObjectStore::loadAll(Database * database) {
          QList<QVariant> otherKeys = thisToOtherKeys.values(currentKey);
          bool success = false;
          if (junctionTable.assumedNumEntries == ObjectStore::MAX_ONE_ENTRY) {
-            qDebug() <<
+            qCDebug(lcDatabase) <<
                Q_FUNC_INFO << currentObject->metaObject()->className() << " #" << currentKey << ", " <<
                GetJunctionTableDefinitionPropertyName(junctionTable) << "=" << otherKeys.first();
             success = currentObject->setProperty(*GetJunctionTableDefinitionPropertyName(junctionTable),
@@ -1135,7 +1915,7 @@ void ObjectStore::loadAll(Database * database) {
          }
 
          // This is useful for debugging but I usually leave it commented out as it generates a lot of logging at start-up
-//         qDebug() <<
+//         qCDebug(lcDatabase) <<
 //            Q_FUNC_INFO << "Set" <<
 //            (junctionTable.assumedNumEntries == ObjectStore::MAX_ONE_ENTRY ? 1 : otherKeys.size()) <<
 //            GetJunctionTableDefinitionPropertyName(junctionTable).c_str() << "property for" <<
@@ -1145,6 +1925,14 @@ void ObjectStore::loadAll(Database * database) {
    }
 
    dbTransaction.commit();
+
+   // Setting the junction table properties above will have marked them dirty, but of course they all match the DB
+   this->pimpl->dirtyProperties.clear();
+
+   StartupProfile::recordObjectStore(*this->pimpl->primaryTable.tableName,
+                                     primaryTableRows.size(),
+                                     numJunctionTableRows,
+                                     std::chrono::steady_clock::now() - startTime);
    return;
 }
 
@@ -1177,12 +1965,18 @@ QList<std::shared_ptr<QObject> > ObjectStore::getByIds(QVector<int> const & list
 
 
 int ObjectStore::insert(std::shared_ptr<QObject> object) {
-   // Start transaction
-   // (By the magic of RAII, this will abort if we return from this function without calling dbTransaction.commit()
-   QSqlDatabase connection = this->pimpl->database->sqlDatabase();
-   DbTransaction dbTransaction{*this->pimpl->database, connection};
+   Tracing::Span const span{"ObjectStore::insert"};
 
-   int primaryKey = this->pimpl->insertObjectInDb(connection, *object, false);
+   //
+   // Unlike other writes, we have to wait for this one to be done, as we need to know what primary key the DB assigned
+   // to the new object.
+   //
+   auto primaryKeyInDb = std::make_shared<int>(-1);
+   Database::WriteCommand insertCommand = this->pimpl->makeInsertCommand(*object, primaryKeyInDb);
+   if (insertCommand) {
+      this->pimpl->database->enqueueWrite(std::move(insertCommand)).wait();
+   }
+   int const primaryKey = *primaryKeyInDb;
 
    //
    // Add the object to our list of all objects of this type (asserting that it should be impossible for an object with
@@ -1191,12 +1985,9 @@ int ObjectStore::insert(std::shared_ptr<QObject> object) {
    Q_ASSERT(!this->pimpl->allObjects.contains(primaryKey));
    this->pimpl->allObjects.insert(primaryKey, object);
 
-   // Everything succeeded if we got this far so we can wrap up the transaction
-   dbTransaction.commit();
-
    //
-   // Now we tell the object what its primary key is.  Note that we must do this _after_ the database transaction is
-   // finished as there are some circumstances where this call will trigger the start of another database transaction.
+   // Now we tell the object what its primary key is.  Note that we must do this _after_ the insert has been written,
+   // as there are some circumstances where this call will trigger further writes to the database.
    //
    BtStringConst const & primaryKeyProperty = this->pimpl->getPrimaryKeyProperty();
    bool setPrimaryKeyOk = object->setProperty(*primaryKeyProperty, primaryKey);
@@ -1207,6 +1998,7 @@ int ObjectStore::insert(std::shared_ptr<QObject> object) {
          Q_FUNC_INFO << "Unable to set property" << primaryKeyProperty << "on" << object->metaObject()->className();
       Q_ASSERT(false);
    }
+   this->pimpl->indexParent(*object);
 
    //
    // Tell any bits of the UI that need to know that there's a new object
@@ -1216,94 +2008,144 @@ int ObjectStore::insert(std::shared_ptr<QObject> object) {
 }
 
 void ObjectStore::update(std::shared_ptr<QObject> object) {
-   // Start transaction
-   // (By the magic of RAII, this will abort if we return from this function without calling dbTransaction.commit()
-   QSqlDatabase connection = this->pimpl->database->sqlDatabase();
-   DbTransaction dbTransaction{*this->pimpl->database, connection};
+   Tracing::Span const span{"ObjectStore::update"};
+
+   QVariant const primaryKey{this->pimpl->getPrimaryKey(*object)};
+
+   //
+   // We only need to write the properties that have changed since we last wrote the object.  Most changes get written
+   // straight away by updateProperty(), so often there is nothing to do here.
+   //
+   QSet<QString> const dirtyProperties = this->pimpl->dirtyProperties.value(primaryKey.toInt());
+   if (dirtyProperties.isEmpty()) {
+      qCDebug(lcDatabase) <<
+         Q_FUNC_INFO << object->metaObject()->className() << "#" << primaryKey.toInt() << "has no unsaved changes";
+      return;
+   }
 
    //
    // Construct the SQL, which will be of the form
    //
    //    UPDATE tablename
-   //    SET firstColumn = :firstColumn, secondColumn = :secondColumn, ...
+   //    SET firstChangedColumn = :firstChangedColumn, secondChangedColumn = :secondChangedColumn, ...
    //    WHERE primaryKeyColumn = :primaryKeyColumn;
    //
-   // .:TBD:. A small optimisation might be to construct this just once rather than every time this function is called
-   //
    QString queryString{"UPDATE "};
    QTextStream queryStringAsStream{&queryString};
    queryStringAsStream << this->pimpl->primaryTable.tableName << " SET ";
 
-   QString  const primaryKeyColumn {*this->pimpl->getPrimaryKeyColumn()};
-   QVariant const primaryKey       {this->pimpl->getPrimaryKey(*object)};
+   QString const primaryKeyColumn{*this->pimpl->getPrimaryKeyColumn()};
 
-   bool skippedPrimaryKey = false;
-   bool firstFieldOutput = false;
-   for (auto const & fieldDefn: this->pimpl->primaryTable.tableFields) {
-      if (!skippedPrimaryKey) {
-         skippedPrimaryKey = true;
-      } else {
-         if (!firstFieldOutput) {
-            firstFieldOutput = true;
-         } else {
+   //
+   // If any of the fields that children can read from their parents has changed, we write all of them, together with
+   // the list of which ones the object reads from its parent, so that they stay in step.
+   //
+   bool const writeSharedFields =
+      this->pimpl->hasParentSharing() &&
+      std::any_of(this->pimpl->sharedFieldIndexes.cbegin(),
+                  this->pimpl->sharedFieldIndexes.cend(),
+                  [this, &dirtyProperties](int fieldIndex) {
+                     return dirtyProperties.contains(*this->pimpl->primaryTable.tableFields[fieldIndex].propertyName);
+                  });
+
+   //
+   // At the same time, get the values to bind.  Note that, because we're using bind names, it doesn't matter that the
+   // order in which we do the binds is different than the order in which the fields appear in the query.
+   //
+   // By convention the first field is the primary key, so we skip it.
+   //
+   QVector<QPair<QString, QVariant> > bindValues;
+   for (int fieldIndex = 1; fieldIndex < this->pimpl->primaryTable.tableFields.size(); ++fieldIndex) {
+      auto const & fieldDefn = this->pimpl->primaryTable.tableFields[fieldIndex];
+      if (dirtyProperties.contains(*fieldDefn.propertyName) ||
+          (writeSharedFields && this->pimpl->sharedFieldIndexes.contains(fieldIndex))) {
+         if (!bindValues.isEmpty()) {
             queryStringAsStream << ", ";
          }
          queryStringAsStream << " " << fieldDefn.columnName << " = :" << fieldDefn.columnName;
+         bindValues.append(
+            qMakePair(QString{":"} + *fieldDefn.columnName, this->pimpl->getBindValue(*object, fieldIndex))
+         );
       }
    }
+   if (writeSharedFields) {
+      queryStringAsStream << ", " << inheritedFieldsColumn << " = :" << inheritedFieldsColumn;
+      bindValues.append(qMakePair(QString{":"} + inheritedFieldsColumn,
+                                  QVariant{this->pimpl->getInheritedFieldsBindValue(*object)}));
+   }
 
    queryStringAsStream << " WHERE " << primaryKeyColumn << " = :" << primaryKeyColumn << ";";
 
    //
-   // Bind the values.  Note that, because we're using bind names, it doesn't matter that the order in which we do the
-   // binds is different than the order in which the fields appear in the query.
+   // Get the new contents of the junction tables whose lists have changed
    //
-   BtSqlQuery sqlQuery{connection};
-   sqlQuery.prepare(queryString);
-   for (auto const & fieldDefn: this->pimpl->primaryTable.tableFields) {
-      QVariant bindValue{object->property(*fieldDefn.propertyName)};
-
-      // Enums need to be converted to strings first
-      if (fieldDefn.fieldType == ObjectStore::Enum) {
-         bindValue = QVariant{enumToString(fieldDefn, bindValue)};
+   QVector<JunctionTableValues> allJunctionTableValues;
+   for (auto const & junctionTable : this->pimpl->junctionTables) {
+      if (!dirtyProperties.contains(*GetJunctionTableDefinitionPropertyName(junctionTable))) {
+         continue;
       }
-
-      sqlQuery.bindValue(QString{":"} + *fieldDefn.columnName, bindValue);
+      JunctionTableValues junctionTableValues{&junctionTable, {}};
+      if (!getJunctionTablePropertyValues(junctionTable, *object, primaryKey.toInt(), junctionTableValues.values)) {
+         return;
+      }
+      allJunctionTableValues.append(junctionTableValues);
    }
 
+   Database::WriteCommand updateCommand{
+      [queryString, primaryKeyColumn, primaryKey, bindValues, allJunctionTableValues](QSqlDatabase & connection) {
+         if (!bindValues.isEmpty()) {
+            BtSqlQuery sqlQuery{connection};
+            sqlQuery.prepare(queryString);
+            for (auto const & bindValue : bindValues) {
+               sqlQuery.bindValue(bindValue.first, bindValue.second);
+            }
+            sqlQuery.bindValue(QString{":"} + primaryKeyColumn, primaryKey);
+
+            //
+            // Run the query
+            //
+            if (!sqlQuery.exec()) {
+               qCritical() <<
+                  Q_FUNC_INFO << "Error executing database query " << queryString << ": " <<
+                  sqlQuery.lastError().text();
+               return false;
+            }
+         }
+
+         for (auto const & junctionTableValues : allJunctionTableValues) {
+            qCDebug(lcDatabase) <<
+               Q_FUNC_INFO << "Updating property " <<
+               GetJunctionTableDefinitionPropertyName(*junctionTableValues.junctionTable) << " in junction table " <<
+               junctionTableValues.junctionTable->tableName;
+            if (!rewriteJunctionTable(junctionTableValues, primaryKey, connection)) {
+               return false;
+            }
+         }
+         return true;
+      }
+   };
+
    //
-   // Run the query
+   // Any rewrites of shared fields that the changes make necessary go in the same write, so that they happen in the
+   // same DB transaction.
    //
-   if (!sqlQuery.exec()) {
-      qCritical() <<
-         Q_FUNC_INFO << "Error executing database query " << queryString << ": " << sqlQuery.lastError().text();
-      return;
-   }
+   updateCommand = combineWrites(std::move(updateCommand),
+                                 this->pimpl->makeSharedFieldsCommand(*object, dirtyProperties));
 
    //
-   // Now update data in the junction tables
+   // Once the write is queued, we can forget about the changes.  If it fails, we put them back so that they get
+   // written by a subsequent update() -- at the latest, the one writeDirtyProperties() does when the DB is unloaded.
    //
-   for (auto const & junctionTable : this->pimpl->junctionTables) {
-      qDebug() <<
-         Q_FUNC_INFO << "Updating property " << GetJunctionTableDefinitionPropertyName(junctionTable) <<
-         " in junction table " << junctionTable.tableName;
-
-      //
-      // The simplest thing to do with each junction table is to blat any rows relating to the current object and then
-      // write out data based on the current property values.  This may often mean we're deleting rows and rewriting
-      // them but, for the small quantity of data we're talking about, it doesn't seem worth the complexity of
-      // optimising (eg read what's in the DB, compare with what's in the object property, work out what deletes,
-      // inserts and updates are needed to sync them, etc.
-      //
-      if (!deleteFromJunctionTableDefinition(junctionTable, primaryKey, connection)) {
-         return;
-      }
-      if (!insertIntoJunctionTableDefinition(junctionTable, *object, primaryKey, connection)) {
-         return;
+   int const key = primaryKey.toInt();
+   this->pimpl->dirtyProperties.remove(key);
+   this->pimpl->database->enqueueWrite(
+      std::move(updateCommand),
+      [this, key, dirtyProperties](bool succeeded) {
+         if (!succeeded) {
+            this->pimpl->dirtyProperties[key].unite(dirtyProperties);
+         }
       }
-   }
-
-   dbTransaction.commit();
+   );
    return;
 }
 
@@ -1325,22 +2167,107 @@ int ObjectStore::insertOrUpdate(QObject & object) {
 }
 
 void ObjectStore::updateProperty(QObject const & object, BtStringConst const & propertyName) {
-   // Start transaction
-   // (By the magic of RAII, this will abort if we return from this function without calling dbTransaction.commit()
-   QSqlDatabase connection = this->pimpl->database->sqlDatabase();
-   DbTransaction dbTransaction{*this->pimpl->database, connection};
+   Database::WriteCommand updateCommand = this->pimpl->makeUpdatePropertyCommand(object, propertyName);
+   if (!updateCommand) {
+      // Something went wrong.  Bailing out here avoids sending the signal.  We remember that the property is unsaved
+      // so that a subsequent update() (see writeDirtyProperties()) can have another go at writing it.
+      this->markDirty(object, propertyName);
+      return;
+   }
+
+   //
+   // As in update(), any rewrites of shared fields that the change makes necessary go in the same write.
+   //
+   QString const propertyNameAsString{*propertyName};
+   updateCommand = combineWrites(std::move(updateCommand),
+                                 this->pimpl->makeSharedFieldsCommand(object, QSet<QString>{propertyNameAsString}));
+
+   //
+   // The write happens in the background.  If it fails, we remember that the property is unsaved so that a subsequent
+   // update() (see writeDirtyProperties()) can have another go at writing it.
+   //
+   int const primaryKey = this->pimpl->getPrimaryKey(object).toInt();
+   this->markClean(object, propertyName);
+   this->pimpl->database->enqueueWrite(
+      std::move(updateCommand),
+      [this, primaryKey, propertyNameAsString](bool succeeded) {
+         if (!succeeded && primaryKey > 0) {
+            this->pimpl->dirtyProperties[primaryKey].insert(propertyNameAsString);
+         }
+      }
+   );
+
+   // The in-memory object is already up-to-date, so we can tell any bits of the UI that need to know straight away
+   emit this->signalPropertyChanged(primaryKey, propertyName);
+
+   return;
+}
+
+
+void ObjectStore::markDirty(QObject const & object, BtStringConst const & propertyName) {
+   int const primaryKey = this->pimpl->getPrimaryKey(object).toInt();
+   if (primaryKey > 0) {
+      this->pimpl->dirtyProperties[primaryKey].insert(*propertyName);
+
+      // NamedEntity::setParentKey() comes through here, including when loadAll() sets the parent key it read
+      if (this->pimpl->hasParentSharing() &&
+          propertyName == GetJunctionTableDefinitionPropertyName(*this->pimpl->parentJunctionTable)) {
+         this->pimpl->indexParent(object);
+      }
+
+      //
+      // Setters that mark properties dirty are often called several times in a row for the same object (eg when a
+      // Recipe's ingredient lists are being rebuilt), so, rather than write each one straight away, we write everything
+      // that's outstanding once the current event loop turn is done.  (Whilst we're loading, everything that gets marked
+      // dirty is marked clean again before we get back to the event loop, so the write then has nothing to do.)
+      //
+      if (!this->pimpl->dirtyWriteScheduled) {
+         this->pimpl->dirtyWriteScheduled = true;
+         QTimer::singleShot(0, this, [this]() { this->writeDirtyProperties(); });
+      }
+   }
+   return;
+}
 
-   if (!this->pimpl->updatePropertyInDb(connection, object, propertyName)) {
-      // Something went wrong.  Bailing out here will abort the transaction and avoid sending the signal.
+void ObjectStore::writeDirtyProperties() {
+   this->pimpl->dirtyWriteScheduled = false;
+   if (this->pimpl->dirtyProperties.isEmpty()) {
       return;
    }
 
-   // Everything went fine so we can commit the transaction
-   dbTransaction.commit();
+   qCDebug(lcDatabase) <<
+      Q_FUNC_INFO << this->pimpl->dirtyProperties.size() << "objects in" << this->pimpl->primaryTable.tableName <<
+      "have unsaved changes";
+
+   // update() removes each object's entry from dirtyProperties, so we need to work from a copy of the keys
+   for (int const primaryKey : this->pimpl->dirtyProperties.keys()) {
+      std::shared_ptr<QObject> object = this->pimpl->allObjects.value(primaryKey);
+      if (object) {
+         this->update(object);
+      } else {
+         // Object has gone from the cache, so there is nothing left to write
+         this->pimpl->dirtyProperties.remove(primaryKey);
+      }
+   }
+   return;
+}
 
-   // Tell any bits of the UI that need to know that the property was updated
-   emit this->signalPropertyChanged(this->pimpl->getPrimaryKey(object).toInt(), propertyName);
+void ObjectStore::writeDirtyProperties(Database const & database) {
+   // Nothing to do if we were loaded from a different DB (eg this is the DB we're copying to)
+   if (this->pimpl->database == &database) {
+      this->writeDirtyProperties();
+   }
+   return;
+}
 
+void ObjectStore::markClean(QObject const & object, BtStringConst const & propertyName) {
+   auto dirtyPropertiesForObject = this->pimpl->dirtyProperties.find(this->pimpl->getPrimaryKey(object).toInt());
+   if (dirtyPropertiesForObject != this->pimpl->dirtyProperties.end()) {
+      dirtyPropertiesForObject->remove(*propertyName);
+      if (dirtyPropertiesForObject->isEmpty()) {
+         this->pimpl->dirtyProperties.erase(dirtyPropertiesForObject);
+      }
+   }
    return;
 }
 
@@ -1350,7 +2277,7 @@ std::shared_ptr<QObject>  ObjectStore::defaultSoftDelete(int id) {
    // We assume on soft-delete that there is nothing to do on related objects - eg if a Mash is soft deleted (ie marked
    // deleted but remains in the DB) then there isn't actually anything we need to do with its MashSteps.
    //
-   qDebug() << Q_FUNC_INFO << "Soft delete item #" << id;
+   qCDebug(lcDatabase) << Q_FUNC_INFO << "Soft delete item #" << id;
    auto object = this->pimpl->allObjects.value(id);
    if (this->pimpl->allObjects.contains(id)) {
       this->pimpl->allObjects.remove(id);
@@ -1370,10 +2297,21 @@ std::shared_ptr<QObject>  ObjectStore::defaultHardDelete(int id) {
    // the object model than here in the object store as they can be subtle, and it would be cumbersome to model them
    // generically.
    //
-   qDebug() << Q_FUNC_INFO << "Hard delete item #" << id;
+   qCDebug(lcDatabase) << Q_FUNC_INFO << "Hard delete item #" << id;
    auto object = this->pimpl->allObjects.value(id);
-   QSqlDatabase connection = this->pimpl->database->sqlDatabase();
-   DbTransaction dbTransaction{*this->pimpl->database, connection};
+
+   //
+   // Any children of the object are about to lose their parent, so they need to store their own copies of the fields
+   // they currently read from it, and to be unlinked from it.  This goes in the same write as the delete, so that the
+   // DB never has one without the other.
+   //
+   Database::WriteCommand unshareCommand;
+   if (object) {
+      unshareCommand = combineWrites(
+         this->pimpl->makeUpdateSharedFieldsCommand(this->pimpl->getChildren(*object), false),
+         this->pimpl->makeDetachChildrenCommand(QVariant{id})
+      );
+   }
 
    //
    // Construct the SQL, which will be of the form
@@ -1388,44 +2326,56 @@ std::shared_ptr<QObject>  ObjectStore::defaultHardDelete(int id) {
    queryStringAsStream << this->pimpl->primaryTable.tableName;
    BtStringConst const & primaryKeyColumn = this->pimpl->getPrimaryKeyColumn();
    queryStringAsStream << " WHERE " << primaryKeyColumn << " = :" << primaryKeyColumn << ";";
-   qDebug() <<
+   qCDebug(lcDatabase) <<
       Q_FUNC_INFO << "Deleting main table row #" << id << "with database query " << queryString;
 
-   //
-   // Bind the value
-   //
-   QVariant primaryKey{id};
-   BtSqlQuery sqlQuery{connection};
-   sqlQuery.prepare(queryString);
-   sqlQuery.bindValue(QString{":"} + *primaryKeyColumn, primaryKey);
-   qDebug().noquote() << Q_FUNC_INFO << "Bind values:" << BoundValuesToString(sqlQuery);
+   QString const primaryKeyBindName{QString{":"} + *primaryKeyColumn};
+   // The table definitions are fixed, so it's safe to read them from the write thread
+   JunctionTableDefinitions const * junctionTables = &this->pimpl->junctionTables;
+   Database::WriteCommand deleteCommand{
+      [queryString, primaryKeyBindName, id, junctionTables](QSqlDatabase & connection) {
+         //
+         // Bind the value
+         //
+         QVariant primaryKey{id};
+         BtSqlQuery sqlQuery{connection};
+         sqlQuery.prepare(queryString);
+         sqlQuery.bindValue(primaryKeyBindName, primaryKey);
+         qCDebug(lcDatabase).noquote() << Q_FUNC_INFO << "Bind values:" << BoundValuesToString(sqlQuery);
 
-   //
-   // Run the query
-   //
-   if (!sqlQuery.exec()) {
-      qCritical() <<
-         Q_FUNC_INFO << "Error executing database query " << queryString << ": " << sqlQuery.lastError().text();
-      return object;
-   }
+         //
+         // Run the query
+         //
+         if (!sqlQuery.exec()) {
+            qCritical() <<
+               Q_FUNC_INFO << "Error executing database query " << queryString << ": " << sqlQuery.lastError().text();
+            return false;
+         }
 
-   //
-   // Now remove data in the junction tables
-   //
-   for (auto const & junctionTable : this->pimpl->junctionTables) {
-      if (!deleteFromJunctionTableDefinition(junctionTable, primaryKey, connection)) {
-         // We'll have already logged errors in deleteFromJunctionTableDefinition().  Not much more we can do other than
-         // bail here.
-         return object;
+         //
+         // Now remove data in the junction tables
+         //
+         for (auto const & junctionTable : *junctionTables) {
+            if (!deleteFromJunctionTableDefinition(junctionTable, primaryKey, connection)) {
+               // We'll have already logged errors in deleteFromJunctionTableDefinition().  Not much more we can do
+               // other than bail here.
+               return false;
+            }
+         }
+         return true;
       }
-   }
-
-   dbTransaction.commit();
+   };
+   this->pimpl->database->enqueueWrite(combineWrites(std::move(unshareCommand), std::move(deleteCommand)));
 
    //
-   // Remove the object from the cache
+   // Remove the object from the cache.  We don't wait for the DB, as the cache is what the rest of the program sees.
    //
    this->pimpl->allObjects.remove(id);
+   this->pimpl->dirtyProperties.remove(id);
+   this->pimpl->unindexParent(id);
+   for (int const childId : this->pimpl->childIdsByParentId.take(id)) {
+      this->pimpl->parentIdByChildId.remove(childId);
+   }
 
    // Tell any bits of the UI that need to know that an object was deleted
    emit this->signalObjectDeleted(id, object);
@@ -1506,13 +2456,52 @@ bool ObjectStore::writeAllToNewDb(Database & databaseNew, QSqlDatabase & connect
    //
    // We've got all the data cached in memory, so we just need to write it to the new database ... with a couple of
    // twists.  The assumption here is that we're already inside a transaction and that foreign key constraints are
-   // turned off.  So we just need to tell our insert member function to write to a different DB than normal and not to
-   // try to do anything with transactions ... AND we want to keep all the existing primary key values the same, rather
-   // than let the DB generate new ones when we do the inserts, so the third parameter to this->pimpl->insertObjectInDb
-   // is true.
+   // turned off.  We want to keep all the existing primary key values the same, rather than let the DB generate new
+   // ones when we do the inserts.  And, because there can be a lot of data, we don't go through insert() one
+   // object (and one junction table row) at a time, but gather up all the rows for each table and write them with
+   // multi-row inserts.
    //
+   ObjectStoreSnapshot::Rows primaryTableRows;
+   primaryTableRows.reserve(this->pimpl->allObjects.size());
    for (auto object : this->pimpl->allObjects) {
-      if (this->pimpl->insertObjectInDb(connectionNew, *object, true) <= 0) {
+      primaryTableRows.append(this->pimpl->getInsertBindValues(*object, true));
+   }
+   if (!insertRowsInBatches(connectionNew,
+                            this->pimpl->primaryTable.tableName,
+                            this->pimpl->getPrimaryTableColumnNames(),
+                            primaryTableRows)) {
+      return false;
+   }
+
+   //
+   // As in insertIntoJunctionTableDefinition(), we let the DB auto-generate the junction table primary keys, and, if
+   // there is an order-by column, we number the entries for each object from 1.
+   //
+   for (auto const & junctionTable : this->pimpl->junctionTables) {
+      bool const hasOrderByColumn = !GetJunctionTableDefinitionOrderByColumn(junctionTable).isNull();
+      QStringList columnNames = getJunctionTableColumnNames(junctionTable);
+      if (hasOrderByColumn) {
+         columnNames.append(*GetJunctionTableDefinitionOrderByColumn(junctionTable));
+      }
+
+      ObjectStoreSnapshot::Rows junctionTableRows;
+      for (auto object : this->pimpl->allObjects) {
+         int const primaryKey = this->pimpl->getPrimaryKey(*object).toInt();
+         QVector<int> propertyValues;
+         if (!getJunctionTablePropertyValues(junctionTable, *object, primaryKey, propertyValues)) {
+            return false;
+         }
+         int itemNumber = 1;
+         for (int curValue : propertyValues) {
+            QVector<QVariant> row{QVariant{primaryKey}, QVariant{curValue}};
+            if (hasOrderByColumn) {
+               row.append(QVariant{itemNumber});
+            }
+            junctionTableRows.append(row);
+            ++itemNumber;
+         }
+      }
+      if (!insertRowsInBatches(connectionNew, junctionTable.tableName, columnNames, junctionTableRows)) {
          return false;
       }
    }
@@ -1524,13 +2513,148 @@ bool ObjectStore::writeAllToNewDb(Database & databaseNew, QSqlDatabase & connect
    // Note that we only need to do this for the primary key on primaryTable.  We make no use of the primary key IDs on
    // junction tables and we always let the DB auto-generate them, even when writing all data to a new DB.
    //
-   // We _could_ call databaseNew.updatePrimaryKeySequenceIfNecessary() in this->pimpl->insertObjectInDb() every time we
-   // explicitly insert an ID in primaryTable, but it's currently not necessary as this is the only place we ask
-   // this->pimpl->insertObjectInDb() to do that.
-   //
    databaseNew.updatePrimaryKeySequenceIfNecessary(connectionNew,
                                                    this->pimpl->primaryTable.tableName,
                                                    this->pimpl->getPrimaryKeyColumn());
 
    return true;
 }
+
+int ObjectStore::size() const {
+   return this->pimpl->allObjects.size();
+}
+
+BtStringConst const & ObjectStore::tableName() const {
+   return this->pimpl->primaryTable.tableName;
+}
+
+void ObjectStore::getReferencedIds(int id,
+                                   QVector<ObjectReference> & foreignKeyReferences,
+                                   QVector<ObjectReference> & junctionTableReferences) const {
+   foreignKeyReferences.clear();
+   junctionTableReferences.clear();
+   auto object = this->pimpl->allObjects.value(id);
+   if (!object) {
+      return;
+   }
+
+   auto addReference = [this, id](QVector<ObjectReference> & references,
+                                  TableDefinition const & referencedTable,
+                                  int referencedId) {
+      // As elsewhere, a foreign key that is not set is zero or negative
+      if (referencedId > 0 && !(&referencedTable == &this->pimpl->primaryTable && referencedId == id)) {
+         references.append(ObjectReference{*referencedTable.tableName, referencedId});
+      }
+      return;
+   };
+
+   for (auto const & fieldDefn : this->pimpl->primaryTable.tableFields) {
+      if (fieldDefn.foreignKeyTo != nullptr) {
+         addReference(foreignKeyReferences, *fieldDefn.foreignKeyTo, object->property(*fieldDefn.propertyName).toInt());
+      }
+   }
+
+   for (auto const & junctionTable : this->pimpl->junctionTables) {
+      TableDefinition const * referencedTable = junctionTable.tableFields[2].foreignKeyTo;
+      QVector<int> propertyValues;
+      if (referencedTable == nullptr ||
+          !getJunctionTablePropertyValues(junctionTable, *object, id, propertyValues)) {
+         continue;
+      }
+      for (int referencedId : propertyValues) {
+         addReference(junctionTableReferences, *referencedTable, referencedId);
+      }
+   }
+   return;
+}
+
+bool ObjectStore::shareParentData(Database & database, QSqlDatabase & connection) const {
+   if (!this->pimpl->hasParentSharing()) {
+      return true;
+   }
+   if (!this->pimpl->addInheritedFieldsColumn(database, connection)) {
+      return false;
+   }
+
+   //
+   // For each shared field, the SQL will be of the form
+   //
+   //    UPDATE tablename
+   //    SET inherited_fields = CASE WHEN inherited_fields = '' THEN 'columnName'
+   //                                ELSE inherited_fields || ',columnName' END,
+   //        columnName = :placeholder
+   //    WHERE EXISTS (SELECT 1 FROM parentJunctionTable AS jt, tablename AS parent_row
+   //                  WHERE jt.childColumn = tablename.primaryKeyColumn
+   //                  AND jt.parentColumn <> tablename.primaryKeyColumn
+   //                  AND parent_row.primaryKeyColumn = jt.parentColumn
+   //                  AND (parent_row.columnName = tablename.columnName OR
+   //                       (parent_row.columnName IS NULL AND tablename.columnName IS NULL))
+   //                  AND NOT EXISTS (SELECT 1 FROM parentJunctionTable AS jt2
+   //                                  WHERE jt2.childColumn = parent_row.primaryKeyColumn
+   //                                  AND jt2.parentColumn <> jt2.childColumn));
+   //
+   // (All the expressions in an UPDATE are evaluated on the row as it was before the UPDATE, so it doesn't matter that
+   // we're changing the column we're comparing.)  We leave alone the children of parents that are themselves children,
+   // as such a parent might already have had the column replaced with a placeholder.  That doesn't lose us anything
+   // much, as parents are not normally children.
+   //
+   JunctionTableDefinition const & parentJunctionTable = *this->pimpl->parentJunctionTable;
+   BtStringConst const & tableName = this->pimpl->primaryTable.tableName;
+   BtStringConst const & primaryKeyColumn = this->pimpl->getPrimaryKeyColumn();
+   BtStringConst const & childColumn = GetJunctionTableDefinitionThisPrimaryKeyColumn(parentJunctionTable);
+   BtStringConst const & parentColumn = GetJunctionTableDefinitionOtherPrimaryKeyColumn(parentJunctionTable);
+   for (int fieldIndex : this->pimpl->sharedFieldIndexes) {
+      auto const & fieldDefn = this->pimpl->primaryTable.tableFields[fieldIndex];
+      BtStringConst const & columnName = fieldDefn.columnName;
+      QString queryString{"UPDATE "};
+      QTextStream queryStringAsStream{&queryString};
+      queryStringAsStream <<
+         tableName <<
+         " SET " << inheritedFieldsColumn << " = CASE WHEN " << inheritedFieldsColumn << " = '' THEN '" <<
+                                            columnName << "' ELSE " << inheritedFieldsColumn << " || '," <<
+                                            columnName << "' END, " <<
+                   columnName << " = :placeholder" <<
+         " WHERE EXISTS (SELECT 1 FROM " << parentJunctionTable.tableName << " AS jt, " <<
+                                        tableName << " AS parent_row" <<
+                       " WHERE jt." << childColumn << " = " << tableName << "." << primaryKeyColumn <<
+                       " AND jt." << parentColumn << " <> " << tableName << "." << primaryKeyColumn <<
+                       " AND parent_row." << primaryKeyColumn << " = jt." << parentColumn <<
+                       " AND (parent_row." << columnName << " = " << tableName << "." << columnName << " OR " <<
+                             "(parent_row." << columnName << " IS NULL AND " <<
+                               tableName << "." << columnName << " IS NULL))" <<
+                       " AND NOT EXISTS (SELECT 1 FROM " << parentJunctionTable.tableName << " AS jt2" <<
+                                       " WHERE jt2." << childColumn << " = parent_row." << primaryKeyColumn <<
+                                       " AND jt2." << parentColumn << " <> jt2." << childColumn << "));";
+      BtSqlQuery sqlQuery{connection};
+      sqlQuery.prepare(queryString);
+      sqlQuery.bindValue(":placeholder", getInheritedFieldPlaceholder(fieldDefn.fieldType));
+      if (!sqlQuery.exec()) {
+         qCritical() <<
+            Q_FUNC_INFO << "Error executing database query " << queryString << ": " << sqlQuery.lastError().text();
+         return false;
+      }
+   }
+   qInfo() <<
+      Q_FUNC_INFO << "Children in" << tableName << "now read up to" << this->pimpl->sharedFieldIndexes.size() <<
+      "fields from their parents";
+   return true;
+}
+
+bool ObjectStore::addAllToSnapshot(QSqlDatabase & connection) const {
+   ObjectStoreSnapshot & snapshot = ObjectStoreSnapshot::instance();
+
+   ObjectStoreSnapshot::Rows rows;
+   if (!this->pimpl->readPrimaryTableRows(connection, rows)) {
+      return false;
+   }
+   snapshot.addTable(this->pimpl->primaryTable.tableName, this->pimpl->getPrimaryTableColumnNames(), rows);
+
+   for (auto const & junctionTable : this->pimpl->junctionTables) {
+      if (!readJunctionTableRows(connection, junctionTable, rows)) {
+         return false;
+      }
+      snapshot.addTable(junctionTable.tableName, getJunctionTableColumnNames(junctionTable), rows);
+   }
+
+   return true;
+}
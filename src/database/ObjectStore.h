@@ -25,6 +25,7 @@
 #include <optional>
 
 #include <QObject>
+#include <QPair>
 #include <QSqlDatabase>
 #include <QString>
 #include <QVector>
@@ -54,6 +55,27 @@ class NamedParameterBundle;
  *
  *        Inheritance from QObject is to allow this class to send signals (and therefore that inheritance needs to be
  *        public).
+ *
+ *        The in-memory cache is what the rest of the program sees, and it is only used from the GUI thread.  Writes to
+ *        the DB are queued (via \c Database::enqueueWrite()) to run in the background, in order, on the DB write
+ *        thread.  Everything a write needs is read from the object when it is queued, so that the write thread never
+ *        touches the object itself.  Only \c insert() waits for its write to be done, as it needs the primary key that
+ *        the DB assigns.  The cache is updated, and signals sent, without waiting for the DB.  If a write fails, the
+ *        properties it was writing are marked dirty again (see \c markDirty()).  Dirty properties are written by
+ *        \c writeDirtyProperties(), which runs at the end of the event loop turn in which something was marked dirty,
+ *        and once more when the DB is unloaded (so that anything whose write failed gets another go).
+ *
+ *        Where a type has children (ie objects that are "instances of use of" another object of the same type, eg the
+ *        copy of a Hop that is used in a Recipe -- see \c NamedEntity::makeChild()), each child has its own row in the
+ *        primary table, but we do not want to store all the catalogue data (name, notes, origin, alpha acid, etc) over
+ *        and over again.  So, in a child's row, any field that is the same as in its parent's row is stored as an empty
+ *        placeholder value and listed (by column name) in the row's \c inherited_fields column, and, when we read the
+ *        child back from the DB, we fill in each listed field from the parent.  (We can't just store NULL, as some of
+ *        these columns are NOT NULL, and, for those that aren't, NULL can be a genuine value.)  The exceptions are the
+ *        fields that belong to the use itself (eg amount and time -- see \c UseOfPropertyNames) plus foreign keys and
+ *        \c NamedEntity housekeeping fields (display, deleted, folder), which are always stored.  This is all
+ *        invisible outside of this class: every object has all its properties in memory, and, where a child's value is
+ *        read from its parent, the two share the same (implicitly-shared) data.
  */
 class ObjectStore : public QObject {
    // We also need the Q_OBJECT macro to use signals and/or slots
@@ -204,14 +226,24 @@ public:
    // This isn't strictly necessary, but it makes various declarations more concise
    typedef QVector<JunctionTableDefinition> JunctionTableDefinitions;
 
+   /**
+    * \brief For a type that has children, the properties that belong to each "instance of use of" rather than being
+    *        copied from the parent (eg for a Hop, the amount and time of the addition).  See comments above for how
+    *        the other properties of a child are stored.
+    */
+   typedef QVector<BtStringConst const *> UseOfPropertyNames;
+
    /**
     * \brief Constructor sets up mappings but does not read in data from DB
     *
     * \param primaryTable  First in the list should be the primary key
-    * \param junctionTables  Optional
+    * \param junctionTables  Optional.  If one of them stores the parent of each object (ie its third field is a foreign
+    *                        key to \c primaryTable) then we share catalogue data between children and their parents.
+    * \param useOfPropertyNames  Optional.  Only meaningful if there is a junction table for the parent.
     */
    ObjectStore(TableDefinition const &          primaryTable,
-               JunctionTableDefinitions const & junctionTables = JunctionTableDefinitions{});
+               JunctionTableDefinitions const & junctionTables = JunctionTableDefinitions{},
+               UseOfPropertyNames const &       useOfPropertyNames = UseOfPropertyNames{});
 
    ~ObjectStore();
 
@@ -242,14 +274,17 @@ public:
    virtual std::shared_ptr<QObject> createNewObject(NamedParameterBundle & namedParameterBundle) = 0;
 
    /**
-    * \brief Insert a new object in the DB (and in our cache list)
+    * \brief Insert a new object in the DB (and in our cache list).  Waits until the DB has assigned the primary key,
+    *        which, as writes are run in order, also means any previously-queued writes have been done.
     *
     * \return The ID of what was inserted
     */
    virtual int insert(std::shared_ptr<QObject> object);
 
    /**
-    * \brief Update an existing object in the DB
+    * \brief Update an existing object in the DB.  Only the properties that have been marked dirty (see \c markDirty)
+    *        since they were last written are sent to the DB, so, eg, changing the notes on a Recipe does not rewrite its
+    *        hop list.  Does not wait for the write to be done.
     */
    virtual void update(std::shared_ptr<QObject> object);
 
@@ -271,10 +306,35 @@ public:
    int insertOrUpdate(QObject & object);
 
    /**
-    * \brief Update a single property of an existing object in the DB
+    * \brief Update a single property of an existing object in the DB.  Does not wait for the write to be done.
     */
    void updateProperty(QObject const & object, BtStringConst const & propertyName);
 
+   /**
+    * \brief Record that a property of a stored object has been changed in memory without (yet) being written to the DB,
+    *        so that the next call to \c update will write it.  Used by setters (eg of junction table ID lists) that do
+    *        not write straight through to the DB.  Does nothing for objects that are not yet stored.
+    *
+    *        If it is not already scheduled, this also schedules a call to \c writeDirtyProperties() for when control
+    *        returns to the event loop.
+    */
+   void markDirty(QObject const & object, BtStringConst const & propertyName);
+
+   /**
+    * \brief Call \c update() for every object that has dirty properties.  Does not wait for the writes to be done.
+    */
+   void writeDirtyProperties();
+
+   /**
+    * \brief As \c writeDirtyProperties(), but does nothing unless this store was loaded from \c database
+    */
+   void writeDirtyProperties(Database const & database);
+
+   /**
+    * \brief Record that a property of a stored object has been written to the DB
+    */
+   void markClean(QObject const & object, BtStringConst const & propertyName);
+
    /**
     * \brief Remove the object from our local in-memory cache
     *
@@ -293,7 +353,8 @@ public:
    std::shared_ptr<QObject> defaultSoftDelete(int id);
 
    /**
-    * \brief Remove the object from our local in-memory cache and remove its record from the DB.
+    * \brief Remove the object from our local in-memory cache and remove its record from the DB.  (The latter happens
+    *        in the background.)
     *
     *        Subclasses implementing their own soft delete member functions can use this and do additional work, eg
     *        \c ObjectStoreTyped will also mark the in-memory object as deleted (via the \c "deleted" property of
@@ -380,6 +441,33 @@ public:
     */
    QList<QObject *> getAllRaw() const;
 
+   /**
+    * \brief Number of objects in this store
+    */
+   int size() const;
+
+   /**
+    * \brief Name of the primary table for this store, eg "hop"
+    */
+   BtStringConst const & tableName() const;
+
+   //! \brief Identifies a stored object (of any type) by the name of its primary table and its primary key
+   typedef QPair<QString, int> ObjectReference;
+
+   /**
+    * \brief Get the other stored objects that the object with the supplied ID refers to.  A reference from an object to
+    *        itself (eg a Recipe that is, by convention, its own ancestor) is left out.  Used by \c Compaction to work out
+    *        which objects are no longer needed.
+    *
+    * \param id
+    * \param foreignKeyReferences Where to put what is referred to by foreign key columns in the primary table
+    * \param junctionTableReferences Where to put what is referred to in junction tables, eg the Hops in a Recipe or the
+    *                                parent of a Hop
+    */
+   void getReferencedIds(int id,
+                         QVector<ObjectReference> & foreignKeyReferences,
+                         QVector<ObjectReference> & junctionTableReferences) const;
+
    /**
     * \brief Write everything in this object store to a new database.  Caller's responsibility to wrap everything in a
     *        transaction and turn off foreign key constraints.
@@ -391,6 +479,30 @@ public:
     */
    bool writeAllToNewDb(Database & databaseNew, QSqlDatabase & connectionNew) const;
 
+   /**
+    * \brief Read the raw contents of all the tables for this object store from the DB and add them to the start-up
+    *        snapshot (see \c ObjectStoreSnapshot).  Caller's responsibility to call \c ObjectStoreSnapshot::write()
+    *        afterwards.
+    *
+    *        We read from the DB rather than our in-memory cache so that the snapshot is guaranteed to contain exactly
+    *        what \c loadAll() would have read.
+    *
+    * \param connection
+    *
+    * \return \c true if succeeded \c false otherwise
+    */
+   bool addAllToSnapshot(QSqlDatabase & connection) const;
+
+   /**
+    * \brief For a DB written before we shared catalogue data between children and their parents, add the
+    *        \c inherited_fields column to the primary table and, in every child, replace each field it can read from
+    *        its parent with a placeholder and mark it as inherited.  Does nothing for types without children.
+    *        Caller's responsibility to handle transactions.  Used by \c DatabaseSchemaHelper when upgrading the DB.
+    *
+    * \return \c true if succeeded \c false otherwise
+    */
+   bool shareParentData(Database & database, QSqlDatabase & connection) const;
+
 signals:
    /**
     * \brief Signal emitted when a new object is inserted in the database.  Parts of the UI that need to display all
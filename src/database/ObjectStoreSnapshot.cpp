@@ -0,0 +1,418 @@
+/*
+ * database/ObjectStoreSnapshot.cpp is part of Brewtarget, and is copyright the following
+ * authors 2021:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "database/ObjectStoreSnapshot.h"
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+
+#include "Logging.h"
+#include "utils/BtStringConst.h"
+
+namespace {
+   //
+   // File layout is:
+   //
+   //    Header
+   //       quint32     magic number
+   //       quint32     snapshot format version
+   //       qint32      DB schema version
+   //       qint64      DB file last modified time (ms since epoch, UTC)
+   //       qint64      DB file size
+   //       quint32     number of tables
+   //    For each table
+   //       QString     table name
+   //       QStringList column names
+   //       quint32     number of rows
+   //       quint32     size in bytes of the row data that follows
+   //       Row data    (number of rows × number of columns) QVariant values
+   //
+   // The per-table size means that, on opening, we can build an index of tables without having to deserialise any of
+   // the row data.
+   //
+   // If you change the layout, bump snapshotFormatVersion so that old snapshots get ignored.
+   //
+   quint32 const snapshotMagicNumber   = 0x42545353; // "BTSS"
+   quint32 const snapshotFormatVersion = 1;
+   QDataStream::Version const snapshotStreamVersion = QDataStream::Qt_5_9;
+
+   /**
+    * \brief Where to find a table's row data inside the mapped file
+    */
+   struct TableLocation {
+      QStringList columnNames;
+      quint32     numRows;
+      qint64      offset;
+      quint32     size;
+   };
+
+   /**
+    * \brief A table waiting to be written
+    */
+   struct PendingTable {
+      QString     tableName;
+      QStringList columnNames;
+      quint32     numRows;
+      QByteArray  rowData;
+   };
+
+   /**
+    * \brief We have to be careful with lastModified() as, eg, it can have different resolution on different
+    *        filesystems.  The main thing is to be consistent between writing and reading.
+    */
+   qint64 modificationStamp(QFileInfo const & fileInfo) {
+      return fileInfo.lastModified().toMSecsSinceEpoch();
+   }
+}
+
+// This private implementation class holds all private non-virtual members of ObjectStoreSnapshot
+class ObjectStoreSnapshot::impl {
+public:
+
+   /**
+    * Constructor
+    */
+   impl() : mutex{},
+            file{},
+            mappedData{nullptr},
+            mappedSize{0},
+            tableIndex{},
+            pendingTables{} {
+      return;
+   }
+
+   /**
+    * Destructor
+    */
+   ~impl() = default;
+
+   /**
+    * \brief Unmap and close the file.  Caller should hold the mutex.
+    */
+   void unmap() {
+      if (this->mappedData) {
+         this->file.unmap(this->mappedData);
+         this->mappedData = nullptr;
+         this->mappedSize = 0;
+      }
+      if (this->file.isOpen()) {
+         this->file.close();
+      }
+      this->tableIndex.clear();
+      return;
+   }
+
+   /**
+    * \brief Read the header and table index out of the mapped data.  Caller should hold the mutex.
+    *
+    * \return \c true if everything checked out, \c false otherwise
+    */
+   bool readIndex(QFileInfo const & dbFileInfo, int schemaVersion) {
+      // fromRawData doesn't copy anything, so this is cheap
+      QByteArray const rawData = QByteArray::fromRawData(reinterpret_cast<char const *>(this->mappedData),
+                                                          static_cast<int>(this->mappedSize));
+      QDataStream inputStream{rawData};
+      inputStream.setVersion(snapshotStreamVersion);
+
+      quint32 magicNumber    = 0;
+      quint32 formatVersion  = 0;
+      qint32  snapshotSchema = 0;
+      qint64  dbModified     = 0;
+      qint64  dbSize         = 0;
+      quint32 numTables      = 0;
+      inputStream >> magicNumber >> formatVersion >> snapshotSchema >> dbModified >> dbSize >> numTables;
+      if (inputStream.status() != QDataStream::Ok) {
+         qWarning() << Q_FUNC_INFO << "Unable to read snapshot header from" << this->file.fileName();
+         return false;
+      }
+
+      if (magicNumber != snapshotMagicNumber || formatVersion != snapshotFormatVersion) {
+         qInfo() <<
+            Q_FUNC_INFO << "Ignoring snapshot" << this->file.fileName() << "with magic number" << magicNumber <<
+            "and format version" << formatVersion;
+         return false;
+      }
+
+      if (snapshotSchema != schemaVersion) {
+         qInfo() <<
+            Q_FUNC_INFO << "Ignoring snapshot for schema version" << snapshotSchema << "as current schema version is" <<
+            schemaVersion;
+         return false;
+      }
+
+      if (dbModified != modificationStamp(dbFileInfo) || dbSize != dbFileInfo.size()) {
+         qInfo() <<
+            Q_FUNC_INFO << "Ignoring snapshot as" << dbFileInfo.filePath() << "has changed since it was taken";
+         return false;
+      }
+
+      for (quint32 ii = 0; ii < numTables; ++ii) {
+         QString tableName;
+         TableLocation tableLocation;
+         inputStream >> tableName >> tableLocation.columnNames >> tableLocation.numRows >> tableLocation.size;
+         if (inputStream.status() != QDataStream::Ok) {
+            qWarning() << Q_FUNC_INFO << "Unable to read table" << ii << "header from snapshot";
+            return false;
+         }
+         tableLocation.offset = inputStream.device()->pos();
+         if (tableLocation.offset + tableLocation.size > this->mappedSize ||
+             inputStream.skipRawData(static_cast<int>(tableLocation.size)) != static_cast<int>(tableLocation.size)) {
+            qWarning() << Q_FUNC_INFO << "Snapshot is truncated in table" << tableName;
+            return false;
+         }
+         this->tableIndex.insert(tableName, tableLocation);
+      }
+
+      return true;
+   }
+
+   // Used for locking member functions, in case object stores are loaded from more than one thread
+   QMutex mutex;
+
+   QFile file;
+   uchar * mappedData;
+   qint64 mappedSize;
+   QHash<QString, TableLocation> tableIndex;
+
+   QVector<PendingTable> pendingTables;
+};
+
+ObjectStoreSnapshot::ObjectStoreSnapshot() : pimpl{ std::make_unique<impl>() } {
+   return;
+}
+
+// See https://herbsutter.com/gotw/_100/ for why we need to explicitly define the destructor here (and not in the
+// header file)
+ObjectStoreSnapshot::~ObjectStoreSnapshot() {
+   // Don't try and log in this function as it's called pretty close to the program exiting
+   this->pimpl->unmap();
+   return;
+}
+
+ObjectStoreSnapshot & ObjectStoreSnapshot::instance() {
+   // As of C++11, simple "Meyers singleton" is thread-safe
+   static ObjectStoreSnapshot snapshotSingleton;
+   return snapshotSingleton;
+}
+
+bool ObjectStoreSnapshot::open(QString const & snapshotFilePath, QFileInfo const & dbFileInfo, int schemaVersion) {
+   QMutexLocker locker(&this->pimpl->mutex);
+
+   this->pimpl->unmap();
+
+   this->pimpl->file.setFileName(snapshotFilePath);
+   if (!this->pimpl->file.exists()) {
+      qInfo() << Q_FUNC_INFO << "No snapshot at" << snapshotFilePath << "so will read from DB";
+      return false;
+   }
+
+   //
+   // The snapshot is validated against the DB file, but, in WAL mode, committed changes can also be in the write-ahead
+   // log, which only gets left behind (non-empty) if we didn't shut down cleanly.  In that case the snapshot is stale.
+   //
+   QFileInfo const walFileInfo{dbFileInfo.filePath() + "-wal"};
+   if (walFileInfo.exists() && walFileInfo.size() > 0) {
+      qInfo() << Q_FUNC_INFO << "Ignoring snapshot" << snapshotFilePath << "as DB has unmerged write-ahead log";
+      return false;
+   }
+
+   if (!this->pimpl->file.open(QIODevice::ReadOnly)) {
+      qWarning() <<
+         Q_FUNC_INFO << "Unable to open snapshot" << snapshotFilePath << ":" << this->pimpl->file.errorString();
+      return false;
+   }
+
+   this->pimpl->mappedSize = this->pimpl->file.size();
+   this->pimpl->mappedData = this->pimpl->file.map(0, this->pimpl->mappedSize);
+   if (!this->pimpl->mappedData) {
+      qWarning() <<
+         Q_FUNC_INFO << "Unable to map snapshot" << snapshotFilePath << ":" << this->pimpl->file.errorString();
+      this->pimpl->unmap();
+      return false;
+   }
+
+   if (!this->pimpl->readIndex(dbFileInfo, schemaVersion)) {
+      this->pimpl->unmap();
+      return false;
+   }
+
+   qInfo() <<
+      Q_FUNC_INFO << "Using snapshot" << snapshotFilePath << "(" << this->pimpl->mappedSize << "bytes," <<
+      this->pimpl->tableIndex.size() << "tables)";
+   return true;
+}
+
+bool ObjectStoreSnapshot::isOpen() const {
+   QMutexLocker locker(&this->pimpl->mutex);
+   return this->pimpl->mappedData != nullptr;
+}
+
+bool ObjectStoreSnapshot::readTable(BtStringConst const & tableName, QStringList const & columnNames, Rows & rows) {
+   QMutexLocker locker(&this->pimpl->mutex);
+
+   if (!this->pimpl->mappedData) {
+      return false;
+   }
+
+   QString const tableNameAsString{*tableName};
+   if (!this->pimpl->tableIndex.contains(tableNameAsString)) {
+      qCDebug(lcDatabase) << Q_FUNC_INFO << "Table" << tableName << "not in snapshot";
+      return false;
+   }
+
+   // Each table is only read once, so we can take it out of the index now
+   TableLocation const tableLocation = this->pimpl->tableIndex.take(tableNameAsString);
+
+   bool succeeded = false;
+   if (tableLocation.columnNames != columnNames) {
+      qInfo() <<
+         Q_FUNC_INFO << "Columns for table" << tableName << "in snapshot (" << tableLocation.columnNames <<
+         ") do not match those expected (" << columnNames << ")";
+   } else {
+      QByteArray const rawData = QByteArray::fromRawData(
+         reinterpret_cast<char const *>(this->pimpl->mappedData + tableLocation.offset),
+         static_cast<int>(tableLocation.size)
+      );
+      QDataStream inputStream{rawData};
+      inputStream.setVersion(snapshotStreamVersion);
+
+      int const numColumns = columnNames.size();
+      rows.clear();
+      rows.reserve(static_cast<int>(tableLocation.numRows));
+      for (quint32 rowNum = 0; rowNum < tableLocation.numRows; ++rowNum) {
+         QVector<QVariant> row(numColumns);
+         for (int colNum = 0; colNum < numColumns; ++colNum) {
+            inputStream >> row[colNum];
+         }
+         rows.append(row);
+      }
+
+      if (inputStream.status() != QDataStream::Ok) {
+         qWarning() << Q_FUNC_INFO << "Error reading rows for table" << tableName << "from snapshot";
+         rows.clear();
+      } else {
+         qCDebug(lcDatabase) << Q_FUNC_INFO << "Read" << rows.size() << "rows for table" << tableName << "from snapshot";
+         succeeded = true;
+      }
+   }
+
+   // Once everything has been read, there's no point keeping the file mapped
+   if (this->pimpl->tableIndex.isEmpty()) {
+      qCDebug(lcDatabase) << Q_FUNC_INFO << "All tables read from snapshot";
+      this->pimpl->unmap();
+   }
+
+   return succeeded;
+}
+
+void ObjectStoreSnapshot::close() {
+   QMutexLocker locker(&this->pimpl->mutex);
+   this->pimpl->unmap();
+   return;
+}
+
+void ObjectStoreSnapshot::addTable(BtStringConst const & tableName, QStringList const & columnNames, Rows const & rows) {
+   QMutexLocker locker(&this->pimpl->mutex);
+
+   PendingTable pendingTable;
+   pendingTable.tableName   = *tableName;
+   pendingTable.columnNames = columnNames;
+   pendingTable.numRows     = static_cast<quint32>(rows.size());
+
+   QDataStream outputStream{&pendingTable.rowData, QIODevice::WriteOnly};
+   outputStream.setVersion(snapshotStreamVersion);
+   for (auto const & row : rows) {
+      // It's a coding error if the row doesn't match the columns
+      Q_ASSERT(row.size() == columnNames.size());
+      for (auto const & value : row) {
+         outputStream << value;
+      }
+   }
+
+   this->pimpl->pendingTables.append(pendingTable);
+   return;
+}
+
+bool ObjectStoreSnapshot::write(QString const & snapshotFilePath, QFileInfo const & dbFileInfo, int schemaVersion) {
+   QMutexLocker locker(&this->pimpl->mutex);
+
+   // If we are still mapping the old snapshot, we need to let go of it before we can replace it
+   this->pimpl->unmap();
+
+   //
+   // QSaveFile writes to a temporary file and only replaces the real one on commit(), so we should never leave a
+   // half-written snapshot lying around
+   //
+   QSaveFile saveFile{snapshotFilePath};
+   if (!saveFile.open(QIODevice::WriteOnly)) {
+      qWarning() <<
+         Q_FUNC_INFO << "Unable to open" << snapshotFilePath << "for writing:" << saveFile.errorString();
+      this->pimpl->pendingTables.clear();
+      return false;
+   }
+
+   QDataStream outputStream{&saveFile};
+   outputStream.setVersion(snapshotStreamVersion);
+   outputStream <<
+      snapshotMagicNumber <<
+      snapshotFormatVersion <<
+      static_cast<qint32>(schemaVersion) <<
+      modificationStamp(dbFileInfo) <<
+      static_cast<qint64>(dbFileInfo.size()) <<
+      static_cast<quint32>(this->pimpl->pendingTables.size());
+
+   for (auto const & pendingTable : this->pimpl->pendingTables) {
+      outputStream <<
+         pendingTable.tableName <<
+         pendingTable.columnNames <<
+         pendingTable.numRows <<
+         static_cast<quint32>(pendingTable.rowData.size());
+      outputStream.writeRawData(pendingTable.rowData.constData(), pendingTable.rowData.size());
+   }
+
+   int const numTables = this->pimpl->pendingTables.size();
+   this->pimpl->pendingTables.clear();
+
+   if (outputStream.status() != QDataStream::Ok || !saveFile.commit()) {
+      qWarning() << Q_FUNC_INFO << "Error writing snapshot" << snapshotFilePath << ":" << saveFile.errorString();
+      return false;
+   }
+
+   qInfo() << Q_FUNC_INFO << "Wrote" << numTables << "tables to snapshot" << snapshotFilePath;
+   return true;
+}
+
+void ObjectStoreSnapshot::discardPendingWrite() {
+   QMutexLocker locker(&this->pimpl->mutex);
+   this->pimpl->pendingTables.clear();
+   return;
+}
+
+void ObjectStoreSnapshot::remove(QString const & snapshotFilePath) {
+   if (QFile::exists(snapshotFilePath) && !QFile::remove(snapshotFilePath)) {
+      qWarning() << Q_FUNC_INFO << "Unable to remove snapshot" << snapshotFilePath;
+   }
+   return;
+}
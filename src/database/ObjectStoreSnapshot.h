@@ -0,0 +1,144 @@
+/*
+ * database/ObjectStoreSnapshot.h is part of Brewtarget, and is copyright the following
+ * authors 2021:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef DATABASE_OBJECTSTORESNAPSHOT_H
+#define DATABASE_OBJECTSTORESNAPSHOT_H
+#pragma once
+
+#include <memory> // For PImpl
+
+#include <QFileInfo>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QVector>
+
+class BtStringConst;
+
+/**
+ * \brief Binary snapshot of the raw contents of all the tables read by \c ObjectStore::loadAll(), so that, on the next
+ *        start-up, we can skip the SQL queries and just read everything straight out of a memory-mapped file.
+ *
+ *        The snapshot is written when we close down cleanly (see \c Database::unload()) and records the modification
+ *        time and size of the SQLite file at that point, together with the schema version.  When we next start up,
+ *        if any of these no longer match (eg because the DB was changed by a session that crashed, or because a
+ *        schema migration ran), the snapshot is ignored and \c ObjectStore falls back to reading from the DB.
+ *        Similarly, each table in the snapshot records its column names so that a change to a table definition in
+ *        the code (without a corresponding schema version bump) does not result in us reading garbage.
+ *
+ *        The rows stored are exactly what came out of the DB (ie before enum conversion etc), so the snapshot and SQL
+ *        paths of \c ObjectStore::loadAll() share all the logic for turning rows into objects.
+ *
+ *        Each table can be read only once.  When all tables have been read, the file is unmapped.
+ *
+ *        We only do this for SQLite.  For PostgreSQL, there is no cheap way to know whether the DB has been modified
+ *        (eg by another client) since we last closed down.
+ */
+class ObjectStoreSnapshot {
+public:
+   /**
+    * \brief Rows of raw values, in the same order as the column names supplied with them
+    */
+   typedef QVector<QVector<QVariant> > Rows;
+
+   /**
+    * \brief There is only one snapshot file, so this is a singleton
+    */
+   static ObjectStoreSnapshot & instance();
+
+   /**
+    * \brief Memory-map and validate the snapshot file.  If anything doesn't check out, the snapshot is closed and
+    *        subsequent calls to \c readTable() will return \c false.
+    *
+    * \param snapshotFilePath
+    * \param dbFileInfo Details of the SQLite file the snapshot was supposedly taken from.  NB: Caller should capture
+    *                   this \b before opening any connection to the DB.
+    * \param schemaVersion The current schema version (ie \c DatabaseSchemaHelper::dbVersion)
+    *
+    * \return \c true if the snapshot is usable, \c false otherwise
+    */
+   bool open(QString const & snapshotFilePath, QFileInfo const & dbFileInfo, int schemaVersion);
+
+   /**
+    * \return \c true if there is a valid snapshot with at least one unread table in it
+    */
+   bool isOpen() const;
+
+   /**
+    * \brief Read all rows for the given table out of the snapshot, if it is there
+    *
+    * \param tableName
+    * \param columnNames The columns, in order, the caller expects each row to contain
+    * \param rows Where to put the results
+    *
+    * \return \c true if the table was read, \c false if the caller needs to go to the DB instead
+    */
+   bool readTable(BtStringConst const & tableName, QStringList const & columnNames, Rows & rows);
+
+   /**
+    * \brief Unmap the snapshot file (if mapped) and forget about any unread tables
+    */
+   void close();
+
+   /**
+    * \brief Add a table to the snapshot we are going to write.  Nothing is written to disk until \c write() is called.
+    */
+   void addTable(BtStringConst const & tableName, QStringList const & columnNames, Rows const & rows);
+
+   /**
+    * \brief Write all tables supplied via \c addTable() to disk, replacing any previous snapshot
+    *
+    * \param snapshotFilePath
+    * \param dbFileInfo Details of the SQLite file.  NB: Caller should capture this \b after closing all connections to
+    *                   the DB, so that it reflects the final state of the file.
+    * \param schemaVersion
+    *
+    * \return \c true if succeeded, \c false otherwise
+    */
+   bool write(QString const & snapshotFilePath, QFileInfo const & dbFileInfo, int schemaVersion);
+
+   /**
+    * \brief Throw away anything supplied via \c addTable() without writing it
+    */
+   void discardPendingWrite();
+
+   /**
+    * \brief Remove the snapshot file, eg because we know it is out of date
+    */
+   static void remove(QString const & snapshotFilePath);
+
+private:
+   // Private implementation details - see https://herbsutter.com/gotw/_100/
+   class impl;
+   std::unique_ptr<impl> pimpl;
+
+   //! Hidden constructor.
+   ObjectStoreSnapshot();
+   //! Destructor hidden.
+   ~ObjectStoreSnapshot();
+   //! No copy constructor, as never want anyone, not even our friends, to make copies of a singleton
+   ObjectStoreSnapshot(ObjectStoreSnapshot const &) = delete;
+   //! No assignment operator , as never want anyone, not even our friends, to make copies of a singleton.
+   ObjectStoreSnapshot & operator=(ObjectStoreSnapshot const &) = delete;
+   //! No move constructor
+   ObjectStoreSnapshot(ObjectStoreSnapshot &&) = delete;
+   //! No move assignment
+   ObjectStoreSnapshot & operator=(ObjectStoreSnapshot &&) = delete;
+};
+
+#endif
@@ -21,6 +21,7 @@
 #include  <mutex> // for std::once_flag
 
 #include "database/DbTransaction.h"
+#include "Logging.h"
 #include "model/BrewNote.h"
 #include "model/Equipment.h"
 #include "model/Fermentable.h"
@@ -50,6 +51,9 @@ namespace {
    //
    template<class NE> ObjectStore::TableDefinition const PRIMARY_TABLE;
    template<class NE> ObjectStore::JunctionTableDefinitions const JUNCTION_TABLES;
+   // Only types with children need to say which properties belong to each use -- see ObjectStore::UseOfPropertyNames.
+   // (For Equipment and Style, everything is shared with the parent.)
+   template<class NE> ObjectStore::UseOfPropertyNames const USE_OF_PROPERTIES{};
 
    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
    // Database field mappings for Equipment
@@ -154,6 +158,11 @@ namespace {
          ObjectStore::MAX_ONE_ENTRY
       }
    };
+   template<> ObjectStore::UseOfPropertyNames const USE_OF_PROPERTIES<Fermentable> {
+      &PropertyNames::Fermentable::addAfterBoil,
+      &PropertyNames::Fermentable::amount_kg,
+      &PropertyNames::Fermentable::isMashed
+   };
 
    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
    // Database field mappings for InventoryHop
@@ -224,6 +233,11 @@ namespace {
          ObjectStore::MAX_ONE_ENTRY
       }
    };
+   template<> ObjectStore::UseOfPropertyNames const USE_OF_PROPERTIES<Hop> {
+      &PropertyNames::Hop::amount_kg,
+      &PropertyNames::Hop::time_min,
+      &PropertyNames::Hop::use
+   };
 
    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
    // Database field mappings for Instruction
@@ -363,6 +377,12 @@ namespace {
          ObjectStore::MAX_ONE_ENTRY
       }
    };
+   template<> ObjectStore::UseOfPropertyNames const USE_OF_PROPERTIES<Misc> {
+      &PropertyNames::Misc::amount,
+      &PropertyNames::Misc::amountIsWeight,
+      &PropertyNames::Misc::time,
+      &PropertyNames::Misc::use
+   };
 
    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
    // Database field mappings for Salt
@@ -478,6 +498,12 @@ namespace {
          ObjectStore::MAX_ONE_ENTRY
       }
    };
+   // The RO dilution is set per Recipe in the water chemistry dialog
+   template<> ObjectStore::UseOfPropertyNames const USE_OF_PROPERTIES<Water> {
+      &PropertyNames::Water::amount,
+      &PropertyNames::Water::mashRO,
+      &PropertyNames::Water::spargeRO
+   };
 
    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
    // Database field mappings for InventoryYeast
@@ -551,6 +577,12 @@ namespace {
          ObjectStore::MAX_ONE_ENTRY
       }
    };
+   template<> ObjectStore::UseOfPropertyNames const USE_OF_PROPERTIES<Yeast> {
+      &PropertyNames::Yeast::addToSecondary,
+      &PropertyNames::Yeast::amount,
+      &PropertyNames::Yeast::amountIsWeight,
+      &PropertyNames::Yeast::timesCultured
+   };
 
    ///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
    // Database field mappings for Recipe
@@ -718,7 +750,9 @@ namespace {
    //
    // This should give us all the singleton instances
    //
-   template<class NE> ObjectStoreTyped<NE> ostSingleton{PRIMARY_TABLE<NE>, JUNCTION_TABLES<NE>};
+   template<class NE> ObjectStoreTyped<NE> ostSingleton{PRIMARY_TABLE<NE>,
+                                                        JUNCTION_TABLES<NE>,
+                                                        USE_OF_PROPERTIES<NE>};
 
 }
 
@@ -754,8 +788,18 @@ template ObjectStoreTyped<Style> &                ObjectStoreTyped<Style>::getIn
 template ObjectStoreTyped<Water> &                ObjectStoreTyped<Water>::getInstance();
 template ObjectStoreTyped<Yeast> &                ObjectStoreTyped<Yeast>::getInstance();
 
+template<class NE>
+std::unique_ptr<ObjectStoreTyped<NE> > ObjectStoreTyped<NE>::createUnshared() {
+   return std::make_unique<ObjectStoreTyped<NE> >(PRIMARY_TABLE<NE>, JUNCTION_TABLES<NE>, USE_OF_PROPERTIES<NE>);
+}
+
+template std::unique_ptr<ObjectStoreTyped<Fermentable> > ObjectStoreTyped<Fermentable>::createUnshared();
+template std::unique_ptr<ObjectStoreTyped<Hop> >         ObjectStoreTyped<Hop>::createUnshared();
+template std::unique_ptr<ObjectStoreTyped<Misc> >        ObjectStoreTyped<Misc>::createUnshared();
+template std::unique_ptr<ObjectStoreTyped<Yeast> >       ObjectStoreTyped<Yeast>::createUnshared();
+
 namespace {
-   QVector<ObjectStore const *> AllObjectStores {
+   QVector<ObjectStore *> AllObjectStores {
       &ostSingleton<BrewNote>,
       &ostSingleton<Equipment>,
       &ostSingleton<Fermentable>,
@@ -777,7 +821,7 @@ namespace {
 }
 
 bool CreateAllDatabaseTables(Database & database, QSqlDatabase & connection) {
-   qDebug() << Q_FUNC_INFO;
+   qCDebug(lcDatabase) << Q_FUNC_INFO;
    for (auto ii : AllObjectStores) {
       if (!ii->createTables(database, connection)) {
          return false;
@@ -791,7 +835,15 @@ bool CreateAllDatabaseTables(Database & database, QSqlDatabase & connection) {
    return true;
 }
 
-bool WriteAllObjectStoresToNewDb(Database & newDatabase, QSqlDatabase & connectionNew) {
+bool WriteAllObjectStoresToNewDb(Database & newDatabase,
+                                 QSqlDatabase & connectionNew,
+                                 std::function<void(int, int)> const & progress) {
+   int totalObjects = 0;
+   for (ObjectStore const * objectStore : AllObjectStores) {
+      totalObjects += objectStore->size();
+   }
+   int objectsWritten = 0;
+
    //
    // Start transaction
    // By the magic of RAII, this will abort if we exit this function (including by throwing an exception) without
@@ -804,6 +856,44 @@ bool WriteAllObjectStoresToNewDb(Database & newDatabase, QSqlDatabase & connecti
       if (!objectStore->writeAllToNewDb(newDatabase, connectionNew)) {
          return false;
       }
+      objectsWritten += objectStore->size();
+      if (progress) {
+         progress(objectsWritten, totalObjects);
+      }
+   }
+   qInfo() << Q_FUNC_INFO << "Wrote" << objectsWritten << "objects to new DB";
+
+   dbTransaction.commit();
+   return true;
+}
+
+void WriteDirtyPropertiesInAllObjectStores(Database const & database) {
+   for (ObjectStore * objectStore : AllObjectStores) {
+      objectStore->writeDirtyProperties(database);
+   }
+   return;
+}
+
+bool ShareParentDataInAllObjectStores(Database & database, QSqlDatabase & connection) {
+   for (ObjectStore const * objectStore : AllObjectStores) {
+      if (!objectStore->shareParentData(database, connection)) {
+         return false;
+      }
+   }
+   return true;
+}
+
+bool AddAllObjectStoresToSnapshot(Database & database, QSqlDatabase & connection) {
+   //
+   // As in ObjectStore::loadAll(), we don't strictly need a transaction to read data, but it does guarantee we get a
+   // consistent view of all the tables.
+   //
+   DbTransaction dbTransaction{database, connection};
+
+   for (ObjectStore const * objectStore : AllObjectStores) {
+      if (!objectStore->addAllToSnapshot(connection)) {
+         return false;
+      }
    }
 
    dbTransaction.commit();
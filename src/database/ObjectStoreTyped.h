@@ -19,11 +19,13 @@
 #ifndef DATABASE_OBJECTSTORETYPED_H
 #define DATABASE_OBJECTSTORETYPED_H
 #pragma once
+#include <functional>
 #include <memory>
 
 #include <QDebug>
 
 #include "database/ObjectStore.h"
+#include "Logging.h"
 #include "model/NamedEntity.h"
 
 /**
@@ -40,8 +42,9 @@ public:
     * \param primaryTable First in the list of fields in this table defn should be the primary key
     */
    ObjectStoreTyped(TableDefinition const & primaryTable,
-                    JunctionTableDefinitions const & junctionTables = JunctionTableDefinitions{}) :
-      ObjectStore(primaryTable, junctionTables) {
+                    JunctionTableDefinitions const & junctionTables = JunctionTableDefinitions{},
+                    UseOfPropertyNames const & useOfPropertyNames = UseOfPropertyNames{}) :
+      ObjectStore(primaryTable, junctionTables, useOfPropertyNames) {
       return;
    }
 
@@ -54,6 +57,14 @@ public:
     */
    static ObjectStoreTyped<NE> & getInstance();
 
+   /**
+    * \brief Create a new store for the same type of object as \c getInstance(), but separate from it.  Nothing else
+    *        knows about the new store, so calling \c loadAll() on it reads a second copy of everything from the DB
+    *        without disturbing the objects the rest of the program is using.  Intended for benchmarking.  (Only
+    *        instantiated for Fermentable, Hop, Misc and Yeast.)
+    */
+   static std::unique_ptr<ObjectStoreTyped<NE> > createUnshared();
+
    /**
     * \brief Insert a new object in the DB (and in our cache list)
     */
@@ -304,7 +315,7 @@ private:
     * \param hard \c true for hard delete, \c false for soft delete
     */
    std::shared_ptr<NE> hardOrSoftDelete(int id, bool hard) {
-      qDebug() <<
+      qCDebug(lcDatabase) <<
          Q_FUNC_INFO << (hard ? "Hard" : "Soft") << "delete " << NE::staticMetaObject.className() << " #" << id;
       if (id <= 0 || !this->contains(id)) {
          // Trying to delete a non-existent object is a coding error, but might be recoverable
@@ -396,8 +407,36 @@ bool CreateAllDatabaseTables(Database & database, QSqlDatabase & connection);
  *
  *        Caller's responsibility to have called \c CreateAllDatabaseTables
  *
+ * \param newDatabase
+ * \param connectionNew
+ * \param progress If set, called after each object store is written, with the number of objects written so far and
+ *                 the total number to write
+ *
+ * \return \c true if succeeded \c false otherwise
+ */
+bool WriteAllObjectStoresToNewDb(Database & newDatabase,
+                                 QSqlDatabase & connectionNew,
+                                 std::function<void(int, int)> const & progress = nullptr);
+
+/**
+ * \brief Call \c ObjectStore::writeDirtyProperties() for all object stores that were loaded from \c database.  Used
+ *        by \c Database::unload() to make sure nothing is left unsaved before the write thread is stopped.
+ */
+void WriteDirtyPropertiesInAllObjectStores(Database const & database);
+
+/**
+ * \brief Call \c ObjectStore::shareParentData() for all object stores.  Caller's responsibility to handle transactions.
+ *
+ * \return \c true if succeeded \c false otherwise
+ */
+bool ShareParentDataInAllObjectStores(Database & database, QSqlDatabase & connection);
+
+/**
+ * \brief Add the contents of all tables used by all object stores to the start-up snapshot.  Caller's responsibility
+ *        to call \c ObjectStoreSnapshot::write() (or \c ObjectStoreSnapshot::discardPendingWrite()) afterwards.
+ *
  * \return \c true if succeeded \c false otherwise
  */
-bool WriteAllObjectStoresToNewDb(Database & newDatabase, QSqlDatabase & connectionNew);
+bool AddAllObjectStoresToSnapshot(Database & database, QSqlDatabase & connection);
 
 #endif
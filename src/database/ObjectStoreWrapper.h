@@ -20,6 +20,7 @@
 #define DATABASE_OBJECTSTOREWRAPPER_H
 #pragma once
 #include "database/ObjectStoreTyped.h"
+#include "Logging.h"
 
 /**
  * \brief Namespace containing convenience functions for accessing member functions of appropriate ObjectStoreTyped
@@ -95,7 +96,7 @@ namespace ObjectStoreWrapper {
       if (id > 0 && objectStore.contains(id)) {
          return objectStore.getById(id);
       }
-      qDebug() <<
+      qCDebug(lcDatabase) <<
          Q_FUNC_INFO << "Creating new shared_ptr for unstored" << ne->metaObject()->className() << ":" << ne->name();
       return std::shared_ptr<NE>{ne};
    }
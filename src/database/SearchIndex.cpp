@@ -0,0 +1,285 @@
+/*
+ * database/SearchIndex.cpp is part of Brewtarget, and is copyright the
+ * following authors 2021:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "database/SearchIndex.h"
+
+#include <algorithm>
+
+#include <QDebug>
+
+#include "database/ObjectStoreTyped.h"
+#include "Logging.h"
+#include "model/Equipment.h"
+#include "model/Fermentable.h"
+#include "model/Hop.h"
+#include "model/Misc.h"
+#include "model/Recipe.h"
+#include "model/Style.h"
+#include "model/Water.h"
+#include "model/Yeast.h"
+
+namespace {
+   int const gramLength = 3;
+
+   /**
+    * \brief All the distinct trigrams in \c text
+    */
+   QSet<QString> gramsOf(QString const & text) {
+      QSet<QString> grams;
+      for (int ii = 0; ii + gramLength <= text.length(); ++ii) {
+         grams.insert(text.mid(ii, gramLength));
+      }
+      return grams;
+   }
+
+   //
+   // What we search on for each type of object, and the names of the corresponding properties
+   //
+   template<class NE> QStringList fieldsOf(NE const & ne);
+   template<class NE> QVector<BtStringConst const *> propertiesOf();
+
+   template<> QStringList fieldsOf<Equipment>(Equipment const & equipment) {
+      return {equipment.name(), equipment.notes()};
+   }
+   template<> QVector<BtStringConst const *> propertiesOf<Equipment>() {
+      return {&PropertyNames::NamedEntity::name, &PropertyNames::Equipment::notes};
+   }
+
+   template<> QStringList fieldsOf<Fermentable>(Fermentable const & fermentable) {
+      return {fermentable.name(), fermentable.notes(), fermentable.origin(), fermentable.supplier()};
+   }
+   template<> QVector<BtStringConst const *> propertiesOf<Fermentable>() {
+      return {&PropertyNames::NamedEntity::name,
+              &PropertyNames::Fermentable::notes,
+              &PropertyNames::Fermentable::origin,
+              &PropertyNames::Fermentable::supplier};
+   }
+
+   template<> QStringList fieldsOf<Hop>(Hop const & hop) {
+      return {hop.name(), hop.notes(), hop.origin(), hop.substitutes()};
+   }
+   template<> QVector<BtStringConst const *> propertiesOf<Hop>() {
+      return {&PropertyNames::NamedEntity::name,
+              &PropertyNames::Hop::notes,
+              &PropertyNames::Hop::origin,
+              &PropertyNames::Hop::substitutes};
+   }
+
+   template<> QStringList fieldsOf<Misc>(Misc const & misc) {
+      return {misc.name(), misc.notes(), misc.useFor()};
+   }
+   template<> QVector<BtStringConst const *> propertiesOf<Misc>() {
+      return {&PropertyNames::NamedEntity::name, &PropertyNames::Misc::notes, &PropertyNames::Misc::useFor};
+   }
+
+   // NB: If a style is renamed, recipes using it are not re-indexed until they themselves change
+   template<> QStringList fieldsOf<Recipe>(Recipe const & recipe) {
+      Style const * style = recipe.style();
+      return {recipe.name(), recipe.notes(), recipe.tasteNotes(), style ? style->name() : QString{}};
+   }
+   template<> QVector<BtStringConst const *> propertiesOf<Recipe>() {
+      return {&PropertyNames::NamedEntity::name,
+              &PropertyNames::Recipe::notes,
+              &PropertyNames::Recipe::tasteNotes,
+              &PropertyNames::Recipe::style,
+              &PropertyNames::Recipe::styleId};
+   }
+
+   template<> QStringList fieldsOf<Style>(Style const & style) {
+      return {style.name(), style.category(), style.styleGuide(), style.notes()};
+   }
+   template<> QVector<BtStringConst const *> propertiesOf<Style>() {
+      return {&PropertyNames::NamedEntity::name,
+              &PropertyNames::Style::category,
+              &PropertyNames::Style::styleGuide,
+              &PropertyNames::Style::notes};
+   }
+
+   template<> QStringList fieldsOf<Water>(Water const & water) {
+      return {water.name(), water.notes()};
+   }
+   template<> QVector<BtStringConst const *> propertiesOf<Water>() {
+      return {&PropertyNames::NamedEntity::name, &PropertyNames::Water::notes};
+   }
+
+   template<> QStringList fieldsOf<Yeast>(Yeast const & yeast) {
+      return {yeast.name(), yeast.notes(), yeast.laboratory(), yeast.productID(), yeast.bestFor()};
+   }
+   template<> QVector<BtStringConst const *> propertiesOf<Yeast>() {
+      return {&PropertyNames::NamedEntity::name,
+              &PropertyNames::Yeast::notes,
+              &PropertyNames::Yeast::laboratory,
+              &PropertyNames::Yeast::productID,
+              &PropertyNames::Yeast::bestFor};
+   }
+}
+
+SearchIndex::SearchIndex(ObjectStore const & objectStore,
+                         std::function<QStringList(QObject const &)> fieldsOf,
+                         QVector<BtStringConst const *> indexedProperties) : QObject{},
+                                                                             objectStore{objectStore},
+                                                                             fieldsOf{fieldsOf},
+                                                                             indexedProperties{indexedProperties},
+                                                                             texts{},
+                                                                             postings{},
+                                                                             currentGeneration{1} {
+   for (auto object : this->objectStore.getAll()) {
+      this->add(object->property(*PropertyNames::NamedEntity::key).toInt());
+   }
+   qCDebug(lcDatabase) << Q_FUNC_INFO << "Indexed" << this->texts.size() << "objects (" << this->postings.size() << "trigrams)";
+
+   connect(&this->objectStore, &ObjectStore::signalObjectInserted,  this, &SearchIndex::objectInserted);
+   connect(&this->objectStore, &ObjectStore::signalObjectDeleted,   this, &SearchIndex::objectDeleted);
+   connect(&this->objectStore, &ObjectStore::signalPropertyChanged, this, &SearchIndex::propertyChanged);
+   return;
+}
+
+SearchIndex::~SearchIndex() = default;
+
+template<class NE>
+SearchIndex & SearchIndex::getInstance() {
+   // C++11 guarantees this is initialised exactly once, even if we're called from more than one thread
+   static SearchIndex singleton{
+      ObjectStoreTyped<NE>::getInstance(),
+      [](QObject const & object) { return fieldsOf<NE>(static_cast<NE const &>(object)); },
+      propertiesOf<NE>()
+   };
+   return singleton;
+}
+
+// We have to make sure that each version of the above function gets instantiated
+template SearchIndex & SearchIndex::getInstance<Equipment>();
+template SearchIndex & SearchIndex::getInstance<Fermentable>();
+template SearchIndex & SearchIndex::getInstance<Hop>();
+template SearchIndex & SearchIndex::getInstance<Misc>();
+template SearchIndex & SearchIndex::getInstance<Recipe>();
+template SearchIndex & SearchIndex::getInstance<Style>();
+template SearchIndex & SearchIndex::getInstance<Water>();
+template SearchIndex & SearchIndex::getInstance<Yeast>();
+
+QSet<int> SearchIndex::search(QString const & searchText) const {
+   QString const needle = searchText.toCaseFolded();
+   QSet<int> results;
+
+   if (needle.length() < gramLength) {
+      for (auto ii = this->texts.cbegin(); ii != this->texts.cend(); ++ii) {
+         if (ii.value().contains(needle)) {
+            results.insert(ii.key());
+         }
+      }
+      return results;
+   }
+
+   // Start with the rarest trigram so that the candidate set is as small as possible from the outset
+   QVector<QSet<int> const *> candidateSets;
+   for (auto const & gram : gramsOf(needle)) {
+      auto posting = this->postings.find(gram);
+      if (posting == this->postings.cend()) {
+         return results;
+      }
+      candidateSets.append(&posting.value());
+   }
+   std::sort(candidateSets.begin(),
+             candidateSets.end(),
+             [](QSet<int> const * lhs, QSet<int> const * rhs) { return lhs->size() < rhs->size(); });
+
+   for (int const id : *candidateSets.first()) {
+      bool inAll = std::all_of(candidateSets.cbegin() + 1,
+                               candidateSets.cend(),
+                               [id](QSet<int> const * candidates) { return candidates->contains(id); });
+      // Having all the trigrams doesn't guarantee they're in the right order, so we still need to check the text
+      if (inAll && this->texts.value(id).contains(needle)) {
+         results.insert(id);
+      }
+   }
+   return results;
+}
+
+unsigned int SearchIndex::generation() const {
+   return this->currentGeneration;
+}
+
+int SearchIndex::size() const {
+   return this->texts.size();
+}
+
+void SearchIndex::objectInserted(int id) {
+   this->add(id);
+   return;
+}
+
+void SearchIndex::objectDeleted(int id, std::shared_ptr<QObject> object) {
+   Q_UNUSED(object)
+   this->remove(id);
+   return;
+}
+
+void SearchIndex::propertyChanged(int id, BtStringConst const & propertyName) {
+   bool indexed = std::any_of(this->indexedProperties.cbegin(),
+                              this->indexedProperties.cend(),
+                              [&propertyName](BtStringConst const * property) { return *property == propertyName; });
+   if (indexed) {
+      this->add(id);
+   }
+   return;
+}
+
+void SearchIndex::add(int id) {
+   auto object = this->objectStore.getById(id);
+   if (!object) {
+      qWarning() << Q_FUNC_INFO << "No object with ID" << id;
+      return;
+   }
+
+   // Fields are joined with newlines so that a search string can't match across the end of one field and the start
+   // of the next
+   QString text = this->fieldsOf(*object).join('\n').toCaseFolded();
+   if (this->texts.contains(id)) {
+      if (this->texts.value(id) == text) {
+         return;
+      }
+      this->remove(id);
+   }
+
+   for (auto const & gram : gramsOf(text)) {
+      this->postings[gram].insert(id);
+   }
+   this->texts.insert(id, text);
+   ++this->currentGeneration;
+   return;
+}
+
+void SearchIndex::remove(int id) {
+   auto text = this->texts.find(id);
+   if (text == this->texts.end()) {
+      return;
+   }
+
+   for (auto const & gram : gramsOf(text.value())) {
+      auto posting = this->postings.find(gram);
+      if (posting != this->postings.end()) {
+         posting->remove(id);
+         if (posting->isEmpty()) {
+            this->postings.erase(posting);
+         }
+      }
+   }
+   this->texts.erase(text);
+   ++this->currentGeneration;
+   return;
+}
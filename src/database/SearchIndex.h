@@ -0,0 +1,148 @@
+/*
+ * database/SearchIndex.h is part of Brewtarget, and is copyright the
+ * following authors 2021:
+ *   • Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef DATABASE_SEARCHINDEX_H
+#define DATABASE_SEARCHINDEX_H
+#pragma once
+
+#include <functional>
+#include <memory>
+
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "utils/BtStringConst.h"
+
+class ObjectStore;
+
+/**
+ * \class SearchIndex
+ *
+ * \brief Trigram index over the searchable text (name, notes, origin, supplier, etc) of every object in one
+ *        \c ObjectStore, so that search-as-you-type does not have to scan every row of a table model.
+ *
+ *        For each object we store the searchable fields, case-folded and joined with newlines, and for every distinct
+ *        three-character sequence ("trigram") in that text we store the set of object IDs containing it.  To search,
+ *        we intersect the ID sets for the trigrams of the search string, starting with the smallest, and then check
+ *        each remaining candidate actually contains the search string.  Searches of fewer than three characters can't
+ *        use the trigrams, so just check every object's text.
+ *
+ *        The index is kept up to date from the \c ObjectStore signals for insert, delete and property change.  (For
+ *        the last, we only re-index if the property is one we search on.)  Every change bumps \c generation(), so
+ *        callers holding on to search results can tell when they need to search again.
+ *
+ *        Use \c getInstance<NE>() to get the index for a particular type of object.  Only intended for use from the
+ *        GUI thread.
+ */
+class SearchIndex : public QObject {
+   Q_OBJECT
+
+public:
+   /**
+    * \param objectStore the store whose objects we index
+    * \param fieldsOf returns the searchable text of an object from \c objectStore
+    * \param indexedProperties names of the properties whose values are returned by \c fieldsOf
+    */
+   SearchIndex(ObjectStore const & objectStore,
+               std::function<QStringList(QObject const &)> fieldsOf,
+               QVector<BtStringConst const *> indexedProperties);
+   virtual ~SearchIndex();
+
+   /**
+    * \brief Get the index for objects of type \c NE, creating it on first use.  Valid for \c Equipment,
+    *        \c Fermentable, \c Hop, \c Misc, \c Recipe, \c Style, \c Water and \c Yeast.
+    */
+   template<class NE> static SearchIndex & getInstance();
+
+   /**
+    * \brief Returns the IDs of all objects whose searchable text contains \c searchText, ignoring case
+    */
+   QSet<int> search(QString const & searchText) const;
+
+   //! \brief Incremented every time the index changes
+   unsigned int generation() const;
+
+   //! \brief Number of objects in the index
+   int size() const;
+
+public slots:
+   void objectInserted(int id);
+   void objectDeleted(int id, std::shared_ptr<QObject> object);
+   void propertyChanged(int id, BtStringConst const & propertyName);
+
+private:
+   void add(int id);
+   void remove(int id);
+
+   ObjectStore const & objectStore;
+   std::function<QStringList(QObject const &)> fieldsOf;
+   QVector<BtStringConst const *> indexedProperties;
+   //! Object ID -> case-folded searchable text
+   QHash<int, QString> texts;
+   //! Trigram -> IDs of objects whose text contains it
+   QHash<QString, QSet<int> > postings;
+   unsigned int currentGeneration;
+};
+
+/**
+ * \class SearchFilter
+ *
+ * \brief Holds the current search string for a filter proxy model and remembers the results of searching for it in
+ *        \c SearchIndex::getInstance<NE>() until the index changes.
+ */
+template<class NE>
+class SearchFilter {
+public:
+   SearchFilter() : text{}, results{}, resultsGeneration{0} {
+      return;
+   }
+
+   void setText(QString const & searchText) {
+      this->text = searchText;
+      this->resultsGeneration = 0;
+      return;
+   }
+
+   //! \brief Returns \c false if there is no search string, in which case everything matches
+   bool isActive() const {
+      return !this->text.isEmpty();
+   }
+
+   bool matches(NE const & ne) const {
+      if (!this->isActive()) {
+         return true;
+      }
+      SearchIndex const & index = SearchIndex::getInstance<NE>();
+      if (this->resultsGeneration != index.generation()) {
+         this->results = index.search(this->text);
+         this->resultsGeneration = index.generation();
+      }
+      return this->results.contains(ne.key());
+   }
+
+private:
+   QString text;
+   mutable QSet<int> results;
+   mutable unsigned int resultsGeneration;
+};
+
+#endif
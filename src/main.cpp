@@ -32,10 +32,14 @@
 #include "brewtarget.h"
 #include "config.h"
 #include "database/Database.h"
+#include "database/DatabaseGenerator.h"
 #include "PersistentSettings.h"
+#include "utils/StartupProfile.h"
+#include "utils/Tracing.h"
 
 void importFromXml(const QString & filename);
 void createBlankDb(const QString & filename);
+void generateDb(const QString & parameters);
 
 int main(int argc, char **argv) {
    QGuiApplication::setAttribute(Qt::AA_EnableHighDpiScaling, true);
@@ -81,23 +85,66 @@ int main(int argc, char **argv) {
     */
    QCommandLineOption const userDirectoryOption("user-dir", "Override the user data directory used by the application with <directory>", "directory", QString());
    parser.addOption(userDirectoryOption);
+   /*!
+    * \brief Records how long startup, import, recalculation etc take, and writes the results to <file> on exit in Chrome
+    *        trace format.  (Can also be turned on with the tracingEnabled setting, in which case the trace is written to
+    *        the log directory.)
+    */
+   QCommandLineOption const traceOption("trace", "Write a Chrome trace of where time is spent to <file> on exit", "file");
+   parser.addOption(traceOption);
+   /*!
+    * \brief Writes a breakdown of how long each phase of startup took, and how many rows were read into each
+    *        ObjectStore, to <file>.  (A summary is always logged at info level.)
+    */
+   QCommandLineOption const startupProfileOption("startup-profile", "Write a breakdown of where startup time is spent to <file>", "file");
+   parser.addOption(startupProfileOption);
+   /*!
+    * \brief Generates a large synthetic database in <directory> for scale testing, then exits.  See
+    *        \c DatabaseGenerator for what --generate-params accepts.
+    */
+   QCommandLineOption const generateDbOption("generate-db", "Generate a synthetic database for scale testing in <directory>", "directory");
+   parser.addOption(generateDbOption);
+   QCommandLineOption const generateParamsOption("generate-params", "Sizes and seed for --generate-db, eg recipes=10000,seed=42", "params");
+   parser.addOption(generateParamsOption);
    parser.addHelpOption();
    parser.addVersionOption();
    parser.process(app);
 
-   //
-   // Having initialised various QApplication settings and read command line options, we can now allow Qt to work out where to get config from
-   //
-   PersistentSettings::initialise(parser.value(userDirectoryOption));
+   StartupProfile::start(parser.value(startupProfileOption));
 
-   //
-   // And once we have config, we can initialise logging
-   //
-   Logging::initializeLogging();
+   if (parser.isSet(generateDbOption)) {
+      // Keep the generator's settings (in particular the user data directory) away from the user's real ones
+      app.setApplicationName(app.applicationName() + "-generate-db");
+   }
+
+   {
+      StartupProfile::Phase const phase{"Settings and logging"};
+      //
+      // Having initialised various QApplication settings and read command line options, we can now allow Qt to work out where to get config from
+      //
+      PersistentSettings::initialise(
+         parser.value(parser.isSet(generateDbOption) ? generateDbOption : userDirectoryOption)
+      );
+      if (parser.isSet(generateDbOption)) {
+         PersistentSettings::insert(PersistentSettings::Names::dbType, Database::SQLITE);
+      }
+
+      //
+      // And once we have config, we can initialise logging
+      //
+      Logging::initializeLogging();
+   }
+
+   if (parser.isSet(traceOption)) {
+      Tracing::start(parser.value(traceOption));
+   } else if (PersistentSettings::value(PersistentSettings::Names::tracingEnabled, false).toBool()) {
+      Tracing::start(Logging::getDirectory().filePath("brewtarget-trace.json"));
+   }
 
    // Initialize Xerces XML tools
    // NB: This is also where where we would initialise xalanc::XalanTransformer if we were using it
    try {
+      StartupProfile::Phase const phase{"Xerces initialisation"};
       xercesc::XMLPlatformUtils::Initialize();
    } catch (xercesc::XMLException const & xercesInitException) {
       qCritical() << Q_FUNC_INFO << "Xerces XML Parser Initialisation Failed: " << xercesInitException.getMessage();
@@ -149,11 +196,14 @@ int main(int argc, char **argv) {
 
    if (parser.isSet(importFromXmlOption)) importFromXml(parser.value(importFromXmlOption));
    if (parser.isSet(createBlankDBOption)) createBlankDb(parser.value(createBlankDBOption));
+   if (parser.isSet(generateDbOption)) generateDb(parser.value(generateParamsOption));
 
    try
    {
       auto mainAppReturnValue = Brewtarget::run();
 
+      Tracing::stop();
+
       //
       // Clean exit of Xerces XML tools
       // If we, in future, want to use XalanTransformer, this needs to be extended to:
@@ -211,3 +261,17 @@ void createBlankDb(const QString & filename) {
     Database::instance().createBlank(filename);
     exit(0);
 }
+
+//! \brief Generates a synthetic database in the user data directory (which main() has set to the --generate-db one).
+void generateDb(const QString & parameters) {
+   QString userMessage;
+   QTextStream userMessageAsStream{&userMessage};
+   DatabaseGenerator::Parameters generatorParameters;
+   if (!DatabaseGenerator::parseParameters(parameters, generatorParameters, userMessageAsStream) ||
+       !DatabaseGenerator::generate(generatorParameters, userMessageAsStream)) {
+      qCritical() << "Unable to generate database:" << userMessage;
+      exit(1);
+   }
+   qInfo() << userMessage;
+   exit(0);
+}
@@ -479,10 +479,14 @@ void BrewNote::setBoilOff_l(double var) {
    this->setAndNotify(PropertyNames::BrewNote::boilOff_l, this->m_boilOff_l, var);
 }
 
-void BrewNote::setRecipeId(int recipeId) { this->m_recipeId = recipeId; }
+void BrewNote::setRecipeId(int recipeId) {
+   this->m_recipeId = recipeId;
+   this->markPropertyDirty(PropertyNames::BrewNote::recipeId);
+   return;
+}
 void BrewNote::setRecipe(Recipe * recipe) {
    Q_ASSERT(nullptr != recipe);
-   this->m_recipeId = recipe->key();
+   this->setRecipeId(recipe->key());
    return;
 }
 
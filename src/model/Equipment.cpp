@@ -294,5 +294,5 @@ double Equipment::wortEndOfBoil_l( double kettleWort_l ) const {
 // Although it's a similar one-liner implementation for many subclasses of NamedEntity, we can't push the
 // implementation of this down to the base class, as Recipe::uses() is templated and won't work with type erasure.
 Recipe * Equipment::getOwningRecipe() {
-   return ObjectStoreWrapper::findFirstMatching<Recipe>( [this](Recipe * rec) {return rec->uses(*this);} );
+   return RecipeHelper::findOwningRecipe(*this);
 }
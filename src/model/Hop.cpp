@@ -27,6 +27,7 @@
 
 #include "brewtarget.h"
 #include "database/ObjectStoreWrapper.h"
+#include "Logging.h"
 #include "model/Inventory.h"
 #include "model/NamedParameterBundle.h"
 #include "model/Recipe.h"
@@ -121,7 +122,7 @@ Hop::Hop(Hop const & other) :
 }
 
 Hop::~Hop() {
-//   qDebug() << Q_FUNC_INFO << "Destructor for Hop #" << this->key();
+//   qCDebug(lcModel) << Q_FUNC_INFO << "Destructor for Hop #" << this->key();
    return;
 }
 
@@ -250,5 +251,5 @@ const QString Hop::formStringTr() const
 }
 
 Recipe * Hop::getOwningRecipe() {
-   return ObjectStoreWrapper::findFirstMatching<Recipe>( [this](Recipe * rec) {return rec->uses(*this);} );
+   return RecipeHelper::findOwningRecipe(*this);
 }
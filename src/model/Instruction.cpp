@@ -173,5 +173,5 @@ int Instruction::instructionNumber() const {
 }
 
 Recipe * Instruction::getOwningRecipe() {
-   return ObjectStoreWrapper::findFirstMatching<Recipe>( [this](Recipe * rec) {return rec->uses(*this);} );
+   return RecipeHelper::findOwningRecipe(*this);
 }
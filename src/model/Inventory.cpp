@@ -19,6 +19,7 @@
 #include "model/Inventory.h"
 
 #include "database/ObjectStoreWrapper.h"
+#include "Logging.h"
 #include "model/Fermentable.h"
 #include "model/Hop.h"
 #include "model/Misc.h"
@@ -141,7 +142,7 @@ void Inventory::setDisplay(bool var) {
 }
 
 void Inventory::hardDeleteOwnedEntities() {
-   qDebug() << Q_FUNC_INFO << this->metaObject()->className() << "owns no other entities";
+   qCDebug(lcModel) << Q_FUNC_INFO << this->metaObject()->className() << "owns no other entities";
    return;
 }
 
@@ -183,13 +184,13 @@ void InventoryUtils::setAmount(Ing & ing, double amount) {
    if (ing.key() > 0) {
       // The ingredient has a valid ID, so it's meaningful to look for its parent, children, siblings
       QVector<int> idsOfParentIngredientAndItsChildren = ing.getParentAndChildrenIds();
-      qDebug() <<
+      qCDebug(lcModel) <<
          Q_FUNC_INFO << ing.metaObject()->className() << "#" << ing.key() << "has" <<
          idsOfParentIngredientAndItsChildren.size() - 1 << "parents, children and siblings : " <<
          idsOfParentIngredientAndItsChildren;
       auto parentIngredientAndItsChildren = ObjectStoreWrapper::getByIds<Ing>(idsOfParentIngredientAndItsChildren);
       for (auto ii : parentIngredientAndItsChildren) {
-         qDebug() <<
+         qCDebug(lcModel) <<
             Q_FUNC_INFO << "Assigning new" << inventory->metaObject()->className() << "#" << inventory->getId() <<
             "to" << ing.metaObject()->className() << "#" << ii->key();
          ii->setInventoryId(inventory->getId());
@@ -27,6 +27,7 @@
 
 #include "brewtarget.h"
 #include "database/ObjectStoreWrapper.h"
+#include "Logging.h"
 #include "model/MashStep.h"
 #include "model/NamedParameterBundle.h"
 #include "model/Recipe.h"
@@ -222,7 +223,7 @@ void Mash::swapMashSteps(MashStep & ms1, MashStep & ms2) {
 
    this->pimpl->setCanonicalMashStepNumbers();
 
-   qDebug() <<
+   qCDebug(lcModel) <<
       Q_FUNC_INFO << "Swapping steps" << ms1.stepNumber() << "(#" << ms1.key() << ") and " << ms2.stepNumber() <<
       " (#" << ms2.key() << ")";
 
@@ -250,6 +251,10 @@ void Mash::swapMashSteps(MashStep & ms1, MashStep & ms2) {
 
 
 void Mash::removeAllMashSteps() {
+   if (this->key() > 0) {
+      // As in Mash::addMashStep(), previous versions of our Recipe that share us need to keep their steps
+      this->prepareForPropertyChange(PropertyNames::Mash::mashSteps);
+   }
    for (auto ms : this->mashSteps()) {
       ObjectStoreWrapper::softDelete(*ms);
    }
@@ -393,7 +398,9 @@ void Mash::acceptMashStepChange(QMetaProperty prop, QVariant /*val*/) {
 
 std::shared_ptr<MashStep> Mash::addMashStep(std::shared_ptr<MashStep> mashStep) {
    if (this->key() > 0) {
-      qDebug() << Q_FUNC_INFO << "Add MashStep #" << mashStep->key() << "to Mash #" << this->key();
+      // We might be shared with previous versions of our Recipe, which shouldn't get the new step
+      this->prepareForPropertyChange(PropertyNames::Mash::mashSteps);
+      qCDebug(lcModel) << Q_FUNC_INFO << "Add MashStep #" << mashStep->key() << "to Mash #" << this->key();
       mashStep->setMashId(this->key());
    }
 
@@ -401,7 +408,7 @@ std::shared_ptr<MashStep> Mash::addMashStep(std::shared_ptr<MashStep> mashStep)
 
    // MashStep needs to be in the DB for us to add it to the Mash
    if (mashStep->key() < 0) {
-      qDebug() << Q_FUNC_INFO << "Inserting MashStep in DB for Mash #" << this->key();
+      qCDebug(lcModel) << Q_FUNC_INFO << "Inserting MashStep in DB for Mash #" << this->key();
       ObjectStoreWrapper::insert(mashStep);
    }
 
@@ -415,7 +422,7 @@ std::shared_ptr<MashStep> Mash::addMashStep(std::shared_ptr<MashStep> mashStep)
    // any time by just asking the relevant ObjectStore for all MashSteps with Mash ID the same as ours.)
    //
    if (this->key() < 0) {
-      qDebug() << Q_FUNC_INFO << "Adding MashStep #" << mashStep->key() << "to Mash #" << this->key();
+      qCDebug(lcModel) << Q_FUNC_INFO << "Adding MashStep #" << mashStep->key() << "to Mash #" << this->key();
       this->pimpl->mashStepIds.append(mashStep->key());
    }
 
@@ -423,6 +430,12 @@ std::shared_ptr<MashStep> Mash::addMashStep(std::shared_ptr<MashStep> mashStep)
 }
 
 std::shared_ptr<MashStep> Mash::removeMashStep(std::shared_ptr<MashStep> mashStep) {
+   if (this->key() > 0) {
+      // As in Mash::addMashStep(), previous versions of our Recipe that share us need to keep the step
+      this->prepareForPropertyChange(PropertyNames::Mash::mashSteps);
+      qCDebug(lcModel) << Q_FUNC_INFO << "Remove MashStep #" << mashStep->key() << "from Mash #" << this->key();
+   }
+
    // Disassociate the MashStep from this Mash
    mashStep->setMashId(-1);
 
@@ -453,7 +466,7 @@ std::shared_ptr<MashStep> Mash::removeMashStep(std::shared_ptr<MashStep> mashSte
 }
 
 Recipe * Mash::getOwningRecipe() {
-   return ObjectStoreWrapper::findFirstMatching<Recipe>( [this](Recipe * rec) {return rec->uses(*this);} );
+   return RecipeHelper::findOwningRecipe(*this);
 }
 
 void Mash::hardDeleteOwnedEntities() {
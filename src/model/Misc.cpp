@@ -218,5 +218,5 @@ bool Misc::isValidType( const QString& var )
 }
 
 Recipe * Misc::getOwningRecipe() {
-   return ObjectStoreWrapper::findFirstMatching<Recipe>( [this](Recipe * rec) {return rec->uses(*this);} );
+   return RecipeHelper::findOwningRecipe(*this);
 }
@@ -28,6 +28,7 @@
 
 #include "brewtarget.h"
 #include "database/ObjectStore.h"
+#include "Logging.h"
 #include "model/NamedParameterBundle.h"
 #include "model/Recipe.h"
 
@@ -139,7 +140,7 @@ bool NamedEntity::operator==(NamedEntity const & other) const {
    // The first thing to do is check we are even comparing two objects of the same class.  A Hop is never equal to
    // a Recipe etc.
    if (typeid(*this) != typeid(other)) {
-//      qDebug() << Q_FUNC_INFO << "No type id match (" << typeid(*this).name() << "/" << typeid(other).name() << ")";
+//      qCDebug(lcModel) << Q_FUNC_INFO << "No type id match (" << typeid(*this).name() << "/" << typeid(other).name() << ")";
       return false;
    }
 
@@ -150,7 +151,7 @@ bool NamedEntity::operator==(NamedEntity const & other) const {
    // m_deleted as they are more related to the UI than whether, in essence, two objects are the same.
    //
    if (this->m_name != other.m_name) {
-//      qDebug() << Q_FUNC_INFO << "No name match (" << this->m_name << "/" << other.m_name << ")";
+//      qCDebug(lcModel) << Q_FUNC_INFO << "No name match (" << this->m_name << "/" << other.m_name << ")";
       //
       // If the names don't match, let's check it's not for a trivial reason.  Eg, if you have one Hop called
       // "Tettnang" and another called "Tettnang (1)" we wouldn't say they are different just because of the names.
@@ -165,7 +166,7 @@ bool NamedEntity::operator==(NamedEntity const & other) const {
             names[ii].truncate(positionOfMatch);
          }
       }
-//      qDebug() << Q_FUNC_INFO << "Adjusted names to " << names[0] << " & " << names[1];
+//      qCDebug(lcModel) << Q_FUNC_INFO << "Adjusted names to " << names[0] << " & " << names[1];
       if (names[0] != names[1]) {
          return false;
       }
@@ -254,6 +255,7 @@ bool NamedEntity::cacheOnly() const {
 
 void NamedEntity::setParentKey(int parentKey) {
    this->parentKey = parentKey;
+   this->markPropertyDirty(PropertyNames::NamedEntity::parentKey);
 
    //
    // If the data is obviously messed up then let's at least log it.  (It doesn't necessarily mean there is a bug in
@@ -353,6 +355,14 @@ void NamedEntity::propagatePropertyChange(BtStringConst const & propertyName, bo
    return;
 }
 
+void NamedEntity::markPropertyDirty(BtStringConst const & propertyName) const {
+   // Nothing to track if we're not yet stored, as the whole object gets written when it is
+   if (this->m_key > 0) {
+      this->getObjectStoreTypedInstance().markDirty(*this, propertyName);
+   }
+   return;
+}
+
 NamedEntity * NamedEntity::getParent() const {
    if (this->parentKey <= 0) {
       return nullptr;
@@ -368,13 +378,13 @@ void NamedEntity::setParent(NamedEntity const & parentNamedEntity) {
 
 void NamedEntity::hardDeleteOwnedEntities() {
    // If we are not overridden in the subclass then there is no work to do
-   qDebug() << Q_FUNC_INFO << this->metaObject()->className() << "owns no other entities";
+   qCDebug(lcModel) << Q_FUNC_INFO << this->metaObject()->className() << "owns no other entities";
    return;
 }
 
 void NamedEntity::hardDeleteOrphanedEntities() {
    // If we are not overridden in the subclass then there is no work to do
-   qDebug() << Q_FUNC_INFO << this->metaObject()->className() << "leaves no other entities as orphans";
+   qCDebug(lcModel) << Q_FUNC_INFO << this->metaObject()->className() << "leaves no other entities as orphans";
    return;
 }
 
@@ -384,7 +394,7 @@ void NamedEntity::hardDeleteOrphanedEntities() {
 NamedEntityModifyingMarker::NamedEntityModifyingMarker(NamedEntity & namedEntity) :
    namedEntity{namedEntity},
    savedModificationState{namedEntity.isBeingModified()} {
-   qDebug() <<
+   qCDebug(lcModel) <<
       Q_FUNC_INFO << "Marking" << this->namedEntity.metaObject()->className() << "#" << this->namedEntity.key() <<
       "as being modified (" << (this->savedModificationState ? "no change" : "previously was not") << ")";
    this->namedEntity.setBeingModified(true);
@@ -392,7 +402,7 @@ NamedEntityModifyingMarker::NamedEntityModifyingMarker(NamedEntity & namedEntity
 }
 
 NamedEntityModifyingMarker::~NamedEntityModifyingMarker() {
-   qDebug() <<
+   qCDebug(lcModel) <<
       Q_FUNC_INFO << "Restoring" << this->namedEntity.metaObject()->className() << "#" << this->namedEntity.key() <<
       "\"being modified\" state to" << (this->savedModificationState ? "on" : "off");
    this->namedEntity.setBeingModified(this->savedModificationState);
@@ -34,6 +34,7 @@
 #include <QVariant>
 
 #include "brewtarget.h"
+#include "Logging.h"
 #include "utils/BtStringConst.h"
 
 class NamedParameterBundle;
@@ -347,6 +348,13 @@ protected:
     */
    void propagatePropertyChange(BtStringConst const & propertyName, bool notify = true) const;
 
+   /**
+    * \brief For setters that change stored data \b without propagating the change straight to the database (eg the
+    *        setters for lists of IDs held in junction tables, which are also used when reading from the database).
+    *        Records the change with the object store so that the next \c ObjectStore::update() will write it.
+    */
+   void markPropertyDirty(BtStringConst const & propertyName) const;
+
 
    /**
     * \brief Convenience function to check for the set being a no-op. (Sometimes the UI will call all setters, even on
@@ -359,7 +367,7 @@ protected:
                                 T & memberVariable,
                                 T const newValue) {
       if (newValue == memberVariable) {
-         qDebug() <<
+         qCDebug(lcModel) <<
             Q_FUNC_INFO << this->metaObject()->className() << "#" << this->key() << ": ignoring call to setter for" <<
             propertyName << "as value not changing";
          return true;
@@ -21,6 +21,7 @@
  */
 #include "model/Recipe.h"
 
+#include <algorithm>
 #include <cmath> // For pow/log
 
 #include <QDate>
@@ -35,6 +36,7 @@
 #include "database/ObjectStoreWrapper.h"
 #include "HeatCalculations.h"
 #include "IbuMethods.h"
+#include "Logging.h"
 #include "model/Equipment.h"
 #include "model/Fermentable.h"
 #include "model/Hop.h"
@@ -50,6 +52,7 @@
 #include "PersistentSettings.h"
 #include "PhysicalConstants.h"
 #include "PreInstruction.h"
+#include "utils/Tracing.h"
 
 
 namespace {
@@ -64,7 +67,7 @@ namespace {
          return false;
       }
 
-      qDebug() <<
+      qCDebug(lcModel) <<
          Q_FUNC_INFO << var.metaObject()->className() << "#" << var.key() << "has parent #" << parentOfVar->key();
       //
       // Parameter has a parent.  See if it (the parameter, not its parent!) is used in a recipe.
@@ -84,16 +87,15 @@ namespace {
          // we had two completely unrelated shared_ptr objects (one in the object store and one newly created here)
          // pointing to the same address.  We need to get an instance of shared_ptr that's copied from (and thus
          // shares the internal reference count of) the one held by the object store.
-         qDebug() << Q_FUNC_INFO << var.metaObject()->className() << "#" << var.key() << "not used in any recipe";
+         qCDebug(lcModel) << Q_FUNC_INFO << var.metaObject()->className() << "#" << var.key() << "not used in any recipe";
          return true;
       }
 
-      // The var is used in another Recipe.  (We shouldn't really find ourselves in this position, but the way the rest
-      // of the code works means that, even if we do, we should recover OK - or at least not make the situation any
-      // worse.)
-      qWarning() <<
-         Q_FUNC_INFO << var.metaObject()->className() << "#" << var.key() <<
-         "is unexpectedly already used in recipe #" << matchingRecipe->key();
+      // The var is used in another Recipe, typically because it is shared between versions of a Recipe (see
+      // Recipe::CopyMode::SharedVersion)
+      qCDebug(lcModel) <<
+         Q_FUNC_INFO << var.metaObject()->className() << "#" << var.key() << "is also used in recipe #" <<
+         matchingRecipe->key();
       return false;
    }
 
@@ -126,7 +128,7 @@ namespace {
          return ObjectStoreWrapper::getById<NE>(var.key());
       }
 
-      qDebug() << Q_FUNC_INFO << "Making copy of " << var.metaObject()->className() << "#" << var.key();
+      qCDebug(lcModel) << Q_FUNC_INFO << "Making copy of " << var.metaObject()->className() << "#" << var.key();
 
       // We need to make a copy...
       auto copy = std::make_shared<NE>(var);
@@ -172,6 +174,40 @@ namespace {
    template<> BtStringConst const & propertyToPropertyName<Yeast>()       {
       return PropertyNames::Recipe::yeastIds;
    }
+
+   //! Source of values for Recipe::changeStamp()
+   unsigned int lastChangeStamp = 0;
+
+   //
+   // For each type of thing a Recipe uses, how many times each object (by ID) is referenced by a Recipe.  This lets
+   // copy-on-write skip looking through every Recipe for others sharing something in the usual case where nothing is
+   // shared.  Counts are kept up to date by all the places that change Recipe::impl::fermentableIds etc and
+   // Recipe::equipmentId etc.  Because all Recipe objects are counted (not just the ones in the object store), a count
+   // can be higher than the number of stored Recipes using an object, but never lower, which is all we need.
+   //
+   template<class NE> QHash<int, int> & useCounts() {
+      static QHash<int, int> counts;
+      return counts;
+   }
+
+   template<class NE> void countUse(int const id, int const delta) {
+      if (id <= 0) {
+         return;
+      }
+      int & count = useCounts<NE>()[id];
+      count += delta;
+      if (count <= 0) {
+         useCounts<NE>().remove(id);
+      }
+      return;
+   }
+
+   template<class NE> void countUses(QVector<int> const & ids, int const delta) {
+      for (int const id : ids) {
+         countUse<NE>(id, delta);
+      }
+      return;
+   }
 }
 
 
@@ -190,7 +226,12 @@ public:
       miscIds{},
       saltIds{},
       waterIds{},
-      yeastIds{} {
+      yeastIds{},
+      changeStamp{++lastChangeStamp} {
+      // Changes to the Recipe's own properties, and the things we recalculate, all come through the changed() signal.
+      // Changes to contained objects that don't lead to a recalculation are picked up in
+      // acceptChangeToContainedObject().
+      QObject::connect(&recipe, &NamedEntity::changed, &recipe, [this]() { this->markChanged(); });
       return;
    }
 
@@ -199,20 +240,25 @@ public:
     */
    ~impl() = default;
 
+   void markChanged() {
+      this->changeStamp = ++lastChangeStamp;
+      return;
+   }
+
    /**
     * \brief Make copies of the ingredients of a particular type (Hop, Fermentable, etc) from one Recipe and add them
     *        to another - typically because we are copying the Recipe.
     */
    template<class NE> void copyList(Recipe & us, Recipe const & other) {
-      qDebug() << Q_FUNC_INFO;
+      qCDebug(lcModel) << Q_FUNC_INFO;
       for (int otherIngId : other.pimpl->accessIds<NE>()) {
          // Make and store a copy of the current Hop/Fermentable/etc object we're looking at in the other Recipe
          auto otherIngredient = ObjectStoreWrapper::getById<NE>(otherIngId);
          auto ourIngredient = copyIfNeeded(*otherIngredient);
          // Store the ID of the copy in our recipe
-         this->accessIds<NE>().append(ourIngredient->key());
+         this->appendId<NE>(ourIngredient->key());
 
-         qDebug() <<
+         qCDebug(lcModel) <<
             Q_FUNC_INFO << "After adding" << ourIngredient->metaObject()->className() << "#" << ourIngredient->key() <<
             ", Recipe" << us.name() << "has" << this->accessIds<NE>().size() << "of" <<
             NE::staticMetaObject.className();
@@ -225,15 +271,105 @@ public:
       return;
    }
 
+   /**
+    * \brief Share the ingredients of a particular type (Hop, Fermentable, etc) of one Recipe with another - typically
+    *        because we are making a new version of the Recipe.  See \c unshare() for what happens when one of them is
+    *        about to be changed.
+    */
+   template<class NE> void shareList(Recipe & us, Recipe const & other) {
+      this->setIds<NE>(other.pimpl->accessIds<NE>());
+      for (NE * ingredient : this->getAllMyRaw<NE>()) {
+         connect(ingredient, SIGNAL(changed(QMetaProperty, QVariant)), &us,
+                 SLOT(acceptChangeToContainedObject(QMetaProperty, QVariant)));
+      }
+      return;
+   }
+
+   /**
+    * \brief Returns the other Recipes (eg earlier versions of this one) that also use \c ne
+    */
+   template<class NE> QList<Recipe *> otherRecipesUsing(NE const & ne) const {
+      // Usually nothing is shared, in which case there is no need to look at every Recipe to find that out
+      if (useCounts<NE>().value(ne.key()) <= (this->recipe.uses(ne) ? 1 : 0)) {
+         return {};
+      }
+      Recipe const * us = &this->recipe;
+      return ObjectStoreWrapper::findAllMatching<Recipe>(
+         [us, &ne](Recipe * recipe) { return recipe != us && recipe->uses(ne); }
+      );
+   }
+
+   /**
+    * \brief In another Recipe, replace the use of the object with one ID by the object with another ID.
+    *        Specialisations for things a Recipe has only one of are below.
+    */
+   template<class NE> void replaceUse(Recipe & other, int oldId, int newId) {
+      for (int & id : other.pimpl->accessIds<NE>()) {
+         if (id == oldId) {
+            id = newId;
+            countUse<NE>(oldId, -1);
+            countUse<NE>(newId, 1);
+         }
+      }
+      return;
+   }
+
+   /**
+    * \brief Copy-on-write: \c ne, which we use, is about to change, so any other Recipe that also uses it needs to
+    *        switch to an unchanged copy.  One copy is enough however many other Recipes there are, because they are
+    *        all (older) versions sharing the same thing.
+    */
+   template<class NE> void unshare(NE & ne) {
+      QList<Recipe *> otherRecipes = this->otherRecipesUsing(ne);
+      if (otherRecipes.isEmpty()) {
+         return;
+      }
+      qCDebug(lcModel) <<
+         Q_FUNC_INFO << "Giving" << otherRecipes.size() << "other Recipe(s) their own copy of" <<
+         ne.metaObject()->className() << "#" << ne.key() << "before Recipe #" << this->recipe.key() << "changes it";
+
+      // Copying also copies the parent ID (so the copy is also an "instance of use of" the same Hop/Fermentable/etc)
+      // and, in the case of a Mash, its MashSteps
+      auto copy = std::make_shared<NE>(ne);
+      ObjectStoreWrapper::insert(copy);
+      for (Recipe * other : otherRecipes) {
+         this->replaceUse<NE>(*other, ne.key(), copy->key());
+         QObject::disconnect(&ne, nullptr, other, nullptr);
+         connect(copy.get(), SIGNAL(changed(QMetaProperty, QVariant)), other,
+                 SLOT(acceptChangeToContainedObject(QMetaProperty, QVariant)));
+         // The other Recipe hasn't really changed, so we just need to store the new ID, without telling the UI
+         other->propagatePropertyChange(propertyToPropertyName<NE>(), false);
+      }
+      return;
+   }
+
+   //! Helper for \c unshareAll()
+   template<class NE> void unshareAllMy() {
+      for (NE * ingredient : this->getAllMyRaw<NE>()) {
+         this->unshare(*ingredient);
+      }
+      return;
+   }
+
+   /**
+    * \brief Give any other Recipe that shares anything with us its own copy, eg because we are no longer going to be a
+    *        version of the same Recipe.  (Defined after the class because it needs the specialisations of
+    *        \c accessIds() and \c replaceUse().)
+    */
+   void unshareAll();
+
    /**
     * \brief If the Recipe is about to be deleted, we delete all the things that belong to it.  Note that, with the
     *        exception of Instruction, what we are actually deleting here is not the Hops/Fermentables/etc but the "use
-    *        of" Hops/Fermentables/etc records (which are distinguished by having a parent ID.
+    *        of" Hops/Fermentables/etc records (which are distinguished by having a parent ID.  Anything we share with
+    *        another version of the Recipe is left for that version.
     */
    template<class NE> void hardDeleteAllMy() {
-      qDebug() << Q_FUNC_INFO;
-      for (auto id : this->accessIds<NE>()) {
-         ObjectStoreWrapper::hardDelete<NE>(id);
+      qCDebug(lcModel) << Q_FUNC_INFO;
+      for (NE * ingredient : this->getAllMyRaw<NE>()) {
+         if (this->otherRecipesUsing(*ingredient).isEmpty()) {
+            ObjectStoreWrapper::hardDelete<NE>(ingredient->key());
+         }
       }
       return;
    }
@@ -248,6 +384,68 @@ public:
    //
    template<class NE> QVector<int> & accessIds();
 
+   //
+   // All changes to fermentableIds, hopIds, etc go through these so that useCounts() stays correct
+   //
+   template<class NE> void setIds(QVector<int> const & ids) {
+      countUses<NE>(this->accessIds<NE>(), -1);
+      this->accessIds<NE>() = ids;
+      countUses<NE>(ids, 1);
+      return;
+   }
+
+   template<class NE> void appendId(int const id) {
+      this->accessIds<NE>().append(id);
+      countUse<NE>(id, 1);
+      return;
+   }
+
+   template<class NE> void insertId(int const pos, int const id) {
+      this->accessIds<NE>().insert(pos, id);
+      countUse<NE>(id, 1);
+      return;
+   }
+
+   //! \return \c false if \c id was not in the list
+   template<class NE> bool removeId(int const id) {
+      if (!this->accessIds<NE>().removeOne(id)) {
+         return false;
+      }
+      countUse<NE>(id, -1);
+      return true;
+   }
+
+   //
+   // Similarly, for the things a Recipe has only one of, accessId<Equipment>() etc returns a reference to
+   // this->recipe.equipmentId etc, and changes go through setUsedId().  (Specialisations are defined outside the
+   // class.)
+   //
+   template<class NE> int & accessId();
+
+   template<class NE> void setUsedId(int const id) {
+      countUse<NE>(this->accessId<NE>(), -1);
+      this->accessId<NE>() = id;
+      countUse<NE>(id, 1);
+      return;
+   }
+
+   /**
+    * \brief Add (\c delta = 1) or remove (\c delta = -1) all our uses of things to/from the counts in \c useCounts()
+    */
+   void countAllUses(int const delta) {
+      countUses<Fermentable>(this->fermentableIds, delta);
+      countUses<Hop>        (this->hopIds,         delta);
+      countUses<Instruction>(this->instructionIds, delta);
+      countUses<Misc>       (this->miscIds,        delta);
+      countUses<Salt>       (this->saltIds,        delta);
+      countUses<Water>      (this->waterIds,       delta);
+      countUses<Yeast>      (this->yeastIds,       delta);
+      countUse<Equipment>(this->recipe.equipmentId, delta);
+      countUse<Mash>     (this->recipe.mashId,      delta);
+      countUse<Style>    (this->recipe.styleId,     delta);
+      return;
+   }
+
    /**
     * \brief Get raw pointers to all ingredients etc of a particular type (Hop, Fermentable, etc) in this Recipe
     */
@@ -265,6 +463,7 @@ public:
    QVector<int> saltIds;
    QVector<int> waterIds;
    QVector<int> yeastIds;
+   unsigned int changeStamp;
 
 };
 
@@ -276,6 +475,50 @@ template<> QVector<int> & Recipe::impl::accessIds<Salt>()        { return this->
 template<> QVector<int> & Recipe::impl::accessIds<Water>()       { return this->waterIds; }
 template<> QVector<int> & Recipe::impl::accessIds<Yeast>()       { return this->yeastIds; }
 
+template<> int & Recipe::impl::accessId<Equipment>() { return this->recipe.equipmentId; }
+template<> int & Recipe::impl::accessId<Mash>()      { return this->recipe.mashId; }
+template<> int & Recipe::impl::accessId<Style>()     { return this->recipe.styleId; }
+
+template<> void Recipe::impl::replaceUse<Equipment>(Recipe & other, int oldId, int newId) {
+   if (other.equipmentId == oldId) {
+      other.pimpl->setUsedId<Equipment>(newId);
+   }
+   return;
+}
+template<> void Recipe::impl::replaceUse<Mash>(Recipe & other, int oldId, int newId) {
+   if (other.mashId == oldId) {
+      other.pimpl->setUsedId<Mash>(newId);
+   }
+   return;
+}
+template<> void Recipe::impl::replaceUse<Style>(Recipe & other, int oldId, int newId) {
+   if (other.styleId == oldId) {
+      other.pimpl->setUsedId<Style>(newId);
+   }
+   return;
+}
+
+void Recipe::impl::unshareAll() {
+   this->unshareAllMy<Fermentable>();
+   this->unshareAllMy<Hop>        ();
+   this->unshareAllMy<Instruction>();
+   this->unshareAllMy<Misc>       ();
+   this->unshareAllMy<Salt>       ();
+   this->unshareAllMy<Water>      ();
+   this->unshareAllMy<Yeast>      ();
+   // As elsewhere, any of these might not be set
+   if (this->recipe.equipmentId > 0) {
+      this->unshare(*ObjectStoreWrapper::getByIdRaw<Equipment>(this->recipe.equipmentId));
+   }
+   if (this->recipe.mashId > 0) {
+      this->unshare(*ObjectStoreWrapper::getByIdRaw<Mash>(this->recipe.mashId));
+   }
+   if (this->recipe.styleId > 0) {
+      this->unshare(*ObjectStoreWrapper::getByIdRaw<Style>(this->recipe.styleId));
+   }
+   return;
+}
+
 static const QHash<QString, Recipe::Type> RECIPE_TYPE_STRING_TO_TYPE {
    {"Extract",      Recipe::Extract},
    {"Partial Mash", Recipe::PartialMash},
@@ -404,12 +647,14 @@ Recipe::Recipe(NamedParameterBundle const & namedParameterBundle) :
    m_hasDescendants    {false                                                                     } {
    // At this stage, we haven't set any Hops, Fermentables, etc.  This is deliberate because the caller typically needs
    // to access subsidiary records to obtain this info.   Callers will usually use setters (setHopIds, etc but via
-   // setProperty) to finish constructing the object.
+   // setProperty) to finish constructing the object.  Those setters count the uses; here we just need to count the
+   // Equipment, Mash and Style.
+   this->pimpl->countAllUses(1);
    return;
 }
 
 
-Recipe::Recipe(Recipe const & other) :
+Recipe::Recipe(Recipe const & other, CopyMode copyMode) :
    NamedEntity{other},
    pimpl{std::make_unique<impl>(*this)},
    m_type              {other.m_type              },
@@ -450,53 +695,84 @@ Recipe::Recipe(Recipe const & other) :
    m_hasDescendants    {false                     } {
    setObjectName("Recipe"); // .:TBD:. Would be good to understand why we need this
 
+   // At this point, only the Equipment, Mash and Style IDs (copied above) are set.  Everything after this keeps the
+   // counts up to date.
+   this->pimpl->countAllUses(1);
+
    //
    // We don't want to be versioning something while we're still constructing it
    //
    NamedEntityModifyingMarker modifyingMarker(*this);
 
    //
-   // When we make a copy of a Recipe, it needs to be a deep(ish) copy.  In particular, we need to make copies of the
-   // Hops, Fermentables etc as some attributes of the recipe (eg how much and when to add) are stored inside these
-   // ingredients.
+   // A new version of a Recipe starts off sharing everything with the one it was copied from.  Whichever of them is
+   // changed first gets its own copy of the thing being changed (see Recipe::unshare()).
    //
-   // We _don't_ want to copy BrewNotes (an instance of brewing the Recipe).  (This is easy not to do as we don't
-   // currently store BrewNote IDs in Recipe.)
+   // We _don't_ want to share or copy BrewNotes (an instance of brewing the Recipe).  (This is easy not to do as we
+   // don't currently store BrewNote IDs in Recipe.)
    //
-   this->pimpl->copyList<Fermentable>(*this, other);
-   this->pimpl->copyList<Hop> (*this, other);
-   this->pimpl->copyList<Instruction>(*this, other);
-   this->pimpl->copyList<Misc> (*this, other);
-   this->pimpl->copyList<Salt> (*this, other);
-   this->pimpl->copyList<Water> (*this, other);
-   this->pimpl->copyList<Yeast> (*this, other);
+   if (copyMode == CopyMode::SharedVersion) {
+      this->pimpl->shareList<Fermentable>(*this, other);
+      this->pimpl->shareList<Hop>        (*this, other);
+      this->pimpl->shareList<Instruction>(*this, other);
+      this->pimpl->shareList<Misc>       (*this, other);
+      this->pimpl->shareList<Salt>       (*this, other);
+      this->pimpl->shareList<Water>      (*this, other);
+      this->pimpl->shareList<Yeast>      (*this, other);
+      // The Equipment, Mash and Style IDs were already copied above
+      if (this->equipmentId > 0) {
+         connect(ObjectStoreWrapper::getByIdRaw<Equipment>(this->equipmentId), SIGNAL(changed(QMetaProperty, QVariant)),
+                 this, SLOT(acceptChangeToContainedObject(QMetaProperty, QVariant)));
+      }
+      if (this->mashId > 0) {
+         connect(ObjectStoreWrapper::getByIdRaw<Mash>(this->mashId), SIGNAL(changed(QMetaProperty, QVariant)),
+                 this, SLOT(acceptChangeToContainedObject(QMetaProperty, QVariant)));
+      }
+      if (this->styleId > 0) {
+         connect(ObjectStoreWrapper::getByIdRaw<Style>(this->styleId), SIGNAL(changed(QMetaProperty, QVariant)),
+                 this, SLOT(acceptChangeToContainedObject(QMetaProperty, QVariant)));
+      }
+   } else {
+      //
+      // Otherwise, when we make a copy of a Recipe, it needs to be a deep(ish) copy.  In particular, we need to make
+      // copies of the Hops, Fermentables etc as some attributes of the recipe (eg how much and when to add) are stored
+      // inside these ingredients.
+      //
+      this->pimpl->copyList<Fermentable>(*this, other);
+      this->pimpl->copyList<Hop> (*this, other);
+      this->pimpl->copyList<Instruction>(*this, other);
+      this->pimpl->copyList<Misc> (*this, other);
+      this->pimpl->copyList<Salt> (*this, other);
+      this->pimpl->copyList<Water> (*this, other);
+      this->pimpl->copyList<Yeast> (*this, other);
 
-   //
-   // You might think that Style, Mash and Equipment could safely be shared between Recipes.   However, AFAICT, none of
-   // them is.  Presumably this is because users expect to be able to edit them in one Recipe without changing the
-   // settings for any other Recipe.
-   //
-   // We also need to be careful here as one or more of these may not be set to a valid value.
-   //
-   if (other.equipmentId > 0) {
-      auto equipment = copyIfNeeded(*ObjectStoreWrapper::getById<Equipment>(other.equipmentId));
-      this->equipmentId = equipment->key();
-      connect(equipment.get(), SIGNAL(changed(QMetaProperty, QVariant)), this,
-              SLOT(acceptChangeToContainedObject(QMetaProperty, QVariant)));
-   }
+      //
+      // You might think that Style, Mash and Equipment could safely be shared between Recipes.   However, AFAICT, none
+      // of them is (other than between versions of the same Recipe).  Presumably this is because users expect to be
+      // able to edit them in one Recipe without changing the settings for any other Recipe.
+      //
+      // We also need to be careful here as one or more of these may not be set to a valid value.
+      //
+      if (other.equipmentId > 0) {
+         auto equipment = copyIfNeeded(*ObjectStoreWrapper::getById<Equipment>(other.equipmentId));
+         this->pimpl->setUsedId<Equipment>(equipment->key());
+         connect(equipment.get(), SIGNAL(changed(QMetaProperty, QVariant)), this,
+                 SLOT(acceptChangeToContainedObject(QMetaProperty, QVariant)));
+      }
 
-   if (other.mashId > 0) {
-      auto mash = copyIfNeeded(*ObjectStoreWrapper::getById<Mash>(other.mashId));
-      this->mashId = mash->key();
-      connect(mash.get(), SIGNAL(changed(QMetaProperty, QVariant)), this, SLOT(acceptChangeToContainedObject(QMetaProperty,
-                                                                                                             QVariant)));
-   }
+      if (other.mashId > 0) {
+         auto mash = copyIfNeeded(*ObjectStoreWrapper::getById<Mash>(other.mashId));
+         this->pimpl->setUsedId<Mash>(mash->key());
+         connect(mash.get(), SIGNAL(changed(QMetaProperty, QVariant)), this,
+                 SLOT(acceptChangeToContainedObject(QMetaProperty, QVariant)));
+      }
 
-   if (other.styleId > 0) {
-      auto style = copyIfNeeded(*ObjectStoreWrapper::getById<Style>(other.styleId));
-      this->styleId = style->key();
-      connect(style.get(), SIGNAL(changed(QMetaProperty, QVariant)), this, SLOT(acceptChangeToContainedObject(QMetaProperty,
-                                                                                                              QVariant)));
+      if (other.styleId > 0) {
+         auto style = copyIfNeeded(*ObjectStoreWrapper::getById<Style>(other.styleId));
+         this->pimpl->setUsedId<Style>(style->key());
+         connect(style.get(), SIGNAL(changed(QMetaProperty, QVariant)), this,
+                 SLOT(acceptChangeToContainedObject(QMetaProperty, QVariant)));
+      }
    }
 
    this->recalcAll();
@@ -506,7 +782,10 @@ Recipe::Recipe(Recipe const & other) :
 
 // See https://herbsutter.com/gotw/_100/ for why we need to explicitly define the destructor here (and not in the
 // header file)
-Recipe::~Recipe() = default;
+Recipe::~Recipe() {
+   this->pimpl->countAllUses(-1);
+   return;
+}
 
 void Recipe::setKey(int key) {
    //
@@ -518,7 +797,7 @@ void Recipe::setKey(int key) {
    //
    this->NamedEntity::setKey(key);
    if (this->m_ancestor_id <= 0) {
-      qDebug() << Q_FUNC_INFO << "Setting default ancestor ID on Recipe #" << key;
+      qCDebug(lcModel) << Q_FUNC_INFO << "Setting default ancestor ID on Recipe #" << key;
 
       // We want to store the new ancestor ID in the DB, but we don't want to signal the UI about this change, so
       // suppress signal sending.
@@ -529,10 +808,10 @@ void Recipe::setKey(int key) {
 
 
 void Recipe::connectSignals() {
-   qDebug() << Q_FUNC_INFO << "Connecting signals for Recipes";
+   qCDebug(lcModel) << Q_FUNC_INFO << "Connecting signals for Recipes";
    // Connect fermentable, hop changed signals to their parent recipe
    for (auto recipe : ObjectStoreTyped<Recipe>::getInstance().getAllRaw()) {
-//      qDebug() << Q_FUNC_INFO << "Connecting signals for Recipe #" << recipe->key();
+//      qCDebug(lcModel) << Q_FUNC_INFO << "Connecting signals for Recipe #" << recipe->key();
       Equipment * equipment = recipe->equipment();
       if (equipment != nullptr) {
          connect(equipment, &NamedEntity::changed,           recipe, &Recipe::acceptChangeToContainedObject);
@@ -1207,7 +1486,7 @@ template<class NE> std::shared_ptr<NE> Recipe::add(std::shared_ptr<NE> ne) {
    if (ne->key() <= 0) {
       // With shared pointer parameter, ObjectStoreWrapper::insert returns what we passed it (ie our shared pointer
       // remains valid after the call).
-      qDebug() << Q_FUNC_INFO << "Inserting" << ne->metaObject()->className() << "in object store";
+      qCDebug(lcModel) << Q_FUNC_INFO << "Inserting" << ne->metaObject()->className() << "in object store";
       ObjectStoreWrapper::insert(ne);
    } else {
       //
@@ -1218,7 +1497,7 @@ template<class NE> std::shared_ptr<NE> Recipe::add(std::shared_ptr<NE> ne) {
       ne = copyIfNeeded(*ne);
    }
 
-   this->pimpl->accessIds<NE>().append(ne->key());
+   this->pimpl->appendId<NE>(ne->key());
    connect(ne.get(), SIGNAL(changed(QMetaProperty, QVariant)), this, SLOT(acceptChangeToContainedObject(QMetaProperty,
                                                                                                         QVariant)));
    this->propagatePropertyChange(propertyToPropertyName<NE>());
@@ -1284,7 +1563,7 @@ template<class NE> std::shared_ptr<NE> Recipe::remove(std::shared_ptr<NE> var) {
    Q_ASSERT(var);
 
    int idToRemove = var->key();
-   if (!this->pimpl->accessIds<NE>().removeOne(idToRemove)) {
+   if (!this->pimpl->removeId<NE>(idToRemove)) {
       // It's a coding error if we try to remove something from the Recipe that wasn't in it in the first place!
       qCritical() <<
          Q_FUNC_INFO << "Tried to remove" << var->metaObject()->className() << "with ID" << idToRemove <<
@@ -1302,7 +1581,7 @@ template<class NE> std::shared_ptr<NE> Recipe::remove(std::shared_ptr<NE> var) {
    // other Recipes.
    //
    if (isUnusedInstanceOfUseOf(*var)) {
-      qDebug() <<
+      qCDebug(lcModel) <<
          Q_FUNC_INFO << "Deleting" << var->metaObject()->className() << "#" << var->key() <<
          "as it is \"instance of use of\" that is no longer needed";
       ObjectStoreWrapper::hardDelete<NE>(var->key());
@@ -1345,10 +1624,14 @@ void Recipe::swapInstructions(Instruction * ins1, Instruction * ins2) {
 }
 
 void Recipe::clearInstructions() {
-   for (int ii : this->pimpl->instructionIds) {
-      ObjectStoreTyped<Instruction>::getInstance().softDelete(ii);
+   for (Instruction * instruction : this->pimpl->getAllMyRaw<Instruction>()) {
+      // Previous versions of the Recipe can share our Instructions, in which case they carry on using them and we just
+      // stop doing so
+      if (this->pimpl->otherRecipesUsing(*instruction).isEmpty()) {
+         ObjectStoreTyped<Instruction>::getInstance().softDelete(instruction->key());
+      }
    }
-   this->pimpl->instructionIds.clear();
+   this->pimpl->setIds<Instruction>({});
    this->propagatePropertyChange(propertyToPropertyName<Instruction>());
    return;
 }
@@ -1358,7 +1641,7 @@ void Recipe::insertInstruction(Instruction * ins, int pos) {
       return;
    }
 
-   this->pimpl->instructionIds.insert(pos, ins->key());
+   this->pimpl->insertId<Instruction>(pos, ins->key());
    this->propagatePropertyChange(propertyToPropertyName<Instruction>());
    return;
 }
@@ -1369,7 +1652,7 @@ void Recipe::setStyle(Style * var) {
    }
 
    std::shared_ptr<Style> styleToAdd = copyIfNeeded(*var);
-   this->styleId = styleToAdd->key();
+   this->pimpl->setUsedId<Style>(styleToAdd->key());
    this->propagatePropertyChange(propertyToPropertyName<Style>());
    return;
 }
@@ -1380,7 +1663,7 @@ void Recipe::setEquipment(Equipment * var) {
    }
 
    std::shared_ptr<Equipment> equipmentToAdd = copyIfNeeded(*var);
-   this->equipmentId = equipmentToAdd->key();
+   this->pimpl->setUsedId<Equipment>(equipmentToAdd->key());
    this->propagatePropertyChange(propertyToPropertyName<Equipment>());
    return;
 }
@@ -1393,7 +1676,7 @@ void Recipe::setMash(Mash * var) {
    // .:TBD:. Do we need to disconnect the old Mash?
 
    std::shared_ptr<Mash> mashToAdd = copyIfNeeded(*var);
-   this->mashId = mashToAdd->key();
+   this->pimpl->setUsedId<Mash>(mashToAdd->key());
    this->propagatePropertyChange(propertyToPropertyName<Mash>());
 
    connect(mashToAdd.get(), SIGNAL(changed(QMetaProperty, QVariant)), this, SLOT(acceptMashChange(QMetaProperty,
@@ -1406,50 +1689,62 @@ void Recipe::setMash(Mash * var) {
 }
 
 void Recipe::setStyleId(int id) {
-   this->styleId = id;
+   this->pimpl->setUsedId<Style>(id);
+   this->markPropertyDirty(PropertyNames::Recipe::styleId);
+   return;
 }
 
 void Recipe::setEquipmentId(int id) {
-   this->equipmentId = id;
+   this->pimpl->setUsedId<Equipment>(id);
+   this->markPropertyDirty(PropertyNames::Recipe::equipmentId);
+   return;
 }
 
 void Recipe::setMashId(int id) {
-   this->mashId = id;
+   this->pimpl->setUsedId<Mash>(id);
+   this->markPropertyDirty(PropertyNames::Recipe::mashId);
    return;
 }
 
 void Recipe::setFermentableIds(QVector<int> fermentableIds) {
-   this->pimpl->fermentableIds = fermentableIds;
+   this->pimpl->setIds<Fermentable>(fermentableIds);
+   this->markPropertyDirty(PropertyNames::Recipe::fermentableIds);
    return;
 }
 
 void Recipe::setHopIds(QVector<int> hopIds) {
-   this->pimpl->hopIds = hopIds;
+   this->pimpl->setIds<Hop>(hopIds);
+   this->markPropertyDirty(PropertyNames::Recipe::hopIds);
    return;
 }
 
 void Recipe::setInstructionIds(QVector<int> instructionIds) {
-   this->pimpl->instructionIds = instructionIds;
+   this->pimpl->setIds<Instruction>(instructionIds);
+   this->markPropertyDirty(PropertyNames::Recipe::instructionIds);
    return;
 }
 
 void Recipe::setMiscIds(QVector<int> miscIds) {
-   this->pimpl->miscIds = miscIds;
+   this->pimpl->setIds<Misc>(miscIds);
+   this->markPropertyDirty(PropertyNames::Recipe::miscIds);
    return;
 }
 
 void Recipe::setSaltIds(QVector<int> saltIds) {
-   this->pimpl->saltIds = saltIds;
+   this->pimpl->setIds<Salt>(saltIds);
+   this->markPropertyDirty(PropertyNames::Recipe::saltIds);
    return;
 }
 
 void Recipe::setWaterIds(QVector<int> waterIds) {
-   this->pimpl->waterIds = waterIds;
+   this->pimpl->setIds<Water>(waterIds);
+   this->markPropertyDirty(PropertyNames::Recipe::waterIds);
    return;
 }
 
 void Recipe::setYeastIds(QVector<int> yeastIds) {
-   this->pimpl->yeastIds = yeastIds;
+   this->pimpl->setIds<Yeast>(yeastIds);
+   this->markPropertyDirty(PropertyNames::Recipe::yeastIds);
    return;
 }
 
@@ -1700,7 +1995,7 @@ void Recipe::setAncestor(Recipe & ancestor) {
    //    - Recipe A is modified
    // This means that, if Recipe A already has a direct ancestor, then Recipe B needs to take it
    //
-   qDebug() <<
+   qCDebug(lcModel) <<
       Q_FUNC_INFO << "Setting Recipe #" << ancestor.key() << "to be immediate prior version (ancestor) of Recipe #" <<
       this->key();
 
@@ -1711,6 +2006,9 @@ void Recipe::setAncestor(Recipe & ancestor) {
          // Setting a Recipe to be its own ancestor is a kooky way of saying we want the Recipe not to have any
          // ancestors
          if (this->ancestors().size() > 0) {
+            // Our former ancestors are going to be a separate Recipe, which can be edited independently of us, so we
+            // can't share anything with them any more
+            this->pimpl->unshareAll();
             // We have some ancestors so we just have to tell the immediate one that it no longer has descendants
             this->ancestors().at(0)->setHasDescendants(false);
             this->ancestors().clear();
@@ -1746,6 +2044,9 @@ Recipe * Recipe::revertToPreviousVersion() {
       return nullptr;
    }
 
+   // Our immediate ancestor is about to become editable, so it can't share anything with us any more
+   this->pimpl->unshareAll();
+
    // Reactivate our immediate ancestor (aka previous version)
    Recipe * ancestor = ObjectStoreWrapper::getByIdRaw<Recipe>(this->m_ancestor_id);
    ancestor->setDisplay(true);
@@ -1929,6 +2230,7 @@ QVector<int> Recipe::getWaterIds() const          { return this->pimpl->waterIds
 QList<Salt *> Recipe::salts() const               { return this->pimpl->getAllMyRaw<Salt>();        }
 QVector<int> Recipe::getSaltIds() const           { return this->pimpl->saltIds;                    }
 int Recipe::getAncestorId() const                 { return this->m_ancestor_id;                     }
+unsigned int Recipe::changeStamp() const          { return this->pimpl->changeStamp;                }
 
 //==============================Getters===================================
 Recipe::Type Recipe::recipeType() const {
@@ -2003,6 +2305,7 @@ void Recipe::recalcIfNeeded(QString classNameOfWhatWasAddedOrChanged) {
 }
 
 void Recipe::recalcAll() {
+   Tracing::Span const span{"Recipe::recalcAll"};
    // WARNING
    // Infinite recursion possible, since these methods will emit changed(),
    // causing other objects to call finalVolume_l() for example, which may
@@ -2680,14 +2983,16 @@ QStringList Recipe::getReagents(QList<Salt *> salts, Salt::WhenToAdd wanted) {
 //==========================Accept changes from ingredients====================
 
 void Recipe::acceptChangeToContainedObject(QMetaProperty prop, QVariant val) {
+   this->pimpl->markChanged();
+
    // This tells us which object sent us the signal
    QObject * signalSender = this->sender();
    if (signalSender != nullptr) {
       QString signalSenderClassName = signalSender->metaObject()->className();
-      qDebug() << Q_FUNC_INFO << "Signal received from " << signalSenderClassName;
+      qCDebug(lcModel) << Q_FUNC_INFO << "Signal received from " << signalSenderClassName;
       this->recalcIfNeeded(signalSenderClassName);
    } else {
-      qDebug() << Q_FUNC_INFO << "No sender";
+      qCDebug(lcModel) << Q_FUNC_INFO << "No sender";
    }
    return;
 }
@@ -2734,6 +3039,37 @@ Recipe * Recipe::getOwningRecipe() {
    return this;
 }
 
+void Recipe::unshare(NamedEntity & ne) {
+   if (auto equipment = qobject_cast<Equipment *>(&ne)) {
+      this->pimpl->unshare(*equipment);
+   } else if (auto fermentable = qobject_cast<Fermentable *>(&ne)) {
+      this->pimpl->unshare(*fermentable);
+   } else if (auto hop = qobject_cast<Hop *>(&ne)) {
+      this->pimpl->unshare(*hop);
+   } else if (auto instruction = qobject_cast<Instruction *>(&ne)) {
+      this->pimpl->unshare(*instruction);
+   } else if (auto mash = qobject_cast<Mash *>(&ne)) {
+      this->pimpl->unshare(*mash);
+   } else if (auto mashStep = qobject_cast<MashStep *>(&ne)) {
+      // MashSteps belong to a Mash, so it's the whole Mash that needs to be unshared
+      if (mashStep->getMashId() > 0) {
+         this->pimpl->unshare(*ObjectStoreWrapper::getByIdRaw<Mash>(mashStep->getMashId()));
+      }
+   } else if (auto misc = qobject_cast<Misc *>(&ne)) {
+      this->pimpl->unshare(*misc);
+   } else if (auto salt = qobject_cast<Salt *>(&ne)) {
+      this->pimpl->unshare(*salt);
+   } else if (auto style = qobject_cast<Style *>(&ne)) {
+      this->pimpl->unshare(*style);
+   } else if (auto water = qobject_cast<Water *>(&ne)) {
+      this->pimpl->unshare(*water);
+   } else if (auto yeast = qobject_cast<Yeast *>(&ne)) {
+      this->pimpl->unshare(*yeast);
+   }
+   // Otherwise it's us or one of our BrewNotes, neither of which is shared
+   return;
+}
+
 void Recipe::hardDeleteOwnedEntities() {
    // It's the BrewNote that stores its Recipe ID, so all we need to do is delete our BrewNotes then the subsequent
    // database delete of this Recipe won't hit any foreign key problems.
@@ -2770,14 +3106,14 @@ void Recipe::hardDeleteOrphanedEntities() {
    //
    Mash * mash = this->mash();
    if (mash && mash->name() == "") {
-      qDebug() << Q_FUNC_INFO << "Checking whether our unnamed Mash is used elsewhere";
+      qCDebug(lcModel) << Q_FUNC_INFO << "Checking whether our unnamed Mash is used elsewhere";
       auto recipesUsingThisMash = ObjectStoreWrapper::findAllMatching<Recipe>(
          [mash](Recipe const * rec) {
             return rec->uses(*mash);
          }
       );
       if (1 == recipesUsingThisMash.size()) {
-         qDebug() <<
+         qCDebug(lcModel) <<
             Q_FUNC_INFO << "Deleting unnamed Mash # " << mash->key() << " used only by Recipe #" << this->key();
          Q_ASSERT(recipesUsingThisMash.at(0)->key() == this->key());
          ObjectStoreWrapper::hardDelete<Mash>(*mash);
@@ -2799,16 +3135,31 @@ QList<BrewNote *> RecipeHelper::brewNotesForRecipeAndAncestors(Recipe const & re
    return brewNotes;
 }
 
-void RecipeHelper::prepareForPropertyChange(NamedEntity & ne, BtStringConst const & propertyName) {
-
-   //
-   // If the user has said they don't want versioning, just return
-   //
-   if (!RecipeHelper::getAutomaticVersioningEnabled()) {
-      return;
+template<class NE> Recipe * RecipeHelper::findOwningRecipe(NE const & ne) {
+   QList<Recipe *> recipes = ObjectStoreWrapper::findAllMatching<Recipe>(
+      [&ne](Recipe * recipe) { return recipe->uses(ne); }
+   );
+   for (Recipe * recipe : recipes) {
+      if (!recipe->hasDescendants()) {
+         return recipe;
+      }
    }
+   return recipes.isEmpty() ? nullptr : recipes.first();
+}
+template Recipe * RecipeHelper::findOwningRecipe(Equipment   const & ne);
+template Recipe * RecipeHelper::findOwningRecipe(Fermentable const & ne);
+template Recipe * RecipeHelper::findOwningRecipe(Hop         const & ne);
+template Recipe * RecipeHelper::findOwningRecipe(Instruction const & ne);
+template Recipe * RecipeHelper::findOwningRecipe(Mash        const & ne);
+template Recipe * RecipeHelper::findOwningRecipe(Misc        const & ne);
+template Recipe * RecipeHelper::findOwningRecipe(Salt        const & ne);
+template Recipe * RecipeHelper::findOwningRecipe(Style       const & ne);
+template Recipe * RecipeHelper::findOwningRecipe(Water       const & ne);
+template Recipe * RecipeHelper::findOwningRecipe(Yeast       const & ne);
+
+void RecipeHelper::prepareForPropertyChange(NamedEntity & ne, BtStringConst const & propertyName) {
 
-   qDebug() <<
+   qCDebug(lcModel) <<
       Q_FUNC_INFO << "Modifying: " << ne.metaObject()->className() << "#" << ne.key() << "property" << propertyName;
 
    //
@@ -2822,53 +3173,66 @@ void RecipeHelper::prepareForPropertyChange(NamedEntity & ne, BtStringConst cons
    }
 
    //
-   // Automatic versioning means that, once a recipe is brewed, it is "soft locked" and the first change should spawn a
-   // new version.  Any subsequent change should not spawn a new version until it is brewed again.
+   // If the user has said they don't want versioning, we skip straight to making sure the change doesn't leak into
+   // any existing previous versions of the Recipe
    //
-   if (owner->brewNotes().empty()) {
-      // Recipe hasn't been brewed
-      return;
-   }
-
-   // If the object we're about to change already has descendants, then we don't want to create new ones.
-   if (owner->hasDescendants()) {
-      qDebug() << Q_FUNC_INFO << "Recipe #" << owner->key() << "already has descendants, so not creating any more";
-      return;
+   if (RecipeHelper::getAutomaticVersioningEnabled()) {
+      //
+      // Automatic versioning means that, once a recipe is brewed, it is "soft locked" and the first change should spawn
+      // a new version.  Any subsequent change should not spawn a new version until it is brewed again.
+      //
+      if (owner->brewNotes().empty()) {
+         // Recipe hasn't been brewed
+         qCDebug(lcModel) << Q_FUNC_INFO << "Recipe #" << owner->key() << "not yet brewed, so no new version needed";
+      } else if (owner->hasDescendants()) {
+         // If the object we're about to change already has descendants, then we don't want to create new ones.
+         qCDebug(lcModel) <<
+            Q_FUNC_INFO << "Recipe #" << owner->key() << "already has descendants, so not creating any more";
+      } else {
+         //
+         // Once we've started doing versioning, we don't want to trigger it again on the same Recipe until we've
+         // finished
+         //
+         NamedEntityModifyingMarker ownerModifyingMarker(*owner);
+
+         //
+         // Versioning when modifying something in a recipe is *hard*.  If we copy the recipe, there is no easy way to
+         // say "this ingredient in the old recipe is that ingredient in the new".  So, rather than taking a deep copy,
+         // the previous version initially shares all its ingredients (and its mash etc) with the current one.  Below,
+         // we then give the previous version its own copy of just the thing that's about to change.
+         //
+         qCDebug(lcModel) << Q_FUNC_INFO << "Copying Recipe" << owner->key();
+
+         // We also don't want to trigger versioning on the newly spawned Recipe until we're completely done here!
+         // (Inserting will also emit signalObjectInserted for the new Recipe from ObjectStoreTyped<Recipe>.)
+         std::shared_ptr<Recipe> spawn = std::make_shared<Recipe>(*owner, Recipe::CopyMode::SharedVersion);
+         NamedEntityModifyingMarker spawnModifyingMarker(*spawn);
+         ObjectStoreWrapper::insert(spawn);
+
+         qCDebug(lcModel) << Q_FUNC_INFO << "Copied Recipe #" << owner->key() << "to new Recipe #" << spawn->key();
+
+         // We assert that the newly created version of the recipe has not yet been brewed (and therefore will not get
+         // automatically versioned on subsequent changes before it is brewed).
+         Q_ASSERT(spawn->brewNotes().empty());
+
+         //
+         // By default, copying a Recipe does not copy all its ancestry.  Here, we want the copy to become our ancestor
+         // (ie previous version).  This will also emit a signalPropertyChanged from ObjectStoreTyped<Recipe>, which the
+         // UI can pick up to update tree display of Recipes etc.
+         //
+         owner->setAncestor(*spawn);
+      }
    }
 
    //
-   // Once we've started doing versioning, we don't want to trigger it again on the same Recipe until we've finished
-   //
-   NamedEntityModifyingMarker ownerModifyingMarker(*owner);
-
-   //
-   // Versioning when modifying something in a recipe is *hard*.  If we copy the recipe, there is no easy way to say
-   // "this ingredient in the old recipe is that ingredient in the new".  One approach would be to use the delete idea,
-   // ie copy everything but what's being modified, clone what's being modified and add the clone to the copy.  Another
-   // is to take a deep copy of the Recipe and make that the "prior version".
-   //
-
-   // Create a deep copy of the Recipe, and put it in the DB, so it has an ID.
-   // (This will also emit signalObjectInserted for the new Recipe from ObjectStoreTyped<Recipe>.)
-   qDebug() << Q_FUNC_INFO << "Copying Recipe" << owner->key();
-
-   // We also don't want to trigger versioning on the newly spawned Recipe until we're completely done here!
-   std::shared_ptr<Recipe> spawn = std::make_shared<Recipe>(*owner);
-   NamedEntityModifyingMarker spawnModifyingMarker(*spawn);
-   ObjectStoreWrapper::insert(spawn);
-
-   qDebug() << Q_FUNC_INFO << "Copied Recipe #" << owner->key() << "to new Recipe #" << spawn->key();
-
-   // We assert that the newly created version of the recipe has not yet been brewed (and therefore will not get
-   // automatically versioned on subsequent changes before it is brewed).
-   Q_ASSERT(spawn->brewNotes().empty());
-
-   //
-   // By default, copying a Recipe does not copy all its ancestry.  Here, we want the copy to become our ancestor (ie
-   // previous version).  This will also emit a signalPropertyChanged from ObjectStoreTyped<Recipe>, which the UI can
-   // pick up to update tree display of Recipes etc.
+   // Whether or not we just made a new version, the thing being changed might be shared with previous versions of the
+   // Recipe, which must not see the change.  They get their own copy, and the current version carries on using (and
+   // modifying) the original.
    //
-   owner->setAncestor(*spawn);
+   if (owner->hasAncestors()) {
+      NamedEntityModifyingMarker ownerModifyingMarker(*owner);
+      owner->unshare(ne);
+   }
 
    return;
 }
@@ -2891,14 +3255,14 @@ bool RecipeHelper::getAutomaticVersioningEnabled() {
 RecipeHelper::SuspendRecipeVersioning::SuspendRecipeVersioning() {
    this->savedVersioningValue = RecipeHelper::getAutomaticVersioningEnabled();
    if (this->savedVersioningValue) {
-      qDebug() << Q_FUNC_INFO << "Temporarily suspending automatic Recipe versioning";
+      qCDebug(lcModel) << Q_FUNC_INFO << "Temporarily suspending automatic Recipe versioning";
       RecipeHelper::setAutomaticVersioningEnabled(false);
    }
    return;
 }
 RecipeHelper::SuspendRecipeVersioning::~SuspendRecipeVersioning() {
    if (this->savedVersioningValue) {
-      qDebug() << Q_FUNC_INFO << "Re-enabling automatic Recipe versioning";
+      qCDebug(lcModel) << Q_FUNC_INFO << "Re-enabling automatic Recipe versioning";
       RecipeHelper::setAutomaticVersioningEnabled(true);
    }
    return;
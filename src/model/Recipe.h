@@ -140,9 +140,20 @@ class Recipe : public NamedEntity {
    friend class WaterDialog;
 public:
 
+   /**
+    * \brief How copying a Recipe treats the ingredients, Mash, Equipment and Style it uses
+    */
+   enum class CopyMode {
+      //! Make copies of them, so that the two Recipes can be changed independently
+      Deep,
+      //! Share them, as when making a new version of a Recipe.  Anything shared is only copied when it is about to be
+      //  changed (see \c unshare()), so versions that have not changed much take up little space.
+      SharedVersion
+   };
+
    Recipe(QString name, bool cache = true);
    Recipe(NamedParameterBundle const & namedParameterBundle);
-   Recipe(Recipe const & other);
+   Recipe(Recipe const & other, CopyMode copyMode = CopyMode::Deep);
 
    virtual ~Recipe();
 
@@ -462,6 +473,13 @@ public:
 
    int getAncestorId() const;
 
+   /**
+    * \brief Changes every time this Recipe, or anything in it, changes.  Values are never reused, either over time or
+    *        between different Recipe objects, so things derived from a Recipe (eg formatted HTML) can be cached against
+    *        the pair (Recipe *, changeStamp()).
+    */
+   unsigned int changeStamp() const;
+
    // Relational setters
    void setEquipment(Equipment * equipment);
    void setMash(Mash * var);
@@ -545,6 +563,13 @@ public:
 
    virtual Recipe * getOwningRecipe();
 
+   /**
+    * \brief Copy-on-write for the things we share with other versions of this Recipe.  Called before \c ne (which we
+    *        use, or which belongs to something we use, eg a MashStep in our Mash) is changed.  If any other Recipe also
+    *        uses it, that Recipe is given an unchanged copy of it instead, so that the change only affects us.
+    */
+   void unshare(NamedEntity & ne);
+
    /**
     * \brief A Recipe owns some of its contained objects, so needs to delete those if it itself is being deleted
     */
@@ -694,6 +719,15 @@ namespace RecipeHelper {
     */
    QList<BrewNote *> brewNotesForRecipeAndAncestors(Recipe const & recipe);
 
+   /**
+    * \brief Find the Recipe that uses \c ne.  Because versions of a Recipe share what has not changed between them,
+    *        more than one Recipe can use the same object, in which case we want the latest version (ie the one without
+    *        descendants), as that's the one that can be edited.  Used to implement \c getOwningRecipe().
+    *
+    * \return \c nullptr if no Recipe uses \c ne
+    */
+   template<class NE> Recipe * findOwningRecipe(NE const & ne);
+
    /**
     * \brief Checks whether an about-to-be-made property change require us to create a new version of a Recipe - eg
     *        because we are modifying some ingredient or other attribute of the Recipe and automatic versioning is
@@ -188,5 +188,5 @@ double Water::ppm( Water::Ions ion )
 }
 
 Recipe * Water::getOwningRecipe() {
-   return ObjectStoreWrapper::findFirstMatching<Recipe>( [this](Recipe * rec) {return rec->uses(*this);} );
+   return RecipeHelper::findOwningRecipe(*this);
 }
@@ -0,0 +1,83 @@
+/*
+ * utils/ChangeDispatcher.cpp is part of Brewtarget, and is Copyright the following
+ * authors 2021
+ * - Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "utils/ChangeDispatcher.h"
+
+#include <QDebug>
+#include <QTimer>
+
+#include "Logging.h"
+
+ChangeDispatcher::ChangeDispatcher(QString const & name, QObject * parent) : QObject{parent},
+                                                                           name{name},
+                                                                           dirty{},
+                                                                           flushScheduled{false},
+                                                                           notifications{0},
+                                                                           refreshes{0} {
+   return;
+}
+
+ChangeDispatcher::~ChangeDispatcher() {
+   qCDebug(lcUi) <<
+      Q_FUNC_INFO << this->name << ":" << this->notifications << "changes resulted in" << this->refreshes <<
+      "refreshes (" << this->savedRefreshCount() << "saved)";
+   return;
+}
+
+void ChangeDispatcher::markDirty(QString const & propertyName) {
+   ++this->notifications;
+   this->dirty.insert(propertyName);
+   if (!this->flushScheduled) {
+      this->flushScheduled = true;
+      // A zero timeout means we get called as soon as the event loop has processed everything already queued, which
+      // includes the rest of whatever set of changes we're in the middle of
+      QTimer::singleShot(0, this, &ChangeDispatcher::flush);
+   }
+   return;
+}
+
+void ChangeDispatcher::discardPending() {
+   this->dirty.clear();
+   return;
+}
+
+void ChangeDispatcher::flush() {
+   this->flushScheduled = false;
+   if (this->dirty.isEmpty()) {
+      return;
+   }
+
+   // Take a copy, so that anything marked dirty as a result of the refresh goes in the next one
+   QSet<QString> changedProperties;
+   changedProperties.swap(this->dirty);
+   ++this->refreshes;
+   emit refresh(changedProperties);
+   return;
+}
+
+unsigned int ChangeDispatcher::notificationCount() const {
+   return this->notifications;
+}
+
+unsigned int ChangeDispatcher::refreshCount() const {
+   return this->refreshes;
+}
+
+unsigned int ChangeDispatcher::savedRefreshCount() const {
+   return this->notifications - this->refreshes;
+}
@@ -0,0 +1,90 @@
+/*
+ * utils/ChangeDispatcher.h is part of Brewtarget, and is Copyright the following
+ * authors 2021
+ * - Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef UTILS_CHANGEDISPATCHER_H
+#define UTILS_CHANGEDISPATCHER_H
+#pragma once
+
+#include <QObject>
+#include <QSet>
+#include <QString>
+
+/**
+ * \class ChangeDispatcher
+ *
+ * \brief Collects the names of properties that have changed and tells whoever is displaying them once, on the next
+ *        turn of the event loop, rather than once per change.
+ *
+ *        When, eg, a Recipe recalculates, it emits \c changed() for OG, FG, colour, IBU, ABV and so on one after
+ *        another.  If each of these causes a widget to redraw everything it shows, we do a lot of work for nothing.
+ *        Instead the widget calls \c markDirty() from its \c changed() slot and does its refresh from a slot connected
+ *        to \c refresh(), which gets the set of everything that changed since the last refresh.
+ *
+ *        We keep count of how many changes came in and how many refreshes went out, so we can see how much work was
+ *        saved.  (These are logged when the dispatcher is destroyed.)
+ *
+ *        Only intended for use from the GUI thread.
+ */
+class ChangeDispatcher : public QObject {
+   Q_OBJECT
+
+public:
+   /**
+    * \param name Used for logging
+    */
+   ChangeDispatcher(QString const & name, QObject * parent = nullptr);
+   virtual ~ChangeDispatcher();
+
+   /**
+    * \brief Note that \c propertyName has changed and make sure there will be a \c refresh() on the next turn of the
+    *        event loop
+    */
+   void markDirty(QString const & propertyName);
+
+   /**
+    * \brief Forget about any changes we haven't yet sent out, eg because the caller has just refreshed everything
+    */
+   void discardPending();
+
+   //! \brief Emit \c refresh() now if there is anything pending
+   void flush();
+
+   //! \brief Number of calls to \c markDirty() so far
+   unsigned int notificationCount() const;
+   //! \brief Number of times \c refresh() has been emitted so far
+   unsigned int refreshCount() const;
+   //! \brief Number of refreshes we didn't have to do because we coalesced changes
+   unsigned int savedRefreshCount() const;
+
+signals:
+   /**
+    * \brief Emitted at most once per turn of the event loop
+    *
+    * \param changedProperties the names of everything passed to \c markDirty() since the last \c refresh()
+    */
+   void refresh(QSet<QString> const & changedProperties);
+
+private:
+   QString name;
+   QSet<QString> dirty;
+   bool flushScheduled;
+   unsigned int notifications;
+   unsigned int refreshes;
+};
+
+#endif
@@ -0,0 +1,81 @@
+/*
+ * utils/FormattedValueCache.cpp is part of Brewtarget, and is Copyright the following
+ * authors 2021
+ * - Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "utils/FormattedValueCache.h"
+
+unsigned int FormattedValueCache::globalGeneration = 0;
+
+FormattedValueCache::FormattedValueCache(int numColumns) : numColumns{numColumns},
+                                                           generation{FormattedValueCache::globalGeneration},
+                                                           cells{} {
+   return;
+}
+
+QString FormattedValueCache::get(void const * rowObject, int column, std::function<QString()> const & formatter) {
+   Q_ASSERT(column >= 0 && column < this->numColumns);
+
+   if (this->generation != FormattedValueCache::globalGeneration) {
+      this->clear();
+   }
+
+   auto rowCells = this->cells.find(rowObject);
+   if (rowCells == this->cells.end()) {
+      rowCells = this->cells.insert(rowObject, QVector<std::optional<QString> >(this->numColumns));
+   }
+
+   std::optional<QString> & cell = (*rowCells)[column];
+   if (!cell) {
+      cell = formatter();
+   }
+   return *cell;
+}
+
+void FormattedValueCache::invalidateRow(void const * rowObject) {
+   this->cells.remove(rowObject);
+   return;
+}
+
+void FormattedValueCache::invalidateCell(void const * rowObject, int column) {
+   auto rowCells = this->cells.find(rowObject);
+   if (rowCells != this->cells.end()) {
+      (*rowCells)[column].reset();
+   }
+   return;
+}
+
+void FormattedValueCache::invalidateColumn(int column) {
+   for (auto & rowCells : this->cells) {
+      rowCells[column].reset();
+   }
+   return;
+}
+
+void FormattedValueCache::clear() {
+   this->cells.clear();
+   this->generation = FormattedValueCache::globalGeneration;
+   return;
+}
+
+void FormattedValueCache::invalidateAll() {
+   ++FormattedValueCache::globalGeneration;
+   return;
+}
+
+unsigned int FormattedValueCache::currentGeneration() {
+   return FormattedValueCache::globalGeneration;
+}
@@ -0,0 +1,90 @@
+/*
+ * utils/FormattedValueCache.h is part of Brewtarget, and is Copyright the following
+ * authors 2021
+ * - Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef UTILS_FORMATTEDVALUECACHE_H
+#define UTILS_FORMATTEDVALUECACHE_H
+#pragma once
+
+#include <functional>
+#include <optional>
+
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+/**
+ * \class FormattedValueCache
+ *
+ * \brief Per-cell cache of display strings for a table model, so that we don't have to call
+ *        \c Brewtarget::displayAmount() (which reads units and scales out of \c PersistentSettings and then formats a
+ *        number) for every cell on every repaint.
+ *
+ *        Cells are keyed by the object shown in the row (rather than by row number) so that inserting or removing rows
+ *        does not invalidate anything else.  It is the model's responsibility to invalidate:
+ *           • a row when the object it shows changes (ie from the model's \c changed() slot)
+ *           • a cell when something else it depends on changes (eg inventory)
+ *           • a column when its display unit or scale changes
+ *           • everything when the model is cleared
+ *
+ *        Changes to global display settings (eg default units in \c OptionDialog, or language) affect every cache, so
+ *        for these we just call the static \c invalidateAll(), which lazily clears each cache the next time it is used.
+ *
+ *        Only intended for use from the GUI thread.
+ */
+class FormattedValueCache {
+public:
+   FormattedValueCache(int numColumns);
+   ~FormattedValueCache() = default;
+
+   /**
+    * \brief Return the cached display string for the given cell, calling \c formatter to create it if necessary
+    */
+   QString get(void const * rowObject, int column, std::function<QString()> const & formatter);
+
+   //! \brief Forget everything cached for one row
+   void invalidateRow(void const * rowObject);
+
+   //! \brief Forget one cell
+   void invalidateCell(void const * rowObject, int column);
+
+   //! \brief Forget one column in every row
+   void invalidateColumn(int column);
+
+   //! \brief Forget everything
+   void clear();
+
+   /**
+    * \brief Invalidate every \c FormattedValueCache, eg because default units or language have changed
+    */
+   static void invalidateAll();
+
+   /**
+    * \brief Changes every time \c invalidateAll() is called, so that other things holding formatted values (eg
+    *        \c RecipeFormatter) know when to throw them away
+    */
+   static unsigned int currentGeneration();
+
+private:
+   int numColumns;
+   unsigned int generation;
+   QHash<void const *, QVector<std::optional<QString> > > cells;
+
+   static unsigned int globalGeneration;
+};
+
+#endif
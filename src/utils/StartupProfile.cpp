@@ -0,0 +1,209 @@
+/*
+ * utils/StartupProfile.cpp is part of Brewtarget, and is Copyright the following
+ * authors 2021
+ * - Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "utils/StartupProfile.h"
+
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <QDebug>
+#include <QSaveFile>
+#include <QStringList>
+#include <QTextStream>
+
+#include "config.h"
+
+//
+// Anonymous namespace for constants, global variables and functions used only in this file
+//
+namespace {
+   using Clock = std::chrono::steady_clock;
+
+   //
+   // Static initialisation happens on the main thread before main() is called, so this is as close as we can
+   // (portably) get to the time the process started
+   //
+   Clock::time_point const processStartTime = Clock::now();
+   std::thread::id const mainThreadId = std::this_thread::get_id();
+
+   struct PhaseRecord {
+      char const * name;
+      int depth;
+      Clock::duration start;
+      Clock::duration duration;
+   };
+
+   struct ObjectStoreRecord {
+      char const * tableName;
+      int rows;
+      int junctionRows;
+      Clock::duration duration;
+   };
+
+   // ObjectStores can (in principle) be loaded from other threads, so everything below is guarded by this
+   std::mutex mutex;
+   bool recording = false;
+   QString outputFilePath;
+   int currentDepth = 0;
+   std::vector<PhaseRecord> phases;
+   std::vector<ObjectStoreRecord> objectStores;
+
+   double toMilliseconds(Clock::duration duration) {
+      return std::chrono::duration<double, std::milli>(duration).count();
+   }
+
+   QString column(QString const & text, int width) {
+      return width < 0 ? text.leftJustified(-width) : text.rightJustified(width);
+   }
+
+   QString column(double milliseconds, int width) {
+      return column(QString::number(milliseconds, 'f', 1), width);
+   }
+
+   void writeBreakdown(QTextStream & output, Clock::duration total) {
+      output << "Brewtarget " << VERSIONSTRING << " startup profile\n\n";
+      output << "Total: " << QString::number(toMilliseconds(total), 'f', 1) << " ms since process start\n\n";
+
+      // Negative widths are left-justified
+      output << column("Phase", -50) << column("Start (ms)", 12) << column("Time (ms)", 12) << "\n";
+      for (auto const & phase : phases) {
+         output <<
+            column(QString(phase.depth * 2, ' ') + phase.name, -50) << column(toMilliseconds(phase.start), 12) <<
+            column(toMilliseconds(phase.duration), 12) << "\n";
+      }
+
+      // Slowest first, as that's what we're interested in
+      std::vector<ObjectStoreRecord> sortedObjectStores{objectStores};
+      std::sort(sortedObjectStores.begin(),
+                sortedObjectStores.end(),
+                [](ObjectStoreRecord const & lhs, ObjectStoreRecord const & rhs) {
+                   return lhs.duration > rhs.duration;
+                });
+      output <<
+         "\n" << column("ObjectStore (table)", -26) << column("Rows", 12) << column("Junction rows", 16) <<
+         column("Time (ms)", 12) << "\n";
+      for (auto const & objectStore : sortedObjectStores) {
+         output <<
+            column(objectStore.tableName, -26) << column(QString::number(objectStore.rows), 12) <<
+            column(QString::number(objectStore.junctionRows), 16) << column(toMilliseconds(objectStore.duration), 12) <<
+            "\n";
+      }
+      return;
+   }
+}
+
+void StartupProfile::start(QString const & outputFile) {
+   std::lock_guard<std::mutex> lock{mutex};
+   outputFilePath = outputFile;
+   recording = true;
+   return;
+}
+
+void StartupProfile::recordObjectStore(char const * tableName,
+                                       int rows,
+                                       int junctionRows,
+                                       std::chrono::steady_clock::duration duration) {
+   std::lock_guard<std::mutex> lock{mutex};
+   if (recording) {
+      objectStores.push_back(ObjectStoreRecord{tableName, rows, junctionRows, duration});
+   }
+   return;
+}
+
+void StartupProfile::finish() {
+   std::lock_guard<std::mutex> lock{mutex};
+   if (!recording) {
+      return;
+   }
+   recording = false;
+   Clock::duration const total = Clock::now() - processStartTime;
+
+   //
+   // The summary is the top-level phases plus the total time spent loading from the database, which is enough to see
+   // at a glance where any slowdown is
+   //
+   QStringList topLevelPhases;
+   for (auto const & phase : phases) {
+      if (phase.depth == 0) {
+         topLevelPhases.append(
+            QString{"%1 %2 ms"}.arg(phase.name).arg(QString::number(toMilliseconds(phase.duration), 'f', 0))
+         );
+      }
+   }
+   Clock::duration objectStoresTotal{0};
+   int objectStoresRows = 0;
+   for (auto const & objectStore : objectStores) {
+      objectStoresTotal += objectStore.duration;
+      objectStoresRows += objectStore.rows + objectStore.junctionRows;
+   }
+   qInfo().noquote() <<
+      Q_FUNC_INFO << "Startup took" << QString::number(toMilliseconds(total), 'f', 0) << "ms (" <<
+      topLevelPhases.join(", ") << "); loading" << objectStores.size() << "object stores (" << objectStoresRows <<
+      "rows) took" << QString::number(toMilliseconds(objectStoresTotal), 'f', 0) << "ms";
+
+   if (!outputFilePath.isEmpty()) {
+      QSaveFile saveFile{outputFilePath};
+      if (!saveFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
+         qWarning() << Q_FUNC_INFO << "Could not open" << outputFilePath << "for writing:" << saveFile.errorString();
+      } else {
+         QTextStream output{&saveFile};
+         output.setCodec("UTF-8");
+         writeBreakdown(output, total);
+         output.flush();
+         if (output.status() != QTextStream::Ok || !saveFile.commit()) {
+            qWarning() << Q_FUNC_INFO << "Could not write" << outputFilePath << ":" << saveFile.errorString();
+         } else {
+            qInfo() << Q_FUNC_INFO << "Startup profile written to" << outputFilePath;
+         }
+      }
+   }
+
+   phases.clear();
+   objectStores.clear();
+   return;
+}
+
+StartupProfile::Phase::Phase(char const * name) : span{name}, index{-1} {
+   if (std::this_thread::get_id() != mainThreadId) {
+      return;
+   }
+   std::lock_guard<std::mutex> lock{mutex};
+   if (recording) {
+      this->index = static_cast<int>(phases.size());
+      phases.push_back(PhaseRecord{name, currentDepth, Clock::now() - processStartTime, Clock::duration{0}});
+      ++currentDepth;
+   }
+   return;
+}
+
+StartupProfile::Phase::~Phase() {
+   if (this->index < 0) {
+      return;
+   }
+   auto const endTime = Clock::now();
+   std::lock_guard<std::mutex> lock{mutex};
+   --currentDepth;
+   // If we finished while this phase was still running, the records will have been cleared
+   if (this->index < static_cast<int>(phases.size())) {
+      PhaseRecord & phase = phases[static_cast<std::size_t>(this->index)];
+      phase.duration = (endTime - processStartTime) - phase.start;
+   }
+   return;
+}
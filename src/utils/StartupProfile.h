@@ -0,0 +1,93 @@
+/*
+ * utils/StartupProfile.h is part of Brewtarget, and is Copyright the following
+ * authors 2021
+ * - Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef UTILS_STARTUPPROFILE_H
+#define UTILS_STARTUPPROFILE_H
+#pragma once
+
+#include <chrono>
+
+#include <QString>
+
+#include "utils/Tracing.h"
+
+/**
+ * \brief Measures how long each phase of program startup takes, so that, when launch gets slow, we can see what to fix
+ *        first.
+ *
+ *        Each phase is marked by a \c StartupProfile::Phase on the stack, eg:
+ *           StartupProfile::Phase const phase{"MainWindow::setupTables"};
+ *        Phases can be nested.  \c ObjectStore::loadAll also reports, for each store, how many rows it read and how
+ *        long it took.
+ *
+ *        Nothing is recorded until \c start() is called (which \c main() does as soon as it can), and recording stops at
+ *        \c finish(), once the main window is up.  At that point we log a one-line summary at info level and, if the
+ *        --startup-profile command-line option was given, write the full breakdown to the file it names.
+ *
+ *        Phases are also \c Tracing spans, so they show up in traces too.  Only phases on the main thread are recorded,
+ *        as that's where startup happens.
+ */
+namespace StartupProfile {
+
+   /**
+    * \brief Start recording
+    *
+    * \param outputFile Where to write the full breakdown when we finish.  If empty, we only log the summary.
+    */
+   void start(QString const & outputFile);
+
+   /**
+    * \brief Called by \c ObjectStore::loadAll to report what it read.  Does nothing if we're not recording.
+    */
+   void recordObjectStore(char const * tableName,
+                          int rows,
+                          int junctionRows,
+                          std::chrono::steady_clock::duration duration);
+
+   /**
+    * \brief Stop recording, log the summary and write the breakdown file (if requested).  Does nothing if we're not
+    *        recording.
+    */
+   void finish();
+
+   /**
+    * \brief RAII object that times a startup phase from its construction to its destruction
+    */
+   class Phase {
+   public:
+      /**
+       * \param name Must be a string literal (or otherwise outlive the end of startup), as we only store the pointer
+       */
+      explicit Phase(char const * name);
+      ~Phase();
+
+   private:
+      Tracing::Span span;
+      // Where we are in the list of recorded phases, or -1 if we're not being recorded
+      int index;
+
+      // RAII objects shouldn't be copied or moved
+      Phase(Phase const &) = delete;
+      Phase & operator=(Phase const &) = delete;
+      Phase(Phase &&) = delete;
+      Phase & operator=(Phase &&) = delete;
+   };
+
+}
+
+#endif
@@ -0,0 +1,209 @@
+/*
+ * utils/Tracing.cpp is part of Brewtarget, and is Copyright the following
+ * authors 2021
+ * - Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "utils/Tracing.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QSaveFile>
+#include <QTextStream>
+#include <QThread>
+
+//
+// Anonymous namespace for constants, global variables and functions used only in this file
+//
+namespace {
+
+   // If a thread records more than this many spans, we stop recording for it rather than eat all the memory
+   std::size_t const maxEventsPerThread = 1000000;
+
+   std::atomic<bool> enabled{false};
+   QString outputFilePath;
+
+   // All timestamps are relative to this, which is set when tracing starts
+   std::chrono::steady_clock::time_point epoch;
+
+   struct Event {
+      char const * name;
+      std::chrono::steady_clock::duration start;
+      std::chrono::steady_clock::duration duration;
+   };
+
+   //
+   // Each thread records spans into its own buffer.  The buffer's mutex is only ever contended when we're writing the
+   // trace out, so taking it costs almost nothing the rest of the time.
+   //
+   struct ThreadBuffer {
+      std::mutex mutex;
+      int threadNumber;
+      QString threadName;
+      std::vector<Event> events;
+      std::size_t droppedEvents;
+   };
+
+   //
+   // The buffers are owned here rather than by their threads, so we don't lose what a thread recorded if it finishes
+   // before we write the trace out.
+   //
+   std::mutex registryMutex;
+   std::vector<std::shared_ptr<ThreadBuffer>> registry;
+
+   thread_local std::shared_ptr<ThreadBuffer> threadBuffer;
+
+   ThreadBuffer & getThreadBuffer() {
+      if (!threadBuffer) {
+         threadBuffer = std::make_shared<ThreadBuffer>();
+         threadBuffer->droppedEvents = 0;
+         QThread * currentThread = QThread::currentThread();
+         if (QCoreApplication::instance() && currentThread == QCoreApplication::instance()->thread()) {
+            threadBuffer->threadName = "Main";
+         } else {
+            threadBuffer->threadName = currentThread->objectName();
+         }
+         std::lock_guard<std::mutex> lock{registryMutex};
+         threadBuffer->threadNumber = static_cast<int>(registry.size()) + 1;
+         if (threadBuffer->threadName.isEmpty()) {
+            threadBuffer->threadName = QString{"Thread %1"}.arg(threadBuffer->threadNumber);
+         }
+         registry.push_back(threadBuffer);
+      }
+      return *threadBuffer;
+   }
+
+   qint64 toMicroseconds(std::chrono::steady_clock::duration duration) {
+      return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+   }
+
+   /**
+    * \brief Names are mostly just class and function names, but we don't want a stray quote to break the JSON
+    */
+   QString jsonEscaped(QString const & text) {
+      QString escaped;
+      escaped.reserve(text.size());
+      for (QChar const cc : text) {
+         if (cc == '"' || cc == '\\') {
+            escaped.append('\\');
+         }
+         escaped.append(cc);
+      }
+      return escaped;
+   }
+
+   /**
+    * \brief Write out everything in the thread buffers as Chrome trace JSON, emptying the buffers as we go
+    */
+   bool writeTrace(QTextStream & output) {
+      qint64 const pid = QCoreApplication::applicationPid();
+      output << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+      bool first = true;
+      std::lock_guard<std::mutex> registryLock{registryMutex};
+      for (auto const & buffer : registry) {
+         std::lock_guard<std::mutex> bufferLock{buffer->mutex};
+         // Metadata event so the viewer shows a meaningful name for the thread
+         output << (first ? "" : ",\n") <<
+            "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << buffer->threadNumber <<
+            ",\"args\":{\"name\":\"" << jsonEscaped(buffer->threadName) << "\"}}";
+         first = false;
+         for (auto const & event : buffer->events) {
+            output << ",\n" <<
+               "{\"name\":\"" << jsonEscaped(QString::fromUtf8(event.name)) << "\",\"cat\":\"brewtarget\",\"ph\":\"X\"," <<
+               "\"ts\":" << toMicroseconds(event.start) << ",\"dur\":" << toMicroseconds(event.duration) <<
+               ",\"pid\":" << pid << ",\"tid\":" << buffer->threadNumber << "}";
+         }
+         if (buffer->droppedEvents > 0) {
+            qWarning() <<
+               Q_FUNC_INFO << "Dropped" << buffer->droppedEvents << "spans on" << buffer->threadName <<
+               "because its buffer was full";
+         }
+         buffer->events.clear();
+         buffer->droppedEvents = 0;
+      }
+      output << "\n]}\n";
+      return output.status() == QTextStream::Ok;
+   }
+}
+
+void Tracing::start(QString const & outputFile) {
+   outputFilePath = outputFile;
+   epoch = std::chrono::steady_clock::now();
+   enabled = true;
+   qInfo() << Q_FUNC_INFO << "Tracing on.  Trace will be written to" << outputFilePath;
+   return;
+}
+
+bool Tracing::isEnabled() {
+   return enabled.load(std::memory_order_relaxed);
+}
+
+bool Tracing::stop() {
+   if (!enabled.exchange(false)) {
+      return true;
+   }
+
+   // QSaveFile means we don't leave a half-written file if something goes wrong
+   QSaveFile saveFile{outputFilePath};
+   if (!saveFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
+      qWarning() << Q_FUNC_INFO << "Could not open" << outputFilePath << "for writing:" << saveFile.errorString();
+      return false;
+   }
+   QTextStream output{&saveFile};
+   output.setCodec("UTF-8");
+   if (!writeTrace(output)) {
+      qWarning() << Q_FUNC_INFO << "Error writing to" << outputFilePath;
+      saveFile.cancelWriting();
+      return false;
+   }
+   output.flush();
+   if (!saveFile.commit()) {
+      qWarning() << Q_FUNC_INFO << "Could not write" << outputFilePath << ":" << saveFile.errorString();
+      return false;
+   }
+   qInfo() << Q_FUNC_INFO << "Trace written to" << outputFilePath;
+   return true;
+}
+
+Tracing::Span::Span(char const * name) : name{Tracing::isEnabled() ? name : nullptr}, startTime{} {
+   if (this->name) {
+      this->startTime = std::chrono::steady_clock::now();
+   }
+   return;
+}
+
+Tracing::Span::~Span() {
+   if (!this->name) {
+      return;
+   }
+   auto const endTime = std::chrono::steady_clock::now();
+   // Tracing might have been turned off while we were running, in which case the results have already been written
+   if (!Tracing::isEnabled()) {
+      return;
+   }
+   ThreadBuffer & buffer = getThreadBuffer();
+   std::lock_guard<std::mutex> lock{buffer.mutex};
+   if (buffer.events.size() >= maxEventsPerThread) {
+      ++buffer.droppedEvents;
+      return;
+   }
+   buffer.events.push_back(Event{this->name, this->startTime - epoch, endTime - this->startTime});
+   return;
+}
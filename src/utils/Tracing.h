@@ -0,0 +1,84 @@
+/*
+ * utils/Tracing.h is part of Brewtarget, and is Copyright the following
+ * authors 2021
+ * - Matt Young <mfsy@yahoo.com>
+ *
+ * Brewtarget is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Brewtarget is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef UTILS_TRACING_H
+#define UTILS_TRACING_H
+#pragma once
+
+#include <chrono>
+
+#include <QString>
+
+/**
+ * \brief Lightweight tracing of where time goes in the slower parts of the program (startup, import, recalculation).
+ *
+ *        Put a \c Tracing::Span on the stack at the start of the code you want to time, eg:
+ *           Tracing::Span const span{"ObjectStore::loadAll"};
+ *        When tracing is on, the span records its name, start time and duration, along with which thread it ran on,
+ *        when it goes out of scope.  Each thread records into its own buffer, so threads don't hold each other up.  When
+ *        tracing is off, a span costs one atomic load.
+ *
+ *        Tracing is turned on with the --trace command-line option, or the tracingEnabled setting in the config file.
+ *        The results are written, in Chrome trace JSON format, when \c stop() is called.  You can view them by loading
+ *        the file into chrome://tracing or https://ui.perfetto.dev/.
+ */
+namespace Tracing {
+
+   /**
+    * \brief Start recording spans, to be written to \c outputFile when \c stop() is called
+    */
+   void start(QString const & outputFile);
+
+   /**
+    * \return \b true if we are currently recording spans
+    */
+   bool isEnabled();
+
+   /**
+    * \brief Stop recording spans and write out everything recorded so far.  Does nothing if tracing is not on.
+    *
+    * \return \b false if there was a problem writing the output file
+    */
+   bool stop();
+
+   /**
+    * \brief RAII object that records a span from its construction to its destruction
+    */
+   class Span {
+   public:
+      /**
+       * \param name Must be a string literal (or otherwise outlive the end of tracing), as we only store the pointer
+       */
+      explicit Span(char const * name);
+      ~Span();
+
+   private:
+      // nullptr if tracing was not on when we were created
+      char const * name;
+      std::chrono::steady_clock::time_point startTime;
+
+      // RAII objects shouldn't be copied or moved
+      Span(Span const &) = delete;
+      Span & operator=(Span const &) = delete;
+      Span(Span &&) = delete;
+      Span & operator=(Span &&) = delete;
+   };
+
+}
+
+#endif
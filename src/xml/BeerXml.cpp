@@ -31,6 +31,7 @@
 
 #include "brewtarget.h"
 #include "config.h" // For VERSIONSTRING
+#include "Logging.h"
 #include "model/BrewNote.h"
 #include "model/Equipment.h"
 #include "model/Fermentable.h"
@@ -651,7 +652,7 @@ public:
       //
       QByteArray documentData = inputFile.readLine();
       QString firstLine{documentData};
-      qDebug() << Q_FUNC_INFO << "First line of " << inputFile.fileName() << " was " << firstLine;
+      qCDebug(lcXml) << Q_FUNC_INFO << "First line of " << inputFile.fileName() << " was " << firstLine;
       if (!firstLine.startsWith(QString("<?xml version="))) {
          //
          // For the moment, we're being strict and bailing out here.  An alternative approach would be to accept files
@@ -666,11 +667,11 @@ public:
       documentData += "<BEER_XML>\n";
       documentData += inputFile.readAll();
       documentData += "\n</BEER_XML>";
-      qDebug() << Q_FUNC_INFO << "Input file " << inputFile.fileName() << ": " << documentData.length() << " bytes";
+      qCDebug(lcXml) << Q_FUNC_INFO << "Input file " << inputFile.fileName() << ": " << documentData.length() << " bytes";
 
       // It is sometimes helpful to uncomment the next line for debugging, but usually leave it commented out as can
       // put a _lot_ of data in the logs in DEBUG mode.
-      // qDebug().noquote() << Q_FUNC_INFO << "Full content of " << inputFile.fileName() << " is:\n" << QString(documentData);
+      // qCDebug(lcXml).noquote() << Q_FUNC_INFO << "Full content of " << inputFile.fileName() << " is:\n" << QString(documentData);
 
       //
       // Some errors we explicitly want to ignore.  In particular, the BeerXML 1.0 standard says:
@@ -43,6 +43,8 @@
 #include <xalanc/XercesParserLiaison/XercesDOMSupport.hpp>
 #include <xalanc/XPath/XPathEvaluator.hpp>
 
+#include "Logging.h"
+#include "utils/Tracing.h"
 #include "xml/BtDomDocumentOwner.h"
 #include "xml/XercesHelpers.h"
 #include "xml/XmlRecordCount.h"
@@ -267,12 +269,12 @@ public:
       }
 
       QByteArray schemaData = schemaFile.readAll();
-      qDebug() <<
+      qCDebug(lcXml) <<
          Q_FUNC_INFO << "Schema file " << schemaFile.fileName() << ": " << schemaData.length() << " bytes";
 
       // Don't want qDebug to escape newlines, as there will be lots in the list of parameter settings, hence
       // ".noquote()" here.
-      qDebug().noquote() <<
+      qCDebug(lcXml).noquote() <<
          Q_FUNC_INFO << "Settings for reading schema file " << schemaFile.fileName() << ": " <<
          XercesHelpers::getParameterSettings(*config);
 
@@ -307,7 +309,7 @@ public:
 
       xercesc::Grammar * rootGrammar = this->parser->getRootGrammar();
 
-      qDebug() <<
+      qCDebug(lcXml) <<
          Q_FUNC_INFO << "Schema " << schemaFile.fileName() << " loaded OK.  Grammar:" << grammar << ", root grammar:" <<
          rootGrammar;
 
@@ -368,7 +370,7 @@ public:
 
          // Don't want qDebug to escape newlines, as there will be lots in the list of parameter settings, hence
          // ".noquote()" here.
-         qDebug().noquote() <<
+         qCDebug(lcXml).noquote() <<
             Q_FUNC_INFO << "Settings for reading input " << fileName << ": " << XercesHelpers::getParameterSettings(*config);
 
          QByteArray fileNameAsCString = fileName.toLocal8Bit();
@@ -388,7 +390,7 @@ public:
          BtDomDocumentOwner domDocumentOwner{this->parser->parse(&documentAsDOMLSInput)};
 
          bool parsedOk = !domErrorHandler.failed();
-         qDebug() << Q_FUNC_INFO << "Parse of input file " << fileName << (parsedOk ? "succeeded" : "FAILED");
+         qCDebug(lcXml) << Q_FUNC_INFO << "Parse of input file " << fileName << (parsedOk ? "succeeded" : "FAILED");
 
          if (!parsedOk) {
             userMessage << domErrorHandler.getlastError();
@@ -499,7 +501,7 @@ public:
                                   QTextStream & userMessage) const {
 
       XQString rootNodeName{rootNode->getNodeName()};
-      qDebug() << Q_FUNC_INFO << "Processing root node: " << rootNodeName;
+      qCDebug(lcXml) << Q_FUNC_INFO << "Processing root node: " << rootNodeName;
 
       // It's usually a coding error if we don't understand how to process the root node, because it should have been
       // validated by the XSD.  (In the case of BeerXML, the root node is a manufactured one that we inserted, which is all
@@ -555,7 +557,7 @@ XmlCoding::XmlCoding(QString const name,
    name{name},
    entityNameToXmlRecordDefinition{entityNameToXmlRecordDefinition},
    pimpl{ new impl{schemaResource} } {
-   qDebug() << Q_FUNC_INFO;
+   qCDebug(lcXml) << Q_FUNC_INFO;
    return;
 }
 
@@ -582,5 +584,6 @@ bool XmlCoding::validateLoadAndStoreInDb(QByteArray const & documentData,
                                          QString const & fileName,
                                          BtDomErrorHandler & domErrorHandler,
                                          QTextStream & userMessage) const {
+   Tracing::Span const span{"XmlCoding::validateLoadAndStoreInDb"};
    return this->pimpl->validateLoadAndStoreInDb(this, documentData, fileName, domErrorHandler, userMessage);
 }
@@ -18,6 +18,8 @@
  */
 #include "xml/XmlMashRecord.h"
 
+#include "Logging.h"
+
 void XmlMashRecord::subRecordToXml(XmlRecord::FieldDefinition const & fieldDefinition,
                                    XmlRecord const & subRecord,
                                    NamedEntity const & namedEntityToExport,
@@ -48,6 +50,6 @@ void XmlMashRecord::setContainingEntity(std::shared_ptr<NamedEntity> containingE
    // Don't include Mash in stats is it's in a Recipe (ie if the cast below succeeds); DO include it if it's not (ie if
    // there's no containing entity or the cast below fails).
    this->includeInStats = (nullptr == dynamic_cast<Recipe *>(containingEntity.get()));
-   qDebug() << Q_FUNC_INFO << (this->includeInStats ? "Included in" : "Excluded from") << "stats";
+   qCDebug(lcXml) << Q_FUNC_INFO << (this->includeInStats ? "Included in" : "Excluded from") << "stats";
    return;
 }
@@ -25,6 +25,7 @@
 #include <QList>
 
 #include "database/ObjectStoreWrapper.h"
+#include "Logging.h"
 #include "model/BrewNote.h"
 #include "model/Instruction.h"
 #include "model/Mash.h"
@@ -109,7 +110,7 @@ protected:
          }
       );
       if (matchResult) {
-         qDebug() <<
+         qCDebug(lcXml) <<
             Q_FUNC_INFO << "Found a match (#" << matchResult.value()->key() << "," << matchResult.value()->name() <<
             ") for #" << this->namedEntity->key() << ", " << this->namedEntity->name();
          // Set our Hop/Yeast/Fermentable/etc to the one we found already stored in the database, so that any
@@ -118,7 +119,7 @@ protected:
          this->namedEntity = matchResult.value();
          return true;
       }
-      qDebug() << Q_FUNC_INFO << "No match found for "<< this->namedEntity->name();
+      qCDebug(lcXml) << Q_FUNC_INFO << "No match found for "<< this->namedEntity->name();
       return false;
    }
 
@@ -145,14 +146,14 @@ protected:
             [currentName](std::shared_ptr<NE> ne) {return ne->name() == currentName;}
          )
       ) {
-         qDebug() << Q_FUNC_INFO << "Found existing " << this->namedEntityClassName << "named" << currentName;
+         qCDebug(lcXml) << Q_FUNC_INFO << "Found existing " << this->namedEntityClassName << "named" << currentName;
 
          XmlRecord::modifyClashingName(currentName);
 
          //
          // Now the for loop will search again with the new name
          //
-         qDebug() << Q_FUNC_INFO << "Trying " << currentName;
+         qCDebug(lcXml) << Q_FUNC_INFO << "Trying " << currentName;
       }
 
       this->namedEntity->setName(currentName);
@@ -188,7 +189,7 @@ template<> inline void XmlNamedEntityRecord<BrewNote>::normaliseName() { return;
 
 // Specialisations for cases where object is owned by its containing entity
 template<> inline void XmlNamedEntityRecord<BrewNote>::setContainingEntity(std::shared_ptr<NamedEntity> containingEntity) {
-   qDebug() <<
+   qCDebug(lcXml) <<
       Q_FUNC_INFO << "BrewNote * " << static_cast<void*>(this->namedEntity.get()) << ", Recipe * " <<
       static_cast<void*>(containingEntity.get());
    auto brewNote = std::static_pointer_cast<BrewNote>(this->namedEntity);
@@ -27,6 +27,7 @@
 #include <xalanc/XPath/XPathEvaluator.hpp>
 #include <xalanc/XalanDOM/XalanNamedNodeMap.hpp>
 
+#include "Logging.h"
 #include "xml/XmlCoding.h"
 
 //
@@ -95,7 +96,7 @@ std::shared_ptr<NamedEntity> XmlRecord::getNamedEntity() const {
 bool XmlRecord::load(xalanc::DOMSupport & domSupport,
                      xalanc::XalanNode * rootNodeOfRecord,
                      QTextStream & userMessage) {
-   qDebug() << Q_FUNC_INFO;
+   qCDebug(lcXml) << Q_FUNC_INFO;
 
    xalanc::XPathEvaluator xPathEvaluator;
    //
@@ -129,7 +130,7 @@ bool XmlRecord::load(xalanc::DOMSupport & domSupport,
                                     rootNodeOfRecord,
                                     fieldDefinition->xPath.getXalanString());
       auto numChildNodes = nodesForCurrentXPath.getLength();
-      qDebug() << Q_FUNC_INFO << "Found" << numChildNodes << "node(s) for " << fieldDefinition->xPath;
+      qCDebug(lcXml) << Q_FUNC_INFO << "Found" << numChildNodes << "node(s) for " << fieldDefinition->xPath;
       if (XmlRecord::RecordSimple == fieldDefinition->fieldType ||
           XmlRecord::RecordComplex == fieldDefinition->fieldType) {
          //
@@ -158,12 +159,12 @@ bool XmlRecord::load(xalanc::DOMSupport & domSupport,
          XQString fieldName{fieldContainerNode->getNodeName()};
          xalanc::XalanNodeList const * fieldContents = fieldContainerNode->getChildNodes();
          int numChildrenOfContainerNode = fieldContents->getLength();
-         qDebug() <<
+         qCDebug(lcXml) <<
             Q_FUNC_INFO << "Node " << fieldDefinition->xPath << "(" << fieldName << ":" <<
             XALAN_NODE_TYPES[fieldContainerNode->getNodeType()] << ") has " <<
             numChildrenOfContainerNode << " children";
          if (0 == numChildrenOfContainerNode) {
-            qDebug() << Q_FUNC_INFO << "Empty!";
+            qCDebug(lcXml) << Q_FUNC_INFO << "Empty!";
          } else {
             {
                //
@@ -178,7 +179,7 @@ bool XmlRecord::load(xalanc::DOMSupport & domSupport,
                }
                xalanc::XalanNode * valueNode = fieldContents->item(0);
                XQString value(valueNode->getNodeValue());
-               qDebug() << Q_FUNC_INFO << "Value " << value;
+               qCDebug(lcXml) << Q_FUNC_INFO << "Value " << value;
 
                bool parsedValueOk = false;
                QVariant parsedValue;
@@ -356,7 +357,7 @@ bool XmlRecord::load(xalanc::DOMSupport & domSupport,
                      // out), we can't carry on to normal processing below.  So jump straight to processing the next
                      // node in the loop (via continue).
                      //
-                     qDebug() <<
+                     qCDebug(lcXml) <<
                         Q_FUNC_INFO << "Skipping " << this->namedEntityClassName << " node " <<
                         fieldDefinition->xPath << "=" << value << "(" << fieldDefinition->propertyName <<
                         ") as not useful";
@@ -436,7 +437,7 @@ XmlRecord::ProcessingResult XmlRecord::normaliseAndStoreInDb(std::shared_ptr<Nam
                                                              QTextStream & userMessage,
                                                              XmlRecordCount & stats) {
    if (nullptr != this->namedEntity) {
-      qDebug() <<
+      qCDebug(lcXml) <<
          Q_FUNC_INFO << "Normalise and store " << this->namedEntityClassName << "(" <<
          this->namedEntity->metaObject()->className() << "):" << this->namedEntity->name();
 
@@ -450,7 +451,7 @@ XmlRecord::ProcessingResult XmlRecord::normaliseAndStoreInDb(std::shared_ptr<Nam
       // determine whether they are duplicates.  This is why we check again, after storing in the DB, below.
       //
       if (this->isDuplicate()) {
-         qDebug() <<
+         qCDebug(lcXml) <<
             Q_FUNC_INFO << "(Early found) duplicate" << this->namedEntityClassName <<
             (this->includeInStats ? " will" : " won't") << " be included in stats";
          if (this->includeInStats) {
@@ -505,7 +506,7 @@ XmlRecord::ProcessingResult XmlRecord::normaliseAndStoreInDb(std::shared_ptr<Nam
       // We potentially do stats for everything except failure
       //
       if (XmlRecord::FoundDuplicate == processingResult) {
-         qDebug() <<
+         qCDebug(lcXml) <<
             Q_FUNC_INFO << "(Late found) duplicate" << this->namedEntityClassName <<
             (this->includeInStats ? " will" : " won't") << " be included in stats";
          if (this->includeInStats) {
@@ -528,7 +529,7 @@ XmlRecord::ProcessingResult XmlRecord::normaliseAndStoreInDb(std::shared_ptr<Nam
          // and 2 MashSteps before hitting an error on the 3rd MashStep, then deleting the Mash from the DB will also
          // result in those 2 stored MashSteps getting deleted from the DB.)
          //
-         qDebug() <<
+         qCDebug(lcXml) <<
             Q_FUNC_INFO << "Deleting stored" << this->namedEntityClassName << "as" <<
             (XmlRecord::FoundDuplicate == processingResult ? "duplicate" : "failed to read all child records");
          this->deleteNamedEntityFromDb();
@@ -555,7 +556,7 @@ bool XmlRecord::normaliseAndStoreChildRecordsInDb(QTextStream & userMessage,
    // iterators, so going backwards would be a bit clunky.)
    //
    for (auto ii = this->childRecords.begin(); ii != this->childRecords.end(); ++ii) {
-      qDebug() <<
+      qCDebug(lcXml) <<
          Q_FUNC_INFO << "Storing" << ii->xmlRecord->namedEntityClassName << "child of" << this->namedEntityClassName;
       if (XmlRecord::Failed == ii->xmlRecord->normaliseAndStoreInDb(this->namedEntity, userMessage, stats)) {
          return false;
@@ -587,7 +588,7 @@ bool XmlRecord::normaliseAndStoreChildRecordsInDb(QTextStream & userMessage,
          // It's a coding error if we can't create a valid QVariant from a pointer to class we are trying to "set"
          Q_ASSERT(QVariant::fromValue(ii->xmlRecord->namedEntity.get()).isValid());
 
-         qDebug() <<
+         qCDebug(lcXml) <<
             Q_FUNC_INFO << "Setting" << propertyName << "property (type = " <<
             this->namedEntity->metaObject()->property(
                this->namedEntity->metaObject()->indexOfProperty(propertyName)
@@ -643,7 +644,7 @@ bool XmlRecord::loadChildRecords(xalanc::DOMSupport & domSupport,
       // The return value of xalanc::XalanNode::getIndex() doesn't have an instantly obvious direct meaning, but AFAICT
       // higher values are for nodes that were later in the input file, so useful to log.
       //
-      qDebug() <<
+      qCDebug(lcXml) <<
          Q_FUNC_INFO << "Loading child record" << childRecordName << "with index" << childRecordNode->getIndex();
       if (!xmlRecord->load(domSupport, childRecordNode, userMessage)) {
          return false;
@@ -703,7 +704,7 @@ void XmlRecord::toXml(NamedEntity const & namedEntityToExport,
                       char const * const indentString) const {
    // Callers are not allowed to supply null indent string
    Q_ASSERT(nullptr != indentString);
-   qDebug() <<
+   qCDebug(lcXml) <<
       Q_FUNC_INFO << "Exporting XML for" << namedEntityToExport.metaObject()->className() << "#" << namedEntityToExport.key();
    writeIndents(out, indentLevel, indentString);
    out << "<" << this->recordName << ">\n";
@@ -743,8 +744,8 @@ void XmlRecord::toXml(NamedEntity const & namedEntityToExport,
             writeIndents(out, indentLevel + 1 + ii, indentString);
             out << "<" << xPathElements.at(ii) << ">\n";
          }
-         qDebug() << Q_FUNC_INFO << xPathElements;
-         qDebug() << Q_FUNC_INFO << xPathElements.last();
+         qCDebug(lcXml) << Q_FUNC_INFO << xPathElements;
+         qCDebug(lcXml) << Q_FUNC_INFO << xPathElements.last();
          std::shared_ptr<XmlRecord> subRecord = this->xmlCoding.getNewXmlRecord(xPathElements.last());
 
          if (XmlRecord::RecordSimple == fieldDefinition.fieldType) {